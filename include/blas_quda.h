@@ -93,6 +93,8 @@ namespace quda {
 		   const cpuColorSpinorField &z, const double &b);
   void axpyBzpcxCpu(const double &a, cpuColorSpinorField& x, cpuColorSpinorField& y,
 		    const double &b, const cpuColorSpinorField& z, const double &c); 
+  void axpyBzpcxCpu(const double *a, cpuColorSpinorField **x, cpuColorSpinorField **y,
+		    const double *b, const cpuColorSpinorField &z, const double *c, const int N);
 
   void caxpbyCpu(const Complex &a, const cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y);
   void caxpyCpu(const Complex &a, const cpuColorSpinorField &x, cpuColorSpinorField &y);
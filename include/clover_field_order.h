@@ -143,6 +143,37 @@ namespace quda {
       size_t Bytes() const { return length*sizeof(Float); }
     };
 
+  /**
+     Host vector (AoSoA) ordering for clover fields: the packed QDP
+     ordering with each element stored for blocks of W sites
+   */
+  template <typename Float, int length, int W>
+    struct AoSoAOrder {
+      typedef typename mapper<Float>::type RegType;
+      Float *clover[2];
+      const int volumeCB;
+      const int stride;
+
+      AoSoAOrder(const CloverField &clover, bool inverse, Float *clover_=0)
+      : volumeCB(clover.VolumeCB()), stride(volumeCB) {
+	if (volumeCB % W) errorQuda("Volume %d must be a multiple of the block width %d", volumeCB, W);
+	this->clover[0] = clover_ ? clover_ : (Float*)(clover.V(inverse));
+	this->clover[1] = (Float*)((char*)this->clover[0] + clover.Bytes()/2);
+      }
+
+      __device__ __host__ inline void load(RegType v[length], int x, int parity) const {
+	const Float *block = clover[parity] + (x/W)*length*W + x%W;
+	for (int i=0; i<length; i++) v[i] = 0.5*block[i*W]; // factor of 0.5 comes from basis change
+      }
+
+      __device__ __host__ inline void save(const RegType v[length], int x, int parity) {
+	Float *block = clover[parity] + (x/W)*length*W + x%W;
+	for (int i=0; i<length; i++) block[i*W] = 2.0*v[i];
+      }
+
+      size_t Bytes() const { return length*sizeof(Float); }
+    };
+
   /**
      QDPJIT ordering for clover fields
    */
@@ -353,6 +353,7 @@ namespace quda {
   template <typename Float> class SpaceColorSpinOrder;
   template <typename Float> class SpaceSpinColorOrder;
   template <typename Float> class QOPDomainWallOrder;
+  template <typename Float> class AoSoASpinColorOrder;
 
   // CPU implementation
   class cpuColorSpinorField : public ColorSpinorField {
@@ -362,6 +363,7 @@ namespace quda {
     template <typename Float> friend class SpaceColorSpinOrder;
     template <typename Float> friend class SpaceSpinColorOrder;
     template <typename Float> friend class QOPDomainWallOrder;
+    template <typename Float> friend class AoSoASpinColorOrder;
 
   public:
     static void* fwdGhostFaceBuffer[QUDA_MAX_DIM]; //cpu memory
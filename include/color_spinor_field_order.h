@@ -105,6 +105,30 @@ namespace quda {
     }
   };
 
+  template <typename Float>
+    class AoSoASpinColorOrder : public ColorSpinorFieldOrder<Float> {
+
+  private:
+    cpuColorSpinorField &field;  // convenient to have a "local" reference for code brevity
+    int width;
+
+  public:
+  AoSoASpinColorOrder(cpuColorSpinorField &field) : ColorSpinorFieldOrder<Float>(field),
+      field(field), width(aosoaWidth(field.FieldOrder()))
+      { if (width == 0) errorQuda("Field order %d is not an AoSoA order", field.FieldOrder()); }
+    virtual ~AoSoASpinColorOrder() { ; }
+
+    const Float& operator()(const int &x, const int &s, const int &c, const int &z) const {
+      unsigned long index = ((x/width*field.nSpin+s)*field.nColor+c)*2+z;
+      return *((Float*)(field.v) + index*width + x%width);
+    }
+
+    Float& operator()(const int &x, const int &s, const int &c, const int &z) {
+      unsigned long index = ((x/width*field.nSpin+s)*field.nColor+c)*2+z;
+      return *((Float*)(field.v) + index*width + x%width);
+    }
+  };
+
 template <typename Float, int Ns, int Nc, int N>
 struct FloatNOrder {
   typedef typename mapper<Float>::type RegType;
@@ -226,6 +250,8 @@ struct SpaceColorSpinorOrder {
   size_t Bytes() const { return volumeCB * Nc * Ns * 2 * sizeof(Float); }
 };
 
+#ifndef QUDA_HOST_ONLY // the staging through shared memory is device code only
+
 template <typename Float, int Ns, int Nc>
   __device__ inline void load_shared(typename mapper<Float>::type v[Ns*Nc*2], Float *field, int x, int volume) {
   const int tid = threadIdx.x;
@@ -296,6 +322,8 @@ template <typename Float, int Ns, int Nc>
 
 } 
 
+#endif // QUDA_HOST_ONLY
+
 /**! float load specialization to obtain full coalescing. */
 template<> __host__ __device__ inline void SpaceColorSpinorOrder<float, 4, 3>::load(float v[24], int x) const {
 #ifdef __CUDA_ARCH__
@@ -419,4 +447,45 @@ struct QDPJITDiracOrder {
 };
 
 
+/**
+   Host array-of-structure-of-arrays ordering: blocks of W sites, each
+   stored as [spin][color][complex][W], so that the same component of W
+   consecutive sites is contiguous.
+*/
+template <typename Float, int Ns, int Nc, int W>
+struct AoSoASpinorColorOrder {
+  typedef typename mapper<Float>::type RegType;
+  Float *field;
+  int volumeCB;
+  int stride;
+  AoSoASpinorColorOrder(const ColorSpinorField &a, Float *field_=0)
+  : field(field_ ? field_ : (Float*)a.V()), volumeCB(a.VolumeCB()), stride(a.Stride())
+  {
+    if (volumeCB != stride) errorQuda("Stride must equal volume for this field order");
+    if (volumeCB % W) errorQuda("Volume %d must be a multiple of the block width %d", volumeCB, W);
+  }
+  virtual ~AoSoASpinorColorOrder() { ; }
+
+  __device__ __host__ inline void load(RegType v[Ns*Nc*2], int x) const {
+    const Float *block = field + (x/W)*Ns*Nc*2*W + x%W;
+    for (int i=0; i<Ns*Nc*2; i++) v[i] = block[i*W];
+  }
+
+  __device__ __host__ inline void save(const RegType v[Ns*Nc*2], int x) {
+    Float *block = field + (x/W)*Ns*Nc*2*W + x%W;
+    for (int i=0; i<Ns*Nc*2; i++) block[i*W] = v[i];
+  }
+
+  __device__ __host__ const Float& operator()(int x, int s, int c, int z) const {
+    return field[(((x/W)*Ns + s)*Nc + c)*2*W + z*W + x%W];
+  }
+
+  __device__ __host__ Float& operator()(int x, int s, int c, int z) {
+    return field[(((x/W)*Ns + s)*Nc + c)*2*W + z*W + x%W];
+  }
+
+  size_t Bytes() const { return volumeCB * Nc * Ns * 2 * sizeof(Float); }
+};
+
+
 } // namespace quda
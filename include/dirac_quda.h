@@ -9,6 +9,7 @@
 
 #include <face_quda.h>
 #include <blas_quda.h>
+#include <stencil_index.h>
 
 #include <typeinfo>
 
@@ -123,6 +124,12 @@ namespace quda {
     virtual void reconstruct(cudaColorSpinorField &x, const cudaColorSpinorField &b,
 			     const QudaSolutionType) const = 0;
     void setMass(double mass){ this->mass = mass;}
+
+    const cudaGaugeField& Gauge() const { return gauge; }
+    double Kappa() const { return kappa; }
+    MatPCType getMatPCType() const { return matpcType; }
+    DagType Dagger() const { return dagger; }
+
     // Dirac operator factory
     static Dirac* create(const DiracParam &param);
 
@@ -407,6 +414,8 @@ namespace quda {
     unsigned long long flops() const { return dirac->Flops(); }
 
     std::string Type() const { return typeid(*dirac).name(); }
+
+    const Dirac* Expose() const { return dirac; }
   };
 
   inline DiracMatrix::~DiracMatrix()
@@ -507,6 +516,145 @@ namespace quda {
     }
   };
 
+  /**
+     Host implementation of the Wilson operator (QUDA_WILSON_DIRAC or
+     QUDA_WILSONPC_DIRAC) for the host solvers.  Acts on
+     cpuColorSpinorFields in the DeGrand-Rossi basis with
+     space-spin-color order.  The gauge field is copied once into a
+     [site][dim][18] layout with the backward links of the neighboring
+     nodes appended after the local sites, and the neighbor table,
+     including the halo slots of the partitioned dimensions, is built
+     at construction.  With half or bfloat16 storage the spinors are
+     kept compressed (see cpu_spinor_storage.h) and the operator is
+     only applied to raw vectors in that format.  With
+     QUDA_RECONSTRUCT_12 or QUDA_RECONSTRUCT_8 the links are stored
+     compressed as well and rebuilt on the fly by the kernel, which
+     requires SU(3) links up to the anisotropy and temporal boundary.
+
+     With virtualNode set, the local lattice is split into one
+     sub-lattice per vector lane and the raw vectors and links are held
+     in the virtual-node layout of wilson_cpu_core.h, so that the
+     stencil is applied with unit-stride vector loads and lane
+     permutes (double or single storage without reconstruction only).
+     The cpuColorSpinorField functions convert to and from the layout
+     on every call; ToLayout and FromLayout convert raw vectors.
+   */
+  struct VirtualNodeHop;
+
+  class DiracWilsonCpu {
+
+  protected:
+    QudaDiracType type;
+    double kappa;
+    MatPCType matpcType;
+    DagType dagger;
+    QudaStorageType storage;
+    QudaPrecision precision; // precision of the gauge field and of the arithmetic
+    int siteBytes;           // bytes per spinor site in the storage format
+    QudaReconstructType reconstruct; // reals stored per link
+    double anisotropy;
+    QudaTboundary tBoundary;
+
+    int X[4];
+    int volumeCB;
+    int faceCB[4];
+    int ghostOffset[4][2]; // offset of the backward / forward halo of each dimension
+    int ghostCB;           // total number of halo sites
+
+    const StencilIndex *stencil; // tables shared with the other operators of the geometry
+    const int *nbr[2];           // neighbor table for each parity, 8 entries per site
+    const int *face[4][2][2];    // [dim][bottom/top][parity] checkerboard indices of the face sites
+    const int *sites[2];         // [parity] order in which the sites are visited
+
+    void *gauge[2];        // gauge field of each parity, volumeCB + ghostCB sites
+    void *ghost;           // spinor halo
+    void *sendBuf;         // spinor faces sent to the neighbors
+    void *tmp[2];          // temporaries used by M and MdagM
+
+    MsgHandle *mhSend[4][2]; // persistent halo messages, [dim][backwards/forwards]
+    MsgHandle *mhRecv[4][2];
+
+    mutable unsigned long long flops;
+
+    bool virtualNode;          // raw vectors and links in the virtual-node layout
+    int vnWidth;               // sites per outer site (the vector width)
+    int *vnSite[2];            // [parity] checkerboard index of each layout index
+    int *vnIndex[2];           // [parity] layout index of each checkerboard index
+    VirtualNodeHop *vnHop[2];  // [parity] eight hops per outer site
+    int *vnLanes[2];           // [parity] per-lane sources of the hops into the halo
+    void *layoutBuf[3];        // field conversion buffers of the virtual-node layout
+
+    void checkField(const cpuColorSpinorField &f, QudaSiteSubset subset) const;
+    void exchangeGhost(const void *in, int parity) const;
+    void hop(void *out, const void *in, int parity, int dagger, const void *x, double a) const;
+    void applyM(void *out, const void *in, int dagger) const;
+    void checkParam();
+    void create(const cpuGaugeField &u, QudaStencilOrder stencilOrder);
+    void setupVirtualNode();
+    void relayout(void *out, const void *in, int parity, bool toLayout) const;
+
+  public:
+#ifndef QUDA_HOST_ONLY
+    DiracWilsonCpu(const DiracParam &param, QudaStorageType storage,
+		   QudaReconstructType reconstruct=QUDA_RECONSTRUCT_NO, bool virtualNode=false,
+		   QudaStencilOrder stencilOrder=QUDA_LEXICOGRAPHIC_STENCIL_ORDER);
+#endif
+
+    /**
+       Construct the operator from host links (without reconstruction,
+       in any host gauge order), so that no device is needed; the
+       gauge member of param is not used.
+    */
+    DiracWilsonCpu(const DiracParam &param, const cpuGaugeField &gauge, QudaStorageType storage,
+		   QudaReconstructType reconstruct=QUDA_RECONSTRUCT_NO, bool virtualNode=false,
+		   QudaStencilOrder stencilOrder=QUDA_LEXICOGRAPHIC_STENCIL_ORDER);
+    virtual ~DiracWilsonCpu();
+
+    /**
+       Apply the hopping term to a single-parity field: out = D in
+       @param out The output field of parity parity
+       @param in The input field of the opposite parity
+       @param parity The parity of the output field
+    */
+    void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+		const QudaParity parity) const;
+
+    /**
+       Apply the hopping term and accumulate: out = x + k * D in
+    */
+    void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+		    const QudaParity parity, const cpuColorSpinorField &x, const double &k) const;
+
+    void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void Mdag(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    /**
+       Apply M or MdagM to raw vectors of SiteSubset() sites in the
+       storage format of the operator
+    */
+    void M(void *out, const void *in) const;
+    void MdagM(void *out, const void *in) const;
+
+    /**
+       Convert raw vectors of SiteSubset() sites from the site order of
+       the host fields to the layout of the operator, or back (a copy
+       unless VirtualNode())
+    */
+    void ToLayout(void *out, const void *in) const;
+    void FromLayout(void *out, const void *in) const;
+
+    QudaStorageType Storage() const { return storage; }
+    QudaPrecision Precision() const { return precision; }
+    QudaReconstructType Reconstruct() const { return reconstruct; }
+    int SiteBytes() const { return siteBytes; }
+    int VolumeCB() const { return volumeCB; }
+    bool VirtualNode() const { return virtualNode; }
+    QudaSiteSubset SiteSubset() const
+    { return type == QUDA_WILSONPC_DIRAC ? QUDA_PARITY_SITE_SUBSET : QUDA_FULL_SITE_SUBSET; }
+    unsigned long long Flops() const { unsigned long long rtn = flops; flops = 0; return rtn; }
+  };
+
 } // namespace quda
 
 #endif // _DIRAC_QUDA_H
@@ -34,6 +34,9 @@ extern "C" {
     QUDA_CPS_WILSON_GAUGE_ORDER, // expect *gauge, even-odd, mu, spacetime, column-row color
     QUDA_MILC_GAUGE_ORDER, // expect *gauge, even-odd, mu, spacetime, row-column order
     QUDA_BQCD_GAUGE_ORDER, // expect *gauge, mu, even-odd, spacetime+halos, column-row order
+    QUDA_AOSOA4_GAUGE_ORDER, // expect *gauge, even-odd, mu, spacetime/4, row-column order, spacetime%4
+    QUDA_AOSOA8_GAUGE_ORDER, // expect *gauge, even-odd, mu, spacetime/8, row-column order, spacetime%8
+    QUDA_AOSOA16_GAUGE_ORDER, // expect *gauge, even-odd, mu, spacetime/16, row-column order, spacetime%16
     QUDA_INVALID_GAUGE_ORDER = QUDA_INVALID_ENUM
   } QudaGaugeFieldOrder;
 
@@ -50,6 +53,23 @@ extern "C" {
     QUDA_INVALID_PRECISION = QUDA_INVALID_ENUM
   } QudaPrecision;
 
+  // storage formats of the vectors in the host solvers
+  typedef enum QudaStorageType_s {
+    QUDA_DOUBLE_STORAGE,   // 64-bit IEEE
+    QUDA_SINGLE_STORAGE,   // 32-bit IEEE
+    QUDA_HALF_STORAGE,     // 16-bit fixed point with a per-site norm
+    QUDA_BFLOAT16_STORAGE, // 16-bit truncated IEEE (8-bit exponent, 7-bit mantissa)
+    QUDA_INVALID_STORAGE = QUDA_INVALID_ENUM
+  } QudaStorageType;
+
+  // order in which the host stencils visit the sites of a parity
+  typedef enum QudaStencilOrder_s {
+    QUDA_LEXICOGRAPHIC_STENCIL_ORDER,
+    QUDA_MORTON_STENCIL_ORDER,  // Z-order curve
+    QUDA_HILBERT_STENCIL_ORDER,
+    QUDA_INVALID_STENCIL_ORDER = QUDA_INVALID_ENUM
+  } QudaStencilOrder;
+
   typedef enum QudaReconstructType_s {
     QUDA_RECONSTRUCT_NO = 18, // store all 18 real numbers explicitly
     QUDA_RECONSTRUCT_12 = 12, // reconstruct from 12 real numbers
@@ -170,6 +190,9 @@ extern "C" {
     QUDA_PACKED_CLOVER_ORDER,     // even-odd, QDP packed
     QUDA_QDPJIT_CLOVER_ORDER,     // (diagonal / off-diagonal)-chirality-spacetime
     QUDA_BQCD_CLOVER_ORDER,       // even-odd, super-diagonal packed and reordered
+    QUDA_AOSOA4_CLOVER_ORDER,     // even-odd, spacetime/4, internal order, spacetime%4
+    QUDA_AOSOA8_CLOVER_ORDER,     // even-odd, spacetime/8, internal order, spacetime%8
+    QUDA_AOSOA16_CLOVER_ORDER,    // even-odd, spacetime/16, internal order, spacetime%16
     QUDA_INVALID_CLOVER_ORDER = QUDA_INVALID_ENUM
   } QudaCloverFieldOrder;
 
@@ -252,6 +275,9 @@ extern "C" {
     QUDA_SPACE_COLOR_SPIN_FIELD_ORDER, // QLA ordering (spin inside color)
     QUDA_QDPJIT_FIELD_ORDER, // QDP field ordering (complex-color-spin-spacetime)
     QUDA_QOP_DOMAIN_WALL_FIELD_ORDER, // QOP domain-wall ordering
+    QUDA_AOSOA4_FIELD_ORDER, // space/4-spin-color-complex-space%4 (host vector ordering)
+    QUDA_AOSOA8_FIELD_ORDER, // space/8-spin-color-complex-space%8 (host vector ordering)
+    QUDA_AOSOA16_FIELD_ORDER, // space/16-spin-color-complex-space%16 (host vector ordering)
     QUDA_INVALID_FIELD_ORDER = QUDA_INVALID_ENUM
   } QudaFieldOrder;
   
@@ -312,9 +338,17 @@ extern "C" {
   typedef enum QudaComputeFatMethod_s {
     QUDA_COMPUTE_FAT_STANDARD,
     QUDA_COMPUTE_FAT_EXTENDED_VOLUME,
+    QUDA_COMPUTE_FAT_HOST,
     QUDA_COMPUTE_FAT_INVALID=  QUDA_INVALID_ENUM
   } QudaComputeFatMethod;
 
+  typedef enum QudaGaugeSmearType_s {
+    QUDA_GAUGE_SMEAR_APE,
+    QUDA_GAUGE_SMEAR_STOUT,
+    QUDA_GAUGE_SMEAR_HYP,
+    QUDA_GAUGE_SMEAR_INVALID = QUDA_INVALID_ENUM
+  } QudaGaugeSmearType;
+
   typedef enum QudaFatLinkFlag_s {
     QUDA_FAT_PRESERVE_CPU_GAUGE=1,
     QUDA_FAT_PRESERVE_GPU_GAUGE=2,
@@ -36,6 +36,9 @@
 #define QUDA_CPS_WILSON_GAUGE_ORDER 7 //expect *gauge even-odd spacetime column-row color
 #define QUDA_MILC_GAUGE_ORDER 8 //expect *gauge even-odd mu spacetime row-column order
 #define QUDA_BQCD_GAUGE_ORDER 9 //expect *gauge mu even-odd spacetime row-column order
+#define QUDA_AOSOA4_GAUGE_ORDER 10 //expect *gauge even-odd mu spacetime/4 row-column order spacetime%4
+#define QUDA_AOSOA8_GAUGE_ORDER 11 //expect *gauge even-odd mu spacetime/8 row-column order spacetime%8
+#define QUDA_AOSOA16_GAUGE_ORDER 12 //expect *gauge even-odd mu spacetime/16 row-column order spacetime%16
 #define QUDA_INVALID_GAUGE_ORDER QUDA_INVALID_ENUM
 
 #define QudaTboundary integer(4)
@@ -49,6 +52,19 @@
 #define QUDA_DOUBLE_PRECISION 8
 #define QUDA_INVALID_PRECISION QUDA_INVALID_ENUM
 
+#define QudaStorageType integer(4)
+#define QUDA_DOUBLE_STORAGE 0
+#define QUDA_SINGLE_STORAGE 1
+#define QUDA_HALF_STORAGE 2
+#define QUDA_BFLOAT16_STORAGE 3
+#define QUDA_INVALID_STORAGE QUDA_INVALID_ENUM
+
+#define QudaStencilOrder integer(4)
+#define QUDA_LEXICOGRAPHIC_STENCIL_ORDER 0
+#define QUDA_MORTON_STENCIL_ORDER 1
+#define QUDA_HILBERT_STENCIL_ORDER 2
+#define QUDA_INVALID_STENCIL_ORDER QUDA_INVALID_ENUM
+
 #define QudaReconstructType integer(4)
 #define QUDA_RECONSTRUCT_NO 18 // store all 18 real numbers explicitly
 #define QUDA_RECONSTRUCT_12 12 // reconstruct from 12 real numbers
@@ -156,6 +172,9 @@
 #define QUDA_PACKED_CLOVER_ORDER 5    // even-odd packed
 #define QUDA_QDPJIT_CLOVER_ORDER 6 // lexicographical order packed
 #define QUDA_BQCD_CLOVER_ORDER 7 // BQCD order which is a packed super-diagonal form
+#define QUDA_AOSOA4_CLOVER_ORDER 8 // even-odd spacetime/4 internal order spacetime%4
+#define QUDA_AOSOA8_CLOVER_ORDER 9 // even-odd spacetime/8 internal order spacetime%8
+#define QUDA_AOSOA16_CLOVER_ORDER 10 // even-odd spacetime/16 internal order spacetime%16
 #define QUDA_INVALID_CLOVER_ORDER QUDA_INVALID_ENUM
 
 #define QudaVerbosity integer(4)
@@ -225,6 +244,9 @@
 #define QUDA_SPACE_COLOR_SPIN_FIELD_ORDER 6 // QLA ordering (spin inside color)
 #define QUDA_QDPJIT_FIELD_ORDER 7 // QDP field ordering (complex-color-spin-spacetime)
 #define QUDA_QOP_DOMAIN_WALL_FIELD_ORDER 8 // QOP domain-wall ordering
+#define QUDA_AOSOA4_FIELD_ORDER 9 // space/4-spin-color-complex-space%4 (host vector ordering)
+#define QUDA_AOSOA8_FIELD_ORDER 10 // space/8-spin-color-complex-space%8 (host vector ordering)
+#define QUDA_AOSOA16_FIELD_ORDER 11 // space/16-spin-color-complex-space%16 (host vector ordering)
 #define QUDA_INVALID_FIELD_ORDER QUDA_INVALID_ENUM
   
 #define QudaFieldCreate integer(4)
@@ -276,8 +298,15 @@
 #define QudaComputeFatMethod integer(4)
 #define QUDA_COMPUTE_FAT_STANDARD 0
 #define QUDA_COMPUTE_FAT_EXTENDED_VOLUME 1
+#define QUDA_COMPUTE_FAT_HOST 2
 #define QUDA_COMPUTE_FAT_INVALID QUDA_INVALID_ENUM
 
+#define QudaGaugeSmearType integer(4)
+#define QUDA_GAUGE_SMEAR_APE 0
+#define QUDA_GAUGE_SMEAR_STOUT 1
+#define QUDA_GAUGE_SMEAR_HYP 2
+#define QUDA_GAUGE_SMEAR_INVALID QUDA_INVALID_ENUM
+
 #define QudaFatLinkFlag integer(4)
 #define QUDA_FAT_PRESERVE_CPU_GAUGE 1
 #define QUDA_FAT_PRESERVE_GPU_GAUGE 2
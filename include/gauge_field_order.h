@@ -54,6 +54,7 @@ namespace quda {
     struct Reconstruct {
       typedef typename mapper<Float>::type RegType;
       Reconstruct(const GaugeField &u) { ; }
+      Reconstruct(const int *X, RegType anisotropy, QudaTboundary tBoundary) { ; }
 
       __device__ __host__ inline void Pack(RegType out[N], const RegType in[N], int idx ) const {
         for (int i=0; i<N; i++) out[i] = in[i];
@@ -98,6 +99,11 @@ namespace quda {
       Reconstruct(const GaugeField &u) : anisotropy(u.Anisotropy()), tBoundary(u.TBoundary())
       {	for (int i=0; i<QUDA_MAX_DIM; i++) X[i] = u.X()[i]; }
 
+      /** Used by the host operators, which keep their own copy of the links */
+      Reconstruct(const int *X_, RegType anisotropy, QudaTboundary tBoundary)
+	: anisotropy(anisotropy), tBoundary(tBoundary)
+      {	for (int i=0; i<QUDA_MAX_DIM; i++) X[i] = (i < 4) ? X_[i] : 1; }
+
       __device__ __host__ inline void Pack(RegType out[12], const RegType in[18], int idx) const {
         for (int i=0; i<12; i++) out[i] = in[i];
       }
@@ -185,6 +191,10 @@ namespace quda {
       Reconstruct(const GaugeField &u) : anisotropy(u.Anisotropy()), tBoundary(u.TBoundary()) 
       {	for (int i=0; i<QUDA_MAX_DIM; i++) X[i] = u.X()[i]; }
 
+      Reconstruct(const int *X_, RegType anisotropy, QudaTboundary tBoundary)
+	: anisotropy(anisotropy), tBoundary(tBoundary)
+      {	for (int i=0; i<QUDA_MAX_DIM; i++) X[i] = (i < 4) ? X_[i] : 1; }
+
       __device__ __host__ inline void Pack(RegType out[8], const RegType in[18], int idx) const {
         out[0] = Trig<isHalf<Float>::value>::Atan2(in[1], in[0]);
         out[1] = Trig<isHalf<Float>::value>::Atan2(in[13], in[12]);
@@ -665,5 +675,33 @@ template <typename Float, int length> struct BQCDOrder : LegacyOrder<Float,lengt
   size_t Bytes() const { return Nc * Nc * 2 * sizeof(Float); }
 };
 
+/**
+  struct to define host vector (AoSoA) ordered gauge fields:
+  [parity][dim][volumecb/W][row][col][volumecb%W]
+  */
+template <typename Float, int length, int W> struct AoSoAOrder : public LegacyOrder<Float,length> {
+  typedef typename mapper<Float>::type RegType;
+  Float *gauge;
+  const int volumeCB;
+  AoSoAOrder(const GaugeField &u, Float *gauge_=0, Float **ghost_=0) :
+    LegacyOrder<Float,length>(u, ghost_), gauge(gauge_ ? gauge_ : (Float*)u.Gauge_p()), volumeCB(u.VolumeCB())
+    { if (volumeCB % W) errorQuda("Volume %d must be a multiple of the block width %d", volumeCB, W); }
+  AoSoAOrder(const AoSoAOrder &order) : LegacyOrder<Float,length>(order), gauge(order.gauge), volumeCB(order.volumeCB)
+  { ; }
+  virtual ~AoSoAOrder() { ; }
+
+  __device__ __host__ inline void load(RegType v[length], int x, int dir, int parity) const {
+    const Float *block = gauge + (((parity*4 + dir)*(volumeCB/W) + x/W)*length)*W + x%W;
+    for (int i=0; i<length; i++) v[i] = (RegType)block[i*W];
+  }
+
+  __device__ __host__ inline void save(const RegType v[length], int x, int dir, int parity) {
+    Float *block = gauge + (((parity*4 + dir)*(volumeCB/W) + x/W)*length)*W + x%W;
+    for (int i=0; i<length; i++) block[i*W] = (Float)v[i];
+  }
+
+  size_t Bytes() const { return length * sizeof(Float); }
+};
+
 }
 
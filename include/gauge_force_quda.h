@@ -14,6 +14,16 @@ namespace quda {
 			QudaGaugeParam* param, int*** input_path, int* length,
 			void* path_coeff, int num_paths, int max_length);
 
+  /**
+     Compute the gauge force on the host threads.  The site links are
+     either on the local lattice or extended by two sites in every
+     direction with the border already filled, in QDP or MILC order;
+     the momentum is in MILC order and the path coefficients are in
+     the precision of the fields.
+  */
+  void gaugeForceCpu(cpuGaugeField &mom, double eb3, cpuGaugeField &sitelink, int ***input_path,
+		     const int *length, const void *path_coeff, int num_paths);
+
 } // namespace quda
 
 
@@ -0,0 +1,26 @@
+#ifndef _GAUGE_IO_H
+#define _GAUGE_IO_H
+
+#include <enum_quda.h>
+
+namespace quda {
+
+  /**
+     Read a gauge configuration in NERSC, MILC or ILDG (LIME) format
+     into a host gauge field.  The format is detected from the file.
+     Every rank memory-maps the file and reads its own sub-volume,
+     given by the local dimensions X and its grid coordinates, so the
+     comms must have been initialized.  The checksums stored in the
+     file are verified and a mismatch is fatal.
+     @param gauge The host gauge field (QDP or MILC order)
+     @param filename The configuration file
+     @param order The order of the host field
+     @param precision The precision of the host field
+     @param X The local lattice dimensions
+  */
+  void readGaugeFile(void *gauge, const char *filename, QudaGaugeFieldOrder order,
+		     QudaPrecision precision, const int *X);
+
+} // namespace quda
+
+#endif // _GAUGE_IO_H
@@ -0,0 +1,34 @@
+#ifndef _GAUGE_OBSERVABLES_H
+#define _GAUGE_OBSERVABLES_H
+
+#include <quda.h>
+#include <gauge_field.h>
+
+namespace quda {
+
+  /**
+     Compute the plaquette, rectangle, Polyakov loop and link trace
+     averages and the NERSC and SciDAC checksums of a host gauge field
+     on the host threads.  The links needed from the neighboring
+     processes are exchanged, so this is collective.  The checksums
+     are of the links as stored, in the precision of the field: the
+     NERSC checksum is the sum of the 32-bit words of the 3x3 links,
+     the SciDAC checksum that of the big-endian [dim][row][col] site
+     records in global lexicographic order.
+     @param obs The observables
+     @param gauge The host gauge field (QDP or MILC order)
+     @param order The order of the host field
+     @param precision The precision of the host field
+     @param X The local lattice dimensions
+   */
+  void gaugeObservablesCpu(QudaGaugeObservables &obs, const void *gauge, QudaGaugeFieldOrder order,
+			   QudaPrecision precision, const int *X);
+
+  /**
+     As above, for a cpuGaugeField without reconstruction.
+   */
+  void gaugeObservablesCpu(QudaGaugeObservables &obs, const cpuGaugeField &u);
+
+} // namespace quda
+
+#endif // _GAUGE_OBSERVABLES_H
@@ -0,0 +1,35 @@
+#ifndef _GAUGE_SMEAR_H
+#define _GAUGE_SMEAR_H
+
+#include <quda.h>
+#include <gauge_field.h>
+
+namespace quda {
+
+  /**
+     Smear a host gauge field in place on the host threads.  The links
+     needed from the neighboring processes are exchanged before every
+     level, so this is collective.  The work buffers are allocated once
+     and reused for all the steps.
+     @param gauge The host gauge field (QDP or MILC order)
+     @param order The order of the host field
+     @param precision The precision of the host field
+     @param X The local lattice dimensions
+     @param type The smearing (APE, stout or HYP)
+     @param coeff The smearing parameters: alpha for APE, rho for stout,
+     alpha1, alpha2, alpha3 for HYP
+     @param nSteps The number of smearing steps
+     @param spatial Whether only the spatial links are smeared, with
+     spatial staples (not supported for HYP)
+   */
+  void smearGaugeCpu(void *gauge, QudaGaugeFieldOrder order, QudaPrecision precision, const int *X,
+		     QudaGaugeSmearType type, const double *coeff, int nSteps, bool spatial);
+
+  /**
+     As above, for a cpuGaugeField without reconstruction.
+   */
+  void smearGaugeCpu(cpuGaugeField &u, QudaGaugeSmearType type, const double *coeff, int nSteps, bool spatial);
+
+} // namespace quda
+
+#endif // _GAUGE_SMEAR_H
@@ -45,7 +45,47 @@ namespace quda {
   void unitarizeForceCPU( const QudaGaugeParam &param,
 			    cpuGaugeField &cpuOldForce,
                             cpuGaugeField &cpuGauge,
-                            cpuGaugeField *cpuNewForce);
+                            cpuGaugeField *cpuNewForce,
+			    int* unitarization_failed=0);
+
+  /**
+     Host HISQ force.  The following mirror hisqStaplesForceCuda,
+     hisqLongLinkForceCuda and hisqCompleteForceCuda.  The link and
+     outer-product fields are either on the local lattice param.X,
+     which requires a single process, or extended by two sites in
+     every direction with the border filled.
+   */
+  void hisqStaplesForceCpu(const double path_coeff[6],
+			   const QudaGaugeParam &param,
+			   cpuGaugeField &oprod,
+			   cpuGaugeField &link,
+			   cpuGaugeField *newOprod);
+
+  void hisqLongLinkForceCpu(double coeff,
+			    const QudaGaugeParam &param,
+			    cpuGaugeField &oprod,
+			    cpuGaugeField &link,
+			    cpuGaugeField *newOprod);
+
+  void hisqCompleteForceCpu(const QudaGaugeParam &param,
+			    cpuGaugeField &oprod,
+			    cpuGaugeField &link,
+			    cpuGaugeField *mom);
+
+  /**
+     Link-ordered outer products of the quark fields of all the
+     shifts, summed with the given coefficients in a single pass:
+     oprod_mu(x) = sum_k coeff[k] X_k(x+mu) X_k(x)^dagger, and the same
+     with x+3mu in longOprod (for the Naik term) if it is given.  The
+     quark fields are full-lattice colour vectors (6 reals per site) in
+     param.cpu_prec, in the even-odd order of the host gauge fields.
+   */
+  void hisqOuterProductCpu(const void *const *quark,
+			   const double *coeff,
+			   int num_terms,
+			   const QudaGaugeParam &param,
+			   cpuGaugeField &oprod,
+			   cpuGaugeField *longOprod);
 
 
  } // namespace fermion_force
@@ -43,9 +43,32 @@ void unitarizeLinksCuda(const QudaGaugeParam& param,
 			cudaGaugeField* outfield, 
 			int* num_failures);
 
-void unitarizeLinksCPU(const QudaGaugeParam& param,
-		       cpuGaugeField& infield,
-		       cpuGaugeField* outfield);
+/**
+   Statistics accumulated by unitarizeLinksCPU: the number of links
+   unitarized analytically, the number that fell back to SVD, the
+   number that failed (could not be unitarized, or failed the
+   unitarity check), and the largest deviation of U^dagger U from the
+   identity found by the check.
+ */
+struct UnitarizeLinksStats {
+  long long analytic;
+  long long svd;
+  long long failures;
+  double max_error;
+  UnitarizeLinksStats() : analytic(0), svd(0), failures(0), max_error(0.0) { }
+};
+
+/**
+   Host unitarization with the same method as unitarizeLinksCuda.
+   Returns the number of failed links; if site_failures is given it
+   is set to the number of failed links at each site (full-lattice
+   index), and if stats is given the statistics are added to it.
+ */
+int unitarizeLinksCPU(const QudaGaugeParam& param,
+		      cpuGaugeField& infield,
+		      cpuGaugeField* outfield,
+		      int* site_failures=0,
+		      UnitarizeLinksStats* stats=0);
 
 bool isUnitary(const QudaGaugeParam& param, cpuGaugeField& field, double max_error);
 
@@ -0,0 +1,101 @@
+#ifndef _HOST_ONLY_H
+#define _HOST_ONLY_H
+
+/**
+   Stand-ins for the parts of the CUDA headers that the host code
+   uses, for the host-only library (built with -DQUDA_HOST_ONLY by
+   the host compiler alone, see "make host").  The function
+   qualifiers are dropped, the vector types are plain structs, and
+   every runtime call that needs a device fails with
+   cudaErrorNoDevice, so that anything reaching for the device stops
+   with the usual error message rather than at link time.  Host
+   memory is never page-locked, so registering it trivially succeeds.
+ */
+
+#include <stddef.h>
+#include <math.h>
+
+#define CUDA_VERSION 0
+
+#define __host__
+#define __device__
+#define __global__
+#define __shared__
+#define __constant__
+#define __forceinline__ inline
+
+typedef enum cudaError {
+  cudaSuccess = 0,
+  cudaErrorNoDevice = 38
+} cudaError_t;
+
+typedef enum cudaMemcpyKind {
+  cudaMemcpyHostToHost = 0,
+  cudaMemcpyHostToDevice = 1,
+  cudaMemcpyDeviceToHost = 2,
+  cudaMemcpyDeviceToDevice = 3
+} cudaMemcpyKind;
+
+#define cudaHostRegisterDefault 0
+#define cudaHostRegisterMapped 2
+
+typedef struct CUstream_st *cudaStream_t;
+typedef struct CUevent_st *cudaEvent_t;
+
+#define QUDA_HOST_VECTOR(T, B)						\
+  struct T##2 { B x, y; };						\
+  struct T##3 { B x, y, z; };						\
+  struct T##4 { B x, y, z, w; };					\
+  static inline T##2 make_##T##2(B x, B y) { T##2 r = { x, y }; return r; } \
+  static inline T##3 make_##T##3(B x, B y, B z) { T##3 r = { x, y, z }; return r; } \
+  static inline T##4 make_##T##4(B x, B y, B z, B w) { T##4 r = { x, y, z, w }; return r; }
+
+QUDA_HOST_VECTOR(double, double)
+QUDA_HOST_VECTOR(float, float)
+QUDA_HOST_VECTOR(int, int)
+QUDA_HOST_VECTOR(short, short)
+QUDA_HOST_VECTOR(char, char)
+
+#undef QUDA_HOST_VECTOR
+
+struct cudaDeviceProp {
+  char name[256];
+  int major, minor;
+  int canMapHostMemory;
+  size_t sharedMemPerBlock;
+  int warpSize;
+  int maxThreadsDim[3];
+  int maxGridSize[3];
+};
+
+struct dim3 {
+  unsigned int x, y, z;
+  dim3(unsigned int x=1, unsigned int y=1, unsigned int z=1) : x(x), y(y), z(z) { }
+};
+
+static inline const char* cudaGetErrorString(cudaError_t error)
+{
+  return error == cudaSuccess ? "no error" : "no CUDA device in a host-only build";
+}
+
+static inline cudaError_t cudaGetLastError() { return cudaSuccess; }
+static inline cudaError_t cudaDeviceSynchronize() { return cudaSuccess; }
+
+static inline cudaError_t cudaMalloc(void **ptr, size_t) { *ptr = 0; return cudaErrorNoDevice; }
+static inline cudaError_t cudaFree(void *) { return cudaErrorNoDevice; }
+static inline cudaError_t cudaMemcpy(void *, const void *, size_t, cudaMemcpyKind) { return cudaErrorNoDevice; }
+static inline cudaError_t cudaHostRegister(void *, size_t, unsigned int flags)
+{
+  return flags == cudaHostRegisterDefault ? cudaSuccess : cudaErrorNoDevice;
+}
+static inline cudaError_t cudaHostUnregister(void *) { return cudaSuccess; }
+static inline cudaError_t cudaHostGetDevicePointer(void **ptr, void *, unsigned int)
+{
+  *ptr = 0;
+  return cudaErrorNoDevice;
+}
+
+// the single-precision overload of the CUDA math library
+static inline void sincos(float x, float *s, float *c) { *s = sinf(x); *c = cosf(x); }
+
+#endif // _HOST_ONLY_H
@@ -5,6 +5,7 @@
 #include <quda_internal.h>
 #include <dirac_quda.h>
 #include <color_spinor_field.h>
+#include <vector>
 
 namespace quda {
 
@@ -39,6 +40,10 @@ namespace quda {
     /**< Reliable update tolerance */
     double delta;           
 
+    /**< Residual drift tolerated at a reliable update before the
+       adaptive CG raises delta or promotes the sloppy precision (0 = off) */
+    double drift;
+
     /**< Solver tolerance in the L2 residual norm */
     double tol;             
 
@@ -114,6 +119,12 @@ namespace quda {
     /** Whether to use additive or multiplicative Schwarz preconditioning */
     QudaSchwarzType schwarz_type;
 
+    /** Where the Schwarz preconditioner is applied (host or device) */
+    QudaFieldLocation schwarz_location;
+
+    /** Number of iterations between checkpoints of the solver state (0 = none) */
+    int checkpoint_interval;
+
     /**< The time taken by the solver */
     double secs;
 
@@ -128,7 +139,7 @@ namespace quda {
     SolverParam(QudaInvertParam &param) : inv_type(param.inv_type), 
       inv_type_precondition(param.inv_type_precondition), 
       residual_type(param.residual_type), use_init_guess(param.use_init_guess),
-      delta(param.reliable_delta), tol(param.tol), tol_hq(param.tol_hq), 
+      delta(param.reliable_delta), drift(param.reliable_drift), tol(param.tol), tol_hq(param.tol_hq), 
       true_res(param.true_res), true_res_hq(param.true_res_hq),
       maxiter(param.maxiter), iter(param.iter), 
       precision(param.cuda_prec), precision_sloppy(param.cuda_prec_sloppy), 
@@ -136,7 +147,8 @@ namespace quda {
       preserve_source(param.preserve_source), num_offset(param.num_offset), 
       Nkrylov(param.gcrNkrylov), precondition_cycle(param.precondition_cycle), 
       tol_precondition(param.tol_precondition), maxiter_precondition(param.maxiter_precondition), 
-      omega(param.omega), schwarz_type(param.schwarz_type), secs(param.secs), gflops(param.gflops)
+      omega(param.omega), schwarz_type(param.schwarz_type), schwarz_location(param.schwarz_location),
+      checkpoint_interval(param.checkpoint_interval), secs(param.secs), gflops(param.gflops)
     { 
       for (int i=0; i<num_offset; i++) {
 	offset[i] = param.offset[i];
@@ -198,14 +210,85 @@ namespace quda {
 
   };
 
+  /**
+     Set the path prefix of the solver checkpoint files (default
+     "quda_checkpoint").  Each process appends the solver, a key
+     identifying the solve and its rank.
+   */
+  void setCheckpointPath(const char *path);
+
+  /**
+     Checkpoint of the state of a solver.  The iteration count, a list
+     of scalar recurrences and a list of fields (copied bitwise in
+     their device layout) are written every
+     SolverParam::checkpoint_interval iterations to a file local to
+     each process, replacing the previous checkpoint atomically.  A
+     checkpoint is keyed on the solver, the source norm, the initial
+     residual and the shifts, so that a rerun of the same job picks it
+     up for the same solve and resumes from it.  Loading is
+     collective: a solve is only resumed if every process holds a
+     valid checkpoint of the same iteration.
+   */
+  class SolverCheckpoint {
+
+  private:
+    const SolverParam &param;
+    const char *solver;
+    unsigned long long key; // identifies the solve
+    char filename[512];
+    int last; // iteration of the last checkpoint written or loaded
+    std::vector<char> data; // contents of the loaded checkpoint
+    std::vector<size_t> fieldOffset; // offset of each field in data
+
+  public:
+    /**
+       @param param The solver parameters (checkpoint_interval, shifts)
+       @param solver Name of the solver, which is part of the key
+       @param b2 Norm squared of the source
+       @param r2 Norm squared of the initial residual
+     */
+    SolverCheckpoint(const SolverParam &param, const char *solver, double b2, double r2);
+
+    bool Enabled() const { return param.checkpoint_interval > 0; }
+
+    /** Whether a checkpoint should be written at iteration k */
+    bool Due(int k) const { return Enabled() && k - last >= param.checkpoint_interval; }
+
+    /** Write the state at iteration k */
+    void Save(int k, const double *scalar, int nScalar, cudaColorSpinorField *const *field, int nField);
+
+    /**
+       Load the checkpoint of this solve, if every process has one.
+       @param k Set to the iteration of the checkpoint
+       @param scalar Set to the stored scalars
+       @return Whether the solve is to be resumed; the fields are then
+       restored with Restore
+     */
+    bool Load(int &k, double *scalar, int nScalar, int nField);
+
+    /** Copy the i-th stored field into field, which must match it */
+    void Restore(cudaColorSpinorField &field, int i) const;
+
+    /**
+       Remove the checkpoint once the solve has completed.  A solve
+       cut off at param.maxiter keeps it, so that a rerun with a larger
+       maxiter resumes from it.
+       @param k The iteration the solve finished at
+     */
+    void Remove(int k);
+  };
+
   class CG : public Solver {
 
   private:
     const DiracMatrix &mat;
     const DiracMatrix &matSloppy;
+    const DiracMatrix &matPrecon; // intermediate precision for the adaptive mode
 
   public:
     CG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    CG(DiracMatrix &mat, DiracMatrix &matSloppy, DiracMatrix &matPrecon, SolverParam &param,
+       TimeProfile &profile);
     virtual ~CG();
 
     void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
@@ -248,6 +331,34 @@ namespace quda {
     void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
   };
 
+  class SchwarzBlocks;
+
+  /**
+     Restricted additive or multiplicative Schwarz preconditioner
+     applied on the host.  The local volume is split into blocks that
+     are solved independently (in parallel over threads) with
+     block-local MR and Dirichlet boundary conditions, so no
+     communication is performed.  Only the Wilson operator, with or
+     without even-odd preconditioning, is supported.
+   */
+  class SchwarzCpu : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    SchwarzBlocks *blocks;
+    cpuColorSpinorField *hIn;
+    cpuColorSpinorField *hOut;
+    void *hInBuffer;
+    void *hOutBuffer;
+    bool init;
+
+  public:
+    SchwarzCpu(DiracMatrix &mat, SolverParam &param, TimeProfile &profile);
+    virtual ~SchwarzCpu();
+
+    void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+  };
+
   class MR : public Solver {
 
   private:
@@ -305,6 +416,51 @@ namespace quda {
     void operator()(cudaColorSpinorField **out, cudaColorSpinorField &in);
   };
 
+  /**
+     Host multi-shift CG solving (M^dag M + offset[i]) x[i] = b with the
+     host Wilson operator.  Converged shifts are retired by compacting
+     the active shift list, their search vectors are released
+     immediately, and the x and p updates of all active shifts are
+     fused into a single pass over memory.  The solutions are written
+     directly into the supplied (host) fields.
+   */
+  class MultiShiftCGCpu {
+
+  protected:
+    const DiracWilsonCpu &dirac;
+    SolverParam &param;
+    TimeProfile &profile;
+
+  public:
+    MultiShiftCGCpu(const DiracWilsonCpu &dirac, SolverParam &param, TimeProfile &profile);
+    virtual ~MultiShiftCGCpu();
+
+    void operator()(cpuColorSpinorField **out, cpuColorSpinorField &in);
+  };
+
+  /**
+     Mixed-precision CG run on the host threads.  An outer defect
+     correction loop in the precision of mat recomputes the true
+     residual and restarts an inner CG on matSloppy, whose vectors
+     are kept in the (possibly compressed) storage format of
+     matSloppy.  Each inner solve reduces the residual by param.delta.
+   */
+  class CGCpu {
+
+  protected:
+    const DiracWilsonCpu &mat;
+    const DiracWilsonCpu &matSloppy;
+    SolverParam &param;
+    TimeProfile &profile;
+
+  public:
+    CGCpu(const DiracWilsonCpu &mat, const DiracWilsonCpu &matSloppy, SolverParam &param,
+	  TimeProfile &profile);
+    virtual ~CGCpu();
+
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
+  };
+
   /**
      This computes the optimum guess for the system Ax=b in the L2
      residual norm.  For use in the HMD force calculations using a
@@ -335,6 +491,50 @@ namespace quda {
 		    cudaColorSpinorField **q, int N);
   };
 
+  /**
+     Ring buffer of previous solutions that persists between solves,
+     used to forecast the initial guess with MinResExt.  The library
+     keeps one instance per solve channel.
+   */
+  class ChronoHistory {
+
+  private:
+    cudaColorSpinorField *v[QUDA_MAX_CHRONO];
+    int head; // the slot that will be overwritten next
+    int size; // the number of valid solutions
+    int max;  // the capacity of the buffer
+
+  public:
+    ChronoHistory();
+    virtual ~ChronoHistory();
+
+    /** Discard all stored solutions */
+    void flush();
+
+    int Size() const { return size; }
+
+    /**
+       Build the minimal residual initial guess from the stored
+       solutions.  The history itself is not modified.
+       @param x The initial guess (output)
+       @param b The source vector (preserved)
+       @param mat The Hermitian operator of the system being solved
+       @param profile The profile to which the forecast is charged
+    */
+    void forecast(cudaColorSpinorField &x, const cudaColorSpinorField &b,
+		  DiracMatrix &mat, TimeProfile &profile);
+
+    /**
+       Add a solution to the history, overwriting the oldest one once
+       the buffer is full.  The history is flushed if the capacity,
+       precision or geometry changes.
+       @param x The solution vector
+       @param max_dim The capacity of the buffer
+       @param precision The precision in which the solution is stored
+    */
+    void push(const cudaColorSpinorField &x, int max_dim, QudaPrecision precision);
+  };
+
 } // namespace quda
 
 #endif // _INVERT_QUDA_H
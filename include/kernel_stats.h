@@ -0,0 +1,80 @@
+#ifndef _KERNEL_STATS_H
+#define _KERNEL_STATS_H
+
+#include <vector>
+#include <utility>
+
+#include <perf_counters.h>
+
+/**
+   Cumulative statistics of the kernels of a run, keyed by the
+   TuneKey of the kernel: the device kernels are recorded by
+   tuneLaunch() and the host kernels by their QUDA_PERF_SCOPE (with
+   the aux string "host").  Each thread records into its own table,
+   registered on its first record, so recording takes no lock; the
+   tables are merged when queried, which should be done from the
+   master thread outside of parallel regions.  The device kernels are
+   launched asynchronously, so their time is estimated from the time
+   of the launch measured by the autotuner; a launch with no such
+   estimate (tuning disabled) is counted as untimed and adds no time.
+ */
+
+namespace quda {
+
+  class TuneKey;
+
+  struct KernelStats {
+    long long calls;
+    long long untimed; // calls with no time estimate
+    double secs;
+    long long flops;
+    long long bytes;
+    PerfCount count; // hardware counters of the host kernels (PERF_COUNTERS)
+
+  KernelStats() : calls(0), untimed(0), secs(0.0), flops(0), bytes(0) { }
+
+    KernelStats& operator+=(const KernelStats &a) {
+      calls += a.calls;
+      untimed += a.untimed;
+      secs += a.secs;
+      flops += a.flops;
+      bytes += a.bytes;
+      count += a.count;
+      return *this;
+    }
+  };
+
+  /**
+     Record a call of a kernel in the table of the calling thread
+     @param key The kernel
+     @param stats The calls, time, flops, bytes and counts to add
+   */
+  void kernelStatsRecord(const TuneKey &key, const KernelStats &stats);
+
+  /**
+     The statistics of a kernel, summed over the threads
+     @param key The kernel
+     @param stats The statistics (zero if the kernel was not called)
+     @return Whether the kernel was called
+   */
+  bool kernelStatsQuery(const TuneKey &key, KernelStats &stats);
+
+  /**
+     The kernels taking the most time, summed over the threads
+     @param top The kernels and their statistics, by decreasing time
+     @param n The number of kernels wanted (all if n <= 0)
+   */
+  void kernelStatsTop(std::vector<std::pair<TuneKey, KernelStats> > &top, int n);
+
+  /**
+     Print the kernels taking the most time
+     @param n The number of kernels printed (all if n <= 0)
+   */
+  void kernelStatsPrint(int n);
+
+  /** Clear the statistics of all the threads */
+  void kernelStatsReset();
+
+} // namespace quda
+
+#endif // _KERNEL_STATS_H
@@ -48,6 +48,41 @@ namespace quda {
 
   std::ostream& operator<<(std::ostream& output, const LatticeFieldParam& param);
 
+  /**
+     The number of sites per block of the host array-of-structure-of-
+     arrays orders, or 0 for any other order.  Within a block every
+     real is stored for all the sites of the block before the next, so
+     that a host kernel fills a vector register with the block by a
+     single unit-stride load (see lib/cpu_simd.h).  The checkerboarded
+     volume must be a multiple of the width.
+   */
+  inline int aosoaWidth(QudaFieldOrder order) {
+    switch (order) {
+    case QUDA_AOSOA4_FIELD_ORDER: return 4;
+    case QUDA_AOSOA8_FIELD_ORDER: return 8;
+    case QUDA_AOSOA16_FIELD_ORDER: return 16;
+    default: return 0;
+    }
+  }
+
+  inline int aosoaWidth(QudaGaugeFieldOrder order) {
+    switch (order) {
+    case QUDA_AOSOA4_GAUGE_ORDER: return 4;
+    case QUDA_AOSOA8_GAUGE_ORDER: return 8;
+    case QUDA_AOSOA16_GAUGE_ORDER: return 16;
+    default: return 0;
+    }
+  }
+
+  inline int aosoaWidth(QudaCloverFieldOrder order) {
+    switch (order) {
+    case QUDA_AOSOA4_CLOVER_ORDER: return 4;
+    case QUDA_AOSOA8_CLOVER_ORDER: return 8;
+    case QUDA_AOSOA16_CLOVER_ORDER: return 16;
+    default: return 0;
+    }
+  }
+
   class LatticeField {
 
   protected:
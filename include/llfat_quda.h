@@ -94,6 +94,15 @@ namespace quda {
 			  QudaGaugeParam* qudaGaugeParam, QudaComputeFatMethod method,
 			  cudaGaugeField* cudaFatLink, cudaGaugeField* cudaLongLink, 
                           TimeProfile& profile);
+
+  /**
+     Compute the fat links (and the long links if longlink is set) on
+     the host threads.  The site links must be extended by two sites
+     in every direction, with the border already filled, and be in
+     QDP or MILC order; the fat and long links are in MILC order.
+  */
+  void llfatCpu(cpuGaugeField &fatlink, cpuGaugeField *longlink, cpuGaugeField &sitelink,
+		const double *act_path_coeff);
   
 } // namespace quda
 
@@ -0,0 +1,88 @@
+#ifndef _PERF_COUNTERS_H
+#define _PERF_COUNTERS_H
+
+/**
+   Hardware performance counters of the host threads, read through
+   the Linux perf_event_open interface.  With --enable-perf-counters
+   (which defines PERF_COUNTERS) every Timer of a TimeProfile also
+   accumulates the counts of its regions, and the host kernels
+   marked with QUDA_PERF_SCOPE add their counts to the kernel
+   statistics (kernel_stats.h); both are reported by endQuda.  The counters are opened on first
+   use in each thread and summed over the OpenMP threads, user space
+   only.  The memory traffic is estimated from the last-level cache
+   misses, one 64-byte line each: the memory controller counters need
+   system-wide access, which unprivileged processes do not have.
+   Reading the counters costs a system call per thread, so regions
+   should not be much shorter than a few microseconds.
+ */
+
+namespace quda {
+
+  enum PerfEventType {
+    PERF_CYCLES,           /**< core cycles */
+    PERF_INSTRUCTIONS,     /**< retired instructions */
+    PERF_LLC_READ_MISSES,  /**< last-level cache read misses */
+    PERF_LLC_WRITE_MISSES, /**< last-level cache write misses */
+    PERF_EVENT_COUNT
+  };
+
+  struct PerfCount {
+    unsigned long long count[PERF_EVENT_COUNT];
+
+    PerfCount() { for (int i=0; i<PERF_EVENT_COUNT; i++) count[i] = 0; }
+
+    PerfCount& operator+=(const PerfCount &a) {
+      for (int i=0; i<PERF_EVENT_COUNT; i++) count[i] += a.count[i];
+      return *this;
+    }
+
+    PerfCount& operator-=(const PerfCount &a) {
+      for (int i=0; i<PERF_EVENT_COUNT; i++) count[i] -= a.count[i];
+      return *this;
+    }
+  };
+
+  /**
+     Read the counters, summed over the host threads (only the calling
+     thread when called inside a parallel region).
+     @param c The counts
+     @return Whether the counters are available
+   */
+  bool perfCountersRead(PerfCount &c);
+
+  /**
+     Print the counts of a region, with the derived instructions per
+     cycle and estimated memory bandwidth
+     @param c The counts
+     @param secs The time spent in the region
+   */
+  void perfCountersPrint(const PerfCount &c, double secs);
+
+  /**
+     Records a host kernel call from its construction to its
+     destruction in the kernel statistics: the time, the flops and
+     bytes set by the kernel and, with PERF_COUNTERS, the counts.
+     Only the outermost scope of a thread records, so a kernel built
+     from other kernels is counted once, as a whole, and the times of
+     the kernels add up to the time spent in them.
+   */
+  class PerfScope {
+    const char *name;
+    bool outer; // not nested in another scope of this thread
+    bool counters;
+    double start;
+    PerfCount startCount;
+
+  public:
+    long long flops;
+    long long bytes;
+
+    PerfScope(const char *name);
+    ~PerfScope();
+  };
+
+} // namespace quda
+
+#define QUDA_PERF_SCOPE(name) quda::PerfScope perf_scope_(name)
+
+#endif // _PERF_COUNTERS_H
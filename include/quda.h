@@ -38,6 +38,13 @@
  */
 #define QUDA_MAX_MULTI_SHIFT 32
 
+/**
+ * @def QUDA_MAX_CHRONO
+ * @brief Maximum number of previous solutions that are kept for
+ *        chronological forecasting of the initial guess.
+ */
+#define QUDA_MAX_CHRONO 16
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -85,6 +92,8 @@ extern "C" {
     double gaugeGiB;  /**< The storage used by the gauge fields */
 
     int preserve_gauge; /**< Used by link fattening */
+
+    QudaFieldLocation force_location; /**< Where the gauge force is computed */
     
   } QudaGaugeParam;
 
@@ -118,6 +127,16 @@ extern "C" {
     int maxiter; /**< Maximum number of iterations in the linear solver */
     double reliable_delta; /**< Reliable update tolerance */
 
+    /**
+     * Adaptive reliable updates in CG: the largest relative gap
+     * |r_true - r_iterated| / |r_true| tolerated at a reliable update.
+     * Beyond it reliable_delta is raised, and once reliable updates
+     * are as frequent as allowed the sloppy precision is promoted to
+     * cuda_prec_precondition (if it lies between cuda_prec_sloppy and
+     * cuda_prec) and then to cuda_prec.  Set to 0 to disable (default).
+     */
+    double reliable_drift;
+
     int num_offset; /**< Number of offsets in the multi-shift solver */
 
     /** Offsets for multi-shift solver */
@@ -206,6 +225,10 @@ extern "C" {
     /** Whether to use additive or multiplicative Schwarz preconditioning */
     QudaSchwarzType schwarz_type;
 
+    /** Where to apply the Schwarz preconditioner: on the device, or
+        block-wise on the host threads (Wilson MR only) */
+    QudaFieldLocation schwarz_location;
+
     /**
      * Whether to use the L2 relative residual, Fermilab heavy-quark
      * residual, or both to determine convergence.  To require that both
@@ -216,9 +239,91 @@ extern "C" {
      */
     QudaResidualType residual_type;
 
+    /**
+     * Number of previous solutions kept by the library to build the
+     * initial guess by chronological (minimal residual) extrapolation.
+     * Set to 0 to disable (default).  Only supported for
+     * normal-operator solves (NORMOP and NORMOP_PC solve types).
+     */
+    int chrono_max_dim;
+
+    /** The solve channel: solves with the same index share a history */
+    int chrono_index;
+
+    /** The precision in which the solution history is stored */
+    QudaPrecision chrono_precision;
+
+    /** Where to run the solver of invertQuda and invertMultiShiftQuda:
+        on the device, or on the host threads (Wilson CG only, host
+        input and output fields) */
+    QudaFieldLocation solver_location;
+
+    /** Storage format of the inner solver vectors in the host
+        mixed-precision solver (defaults to cuda_prec_sloppy) */
+    QudaStorageType cpu_storage_sloppy;
+
+    /** Link compression of the sloppy operator in the host
+        mixed-precision solver: QUDA_RECONSTRUCT_NO (default), or 12
+        or 8 for SU(3) gauge fields */
+    QudaReconstructType cpu_reconstruct_sloppy;
+
+    /** Whether the sloppy operator of the host mixed-precision solver
+        uses the virtual-node layout, with the local lattice split
+        into one sub-lattice per vector lane (0 = no, default;
+        requires double or single storage and no link reconstruction) */
+    int cpu_virtual_node_sloppy;
+
+    /** Order in which the host operators of the host solver visit the
+        sites of a parity: lexicographic (default), or along a Morton
+        or Hilbert curve for better reuse of the neighbors in cache.
+        The layout of the fields is unchanged; the virtual-node layout
+        keeps its own order */
+    QudaStencilOrder cpu_stencil_order;
+
+    /** Number of iterations between checkpoints of the state of the
+        CG, BiCGstab, GCR and multi-shift CG solvers, from which a
+        rerun of the same solve resumes (0 = disabled, default).  The
+        files are named after the prefix set by setCheckpointQuda.  A
+        solve cut off at maxiter keeps its checkpoint */
+    int checkpoint_interval;
+
   } QudaInvertParam;
 
 
+  /**
+   * Observables of a gauge configuration, computed by
+   * gaugeObservablesQuda().  The plaquette, rectangle and link trace
+   * are averages of Re tr / 3 (1 for the unit field).
+   */
+  typedef struct QudaGaugeObservables_s {
+    double plaquette[3];  /**< Average plaquette: all, spatial and temporal planes */
+    double rectangle[3];  /**< Average 2x1 rectangle: all, spatial and temporal */
+    double polyakov[2];   /**< Average Polyakov loop in t (real, imaginary) */
+    double link_trace;    /**< Average link trace */
+    unsigned int nersc_checksum;     /**< Sum of the 32-bit words of the links */
+    unsigned int scidac_checksum[2]; /**< SciDAC checksum (suma, sumb) */
+  } QudaGaugeObservables;
+
+
+  /**
+   * Cumulative statistics of a kernel, summed over the launches with
+   * the same tuning key and over the host threads.  The time of the
+   * device kernels is estimated from their autotuned launch time, so
+   * with tuning disabled (QUDA_TUNE_NO) their launches are untimed:
+   * they add no time and the kernels rank by the timed launches only.
+   */
+  typedef struct QudaKernelStats_s {
+    char name[128];   /**< Name of the kernel */
+    char volume[32];  /**< Volume string of the tuning key ("-" for host kernels) */
+    char aux[256];    /**< Auxiliary string of the tuning key ("host" for host kernels) */
+    long long calls;  /**< Number of launches */
+    long long untimed_calls; /**< Launches with no time estimate (not autotuned) */
+    double secs;      /**< Time spent in the kernel */
+    double gflops;    /**< Total Gflop of the launches */
+    double gbytes;    /**< Total GB moved by the launches */
+  } QudaKernelStats;
+
+
   /*
    * Interface functions, found in interface_quda.cpp
    */
@@ -251,6 +356,15 @@ extern "C" {
   void setVerbosityQuda(QudaVerbosity verbosity, const char prefix[],
 			FILE *outfile);
 
+  /**
+   * Set the path prefix of the solver checkpoint files written when
+   * QudaInvertParam::checkpoint_interval is set (default
+   * "quda_checkpoint").  Each process writes its own file.
+   *
+   * @param path  Path prefix, e.g., on node-local storage
+   */
+  void setCheckpointQuda(const char path[]);
+
   /**
    * initCommsGridQuda() takes an optional "rank_from_coords" argument that
    * should be a pointer to a user-defined function with this prototype.  
@@ -323,10 +437,34 @@ extern "C" {
   void initQuda(int device);
 
   /**
-   * Finalize the library.
+   * Finalize the library.  With verbosity QUDA_SUMMARIZE or higher
+   * the kernels taking the most time are printed, as many as the
+   * environment variable QUDA_KERNEL_STATS_TOP (20 by default, all if
+   * 0).
    */
   void endQuda(void);
 
+  /**
+   * Query the kernels taking the most time since the start of the
+   * run or the last resetKernelStatsQuda(), on this process.
+   * @param stats The statistics, by decreasing time
+   * @param n     The size of stats
+   * @return      The number of kernels returned (at most n)
+   */
+  int getKernelStatsQuda(QudaKernelStats *stats, int n);
+
+  /**
+   * Print the kernels taking the most time.
+   * @param n The number of kernels printed (all if n <= 0)
+   */
+  void printKernelStatsQuda(int n);
+
+  /**
+   * Clear the kernel statistics, e.g., after the thermalization of a
+   * Monte Carlo run.
+   */
+  void resetKernelStatsQuda(void);
+
   /**
    * A new QudaGaugeParam should always be initialized immediately
    * after it's defined (and prior to explicitly setting its members)
@@ -376,6 +514,73 @@ extern "C" {
    */
   void saveGaugeQuda(void *h_gauge, QudaGaugeParam *param);
 
+  /**
+   * Read a gauge configuration in NERSC, MILC or ILDG/SciDAC (LIME)
+   * format into a host gauge field, without QIO.  Each process
+   * memory-maps the file and reads its own sub-volume; the checksums
+   * in the file are verified.  Does not require initQuda, but the
+   * comms grid (initCommsGridQuda) must be set up for multi-process
+   * runs.
+   * @param h_gauge  Base pointer to host gauge field
+   * @param filename The configuration file
+   * @param param    Gives the local dimensions (X), the host order
+   *                 (gauge_order, QDP or MILC) and precision (cpu_prec)
+   */
+  void readGaugeFileQuda(void *h_gauge, const char *filename, QudaGaugeParam *param);
+
+  /**
+   * Compute the plaquette, rectangle, Polyakov loop, link trace and
+   * the NERSC and SciDAC checksums of a host gauge field, on the host
+   * threads, exchanging the links needed from the other processes.
+   * Does not require initQuda, but the comms grid must be set up for
+   * multi-process runs.
+   * @param obs      The observables
+   * @param h_gauge  Base pointer to host gauge field
+   * @param param    Gives the local dimensions (X), the host order
+   *                 (gauge_order, QDP or MILC) and precision (cpu_prec)
+   */
+  void gaugeObservablesQuda(QudaGaugeObservables *obs, void *h_gauge, QudaGaugeParam *param);
+
+  /**
+   * Smear a host gauge field in place, on the host threads, exchanging
+   * the links needed from the other processes.  Does not require
+   * initQuda, but the comms grid must be set up for multi-process
+   * runs.
+   * @param h_gauge  Base pointer to host gauge field
+   * @param param    Gives the local dimensions (X), the host order
+   *                 (gauge_order, QDP or MILC) and precision (cpu_prec)
+   * @param type     APE, stout or HYP smearing
+   * @param coeff    alpha (APE, with the staples weighted by
+   *                 alpha/(2(nDim-1))), rho (stout), or alpha1,
+   *                 alpha2, alpha3 (HYP)
+   * @param n_steps  The number of smearing steps
+   * @param spatial  Whether only the spatial links are smeared, using
+   *                 spatial staples (APE and stout only)
+   */
+  void smearGaugeQuda(void *h_gauge, QudaGaugeParam *param, QudaGaugeSmearType type,
+                      const double *coeff, int n_steps, int spatial);
+
+  /**
+   * Append a host solution field to a SciDAC propagator file.  The
+   * field is copied and the call returns at once; the conversion to
+   * the file layout and the writing are done by a background thread,
+   * overlapping the following solves.  At most a few fields are held
+   * in flight, beyond which the call waits.  Collective, and the
+   * writes must be issued in the same order on every process.
+   * @param filename The propagator file, created by the first write
+   *                 after a flush
+   * @param h_x      Base pointer to the host solution field
+   * @param param    Describes the host field as for invertQuda; the
+   *                 solution must be full-lattice
+   */
+  void writeSpinorQuda(const char *filename, void *h_x, QudaInvertParam *param);
+
+  /**
+   * Wait for the queued propagator writes, fill in their checksums
+   * and close the files.  Called by endQuda.
+   */
+  void flushSpinorWriterQuda(void);
+
   /**
    * Load the clover term and/or the clover inverse from the host.
    * Either h_clover or h_clovinv may be set to NULL.
@@ -402,6 +607,55 @@ extern "C" {
    */
   void invertQuda(void *h_x, void *h_b, QudaInvertParam *param);
 
+  /**
+   * Handle of an asynchronous solve, from invertQudaAsync().
+   */
+  typedef struct QudaInvertJob_s *QudaInvertHandle;
+
+  /**
+   * Queue a solve, as invertQuda(), and return without waiting for
+   * it.  The queued solves are run in order by a solver thread of the
+   * library, while the calling thread is free to do other work.
+   * The fields and param are used in place, so they must not be
+   * modified (nor the solution read) until the solve has completed.
+   * While solves are queued, the calling thread should make no other
+   * QUDA calls than invertQudaAsync(), invertQudaTest() and
+   * invertQudaWait(); the calls that use the gauge fields, the
+   * device, the chronological histories or the kernel statistics
+   * (including endQuda) wait for the queued solves first.  In
+   * multi-process runs the communications are made by the solver
+   * thread, so MPI must be initialized with at least
+   * MPI_THREAD_SERIALIZED.
+   * @param h_x    Solution spinor field
+   * @param h_b    Source spinor field
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   * @return The handle of the solve, which must be passed to
+   *         invertQudaWait() once
+   */
+  QudaInvertHandle invertQudaAsync(void *h_x, void *h_b, QudaInvertParam *param);
+
+  /**
+   * Whether a queued solve has completed, without waiting.
+   * @param handle The handle of the solve
+   * @return 1 if completed, 0 otherwise
+   */
+  int invertQudaTest(QudaInvertHandle handle);
+
+  /**
+   * Wait for a queued solve to complete, and release its handle.
+   * The solution and the outputs of param (iter, true_res, secs,
+   * gflops, ...) are then set.
+   * @param handle The handle of the solve
+   */
+  void invertQudaWait(QudaInvertHandle handle);
+
+  /**
+   * Discard the solution history used for chronological forecasting.
+   * @param index The solve channel to flush (all channels if negative)
+   */
+  void flushChronoQuda(int index);
+
   /**
    * Solve for multiple shifts (e.g., masses).
    * @param _hp_x    Array of solution spinor fields
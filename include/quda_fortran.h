@@ -129,6 +129,12 @@ extern "C" {
    */
   void invert_quda_(void *h_x, void *h_b, QudaInvertParam *param);
 
+  /**
+   * Discard the solution history used for chronological forecasting.
+   * @param index The solve channel to flush (all channels if negative)
+   */
+  void flush_chrono_quda_(int *index);
+
 
 #ifdef __cplusplus
 }
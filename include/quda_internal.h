@@ -1,8 +1,12 @@
 #ifndef _QUDA_INTERNAL_H
 #define _QUDA_INTERNAL_H
 
+#ifdef QUDA_HOST_ONLY
+#include <host_only.h>
+#else
 #include <cuda.h>
 #include <cuda_runtime.h>
+#endif
 #include <sys/time.h>
 #include <string>
 #include <complex>
@@ -42,6 +46,7 @@
 #include <quda.h>
 #include <util_quda.h>
 #include <malloc_quda.h>
+#include <perf_counters.h>
 
 // Use bindless texture on Kepler
 #if (__COMPUTE_CAPABILITY__ >= 300) && (CUDA_VERSION >= 5000)
@@ -73,8 +78,9 @@ extern "C" {
     ParityHw even;
   } FullHw;
 
-  struct QUDA_DiracField{
+  struct QUDA_DiracField_s {
     void *field; /**< Pointer to a ColorSpinorField */
+    QudaDiracFieldOrder dirac_order; /**< Order the field was described with */
   };
 
   extern cudaDeviceProp deviceProp;  
@@ -115,10 +121,21 @@ namespace quda {
     /**< Keep track of number of calls */
     int count;
 
+#ifdef PERF_COUNTERS
+    /**< The cumulative hardware counts */
+    PerfCount counts;
+
+    /**< The hardware counts when the timer was last started */
+    PerfCount startCounts;
+#endif
+
   Timer() : time(0.0), last(0.0), running(false), count(0) { ; } 
 
     void Start() {
       if (running) errorQuda("Cannot start an already running timer");
+#ifdef PERF_COUNTERS
+      perfCountersRead(startCounts);
+#endif
       gettimeofday(&start, NULL);
       running = true;
     }
@@ -133,6 +150,13 @@ namespace quda {
       time += last;
       count++;
 
+#ifdef PERF_COUNTERS
+      PerfCount c;
+      perfCountersRead(c);
+      c -= startCounts;
+      counts += c;
+#endif
+
       running = false;
     }
 
@@ -165,6 +189,8 @@ namespace quda {
 
     QUDA_PROFILE_CONSTANT, /**< time spent setting CUDA constant parameters */
 
+    QUDA_PROFILE_CHRONO, /**< chronological forecasting of the initial guess */
+
     QUDA_PROFILE_TOTAL, /**< The total time in seconds for the algorithm. Must be the penultimate type. */
     QUDA_PROFILE_COUNT /**< The total number of timers we have.  Must be last enum type. */
   };
@@ -6,8 +6,18 @@
  * @brief Experimental new interace.  This will eventually evolve into
  * the new quda.h, likely to coincide with release 0.5.0.
  *
+ * Fields are created once and passed by handle to the operators and
+ * solvers.  A field either owns memory allocated by the library or
+ * wraps the memory of the application without copying it.  The
+ * operators and solvers use device fields in the layout of the
+ * solver (QUDA_INTERNAL_DIRAC_ORDER at the cuda_prec, in the UKQCD
+ * basis for four spins, padded by sp_pad) in place, and copy the
+ * other fields in and out.  Keeping the fields of a workflow in that
+ * layout thus avoids the reordering and transfers of every call;
+ * QUDA_copyDiracField() converts between layouts where needed.
  */
 
+#include <quda.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,20 +27,88 @@ extern "C" {
    * Parameters relating to a DiracField
    */
   typedef struct QUDA_DiracFieldParam_s {
-    int X[4];          /**< Lattice dimensions */ 
+    int X[4];          /**< Lattice dimensions */
     int Ls;            /**< Extent of the 5th dimension (for domain wall) */
     int Nc;            /**< Number of colors */
     int Ns;            /**< Number of spins */
     QudaTwistFlavorType twist_flavor;  /**< Twisted mass flavor */
     int pad; /**< Pad used on the field */
-  } QUDA_DiracFieldParam;  
+    QudaPrecision precision;         /**< Precision of the field */
+    QudaFieldLocation location;      /**< Host or device memory */
+    QudaSiteSubset site_subset;      /**< Full lattice, or a single parity (X[0] is still the full extent) */
+    QudaDiracFieldOrder dirac_order; /**< Layout of the field */
+    QudaGammaBasis gamma_basis;      /**< Gamma basis of the field */
+  } QUDA_DiracFieldParam;
 
   typedef struct QUDA_DiracField_s QUDA_DiracField;
 
-  #ifdef __cplusplus
+  /**
+   * A new QUDA_DiracFieldParam should be initialized with this
+   * function: a four-spin, three-color, unpadded full field, with the
+   * remaining members invalid.
+   */
+  QUDA_DiracFieldParam QUDA_newDiracFieldParam(void);
+
+  /**
+   * Create a field in memory owned by the library, set to zero.
+   * @param param Description of the field
+   * @return The handle of the field
+   */
+  QUDA_DiracField* QUDA_createDiracField(const QUDA_DiracFieldParam *param);
+
+  /**
+   * Wrap the memory of the application as a field, without copying
+   * it.  The memory must outlive the handle, and half-precision
+   * device fields cannot be wrapped (their norms are separate).
+   * @param v Base pointer to the field, in host or device memory as
+   *          given by param->location
+   * @param param Description of the field
+   * @return The handle of the field
+   */
+  QUDA_DiracField* QUDA_wrapDiracField(void *v, const QUDA_DiracFieldParam *param);
+
+  /**
+   * Destroy a field handle, freeing the memory owned by the library
+   * (the memory of a wrapped field is left alone).
+   */
+  void QUDA_destroyDiracField(QUDA_DiracField *field);
+
+  /**
+   * Base pointer to the elements of a field.
+   */
+  void* QUDA_diracFieldData(QUDA_DiracField *field);
+
+  /**
+   * Copy a field, converting its precision, layout, gamma basis and
+   * location as needed.
+   */
+  void QUDA_copyDiracField(QUDA_DiracField *dst, QUDA_DiracField *src);
+
+  /**
+   * Squared norm of a field, summed over all processes.
+   */
+  double QUDA_normDiracField(QUDA_DiracField *field);
+
+  /**
+   * Apply the Dirac matrix, as MatQuda().  The site subset of the
+   * fields must match inv_param->solution_type.
+   */
+  void QUDA_MatDiracField(QUDA_DiracField *out, QUDA_DiracField *in, QudaInvertParam *inv_param);
+
+  /**
+   * Apply the normal operator, as MatDagMatQuda().
+   */
+  void QUDA_MatDagMatDiracField(QUDA_DiracField *out, QUDA_DiracField *in, QudaInvertParam *inv_param);
+
+  /**
+   * Solve for x, as invertQuda().  The input_location, output_location,
+   * cpu_prec and dirac_order of param are taken from the fields.
+   */
+  void QUDA_invertDiracField(QUDA_DiracField *x, QUDA_DiracField *b, QudaInvertParam *param);
+
+#ifdef __cplusplus
 }
 #endif
 
 #endif /* _QUDA_NEW_INTERFACE_H */
 
-
@@ -0,0 +1,31 @@
+#ifndef _SPINOR_IO_H
+#define _SPINOR_IO_H
+
+#include <color_spinor_field.h>
+
+namespace quda {
+
+  /**
+     Append a full-lattice host spinor field to a SciDAC (LIME)
+     propagator file as a USQCD DiracFermion (or ColorVector for
+     nSpin=1) record.  The field is copied and the call returns; the
+     reordering to file order, the writing and the checksum are done
+     by a background thread.  Every rank writes its own sites into the
+     shared file.  A failed background write is reported by the next
+     call of writeSpinorFile or flushSpinorWriter.  Must be called collectively, in the same order on
+     every rank.
+     @param filename The propagator file; the first write after a
+     flush creates it
+     @param param Describes the host field (param.v)
+  */
+  void writeSpinorFile(const char *filename, const ColorSpinorParam &param);
+
+  /**
+     Wait for the pending writes, combine their checksums over the
+     ranks and write them, and close the files.  Collective.
+  */
+  void flushSpinorWriter();
+
+} // namespace quda
+
+#endif // _SPINOR_IO_H
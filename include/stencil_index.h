@@ -0,0 +1,89 @@
+#ifndef _STENCIL_INDEX_H
+#define _STENCIL_INDEX_H
+
+#include <quda_internal.h>
+
+namespace quda {
+
+  /**
+     Index tables of the nearest-neighbor stencils of the host
+     operators and force kernels, built once per geometry and shared
+     by all the users of that geometry.  Sites are the checkerboard
+     indices of each parity of a lattice of even dimensions X.  For
+     each parity the neighbor table holds eight entries per site, the
+     forward and backward hops of each dimension d at 2*d and 2*d+1,
+     which are indices of the opposite parity.  Hops across the
+     boundary of a dimension either wrap around (PERIODIC), are
+     redirected to the halo (HALO: entry volumeCB + GhostOffset(d,e)
+     + k for the k-th site of the face) or are dropped (OPEN: -1).
+
+     The traversal order of each parity lists the sites in the order
+     in which the kernels should visit them: lexicographic, or along a
+     Morton or Hilbert curve through the sites of the parity, so that
+     the sites handled together (by a thread, or by the lanes of a
+     vector) are close on the lattice and share their neighbors in
+     cache.  Only the order of the visits changes, not the layout of
+     the fields.
+   */
+  class StencilIndex {
+
+  public:
+    enum Boundary { PERIODIC, HALO, OPEN };
+
+  private:
+    int X[4];
+    Boundary boundary[4];
+    QudaStencilOrder order;
+    int volumeCB;
+    int faceCB[4];
+    int ghostOffset[4][2]; // offset of the backward / forward halo of each dimension
+    int ghostCB;           // total number of halo sites
+
+    int *nbr[2];           // [parity] eight entries per site
+    int *face[4][2][2];    // [dim][bottom/top][parity] checkerboard indices of the face sites
+    int *sites[2];         // [parity] traversal order
+
+    int refCount;
+
+    StencilIndex(const int *X, const Boundary *boundary, QudaStencilOrder order);
+    ~StencilIndex();
+
+    void buildTables();
+    void buildOrder();
+
+  public:
+    /**
+       Return the tables of a geometry, building them on first use.
+       Every Acquire must be matched by a Release; the tables are
+       freed when the last user releases them.
+       @param X The local dimensions (all even)
+       @param boundary The boundary condition of each dimension
+       @param order The traversal order of the sites
+     */
+    static const StencilIndex* Acquire(const int *X, const Boundary *boundary, QudaStencilOrder order);
+    static void Release(const StencilIndex *index);
+
+    int VolumeCB() const { return volumeCB; }
+    int FaceCB(int d) const { return faceCB[d]; }
+    int GhostOffset(int d, int e) const { return ghostOffset[d][e]; }
+    int GhostCB() const { return ghostCB; }
+    QudaStencilOrder Order() const { return order; }
+
+    /** Neighbor table of parity p, [site][8] */
+    const int* Neighbors(int p) const { return nbr[p]; }
+
+    /**
+       Sites of parity p on the bottom (e = 0) or top (e = 1) face of
+       dimension d.  Both faces of a dimension are enumerated in the
+       same order, so the bottom face of parity p on one node lines up
+       with the top face of parity 1-p on its backward neighbor.
+     */
+    const int* Face(int d, int e, int p) const { return face[d][e][p]; }
+
+    /** Sites of parity p in traversal order */
+    const int* Sites(int p) const { return sites[p]; }
+  };
+
+} // namespace quda
+
+#endif // _STENCIL_INDEX_H
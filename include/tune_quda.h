@@ -48,16 +48,19 @@ namespace quda {
     dim3 grid;
     int shared_bytes;
     std::string comment;
+    float time; // time of a launch, for the kernel statistics (negative if not known yet)
 
-  TuneParam() : block(32, 1, 1), grid(1, 1, 1), shared_bytes(0) { }
+  TuneParam() : block(32, 1, 1), grid(1, 1, 1), shared_bytes(0), time(-1.0) { }
   TuneParam(const TuneParam &param)
-    : block(param.block), grid(param.grid), shared_bytes(param.shared_bytes), comment(param.comment) { }
+    : block(param.block), grid(param.grid), shared_bytes(param.shared_bytes), comment(param.comment),
+      time(param.time) { }
     TuneParam& operator=(const TuneParam &param) {
       if (&param != this) {
 	block = param.block;
 	grid = param.grid;
 	shared_bytes = param.shared_bytes;
 	comment = param.comment;
+	time = param.time;
       }
       return *this;
     }
@@ -65,8 +68,13 @@ namespace quda {
   };
 
 
+  class Tunable;
+  TuneParam tuneLaunch(Tunable &tunable, QudaTune enabled, QudaVerbosity verbosity);
+
   class Tunable {
 
+    friend TuneParam tuneLaunch(Tunable &tunable, QudaTune enabled, QudaVerbosity verbosity);
+
   protected:
     virtual long long flops() const = 0;
     virtual long long bytes() const { return 0; } // FIXME
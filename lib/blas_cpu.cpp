@@ -6,11 +6,13 @@ namespace quda {
 
   template <typename Float>
   void axpby(const Float &a, const Float *x, const Float &b, Float *y, const int N) {
+#pragma omp parallel for
     for (int i=0; i<N; i++) y[i] = a*x[i] + b*y[i];
   }
 
   void axpbyCpu(const double &a, const cpuColorSpinorField &x, 
 		const double &b, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("axpbyCpu");
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       axpby(a, (double*)x.V(), b, (double*)y.V(), x.Length());
     else if (x.Precision() == QUDA_SINGLE_PRECISION)
@@ -20,6 +22,7 @@ namespace quda {
   }
 
   void xpyCpu(const cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("xpyCpu");
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       axpby(1.0, (double*)x.V(), 1.0, (double*)y.V(), x.Length());
     else if (x.Precision() == QUDA_SINGLE_PRECISION)
@@ -30,6 +33,7 @@ namespace quda {
 
   void axpyCpu(const double &a, const cpuColorSpinorField &x, 
 	       cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("axpyCpu");
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       axpby(a, (double*)x.V(), 1.0, (double*)y.V(), x.Length());
     else if (x.Precision() == QUDA_SINGLE_PRECISION)
@@ -40,6 +44,7 @@ namespace quda {
 
   void xpayCpu(const cpuColorSpinorField &x, const double &a, 
 	       cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("xpayCpu");
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       axpby(1.0, (double*)x.V(), a, (double*)y.V(), x.Length());
     else if (x.Precision() == QUDA_SINGLE_PRECISION)
@@ -49,6 +54,7 @@ namespace quda {
   }
 
   void mxpyCpu(const cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("mxpyCpu");
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       axpby(-1.0, (double*)x.V(), 1.0, (double*)y.V(), x.Length());
     else if (x.Precision() == QUDA_SINGLE_PRECISION)
@@ -58,6 +64,7 @@ namespace quda {
   }
 
   void axCpu(const double &a, cpuColorSpinorField &x) {
+    QUDA_PERF_SCOPE("axCpu");
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       axpby(0.0, (double*)x.V(), a, (double*)x.V(), x.Length());
     else if (x.Precision() == QUDA_SINGLE_PRECISION)
@@ -78,6 +85,7 @@ namespace quda {
 
   void caxpyCpu(const Complex &a, const cpuColorSpinorField &x,
 		cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("caxpyCpu");
 
     if ( x.Precision() == QUDA_DOUBLE_PRECISION)
       caxpby(a, (Complex*)x.V(), Complex(1.0), 
@@ -91,6 +99,7 @@ namespace quda {
 
   void caxpbyCpu(const Complex &a, const cpuColorSpinorField &x,
 		 const Complex &b, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("caxpbyCpu");
 
     if ( x.Precision() == QUDA_DOUBLE_PRECISION)
       caxpby(a, (Complex*)x.V(), b, (Complex*)y.V(), x.Length()/2);
@@ -115,6 +124,7 @@ namespace quda {
   void cxpaypbzCpu(const cpuColorSpinorField &x, const Complex &a, 
 		   const cpuColorSpinorField &y, const Complex &b,
 		   cpuColorSpinorField &z) {
+    QUDA_PERF_SCOPE("cxpaypbzCpu");
 
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       caxpbypcz(Complex(1, 0), (Complex*)x.V(), a, (Complex*)y.V(), 
@@ -128,13 +138,58 @@ namespace quda {
 
   void axpyBzpcxCpu(const double &a, cpuColorSpinorField& x, cpuColorSpinorField& y, 
 		    const double &b, const cpuColorSpinorField& z, const double &c) {
+    QUDA_PERF_SCOPE("axpyBzpcxCpu");
     axpyCpu(a, x, y);
     axpbyCpu(b, z, c, x);
   }
 
+  // Multi-vector variant of axpyBzpcx used by the host multi-shift
+  // solver.  The vectors are streamed in chunks, and each chunk of z is
+  // reused from cache by all N shifts, so every x[j] and y[j] is
+  // touched exactly once.
+  template <typename Float>
+  void axpyBzpcx(const double *a, Float **x, Float **y, const double *b, const Float *z,
+		 const double *c, const int nVec, const int N) {
+    const int chunk = 1536; // 12 KB of z in double precision
+    const int nChunk = (N + chunk - 1) / chunk;
+#pragma omp parallel for
+    for (int k=0; k<nChunk; k++) {
+      const int begin = k*chunk;
+      const int end = (begin + chunk < N) ? begin + chunk : N;
+      for (int j=0; j<nVec; j++) {
+	Float *xj = x[j], *yj = y[j];
+	const Float aj = a[j], bj = b[j], cj = c[j];
+	for (int i=begin; i<end; i++) {
+	  yj[i] += aj*xj[i];
+	  xj[i] = bj*z[i] + cj*xj[i];
+	}
+      }
+    }
+  }
+
+  // performs the operations: {y[j][i] += a[j]*x[j][i]; x[j][i] = b[j]*z[i] + c[j]*x[j][i]} for j < N
+  void axpyBzpcxCpu(const double *a, cpuColorSpinorField **x, cpuColorSpinorField **y,
+		    const double *b, const cpuColorSpinorField &z, const double *c, const int N) {
+    QUDA_PERF_SCOPE("axpyBzpcxCpu");
+    if (N > QUDA_MAX_MULTI_SHIFT) errorQuda("Number of vectors %d exceeds QUDA_MAX_MULTI_SHIFT", N);
+
+    if (z.Precision() == QUDA_DOUBLE_PRECISION) {
+      double *X[QUDA_MAX_MULTI_SHIFT], *Y[QUDA_MAX_MULTI_SHIFT];
+      for (int j=0; j<N; j++) { X[j] = (double*)x[j]->V(); Y[j] = (double*)y[j]->V(); }
+      axpyBzpcx(a, X, Y, b, (const double*)z.V(), c, N, z.Length());
+    } else if (z.Precision() == QUDA_SINGLE_PRECISION) {
+      float *X[QUDA_MAX_MULTI_SHIFT], *Y[QUDA_MAX_MULTI_SHIFT];
+      for (int j=0; j<N; j++) { X[j] = (float*)x[j]->V(); Y[j] = (float*)y[j]->V(); }
+      axpyBzpcx(a, X, Y, b, (const float*)z.V(), c, N, z.Length());
+    } else {
+      errorQuda("Precision type %d not implemented", z.Precision());
+    }
+  }
+
   // performs the operations: {y[i] = a*x[i] + y[i]; x[i] = z[i] + b*x[i]}
   void axpyZpbxCpu(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y, 
 		   const cpuColorSpinorField &z, const double &b) {
+    QUDA_PERF_SCOPE("axpyZpbxCpu");
     axpyCpu(a, x, y);
     xpayCpu(z, b, x);
   }
@@ -142,6 +197,7 @@ namespace quda {
   // performs the operation z[i] = a*x[i] + b*y[i] + z[i] and y[i] -= b*w[i]
   void caxpbypzYmbwCpu(const Complex &a, const cpuColorSpinorField &x, const Complex &b, 
 		       cpuColorSpinorField &y, cpuColorSpinorField &z, const cpuColorSpinorField &w) {
+    QUDA_PERF_SCOPE("caxpbypzYmbwCpu");
 
     if (x.Precision() == QUDA_DOUBLE_PRECISION)
       caxpbypcz(a, (Complex*)x.V(), b, (Complex*)y.V(), 
@@ -159,11 +215,13 @@ namespace quda {
   template <typename Float>
   double norm(const Float *a, const int N) {
     double norm2 = 0;
+#pragma omp parallel for reduction(+:norm2)
     for (int i=0; i<N; i++) norm2 += a[i]*a[i];
     return norm2;
   }
 
   double normCpu(const cpuColorSpinorField &a) {
+    QUDA_PERF_SCOPE("normCpu");
     double norm2 = 0.0;
     if (a.Precision() == QUDA_DOUBLE_PRECISION)
       norm2 = norm((double*)a.V(), a.Length());
@@ -175,20 +233,41 @@ namespace quda {
     return norm2;
   }
 
+  template <typename Float>
+  double axpyNorm(const Float &a, const Float *x, Float *y, const int N) {
+    double norm2 = 0;
+#pragma omp parallel for reduction(+:norm2)
+    for (int i=0; i<N; i++) {
+      y[i] += a*x[i];
+      norm2 += y[i]*y[i];
+    }
+    return norm2;
+  }
+
   double axpyNormCpu(const double &a, const cpuColorSpinorField &x, 
 		     cpuColorSpinorField &y) {
-    axpyCpu(a, x, y);
-    return normCpu(y);
+    QUDA_PERF_SCOPE("axpyNormCpu");
+    double norm2 = 0.0;
+    if (x.Precision() == QUDA_DOUBLE_PRECISION)
+      norm2 = axpyNorm(a, (double*)x.V(), (double*)y.V(), x.Length());
+    else if (x.Precision() == QUDA_SINGLE_PRECISION)
+      norm2 = axpyNorm((float)a, (float*)x.V(), (float*)y.V(), x.Length());
+    else
+      errorQuda("Precision type %d not implemented", x.Precision());
+    reduceDouble(norm2);
+    return norm2;
   }
 
   template <typename Float>
   double reDotProduct(const Float *a, const Float *b, const int N) {
     double dot = 0;
+#pragma omp parallel for reduction(+:dot)
     for (int i=0; i<N; i++) dot += a[i]*b[i];
     return dot;
   }
 
   double reDotProductCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
+    QUDA_PERF_SCOPE("reDotProductCpu");
     double dot = 0.0;
     if (a.Precision() == QUDA_DOUBLE_PRECISION)
       dot = reDotProduct((double*)a.V(), (double*)b.V(), a.Length());
@@ -203,6 +282,7 @@ namespace quda {
   // First performs the operation y[i] = x[i] - y[i]
   // Second returns the norm of y
   double xmyNormCpu(const cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("xmyNormCpu");
     xpayCpu(x, -1, y);
     return normCpu(y);
   }
@@ -215,6 +295,7 @@ namespace quda {
   }
 
   Complex cDotProductCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
+    QUDA_PERF_SCOPE("cDotProductCpu");
     Complex dot = 0.0;
     if (a.Precision() == QUDA_DOUBLE_PRECISION)
       dot = cDotProduct((Complex*)a.V(), (Complex*)b.V(), a.Length()/2);
@@ -230,17 +311,20 @@ namespace quda {
   // Second returns complex dot product (z,y)
   Complex xpaycDotzyCpu(const cpuColorSpinorField &x, const double &a, 
 			      cpuColorSpinorField &y, const cpuColorSpinorField &z) {
+    QUDA_PERF_SCOPE("xpaycDotzyCpu");
     xpayCpu(x, a, y);
     return cDotProductCpu(z,y);
   }
 
   double3 cDotProductNormACpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
+    QUDA_PERF_SCOPE("cDotProductNormACpu");
     Complex dot = cDotProductCpu(a, b);
     double norm = normCpu(a);
     return make_double3(real(dot), imag(dot), norm);
   }
 
   double3 cDotProductNormBCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
+    QUDA_PERF_SCOPE("cDotProductNormBCpu");
     Complex dot = cDotProductCpu(a, b);
     double norm = normCpu(b);
     return make_double3(real(dot), imag(dot), norm);
@@ -251,24 +335,28 @@ namespace quda {
 					    const Complex &b, cpuColorSpinorField &y, 
 					    cpuColorSpinorField &z, const cpuColorSpinorField &w, 
 					    const cpuColorSpinorField &u) {
+    QUDA_PERF_SCOPE("caxpbypzYmbwcDotProductUYNormYCpu");
 
     caxpbypzYmbwCpu(a, x, b, y, z, w);
     return cDotProductNormBCpu(u, y);
   }
 
   void cabxpyAxCpu(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("cabxpyAxCpu");
     axCpu(a, x);
     caxpyCpu(b, x, y);
   }
 
   double caxpyNormCpu(const Complex &a, cpuColorSpinorField &x, 
 		      cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("caxpyNormCpu");
     caxpyCpu(a, x, y);
     return norm2(y);
   }
 
   double caxpyXmazNormXCpu(const Complex &a, cpuColorSpinorField &x, 
 			   cpuColorSpinorField &y, cpuColorSpinorField &z) {
+    QUDA_PERF_SCOPE("caxpyXmazNormXCpu");
     caxpyCpu(a, x, y);
     caxpyCpu(-a, z, x);
     return norm2(x);
@@ -276,11 +364,13 @@ namespace quda {
 
   void caxpyXmazCpu(const Complex &a, cpuColorSpinorField &x, 
 		    cpuColorSpinorField &y, cpuColorSpinorField &z) {
+    QUDA_PERF_SCOPE("caxpyXmazCpu");
     caxpyCpu(a, x, y);
     caxpyCpu(-a, z, x);
   }
 
   double cabxpyAxNormCpu(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    QUDA_PERF_SCOPE("cabxpyAxNormCpu");
     axCpu(a, x);
     caxpyCpu(b, x, y);
     return norm2(y);
@@ -288,12 +378,14 @@ namespace quda {
 
   void caxpbypzCpu(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y, 
 		   cpuColorSpinorField &z) {
+    QUDA_PERF_SCOPE("caxpbypzCpu");
     caxpyCpu(a, x, z);
     caxpyCpu(b, y, z);
   }
 
   void caxpbypczpwCpu(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y, 
 		      const Complex &c, cpuColorSpinorField &z, cpuColorSpinorField &w) {
+    QUDA_PERF_SCOPE("caxpbypczpwCpu");
     caxpyCpu(a, x, w);
     caxpyCpu(b, y, w);
     caxpyCpu(c, z, w);
@@ -302,6 +394,7 @@ namespace quda {
 
   Complex caxpyDotzyCpu(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
 			cpuColorSpinorField &z) {
+    QUDA_PERF_SCOPE("caxpyDotzyCpu");
     caxpyCpu(a, x, y);
     return cDotProductCpu(z, y);
   }
@@ -329,6 +422,7 @@ namespace quda {
   
   
   double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &r) {
+    QUDA_PERF_SCOPE("HeavyQuarkResidualNormCpu");
     double3 rtn;
     if (x.Precision() == QUDA_DOUBLE_PRECISION) {
       rtn = HeavyQuarkResidualNorm<double>((const double*)(x.V()), (const double*)(r.V()), 
@@ -348,6 +442,7 @@ namespace quda {
   }
   
   double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &r) {
+    QUDA_PERF_SCOPE("HeavyQuarkResidualNormCpu");
     cpuColorSpinorField tmp(x);
     xpyCpu(y, tmp);
     return HeavyQuarkResidualNormCpu(tmp, r);
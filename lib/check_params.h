@@ -96,6 +96,12 @@ void printQudaGaugeParam(QudaGaugeParam *param) {
   P(preserve_gauge, INVALID_INT);
 #endif
 
+#if defined INIT_PARAM
+  P(force_location, QUDA_CUDA_FIELD_LOCATION);
+#else
+  P(force_location, QUDA_INVALID_FIELD_LOCATION);
+#endif
+
 #ifdef INIT_PARAM
   return ret;
 #endif
@@ -157,6 +163,15 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(maxiter, INVALID_INT);
   P(reliable_delta, INVALID_DOUBLE);
 
+#if defined INIT_PARAM
+  P(reliable_drift, 0.0);
+#elif defined CHECK_PARAM
+  if (param->reliable_drift < 0.0)
+    errorQuda("reliable_drift = %e must be non-negative", param->reliable_drift);
+#else
+  P(reliable_drift, INVALID_DOUBLE);
+#endif
+
 #ifndef CHECK_PARAM
   P(num_offset, 0); /**< Number of offsets in the multi-shift solver */
 #endif
@@ -224,6 +239,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(verbosity_precondition, QUDA_INVALID_VERBOSITY);
   P(schwarz_type, QUDA_ADDITIVE_SCHWARZ); // defaults match previous interface behaviour
   P(precondition_cycle, 1);               // defaults match previous interface behaviour
+  P(schwarz_location, QUDA_CUDA_FIELD_LOCATION);
 #else
   if (param->inv_type_precondition == QUDA_BICGSTAB_INVERTER || 
       param->inv_type_precondition == QUDA_CG_INVERTER || 
@@ -233,12 +249,65 @@ void printQudaInvertParam(QudaInvertParam *param) {
     P(verbosity_precondition, QUDA_INVALID_VERBOSITY);
     P(schwarz_type, QUDA_INVALID_SCHWARZ);
     P(precondition_cycle, 0);              
+    P(schwarz_location, QUDA_INVALID_FIELD_LOCATION);
   }
 #endif
 
 
 
   
+#if defined INIT_PARAM
+  P(chrono_max_dim, 0);
+  P(chrono_index, 0);
+  P(chrono_precision, QUDA_INVALID_PRECISION);
+#elif defined CHECK_PARAM
+  if (param->chrono_max_dim > QUDA_MAX_CHRONO)
+    errorQuda("chrono_max_dim = %d exceeds QUDA_MAX_CHRONO = %d", param->chrono_max_dim, QUDA_MAX_CHRONO);
+  if (param->chrono_precision == QUDA_INVALID_PRECISION)
+    param->chrono_precision = param->cuda_prec;
+#else
+  P(chrono_max_dim, INVALID_INT);
+  P(chrono_index, INVALID_INT);
+  P(chrono_precision, QUDA_INVALID_PRECISION);
+#endif
+
+#if defined INIT_PARAM
+  P(solver_location, QUDA_CUDA_FIELD_LOCATION);
+  P(cpu_storage_sloppy, QUDA_INVALID_STORAGE);
+  P(cpu_reconstruct_sloppy, QUDA_RECONSTRUCT_NO);
+  P(cpu_virtual_node_sloppy, 0);
+  P(cpu_stencil_order, QUDA_LEXICOGRAPHIC_STENCIL_ORDER);
+#elif defined CHECK_PARAM
+  P(solver_location, QUDA_INVALID_FIELD_LOCATION);
+  if (param->cpu_storage_sloppy == QUDA_INVALID_STORAGE) {
+    switch (param->cuda_prec_sloppy) {
+    case QUDA_DOUBLE_PRECISION: param->cpu_storage_sloppy = QUDA_DOUBLE_STORAGE; break;
+    case QUDA_SINGLE_PRECISION: param->cpu_storage_sloppy = QUDA_SINGLE_STORAGE; break;
+    default: param->cpu_storage_sloppy = QUDA_HALF_STORAGE;
+    }
+  }
+  if (param->cpu_reconstruct_sloppy == QUDA_RECONSTRUCT_INVALID)
+    param->cpu_reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
+  if (param->cpu_virtual_node_sloppy == INVALID_INT) param->cpu_virtual_node_sloppy = 0;
+  if (param->cpu_stencil_order == QUDA_INVALID_STENCIL_ORDER)
+    param->cpu_stencil_order = QUDA_LEXICOGRAPHIC_STENCIL_ORDER;
+#else
+  P(solver_location, QUDA_INVALID_FIELD_LOCATION);
+  P(cpu_storage_sloppy, QUDA_INVALID_STORAGE);
+  P(cpu_reconstruct_sloppy, QUDA_RECONSTRUCT_INVALID);
+  P(cpu_virtual_node_sloppy, INVALID_INT);
+  P(cpu_stencil_order, QUDA_INVALID_STENCIL_ORDER);
+#endif
+
+#if defined INIT_PARAM
+  P(checkpoint_interval, 0);
+#elif defined CHECK_PARAM
+  if (param->checkpoint_interval < 0)
+    errorQuda("checkpoint_interval = %d must be non-negative", param->checkpoint_interval);
+#else
+  P(checkpoint_interval, INVALID_INT);
+#endif
+
 #ifdef INIT_PARAM
   P(use_init_guess, QUDA_USE_INIT_GUESS_NO); //set the default to no
   P(omega, 1.0); // set default to no relaxation
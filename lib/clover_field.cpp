@@ -34,6 +34,8 @@ namespace quda {
 
   }
 
+#ifndef QUDA_HOST_ONLY
+
   cudaCloverField::cudaCloverField(const CloverFieldParam &param) : CloverField(param) {
 
     if (create != QUDA_NULL_FIELD_CREATE && create != QUDA_REFERENCE_FIELD_CREATE) 
@@ -234,8 +236,12 @@ namespace quda {
 
   }
 
+#endif // QUDA_HOST_ONLY
+
   cpuCloverField::cpuCloverField(const CloverFieldParam &param) : CloverField(param) {
     if (create != QUDA_REFERENCE_FIELD_CREATE) errorQuda("Create type %d not supported", create);
+    if (aosoaWidth(order) && volumeCB % aosoaWidth(order))
+      errorQuda("Checkerboard volume %d not a multiple of the clover order width %d", volumeCB, aosoaWidth(order));
 
     if (create == QUDA_REFERENCE_FIELD_CREATE) {
       clover = param.clover;
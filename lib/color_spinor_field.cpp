@@ -318,10 +318,12 @@ namespace quda {
   double norm2(const ColorSpinorField &a) {
 
     double rtn = 0.0;
-    if (typeid(a) == typeid(cudaColorSpinorField)) {
-      rtn = normCuda(dynamic_cast<const cudaColorSpinorField&>(a));
-    } else if (typeid(a) == typeid(cpuColorSpinorField)) {
+    if (typeid(a) == typeid(cpuColorSpinorField)) {
       rtn = normCpu(dynamic_cast<const cpuColorSpinorField&>(a));
+#ifndef QUDA_HOST_ONLY
+    } else if (typeid(a) == typeid(cudaColorSpinorField)) {
+      rtn = normCuda(dynamic_cast<const cudaColorSpinorField&>(a));
+#endif
     } else {
       errorQuda("Unknown input ColorSpinorField %s", typeid(a).name());
     }
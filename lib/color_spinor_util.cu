@@ -12,6 +12,8 @@ namespace quda {
       ptr = new SpaceColorSpinOrder<Float>(const_cast<cpuColorSpinorField&>(a));
     else if (a.FieldOrder() == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) 
       ptr = new QOPDomainWallOrder<Float>(const_cast<cpuColorSpinorField&>(a));
+    else if (aosoaWidth(a.FieldOrder()))
+      ptr = new AoSoASpinColorOrder<Float>(const_cast<cpuColorSpinorField&>(a));
     else
       errorQuda("Order %d not supported in cpuColorSpinorField", a.FieldOrder());
     return ptr;
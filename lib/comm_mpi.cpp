@@ -68,6 +68,7 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   }
   host_free(hostname_recv_buf);
 
+#ifndef QUDA_HOST_ONLY // no devices to check in the host-only library
   int device_count;
   cudaGetDeviceCount(&device_count);
   if (device_count == 0) {
@@ -76,6 +77,7 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   if (gpuid >= device_count) {
     errorQuda("Too few GPUs available on %s", hostname);
   }
+#endif
 }
 
 
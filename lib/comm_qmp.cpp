@@ -40,6 +40,7 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
 
   // determine which GPU this process will use (FIXME: adopt the scheme in comm_mpi.cpp)
 
+#ifndef QUDA_HOST_ONLY
   int device_count;
   cudaGetDeviceCount(&device_count);
   if (device_count == 0) {
@@ -47,6 +48,9 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   }
 
   gpuid = (comm_rank() % device_count);
+#else // no devices to assign in the host-only library
+  gpuid = 0;
+#endif
 }
 
 
@@ -34,6 +34,8 @@ namespace quda {
 
   }
 
+#ifndef QUDA_HOST_ONLY
+
   /** 
       Generic CUDA clover reordering and packing
   */
@@ -109,6 +111,18 @@ namespace quda {
     long long bytes() const { return 2*arg.volumeCB*(arg.in.Bytes() + arg.out.Bytes()); } 
   };
 
+#else // QUDA_HOST_ONLY
+
+  // no kernels in the host-only library, so device fields cannot be reordered
+  template <typename FloatOut, typename FloatIn, int length, typename Out, typename In>
+    class CopyClover {
+  public:
+    CopyClover(CopyCloverArg<Out,In> &arg) { ; }
+    void apply(const cudaStream_t &stream) { errorQuda("Device clover reordering is not available in the host-only build"); }
+  };
+
+#endif // QUDA_HOST_ONLY
+
  template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
     void copyClover(OutOrder outOrder, const InOrder inOrder, int volume, QudaFieldLocation location) {
 
@@ -147,6 +161,15 @@ namespace quda {
 
     } else if (out.Order() == QUDA_BQCD_CLOVER_ORDER) {
       errorQuda("BQCD output not supported");
+    } else if (out.Order() == QUDA_AOSOA4_CLOVER_ORDER) {
+      copyClover<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatOut,length,4>(out, inverse, Out), inOrder, out.Volume(), location);
+    } else if (out.Order() == QUDA_AOSOA8_CLOVER_ORDER) {
+      copyClover<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatOut,length,8>(out, inverse, Out), inOrder, out.Volume(), location);
+    } else if (out.Order() == QUDA_AOSOA16_CLOVER_ORDER) {
+      copyClover<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatOut,length,16>(out, inverse, Out), inOrder, out.Volume(), location);
     } else {
       errorQuda("Clover field %d order not supported", out.Order());
     }
@@ -185,6 +208,15 @@ namespace quda {
       errorQuda("BQCD interface has not been built\n");
 #endif
 
+    } else if (in.Order() == QUDA_AOSOA4_CLOVER_ORDER) {
+      copyClover<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatIn,length,4>(in, inverse, In), out, inverse, location, Out, outNorm);
+    } else if (in.Order() == QUDA_AOSOA8_CLOVER_ORDER) {
+      copyClover<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatIn,length,8>(in, inverse, In), out, inverse, location, Out, outNorm);
+    } else if (in.Order() == QUDA_AOSOA16_CLOVER_ORDER) {
+      copyClover<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatIn,length,16>(in, inverse, In), out, inverse, location, Out, outNorm);
     } else {
       errorQuda("Clover field %d order not supported", in.Order());
     }
@@ -96,6 +96,8 @@ namespace quda {
     }
   }
 
+#ifndef QUDA_HOST_ONLY
+
   /** CUDA kernel to reorder spinor fields.  Adopts a similar form as the CPU version, using the same inlined functions. */
   template <typename FloatOut, typename FloatIn, int Ns, int Nc, typename OutOrder, typename InOrder, typename Basis>
     __global__ void packSpinorKernel(OutOrder outOrder, const InOrder inOrder, Basis basis, int volume) {  
@@ -177,6 +179,18 @@ namespace quda {
     long long bytes() const { return in.Bytes() + out.Bytes(); } 
   };
 
+#else // QUDA_HOST_ONLY
+
+  // no kernels in the host-only library, so device fields cannot be reordered
+  template <typename FloatOut, typename FloatIn, int Ns, int Nc, typename OutOrder, typename InOrder, typename Basis>
+    class PackSpinor {
+  public:
+    PackSpinor(OutOrder &out, const InOrder &in, Basis &basis, int volume) { ; }
+    void apply(const cudaStream_t &stream) { errorQuda("Device spinor reordering is not available in the host-only build"); }
+  };
+
+#endif // QUDA_HOST_ONLY
+
 
   /** Decide whether we are changing basis or not */
   template <typename FloatOut, typename FloatIn, int Ns, int Nc, typename OutOrder, typename InOrder>
@@ -234,6 +248,18 @@ namespace quda {
       SpaceColorSpinorOrder<FloatOut, Ns, Nc> outOrder(out, Out);
       genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>
 	(outOrder, inOrder, out.VolumeCB(), out.GammaBasis(), inBasis, location);
+    } else if (out.FieldOrder() == QUDA_AOSOA4_FIELD_ORDER) {
+      AoSoASpinorColorOrder<FloatOut, Ns, Nc, 4> outOrder(out, Out);
+      genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>
+	(outOrder, inOrder, out.VolumeCB(), out.GammaBasis(), inBasis, location);
+    } else if (out.FieldOrder() == QUDA_AOSOA8_FIELD_ORDER) {
+      AoSoASpinorColorOrder<FloatOut, Ns, Nc, 8> outOrder(out, Out);
+      genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>
+	(outOrder, inOrder, out.VolumeCB(), out.GammaBasis(), inBasis, location);
+    } else if (out.FieldOrder() == QUDA_AOSOA16_FIELD_ORDER) {
+      AoSoASpinorColorOrder<FloatOut, Ns, Nc, 16> outOrder(out, Out);
+      genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>
+	(outOrder, inOrder, out.VolumeCB(), out.GammaBasis(), inBasis, location);
     } else if (out.FieldOrder() == QUDA_QDPJIT_FIELD_ORDER) {
 
 #ifdef BUILD_QDPJIT_INTERFACE
@@ -267,6 +293,15 @@ namespace quda {
     } else if (in.FieldOrder() == QUDA_SPACE_COLOR_SPIN_FIELD_ORDER) {
       SpaceColorSpinorOrder<FloatIn, Ns, Nc> inOrder(in, In);
       genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>(inOrder, out, in.GammaBasis(), location, Out, outNorm);
+    } else if (in.FieldOrder() == QUDA_AOSOA4_FIELD_ORDER) {
+      AoSoASpinorColorOrder<FloatIn, Ns, Nc, 4> inOrder(in, In);
+      genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>(inOrder, out, in.GammaBasis(), location, Out, outNorm);
+    } else if (in.FieldOrder() == QUDA_AOSOA8_FIELD_ORDER) {
+      AoSoASpinorColorOrder<FloatIn, Ns, Nc, 8> inOrder(in, In);
+      genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>(inOrder, out, in.GammaBasis(), location, Out, outNorm);
+    } else if (in.FieldOrder() == QUDA_AOSOA16_FIELD_ORDER) {
+      AoSoASpinorColorOrder<FloatIn, Ns, Nc, 16> inOrder(in, In);
+      genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>(inOrder, out, in.GammaBasis(), location, Out, outNorm);
     } else if (in.FieldOrder() == QUDA_QDPJIT_FIELD_ORDER) {
 
 #ifdef BUILD_QDPJIT_INTERFACE
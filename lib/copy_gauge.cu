@@ -41,6 +41,8 @@ namespace quda {
     }
   }
 
+#ifndef QUDA_HOST_ONLY
+
   /** 
       Generic CUDA gauge reordering and packing.  Adopts a similar form as
       the CPU version, using the same inlined functions.
@@ -187,6 +189,18 @@ namespace quda {
     } 
   };
 
+#else // QUDA_HOST_ONLY
+
+  // no kernels in the host-only library, so device fields cannot be reordered
+  template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder, bool isGhost>
+    class CopyGauge {
+  public:
+    CopyGauge(CopyGaugeArg<OutOrder,InOrder> &arg) { ; }
+    void apply(const cudaStream_t &stream) { errorQuda("Device gauge reordering is not available in the host-only build"); }
+  };
+
+#endif // QUDA_HOST_ONLY
+
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
     void copyGauge(OutOrder outOrder, const InOrder inOrder, int volume, 
 		   const int *faceVolumeCB, int nDim, QudaFieldLocation location, int type) {
@@ -309,6 +323,15 @@ namespace quda {
       errorQuda("BQCD interface has not been built\n");
 #endif
 
+    } else if (out.Order() == QUDA_AOSOA4_GAUGE_ORDER) {
+      copyGauge<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatOut,length,4>(out, Out, outGhost), inOrder, out.Volume(), faceVolumeCB, out.Ndim(), location, type);
+    } else if (out.Order() == QUDA_AOSOA8_GAUGE_ORDER) {
+      copyGauge<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatOut,length,8>(out, Out, outGhost), inOrder, out.Volume(), faceVolumeCB, out.Ndim(), location, type);
+    } else if (out.Order() == QUDA_AOSOA16_GAUGE_ORDER) {
+      copyGauge<FloatOut,FloatIn,length>
+	(AoSoAOrder<FloatOut,length,16>(out, Out, outGhost), inOrder, out.Volume(), faceVolumeCB, out.Ndim(), location, type);
     } else {
       errorQuda("Gauge field %d order not supported", out.Order());
     }
@@ -409,6 +432,15 @@ namespace quda {
       errorQuda("BQCD interface has not been built\n");
 #endif
 
+    } else if (in.Order() == QUDA_AOSOA4_GAUGE_ORDER) {
+      copyGauge<FloatOut,FloatIn,length>(AoSoAOrder<FloatIn,length,4>(in, In, inGhost),
+					 out, location, Out, outGhost, type);
+    } else if (in.Order() == QUDA_AOSOA8_GAUGE_ORDER) {
+      copyGauge<FloatOut,FloatIn,length>(AoSoAOrder<FloatIn,length,8>(in, In, inGhost),
+					 out, location, Out, outGhost, type);
+    } else if (in.Order() == QUDA_AOSOA16_GAUGE_ORDER) {
+      copyGauge<FloatOut,FloatIn,length>(AoSoAOrder<FloatIn,length,16>(in, In, inGhost),
+					 out, location, Out, outGhost, type);
     } else {
       errorQuda("Gauge field %d order not supported", in.Order());
     }
@@ -63,8 +63,10 @@ namespace quda {
     create(QUDA_COPY_FIELD_CREATE);
     if (typeid(src) == typeid(cpuColorSpinorField)) {
       memcpy(v, dynamic_cast<const cpuColorSpinorField&>(src).v, bytes);
+#ifndef QUDA_HOST_ONLY
     } else if (typeid(src) == typeid(cudaColorSpinorField)) {
       dynamic_cast<const cudaColorSpinorField&>(src).saveSpinorField(*this);
+#endif
     } else {
       errorQuda("Unknown input ColorSpinorField %s", typeid(src).name());
     }
@@ -75,10 +77,12 @@ namespace quda {
   }
 
   ColorSpinorField& cpuColorSpinorField::operator=(const ColorSpinorField &src) {
-    if (typeid(src) == typeid(cudaColorSpinorField)) {
-      *this = (dynamic_cast<const cudaColorSpinorField&>(src));
-    } else if (typeid(src) == typeid(cpuColorSpinorField)) {
+    if (typeid(src) == typeid(cpuColorSpinorField)) {
       *this = (dynamic_cast<const cpuColorSpinorField&>(src));
+#ifndef QUDA_HOST_ONLY
+    } else if (typeid(src) == typeid(cudaColorSpinorField)) {
+      *this = (dynamic_cast<const cudaColorSpinorField&>(src));
+#endif
     } else {
       errorQuda("Unknown input ColorSpinorField %s", typeid(src).name());
     }
@@ -98,6 +102,7 @@ namespace quda {
     return *this;
   }
 
+#ifndef QUDA_HOST_ONLY
   cpuColorSpinorField& cpuColorSpinorField::operator=(const cudaColorSpinorField &src) {
     if (!reference) { // if the field is a reference, then we must maintain the current state
       destroy();
@@ -108,6 +113,7 @@ namespace quda {
     src.saveSpinorField(*this);
     return *this;
   }
+#endif
 
   void cpuColorSpinorField::create(const QudaFieldCreate create) {
     // these need to be reset to ensure no ghost zones for the cpu
@@ -126,10 +132,14 @@ namespace quda {
     if (fieldOrder != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER && 
 	fieldOrder != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER &&
 	fieldOrder != QUDA_QOP_DOMAIN_WALL_FIELD_ORDER &&
-	fieldOrder != QUDA_QDPJIT_FIELD_ORDER) {
+	fieldOrder != QUDA_QDPJIT_FIELD_ORDER &&
+	!aosoaWidth(fieldOrder)) {
       errorQuda("Field order %d not supported", fieldOrder);
     }
 
+    if (aosoaWidth(fieldOrder) && volumeCB % aosoaWidth(fieldOrder))
+      errorQuda("Checkerboard volume %d not a multiple of the field order width %d", volumeCB, aosoaWidth(fieldOrder));
+
     if (create != QUDA_REFERENCE_FIELD_CREATE) {
       // array of 4-d fields
       if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) {
@@ -241,7 +251,7 @@ namespace quda {
       errorQuda("Full spinor is not supported in packGhost for cpu");
     }
   
-    if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) {
+    if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER || aosoaWidth(fieldOrder)) {
       errorQuda("Field order %d not supported", fieldOrder);
     }
 
@@ -40,7 +40,11 @@ namespace quda {
 	}
       }
     
-    } else if (order == QUDA_CPS_WILSON_GAUGE_ORDER || order == QUDA_MILC_GAUGE_ORDER || order == QUDA_BQCD_GAUGE_ORDER) {
+    } else if (order == QUDA_CPS_WILSON_GAUGE_ORDER || order == QUDA_MILC_GAUGE_ORDER || order == QUDA_BQCD_GAUGE_ORDER ||
+	       aosoaWidth(order)) {
+
+      if (aosoaWidth(order) && volumeCB % aosoaWidth(order))
+	errorQuda("Checkerboard volume %d not a multiple of the gauge order width %d", volumeCB, aosoaWidth(order));
 
       if (create == QUDA_NULL_FIELD_CREATE || create == QUDA_ZERO_FIELD_CREATE) {
 	size_t nbytes = nDim * volume * reconstruct * precision;
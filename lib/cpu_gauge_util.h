@@ -0,0 +1,356 @@
+#ifndef _CPU_GAUGE_UTIL_H
+#define _CPU_GAUGE_UTIL_H
+
+#include <string.h>
+#include <math.h>
+#include <enum_quda.h>
+#include <comm_quda.h>
+#include <malloc_quda.h>
+
+/**
+   Helpers shared by the host gauge-field routines (link fattening,
+   gauge force).  Links are 18 reals, a row-major 3x3 complex matrix.
+   The routines work on a copy of the site links on a lattice extended
+   by two sites in every direction, held as [site][dim][18] with the
+   sites in lexicographic order, so that the neighbours of any local
+   site are found by a fixed offset.  The border is filled either from
+   a field that is already extended, or periodically and then from the
+   neighboring processes by exchangeExtendedLinks.
+ */
+
+namespace quda {
+
+  // c = a * b
+  template <typename Float>
+  static inline void su3MulNN(const Float *a, const Float *b, Float *c) {
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) {
+	Float re = 0.0, im = 0.0;
+	for (int k=0; k<3; k++) {
+	  re += a[6*i+2*k+0]*b[6*k+2*j+0] - a[6*i+2*k+1]*b[6*k+2*j+1];
+	  im += a[6*i+2*k+0]*b[6*k+2*j+1] + a[6*i+2*k+1]*b[6*k+2*j+0];
+	}
+	c[6*i+2*j+0] = re; c[6*i+2*j+1] = im;
+      }
+    }
+  }
+
+  // c = a * b^dagger
+  template <typename Float>
+  static inline void su3MulNA(const Float *a, const Float *b, Float *c) {
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) {
+	Float re = 0.0, im = 0.0;
+	for (int k=0; k<3; k++) {
+	  re += a[6*i+2*k+0]*b[6*j+2*k+0] + a[6*i+2*k+1]*b[6*j+2*k+1];
+	  im += a[6*i+2*k+1]*b[6*j+2*k+0] - a[6*i+2*k+0]*b[6*j+2*k+1];
+	}
+	c[6*i+2*j+0] = re; c[6*i+2*j+1] = im;
+      }
+    }
+  }
+
+  // c = a^dagger * b
+  template <typename Float>
+  static inline void su3MulAN(const Float *a, const Float *b, Float *c) {
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) {
+	Float re = 0.0, im = 0.0;
+	for (int k=0; k<3; k++) {
+	  re += a[6*k+2*i+0]*b[6*k+2*j+0] + a[6*k+2*i+1]*b[6*k+2*j+1];
+	  im += a[6*k+2*i+0]*b[6*k+2*j+1] - a[6*k+2*i+1]*b[6*k+2*j+0];
+	}
+	c[6*i+2*j+0] = re; c[6*i+2*j+1] = im;
+      }
+    }
+  }
+
+  /**
+     Geometry of the extended lattice.  Sites are lexicographic on the
+     extended lattice and the links are held as [site][dim][18].
+   */
+  struct ExtendedLattice {
+    int E[4];      // extended dimensions
+    int stride[4]; // site stride of each dimension
+    int volume;
+
+    ExtendedLattice(const int *X) {
+      volume = 1;
+      for (int d=0; d<4; d++) {
+	E[d] = X[d] + 4;
+	stride[d] = volume;
+	volume *= E[d];
+      }
+    }
+
+    // index of the n-th site of the box with a margin of m sites
+    inline int boxSite(int n, int m) const {
+      int x[4];
+      for (int d=0; d<4; d++) {
+	const int L = E[d] - 2*m;
+	x[d] = n % L + m;
+	n /= L;
+      }
+      return ((x[3]*E[2] + x[2])*E[1] + x[1])*E[0] + x[0];
+    }
+
+    inline int boxVolume(int m) const {
+      return (E[0]-2*m)*(E[1]-2*m)*(E[2]-2*m)*(E[3]-2*m);
+    }
+
+    // index of the n-th site of the two slices normal to d starting at slice first
+    inline int slabSite(int n, int d, int first) const {
+      int x[4];
+      for (int e=0; e<4; e++) {
+	const int L = (e == d) ? 2 : E[e];
+	x[e] = n % L + (e == d ? first : 0);
+	n /= L;
+      }
+      return ((x[3]*E[2] + x[2])*E[1] + x[1])*E[0] + x[0];
+    }
+  };
+
+  // site index of a host gauge field with the even-odd ordering
+  static inline int cbIndex(const int x[4], const int *D) {
+    const int volumeCB = D[0]*D[1]*D[2]*D[3]/2;
+    const int parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+    return (((x[3]*D[2] + x[2])*D[1] + x[1])*D[0] + x[0])/2 + parity*volumeCB;
+  }
+
+  template <typename Float>
+  static inline Float* hostLink(void *gauge, QudaGaugeFieldOrder order, int idx, int d) {
+    if (order == QUDA_QDP_GAUGE_ORDER) return ((Float**)gauge)[d] + idx*18;
+    return (Float*)gauge + (idx*4 + d)*18;
+  }
+
+  /**
+     Copy the links of a host gauge field to U, held as [site][dim][18]
+     on the extended lattice.  If extended is set the field is itself
+     on the extended lattice (with its border filled), otherwise it is
+     on the local lattice X and the border is filled periodically.
+   */
+  template <typename Float>
+  static void packExtendedLinks(Float *U, void *gauge, QudaGaugeFieldOrder order, const int *X,
+				bool extended, const ExtendedLattice &lat) {
+#pragma omp parallel for
+    for (int s=0; s<lat.volume; s++) {
+      int x[4], c = s;
+      for (int d=0; d<4; d++) {
+	x[d] = c % lat.E[d];
+	c /= lat.E[d];
+	if (!extended) x[d] = (x[d] - 2 + X[d]) % X[d];
+      }
+      const int idx = cbIndex(x, extended ? lat.E : X);
+      for (int d=0; d<4; d++) memcpy(U + (s*4+d)*18, hostLink<Float>(gauge, order, idx, d), 18*sizeof(Float));
+    }
+  }
+
+  /**
+     Fill the border of the extended links U from the neighboring
+     processes in the partitioned dimensions (the others are left as
+     filled by packExtendedLinks).  The dimensions are exchanged in
+     turn, each slab spanning the border already received in the
+     previous dimensions, so that the corners are filled as well.
+     nLinks is the number of links held per site.
+   */
+  template <typename Float>
+  static void exchangeExtendedLinks(Float *U, const int *X, const ExtendedLattice &lat, int nLinks=4) {
+    const size_t siteBytes = nLinks*18*sizeof(Float);
+    for (int d=0; d<4; d++) {
+      if (!comm_dim_partitioned(d)) continue;
+
+      // a slab is two slices of the extended lattice normal to d
+      const int slab = 2*(lat.volume/lat.E[d]);
+      const size_t bytes = slab*siteBytes;
+      char *buf = (char*)safe_malloc(4*bytes);
+      char *sendBack = buf, *sendFwd = buf + bytes, *recvBack = buf + 2*bytes, *recvFwd = buf + 3*bytes;
+
+      // first slice of each slab: the bottom and top interior slabs
+      // are sent, the borders below and above received
+      const int slice[4] = { 2, X[d], 0, X[d]+2 };
+      char *slabBuf[4] = { sendBack, sendFwd, recvBack, recvFwd };
+
+      for (int b=0; b<2; b++) {
+#pragma omp parallel for
+	for (int n=0; n<slab; n++)
+	  memcpy(slabBuf[b] + n*siteBytes, U + (size_t)lat.slabSite(n, d, slice[b])*nLinks*18, siteBytes);
+      }
+
+      MsgHandle *mh_send_fwd = comm_declare_send_relative(sendFwd, d, +1, bytes);
+      MsgHandle *mh_send_back = comm_declare_send_relative(sendBack, d, -1, bytes);
+      MsgHandle *mh_recv_back = comm_declare_receive_relative(recvBack, d, -1, bytes);
+      MsgHandle *mh_recv_fwd = comm_declare_receive_relative(recvFwd, d, +1, bytes);
+      comm_start(mh_recv_back);
+      comm_start(mh_recv_fwd);
+      comm_start(mh_send_fwd);
+      comm_start(mh_send_back);
+      comm_wait(mh_send_fwd);
+      comm_wait(mh_send_back);
+      comm_wait(mh_recv_back);
+      comm_wait(mh_recv_fwd);
+      comm_free(mh_send_fwd);
+      comm_free(mh_send_back);
+      comm_free(mh_recv_back);
+      comm_free(mh_recv_fwd);
+
+      for (int b=2; b<4; b++) {
+#pragma omp parallel for
+	for (int n=0; n<slab; n++)
+	  memcpy(U + (size_t)lat.slabSite(n, d, slice[b])*nLinks*18, slabBuf[b] + n*siteBytes, siteBytes);
+      }
+
+      host_free(buf);
+    }
+  }
+
+  /**
+     Refill the border of U, with nLinks links per site, after the
+     local sites have been updated: periodically from the local sites,
+     then from the neighboring processes.
+   */
+  template <typename Float>
+  static void refreshExtendedBorder(Float *U, const int *X, const ExtendedLattice &lat, int nLinks=4) {
+    const size_t siteBytes = nLinks*18*sizeof(Float);
+#pragma omp parallel for
+    for (int s=0; s<lat.volume; s++) {
+      int x[4], c = s, interior = 1;
+      for (int d=0; d<4; d++) {
+	x[d] = c % lat.E[d];
+	c /= lat.E[d];
+	if (x[d] < 2 || x[d] >= X[d]+2) interior = 0;
+	x[d] = (x[d] - 2 + X[d]) % X[d] + 2;
+      }
+      if (interior) continue;
+      const int src = ((x[3]*lat.E[2] + x[2])*lat.E[1] + x[1])*lat.E[0] + x[0];
+      memcpy(U + (size_t)s*nLinks*18, U + (size_t)src*nLinks*18, siteBytes);
+    }
+    exchangeExtendedLinks(U, X, lat, nLinks);
+  }
+
+  // determinant of a 3x3 complex matrix
+  static inline void su3Det(const double *a, double det[2]) {
+    det[0] = det[1] = 0.0;
+    for (int k=0; k<3; k++) {
+      const double *p = a + 6 + 2*((k+1)%3), *q = a + 12 + 2*((k+2)%3);
+      const double *u = a + 6 + 2*((k+2)%3), *v = a + 12 + 2*((k+1)%3);
+      const double re = p[0]*q[0] - p[1]*q[1] - u[0]*v[0] + u[1]*v[1];
+      const double im = p[0]*q[1] + p[1]*q[0] - u[0]*v[1] - u[1]*v[0];
+      det[0] += a[2*k]*re - a[2*k+1]*im;
+      det[1] += a[2*k]*im + a[2*k+1]*re;
+    }
+  }
+
+  // b = a^-1 for a 3x3 complex matrix, by the adjugate
+  static inline void su3Inverse(const double *a, double *b) {
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) {
+	const double *p = a + 6*((j+1)%3) + 2*((i+1)%3), *q = a + 6*((j+2)%3) + 2*((i+2)%3);
+	const double *u = a + 6*((j+1)%3) + 2*((i+2)%3), *v = a + 6*((j+2)%3) + 2*((i+1)%3);
+	b[6*i+2*j+0] = p[0]*q[0] - p[1]*q[1] - u[0]*v[0] + u[1]*v[1];
+	b[6*i+2*j+1] = p[0]*q[1] + p[1]*q[0] - u[0]*v[1] - u[1]*v[0];
+      }
+    }
+    double det[2];
+    su3Det(a, det);
+    const double n = 1.0 / (det[0]*det[0] + det[1]*det[1]);
+    for (int i=0; i<9; i++) {
+      const double re = b[2*i], im = b[2*i+1];
+      b[2*i+0] = (re*det[0] + im*det[1])*n;
+      b[2*i+1] = (im*det[0] - re*det[1])*n;
+    }
+  }
+
+  /**
+     Project a 3x3 matrix onto SU(3) in place: the unitary factor W of
+     the polar decomposition a = W H, found by the Newton iteration
+     W <- (W + W^-dag)/2, times the cube root of its inverse
+     determinant phase.
+   */
+  static inline void su3Project(double *a) {
+    double b[18];
+    for (int iter=0; iter<50; iter++) {
+      su3Inverse(a, b);
+      double diff = 0.0, norm = 0.0;
+      for (int i=0; i<3; i++) {
+	for (int j=0; j<3; j++) {
+	  const double re = 0.5*(a[6*i+2*j+0] + b[6*j+2*i+0]);
+	  const double im = 0.5*(a[6*i+2*j+1] - b[6*j+2*i+1]);
+	  diff += (re - a[6*i+2*j+0])*(re - a[6*i+2*j+0]) + (im - a[6*i+2*j+1])*(im - a[6*i+2*j+1]);
+	  norm += re*re + im*im;
+	  a[6*i+2*j+0] = re; a[6*i+2*j+1] = im;
+	}
+      }
+      // a is updated in place: a(i,j) only reads b, which is fixed
+      if (diff <= 1e-28*norm) break;
+    }
+
+    double det[2];
+    su3Det(a, det);
+    const double phi = -atan2(det[1], det[0]) / 3.0;
+    const double c = cos(phi), s = sin(phi);
+    for (int i=0; i<9; i++) {
+      const double re = a[2*i], im = a[2*i+1];
+      a[2*i+0] = re*c - im*s;
+      a[2*i+1] = re*s + im*c;
+    }
+  }
+
+  /**
+     e = exp(iQ) for a traceless hermitian 3x3 matrix Q, by the
+     Cayley-Hamilton form exp(iQ) = f0 + f1 Q + f2 Q^2 of Morningstar
+     and Peardon (hep-lat/0311018).
+   */
+  static inline void su3ExpiQ(const double *Q, double *e) {
+    double Q2[18], Q3[18];
+    su3MulNN(Q, Q, Q2);
+    su3MulNN(Q2, Q, Q3);
+    double c0 = (Q3[0] + Q3[8] + Q3[16]) / 3.0;
+    const double c1 = 0.5*(Q2[0] + Q2[8] + Q2[16]);
+
+    double f[3][2];
+    if (c1 < 1e-24) {
+      // exp(iQ) = 1 + iQ - Q^2/2 to this order
+      f[0][0] = 1.0; f[0][1] = 0.0;
+      f[1][0] = 0.0; f[1][1] = 1.0;
+      f[2][0] = -0.5; f[2][1] = 0.0;
+    } else {
+      const bool negative = c0 < 0;
+      if (negative) c0 = -c0;
+      const double c0max = 2.0*pow(c1/3.0, 1.5);
+      const double theta = acos(c0/c0max > 1.0 ? 1.0 : c0/c0max);
+      const double u = sqrt(c1/3.0)*cos(theta/3.0), w = sqrt(c1)*sin(theta/3.0);
+      const double u2 = u*u, w2 = w*w;
+      const double xi0 = fabs(w) < 0.05 ? 1.0 - w2/6.0*(1.0 - w2/20.0*(1.0 - w2/42.0)) : sin(w)/w;
+      const double cw = cos(w);
+      const double e2[2] = { cos(2*u), sin(2*u) }, em[2] = { cos(u), -sin(u) };
+
+      // h_j = a_j e^{2iu} + e^{-iu} b_j
+      const double a[3][2] = { { u2 - w2, 0.0 }, { 2*u, 0.0 }, { 1.0, 0.0 } };
+      const double b[3][2] = { { 8*u2*cw, 2*u*(3*u2 + w2)*xi0 },
+			       { -2*u*cw, (3*u2 - w2)*xi0 },
+			       { -cw, -3*u*xi0 } };
+      const double d = 1.0 / (9*u2 - w2);
+      for (int j=0; j<3; j++) {
+	f[j][0] = (a[j][0]*e2[0] + em[0]*b[j][0] - em[1]*b[j][1])*d;
+	f[j][1] = (a[j][0]*e2[1] + em[0]*b[j][1] + em[1]*b[j][0])*d;
+	// f_j(-c0) = (-1)^j f_j(c0)^*
+	if (negative) {
+	  f[j][1] = -f[j][1];
+	  if (j == 1) { f[j][0] = -f[j][0]; f[j][1] = -f[j][1]; }
+	}
+      }
+    }
+
+    for (int i=0; i<9; i++) {
+      e[2*i+0] = f[1][0]*Q[2*i] - f[1][1]*Q[2*i+1] + f[2][0]*Q2[2*i] - f[2][1]*Q2[2*i+1];
+      e[2*i+1] = f[1][0]*Q[2*i+1] + f[1][1]*Q[2*i] + f[2][0]*Q2[2*i+1] + f[2][1]*Q2[2*i];
+    }
+    for (int i=0; i<3; i++) {
+      e[8*i+0] += f[0][0];
+      e[8*i+1] += f[0][1];
+    }
+  }
+
+} // namespace quda
+
+#endif // _CPU_GAUGE_UTIL_H
@@ -0,0 +1,120 @@
+#ifndef _CPU_SIMD_H
+#define _CPU_SIMD_H
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+   Vector types for the generated host site kernels
+   (lib/dslash_core/wilson_*cpu_core.h).  Each holds `width` lanes of Float,
+   one lane per lattice site, and provides the arithmetic used by the
+   generated code: +, -, * and the fused fmadd(a,b,c) = a*b + c and
+   fnmadd(a,b,c) = c - a*b, plus permute(mask), which moves lane
+   l^mask to lane l (the lane exchange of the virtual-node layout).
+   SimdScalar is the portable fallback; the AVX2 (with FMA) and
+   AVX-512 types are available when the host compiler targets those
+   instruction sets (see --enable-cpu-simd), and SimdNative<Float>::type
+   is the widest of them.
+ */
+
+namespace quda {
+
+  template <typename T>
+  struct SimdScalar {
+    typedef T Float;
+    static const int width = 1;
+    T v;
+    SimdScalar() { }
+    SimdScalar(T a) : v(a) { }
+    static inline SimdScalar load(const T *p) { return SimdScalar(*p); }
+    inline void store(T *p) const { *p = v; }
+    inline SimdScalar& operator+=(const SimdScalar &a) { v += a.v; return *this; }
+    inline SimdScalar& operator-=(const SimdScalar &a) { v -= a.v; return *this; }
+    inline SimdScalar permute(int) const { return *this; }
+  };
+
+  template <typename T>
+  inline SimdScalar<T> operator+(const SimdScalar<T> &a, const SimdScalar<T> &b) { return SimdScalar<T>(a.v + b.v); }
+  template <typename T>
+  inline SimdScalar<T> operator-(const SimdScalar<T> &a, const SimdScalar<T> &b) { return SimdScalar<T>(a.v - b.v); }
+  template <typename T>
+  inline SimdScalar<T> operator-(const SimdScalar<T> &a) { return SimdScalar<T>(-a.v); }
+  template <typename T>
+  inline SimdScalar<T> operator*(const SimdScalar<T> &a, const SimdScalar<T> &b) { return SimdScalar<T>(a.v * b.v); }
+  template <typename T>
+  inline SimdScalar<T> fmadd(const SimdScalar<T> &a, const SimdScalar<T> &b, const SimdScalar<T> &c)
+  { return SimdScalar<T>(a.v*b.v + c.v); }
+  template <typename T>
+  inline SimdScalar<T> fnmadd(const SimdScalar<T> &a, const SimdScalar<T> &b, const SimdScalar<T> &c)
+  { return SimdScalar<T>(c.v - a.v*b.v); }
+
+  // an intrinsic vector type R of W elements T, with the intrinsics prefix_op_sfx
+#define QUDA_SIMD_TYPE(Name, T, R, W, prefix, sfx)			\
+  struct Name {								\
+    typedef T Float;							\
+    static const int width = W;						\
+    R v;								\
+    Name() { }								\
+    Name(R a) : v(a) { }						\
+    Name(T a) : v(prefix##_set1_##sfx(a)) { }				\
+    static inline Name load(const T *p) { return Name(prefix##_loadu_##sfx(p)); } \
+    inline void store(T *p) const { prefix##_storeu_##sfx(p, v); }	\
+    inline Name& operator+=(const Name &a) { v = prefix##_add_##sfx(v, a.v); return *this; } \
+    inline Name& operator-=(const Name &a) { v = prefix##_sub_##sfx(v, a.v); return *this; } \
+    inline Name permute(int mask) const;				\
+  };									\
+  inline Name operator+(const Name &a, const Name &b) { return Name(prefix##_add_##sfx(a.v, b.v)); } \
+  inline Name operator-(const Name &a, const Name &b) { return Name(prefix##_sub_##sfx(a.v, b.v)); } \
+  inline Name operator-(const Name &a) { return Name(prefix##_sub_##sfx(prefix##_setzero_##sfx(), a.v)); } \
+  inline Name operator*(const Name &a, const Name &b) { return Name(prefix##_mul_##sfx(a.v, b.v)); } \
+  inline Name fmadd(const Name &a, const Name &b, const Name &c) { return Name(prefix##_fmadd_##sfx(a.v, b.v, c.v)); } \
+  inline Name fnmadd(const Name &a, const Name &b, const Name &c) { return Name(prefix##_fnmadd_##sfx(a.v, b.v, c.v)); }
+
+#if defined(__AVX2__) && defined(__FMA__)
+  QUDA_SIMD_TYPE(SimdAVX2d, double, __m256d, 4, _mm256, pd)
+  QUDA_SIMD_TYPE(SimdAVX2f, float, __m256, 8, _mm256, ps)
+
+  // AVX2 has no variable permute of doubles, so the pairs of floats are moved
+  inline SimdAVX2d SimdAVX2d::permute(int mask) const {
+    const __m256i lane = _mm256_xor_si256(_mm256_setr_epi32(0,0,1,1,2,2,3,3), _mm256_set1_epi32(mask));
+    const __m256i idx = _mm256_add_epi32(_mm256_add_epi32(lane, lane), _mm256_setr_epi32(0,1,0,1,0,1,0,1));
+    return SimdAVX2d(_mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), idx)));
+  }
+
+  inline SimdAVX2f SimdAVX2f::permute(int mask) const {
+    const __m256i idx = _mm256_xor_si256(_mm256_setr_epi32(0,1,2,3,4,5,6,7), _mm256_set1_epi32(mask));
+    return SimdAVX2f(_mm256_permutevar8x32_ps(v, idx));
+  }
+#endif
+
+#if defined(__AVX512F__)
+  QUDA_SIMD_TYPE(SimdAVX512d, double, __m512d, 8, _mm512, pd)
+  QUDA_SIMD_TYPE(SimdAVX512f, float, __m512, 16, _mm512, ps)
+
+  inline SimdAVX512d SimdAVX512d::permute(int mask) const {
+    const __m512i idx = _mm512_xor_si512(_mm512_setr_epi64(0,1,2,3,4,5,6,7), _mm512_set1_epi64(mask));
+    return SimdAVX512d(_mm512_permutexvar_pd(idx, v));
+  }
+
+  inline SimdAVX512f SimdAVX512f::permute(int mask) const {
+    const __m512i idx = _mm512_xor_si512(_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),
+					 _mm512_set1_epi32(mask));
+    return SimdAVX512f(_mm512_permutexvar_ps(idx, v));
+  }
+#endif
+
+#undef QUDA_SIMD_TYPE
+
+  template <typename T> struct SimdNative { typedef SimdScalar<T> type; };
+#if defined(__AVX512F__)
+  template <> struct SimdNative<double> { typedef SimdAVX512d type; };
+  template <> struct SimdNative<float> { typedef SimdAVX512f type; };
+#elif defined(__AVX2__) && defined(__FMA__)
+  template <> struct SimdNative<double> { typedef SimdAVX2d type; };
+  template <> struct SimdNative<float> { typedef SimdAVX2f type; };
+#endif
+
+} // namespace quda
+
+#endif // _CPU_SIMD_H
@@ -0,0 +1,121 @@
+#ifndef _CPU_SPINOR_STORAGE_H
+#define _CPU_SPINOR_STORAGE_H
+
+#include <string.h>
+#include <math.h>
+#include <enum_quda.h>
+#include <util_quda.h>
+
+/**
+   Site codecs for the host spinor storage formats (QudaStorageType).
+   Each site of 24 reals is stored contiguously in Storage::bytes
+   bytes, so that sites can be gathered and exchanged with memcpy.
+   load returns a pointer to the decoded site (for the native formats
+   this is the storage itself, otherwise the supplied buffer) and
+   store encodes a site.
+ */
+
+namespace quda {
+
+  template <typename Float>
+  struct NativeStorage {
+    typedef Float RegType;
+    static const int bytes = 24*sizeof(Float);
+
+    static inline const Float* load(const char *site, Float *) { return (const Float*)site; }
+    static inline void store(char *site, const Float *v) { memcpy(site, v, 24*sizeof(Float)); }
+  };
+
+  // 16-bit fixed point scaled by the largest component of the site,
+  // as in the device half format but with the norm kept next to the
+  // site so that each site is a single contiguous record
+  struct HalfStorage {
+    typedef float RegType;
+    static const int bytes = sizeof(float) + 24*sizeof(short);
+
+    static inline const float* load(const char *site, float *v) {
+      const float scale = *(const float*)site * (1.0f/32767.0f);
+      const short *s = (const short*)(site + sizeof(float));
+      for (int i=0; i<24; i++) v[i] = scale * s[i];
+      return v;
+    }
+
+    static inline void store(char *site, const float *v) {
+      float max = 0.0f;
+      for (int i=0; i<24; i++) if (fabsf(v[i]) > max) max = fabsf(v[i]);
+      *(float*)site = max;
+      const float scale = (max > 0.0f) ? 32767.0f / max : 0.0f;
+      short *s = (short*)(site + sizeof(float));
+      for (int i=0; i<24; i++) s[i] = (short)lrintf(v[i]*scale);
+    }
+  };
+
+  // upper half of the IEEE single precision word, rounded to nearest even
+  struct BFloat16Storage {
+    typedef float RegType;
+    static const int bytes = 24*sizeof(unsigned short);
+
+    static inline const float* load(const char *site, float *v) {
+      const unsigned short *h = (const unsigned short*)site;
+      for (int i=0; i<24; i++) {
+	unsigned int u = (unsigned int)h[i] << 16;
+	memcpy(v+i, &u, sizeof(float));
+      }
+      return v;
+    }
+
+    static inline void store(char *site, const float *v) {
+      unsigned short *h = (unsigned short*)site;
+      for (int i=0; i<24; i++) {
+	unsigned int u;
+	memcpy(&u, v+i, sizeof(float));
+	u += 0x7fff + ((u >> 16) & 1);
+	h[i] = (unsigned short)(u >> 16);
+      }
+    }
+  };
+
+  /**
+     A single-parity spinor in a given storage format, with an
+     optional halo: site indices at or beyond volumeCB address the
+     halo buffer.
+   */
+  template <typename Storage>
+  struct SpinorAccessor {
+    typedef typename Storage::RegType RegType;
+
+    char *v;
+    const char *ghost;
+    int volumeCB;
+
+    SpinorAccessor(const void *v, const void *ghost=0, int volumeCB=0)
+      : v((char*)v), ghost((const char*)ghost), volumeCB(volumeCB) { }
+
+    inline const RegType* operator()(int m, RegType *buf) const {
+      const char *site = (ghost && m >= volumeCB) ?
+	ghost + (size_t)(m-volumeCB)*Storage::bytes : v + (size_t)m*Storage::bytes;
+      return Storage::load(site, buf);
+    }
+
+    inline void save(int n, const RegType *val) const {
+      Storage::store(v + (size_t)n*Storage::bytes, val);
+    }
+  };
+
+  /**
+     Bytes per site of a storage format
+   */
+  inline int storageSiteBytes(QudaStorageType storage) {
+    switch (storage) {
+    case QUDA_DOUBLE_STORAGE: return NativeStorage<double>::bytes;
+    case QUDA_SINGLE_STORAGE: return NativeStorage<float>::bytes;
+    case QUDA_HALF_STORAGE: return HalfStorage::bytes;
+    case QUDA_BFLOAT16_STORAGE: return BFloat16Storage::bytes;
+    default: errorQuda("Storage type %d not supported", storage);
+    }
+    return 0;
+  }
+
+} // namespace quda
+
+#endif // _CPU_SPINOR_STORAGE_H
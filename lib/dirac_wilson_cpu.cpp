@@ -0,0 +1,625 @@
+#include <string.h>
+#include <vector>
+
+#include <dirac_quda.h>
+#include <comm_quda.h>
+
+#include "wilson_cpu_core.h"
+
+namespace quda {
+
+  template <typename Storage, int N>
+  static void hopCpu(void *out, void *const *gauge, const void *in, const void *ghost,
+		     const int *X, double anisotropy, QudaTboundary tBoundary,
+		     const int *nbr, const int *sites, int parity, int dagger, const void *x, double a) {
+    typedef SpinorAccessor<Storage> Spinor;
+    typedef typename Storage::RegType Float;
+    const int volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+    const LinkAccessor<Float,N> g(gauge, X, anisotropy, tBoundary,
+				  comm_coord(3) == comm_dim(3)-1, comm_coord(3) == 0);
+    const Spinor o(out), i(in, ghost, volumeCB), xs(x);
+    // one site per vector lane, with the widest vector type this build
+    // targets, taking the sites in the traversal order of the stencil
+    typedef typename SimdNative<Float>::type V;
+#pragma omp parallel for
+    for (int k=0; k<volumeCB; k+=V::width)
+      wilsonHopSimd<V>(o, g, i, nbr, sites+k, volumeCB-k, parity, dagger, x ? &xs : (const Spinor*)0, a);
+  }
+
+  template <typename Storage>
+  static void hopCpu(void *out, void *const *gauge, const void *in, const void *ghost,
+		     QudaReconstructType reconstruct, const int *X, double anisotropy,
+		     QudaTboundary tBoundary, const int *nbr, const int *sites, int parity, int dagger,
+		     const void *x, double a) {
+    switch (reconstruct) {
+    case QUDA_RECONSTRUCT_NO:
+      hopCpu<Storage,18>(out, gauge, in, ghost, X, anisotropy, tBoundary, nbr, sites, parity, dagger, x, a);
+      break;
+    case QUDA_RECONSTRUCT_12:
+      hopCpu<Storage,12>(out, gauge, in, ghost, X, anisotropy, tBoundary, nbr, sites, parity, dagger, x, a);
+      break;
+    case QUDA_RECONSTRUCT_8:
+      hopCpu<Storage,8>(out, gauge, in, ghost, X, anisotropy, tBoundary, nbr, sites, parity, dagger, x, a);
+      break;
+    default:
+      errorQuda("Reconstruct type %d not supported", reconstruct);
+    }
+  }
+
+  template <typename Float>
+  static void hopVN(void *out, void *const *gauge, const void *in, const void *ghost, int volumeCB,
+		    const VirtualNodeHop *hop, const int *lanes, int parity, int dagger, const void *x, double a) {
+    typedef typename SimdNative<Float>::type V;
+    const Float *g[2] = { (const Float*)gauge[0], (const Float*)gauge[1] };
+    const int outerCB = volumeCB / V::width;
+#pragma omp parallel for
+    for (int b=0; b<outerCB; b++)
+      wilsonHopVN<V>((Float*)out, g, (const Float*)in, (const Float*)ghost, hop, lanes, volumeCB, b,
+		     parity, dagger, (const Float*)x, a);
+  }
+
+  // convert a single-parity spinor between the site order and the virtual-node layout
+  template <typename Float>
+  static void spinorLayout(Float *out, const Float *in, const int *site, int volumeCB, int W, bool toLayout) {
+#pragma omp parallel for
+    for (int v=0; v<volumeCB; v++) {
+      const size_t n = site[v], l = (size_t)(v/W)*24*W + v%W;
+      if (toLayout) for (int i=0; i<24; i++) out[l + i*W] = in[24*n + i];
+      else for (int i=0; i<24; i++) out[24*n + i] = in[l + i*W];
+    }
+  }
+
+  // the local links of a parity, [site][dim][18] to [outer site][dim][18][lane]
+  template <typename Float>
+  static void linkLayout(void *gauge, const int *site, int volumeCB, int W) {
+    const size_t length = (size_t)volumeCB*4*18;
+    Float *g = (Float*)gauge;
+    std::vector<Float> tmp(g, g + length);
+#pragma omp parallel for
+    for (int v=0; v<volumeCB; v++)
+      for (int k=0; k<4*18; k++) g[((size_t)(v/W)*4*18 + k)*W + v%W] = tmp[(size_t)site[v]*4*18 + k];
+  }
+
+  // gather the face sites of a virtual-node layout spinor into site records
+  template <typename Float>
+  static void packFaceVN(char *buf, const Float *in, const int *idx, const int *layoutIndex, int n, int W) {
+#pragma omp parallel for
+    for (int k=0; k<n; k++) {
+      const int v = layoutIndex[idx[k]];
+      const Float *s = in + (size_t)(v/W)*24*W + v%W;
+      Float *f = (Float*)buf + (size_t)k*24;
+      for (int i=0; i<24; i++) f[i] = s[i*W];
+    }
+  }
+
+  // copy (and compress) the local links of parity p from a QDP-ordered field
+  template <typename Float, int N>
+  static void packLinks(void *gauge, const void *const *qdp, int p, const int *X,
+			double anisotropy, QudaTboundary tBoundary) {
+    const int volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+    const Reconstruct<N,Float> reconstruct(X, anisotropy, tBoundary);
+    Float *g = (Float*)gauge;
+#pragma omp parallel for
+    for (int n=0; n<volumeCB; n++)
+      for (int d=0; d<4; d++)
+	reconstruct.Pack(g + (4*n+d)*N, (const Float*)qdp[d] + (p*volumeCB + n)*18, n);
+  }
+
+  template <typename Float>
+  static void packLinks(void *gauge, const void *const *qdp, int p, QudaReconstructType reconstruct,
+			const int *X, double anisotropy, QudaTboundary tBoundary) {
+    switch (reconstruct) {
+    case QUDA_RECONSTRUCT_NO: packLinks<Float,18>(gauge, qdp, p, X, anisotropy, tBoundary); break;
+    case QUDA_RECONSTRUCT_12: packLinks<Float,12>(gauge, qdp, p, X, anisotropy, tBoundary); break;
+    case QUDA_RECONSTRUCT_8: packLinks<Float,8>(gauge, qdp, p, X, anisotropy, tBoundary); break;
+    default: errorQuda("Reconstruct type %d not supported", reconstruct);
+    }
+  }
+
+#ifndef QUDA_HOST_ONLY
+  DiracWilsonCpu::DiracWilsonCpu(const DiracParam &param, QudaStorageType storage,
+				 QudaReconstructType reconstruct, bool virtualNode, QudaStencilOrder stencilOrder)
+    : type(param.type), kappa(param.kappa), matpcType(param.matpcType), dagger(param.dagger),
+      storage(storage), reconstruct(reconstruct), ghostCB(0), ghost(0), sendBuf(0), flops(0),
+      virtualNode(virtualNode), vnWidth(1)
+  {
+    checkParam();
+    if (!param.gauge) errorQuda("Gauge field not set");
+
+    // copy the gauge field to the host in QDP order
+    const cudaGaugeField &u = *param.gauge;
+    GaugeFieldParam gParam(u.X(), precision, QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY);
+    gParam.order = QUDA_QDP_GAUGE_ORDER;
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    gParam.link_type = QUDA_WILSON_LINKS;
+    gParam.t_boundary = u.TBoundary();
+    gParam.anisotropy = u.Anisotropy();
+    gParam.nFace = 1;
+    cpuGaugeField cpu(gParam);
+    u.saveCPUField(cpu, QUDA_CPU_FIELD_LOCATION);
+
+    create(cpu, stencilOrder);
+  }
+#endif
+
+  DiracWilsonCpu::DiracWilsonCpu(const DiracParam &param, const cpuGaugeField &u, QudaStorageType storage,
+				 QudaReconstructType reconstruct, bool virtualNode, QudaStencilOrder stencilOrder)
+    : type(param.type), kappa(param.kappa), matpcType(param.matpcType), dagger(param.dagger),
+      storage(storage), reconstruct(reconstruct), ghostCB(0), ghost(0), sendBuf(0), flops(0),
+      virtualNode(virtualNode), vnWidth(1)
+  {
+    checkParam();
+    if (u.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Reconstruct type %d not supported", u.Reconstruct());
+
+    if (u.Order() == QUDA_QDP_GAUGE_ORDER && u.Precision() == precision) {
+      create(u, stencilOrder);
+    } else {
+      GaugeFieldParam gParam(u.X(), precision, QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY);
+      gParam.order = QUDA_QDP_GAUGE_ORDER;
+      gParam.create = QUDA_NULL_FIELD_CREATE;
+      gParam.link_type = u.LinkType();
+      gParam.t_boundary = u.TBoundary();
+      gParam.anisotropy = u.Anisotropy();
+      gParam.nFace = 1;
+      cpuGaugeField cpu(gParam);
+      copyGenericGauge(cpu, u, QUDA_CPU_FIELD_LOCATION);
+      create(cpu, stencilOrder);
+    }
+  }
+
+  void DiracWilsonCpu::checkParam()
+  {
+    initHalfProjector();
+
+    if (type != QUDA_WILSON_DIRAC && type != QUDA_WILSONPC_DIRAC)
+      errorQuda("Host Wilson operator does not support Dirac type %d", type);
+    if (type == QUDA_WILSONPC_DIRAC && matpcType != QUDA_MATPC_EVEN_EVEN && matpcType != QUDA_MATPC_ODD_ODD)
+      errorQuda("MatPCType %d not valid for DiracWilsonCpu", matpcType);
+    if (reconstruct != QUDA_RECONSTRUCT_NO && reconstruct != QUDA_RECONSTRUCT_12 && reconstruct != QUDA_RECONSTRUCT_8)
+      errorQuda("Reconstruct type %d not supported by DiracWilsonCpu", reconstruct);
+    siteBytes = storageSiteBytes(storage);
+    // the compressed formats compute in single precision
+    precision = (storage == QUDA_DOUBLE_STORAGE) ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
+  }
+
+  // set up the tables, links and halo buffers from QDP-ordered host links of the operator precision
+  void DiracWilsonCpu::create(const cpuGaugeField &u, QudaStencilOrder stencilOrder)
+  {
+    for (int d=0; d<4; d++) X[d] = u.X()[d];
+    anisotropy = u.Anisotropy();
+    tBoundary = u.TBoundary();
+    volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+
+    StencilIndex::Boundary boundary[4];
+    for (int d=0; d<4; d++) boundary[d] = commDimPartitioned(d) ? StencilIndex::HALO : StencilIndex::PERIODIC;
+    stencil = StencilIndex::Acquire(X, boundary, stencilOrder);
+
+    for (int d=0; d<4; d++) {
+      faceCB[d] = stencil->FaceCB(d);
+      for (int e=0; e<2; e++) {
+	ghostOffset[d][e] = stencil->GhostOffset(d, e);
+	for (int p=0; p<2; p++) face[d][e][p] = stencil->Face(d, e, p);
+      }
+    }
+    ghostCB = stencil->GhostCB();
+    for (int p=0; p<2; p++) {
+      nbr[p] = stencil->Neighbors(p);
+      sites[p] = stencil->Sites(p);
+    }
+
+    // the halo links are exchanged in the compressed form
+    const size_t linkBytes = reconstruct*precision;
+    const void *const *qdp = (const void *const *)u.Gauge_p();
+    for (int p=0; p<2; p++) {
+      gauge[p] = safe_malloc((size_t)(volumeCB + ghostCB)*4*linkBytes);
+      if (precision == QUDA_DOUBLE_PRECISION)
+	packLinks<double>(gauge[p], qdp, p, reconstruct, X, anisotropy, tBoundary);
+      else
+	packLinks<float>(gauge[p], qdp, p, reconstruct, X, anisotropy, tBoundary);
+    }
+
+    // backward links from the neighboring nodes: the top face links
+    // of parity p are received into the halo of parity p
+    for (int d=0; d<4; d++) {
+      if (!commDimPartitioned(d)) continue;
+      const size_t bytes = faceCB[d]*linkBytes;
+      for (int p=0; p<2; p++) {
+	char *send = (char*)safe_malloc(bytes);
+	char *recv = (char*)safe_malloc(bytes);
+	for (int k=0; k<faceCB[d]; k++)
+	  memcpy(send + k*linkBytes, (char*)gauge[p] + (4*face[d][1][p][k]+d)*linkBytes, linkBytes);
+
+	MsgHandle *mh_send = comm_declare_send_relative(send, d, +1, bytes);
+	MsgHandle *mh_recv = comm_declare_receive_relative(recv, d, -1, bytes);
+	comm_start(mh_recv);
+	comm_start(mh_send);
+	comm_wait(mh_send);
+	comm_wait(mh_recv);
+	comm_free(mh_send);
+	comm_free(mh_recv);
+
+	for (int k=0; k<faceCB[d]; k++)
+	  memcpy((char*)gauge[p] + (4*(volumeCB + ghostOffset[d][0] + k)+d)*linkBytes,
+		 recv + k*linkBytes, linkBytes);
+	host_free(send);
+	host_free(recv);
+      }
+    }
+
+    // spinor halo and persistent message handles
+    for (int d=0; d<4; d++)
+      for (int e=0; e<2; e++) mhSend[d][e] = mhRecv[d][e] = 0;
+
+    if (ghostCB) {
+      ghost = safe_malloc(ghostCB*siteBytes);
+      sendBuf = safe_malloc(ghostCB*siteBytes);
+      for (int d=0; d<4; d++) {
+	if (!commDimPartitioned(d)) continue;
+	const size_t bytes = faceCB[d]*siteBytes;
+	// the top face is sent forwards into the backward halo of the
+	// neighbor, the bottom face backwards into its forward halo
+	mhSend[d][0] = comm_declare_send_relative((char*)sendBuf + ghostOffset[d][1]*siteBytes, d, -1, bytes);
+	mhSend[d][1] = comm_declare_send_relative((char*)sendBuf + ghostOffset[d][0]*siteBytes, d, +1, bytes);
+	mhRecv[d][0] = comm_declare_receive_relative((char*)ghost + ghostOffset[d][0]*siteBytes, d, -1, bytes);
+	mhRecv[d][1] = comm_declare_receive_relative((char*)ghost + ghostOffset[d][1]*siteBytes, d, +1, bytes);
+      }
+    }
+
+    const int nParity = (type == QUDA_WILSONPC_DIRAC) ? 1 : 2;
+    tmp[0] = safe_malloc((size_t)volumeCB*siteBytes);
+    tmp[1] = safe_malloc((size_t)nParity*volumeCB*siteBytes);
+
+    for (int p=0; p<2; p++) {
+      vnSite[p] = vnIndex[p] = vnLanes[p] = 0;
+      vnHop[p] = 0;
+    }
+    for (int i=0; i<3; i++) layoutBuf[i] = 0;
+    if (virtualNode) {
+      setupVirtualNode();
+      for (int i=0; i<3; i++) layoutBuf[i] = safe_malloc((size_t)nParity*volumeCB*siteBytes);
+    }
+  }
+
+  /**
+     Split the local lattice between the vector lanes by halving the
+     largest dimensions divisible by four, so that every sub-lattice
+     has even extent and the sites of an outer site share its parity.
+     Lane l holds the sub-lattice with the upper half of each split
+     dimension whose bit is set in l.  The hops are then classified
+     from the neighbor table: those that map all the lanes onto the
+     lanes of one outer site, up to an exchange, are vector hops.
+   */
+  void DiracWilsonCpu::setupVirtualNode()
+  {
+    if (storage != QUDA_DOUBLE_STORAGE && storage != QUDA_SINGLE_STORAGE)
+      errorQuda("Virtual-node layout requires double or single storage, not %d", storage);
+    if (reconstruct != QUDA_RECONSTRUCT_NO)
+      errorQuda("Virtual-node layout requires uncompressed links, not reconstruct %d", reconstruct);
+
+    const int W = vnWidth = (precision == QUDA_DOUBLE_PRECISION) ?
+      SimdNative<double>::type::width : SimdNative<float>::type::width;
+
+    int Y[4], bit[4];
+    for (int d=0; d<4; d++) { Y[d] = X[d]; bit[d] = 0; }
+    for (int w=1; w<W; w*=2) {
+      int split = -1;
+      for (int d=3; d>=0; d--)
+	if (!bit[d] && X[d] % 4 == 0 && (split < 0 || X[d] > X[split])) split = d;
+      if (split < 0) errorQuda("Local lattice %dx%dx%dx%d cannot be split into %d virtual nodes",
+			       X[0], X[1], X[2], X[3], W);
+      bit[split] = w;
+      Y[split] = X[split] / 2;
+    }
+    const int outerCB = volumeCB / W;
+
+    for (int p=0; p<2; p++) {
+      vnSite[p] = (int*)safe_malloc(volumeCB*sizeof(int));
+      vnIndex[p] = (int*)safe_malloc(volumeCB*sizeof(int));
+      for (int b=0; b<outerCB; b++) {
+	int y[4], r = b;
+	y[0] = 2*(r % (Y[0]/2)); r /= Y[0]/2;
+	y[1] = r % Y[1]; r /= Y[1];
+	y[2] = r % Y[2];
+	y[3] = r / Y[2];
+	y[0] += (y[1] + y[2] + y[3] + p) % 2;
+	for (int l=0; l<W; l++) {
+	  int x[4];
+	  for (int d=0; d<4; d++) x[d] = y[d] + ((l & bit[d]) ? Y[d] : 0);
+	  const int n = (((x[3]*X[2] + x[2])*X[1] + x[1])*X[0] + x[0]) / 2;
+	  vnSite[p][b*W + l] = n;
+	  vnIndex[p][n] = b*W + l;
+	}
+      }
+    }
+
+    int nGather = 0;
+    for (int p=0; p<2; p++) {
+      vnHop[p] = (VirtualNodeHop*)safe_malloc(8*outerCB*sizeof(VirtualNodeHop));
+      std::vector<int> lanes;
+      for (int b=0; b<outerCB; b++) {
+	for (int dir=0; dir<8; dir++) {
+	  int t[16];
+	  for (int l=0; l<W; l++) {
+	    const int m = nbr[p][8*vnSite[p][b*W + l] + dir];
+	    t[l] = (m >= volumeCB) ? m : vnIndex[1-p][m];
+	  }
+	  const int site = t[0] / W, mask = t[0] % W;
+	  bool vector = true;
+	  for (int l=0; l<W; l++) if (t[l] >= volumeCB || t[l] != site*W + (l ^ mask)) vector = false;
+
+	  VirtualNodeHop &h = vnHop[p][8*b + dir];
+	  if (vector) {
+	    h.site = site;
+	    h.lanes = mask;
+	  } else {
+	    h.site = -1;
+	    h.lanes = lanes.size();
+	    lanes.insert(lanes.end(), t, t + W);
+	    nGather++;
+	  }
+	}
+      }
+      vnLanes[p] = (int*)safe_malloc((lanes.size() + 1)*sizeof(int));
+      if (lanes.size()) memcpy(vnLanes[p], &lanes[0], lanes.size()*sizeof(int));
+
+      if (precision == QUDA_DOUBLE_PRECISION) linkLayout<double>(gauge[p], vnSite[p], volumeCB, W);
+      else linkLayout<float>(gauge[p], vnSite[p], volumeCB, W);
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Host Wilson operator: %d virtual nodes of %dx%dx%dx%d, %d of %d hops gathered per lane\n",
+		 W, Y[0], Y[1], Y[2], Y[3], nGather, 16*outerCB);
+  }
+
+  void DiracWilsonCpu::relayout(void *out, const void *in, int parity, bool toLayout) const
+  {
+    if (precision == QUDA_DOUBLE_PRECISION)
+      spinorLayout((double*)out, (const double*)in, vnSite[parity], volumeCB, vnWidth, toLayout);
+    else
+      spinorLayout((float*)out, (const float*)in, vnSite[parity], volumeCB, vnWidth, toLayout);
+  }
+
+  void DiracWilsonCpu::ToLayout(void *out, const void *in) const
+  {
+    const size_t parityBytes = (size_t)volumeCB*siteBytes;
+    if (!virtualNode) {
+      memcpy(out, in, (SiteSubset() == QUDA_FULL_SITE_SUBSET ? 2 : 1)*parityBytes);
+    } else if (SiteSubset() == QUDA_PARITY_SITE_SUBSET) {
+      relayout(out, in, matpcType == QUDA_MATPC_EVEN_EVEN ? 0 : 1, true);
+    } else {
+      relayout(out, in, 0, true);
+      relayout((char*)out + parityBytes, (const char*)in + parityBytes, 1, true);
+    }
+  }
+
+  void DiracWilsonCpu::FromLayout(void *out, const void *in) const
+  {
+    const size_t parityBytes = (size_t)volumeCB*siteBytes;
+    if (!virtualNode) {
+      memcpy(out, in, (SiteSubset() == QUDA_FULL_SITE_SUBSET ? 2 : 1)*parityBytes);
+    } else if (SiteSubset() == QUDA_PARITY_SITE_SUBSET) {
+      relayout(out, in, matpcType == QUDA_MATPC_EVEN_EVEN ? 0 : 1, false);
+    } else {
+      relayout(out, in, 0, false);
+      relayout((char*)out + parityBytes, (const char*)in + parityBytes, 1, false);
+    }
+  }
+
+  DiracWilsonCpu::~DiracWilsonCpu()
+  {
+    for (int d=0; d<4; d++) {
+      for (int e=0; e<2; e++) {
+	if (mhSend[d][e]) comm_free(mhSend[d][e]);
+	if (mhRecv[d][e]) comm_free(mhRecv[d][e]);
+      }
+    }
+    for (int p=0; p<2; p++) {
+      host_free(gauge[p]);
+      host_free(tmp[p]);
+      if (vnSite[p]) host_free(vnSite[p]);
+      if (vnIndex[p]) host_free(vnIndex[p]);
+      if (vnHop[p]) host_free(vnHop[p]);
+      if (vnLanes[p]) host_free(vnLanes[p]);
+    }
+    for (int i=0; i<3; i++) if (layoutBuf[i]) host_free(layoutBuf[i]);
+    if (ghost) host_free(ghost);
+    if (sendBuf) host_free(sendBuf);
+    StencilIndex::Release(stencil);
+  }
+
+  void DiracWilsonCpu::checkField(const cpuColorSpinorField &f, QudaSiteSubset subset) const
+  {
+    if (storage != QUDA_DOUBLE_STORAGE && storage != QUDA_SINGLE_STORAGE)
+      errorQuda("Operator with storage type %d can only be applied to raw vectors", storage);
+    if (f.Precision() != precision)
+      errorQuda("Field precision %d does not match operator precision %d", f.Precision(), precision);
+    if (f.Nspin() != 4 || f.Ncolor() != 3)
+      errorQuda("Host Wilson operator requires Nspin=4, Ncolor=3 fields");
+    if (f.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || f.SiteOrder() != QUDA_EVEN_ODD_SITE_ORDER)
+      errorQuda("Host Wilson operator requires space-spin-color even-odd ordered fields");
+    if (f.GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS)
+      errorQuda("Host Wilson operator requires the DeGrand-Rossi gamma basis");
+    if (f.SiteSubset() != subset || f.VolumeCB() != volumeCB)
+      errorQuda("Field geometry does not match the operator");
+  }
+
+  void DiracWilsonCpu::exchangeGhost(const void *in, int parity) const
+  {
+    if (!ghostCB) return;
+
+    for (int d=0; d<4; d++) {
+      if (!commDimPartitioned(d)) continue;
+      char *top = (char*)sendBuf + ghostOffset[d][0]*siteBytes;
+      char *bottom = (char*)sendBuf + ghostOffset[d][1]*siteBytes;
+      const int *topIdx = face[d][1][parity];
+      const int *bottomIdx = face[d][0][parity];
+      if (virtualNode && precision == QUDA_DOUBLE_PRECISION) {
+	packFaceVN(top, (const double*)in, topIdx, vnIndex[parity], faceCB[d], vnWidth);
+	packFaceVN(bottom, (const double*)in, bottomIdx, vnIndex[parity], faceCB[d], vnWidth);
+      } else if (virtualNode) {
+	packFaceVN(top, (const float*)in, topIdx, vnIndex[parity], faceCB[d], vnWidth);
+	packFaceVN(bottom, (const float*)in, bottomIdx, vnIndex[parity], faceCB[d], vnWidth);
+      } else {
+#pragma omp parallel for
+	for (int k=0; k<faceCB[d]; k++) {
+	  memcpy(top + k*siteBytes, (const char*)in + topIdx[k]*siteBytes, siteBytes);
+	  memcpy(bottom + k*siteBytes, (const char*)in + bottomIdx[k]*siteBytes, siteBytes);
+	}
+      }
+
+      comm_start(mhRecv[d][0]);
+      comm_start(mhRecv[d][1]);
+      comm_start(mhSend[d][0]);
+      comm_start(mhSend[d][1]);
+    }
+
+    for (int d=0; d<4; d++) {
+      if (!commDimPartitioned(d)) continue;
+      comm_wait(mhSend[d][0]);
+      comm_wait(mhSend[d][1]);
+      comm_wait(mhRecv[d][0]);
+      comm_wait(mhRecv[d][1]);
+    }
+  }
+
+  void DiracWilsonCpu::hop(void *out, const void *in, int parity, int dagger,
+			   const void *x, double a) const
+  {
+    PerfScope scope("DiracWilsonCpu::hop");
+    scope.flops = (x ? 1368ll : 1320ll) * volumeCB;
+    scope.bytes = (long long)((x ? 10 : 9)*siteBytes + 8*reconstruct*precision) * volumeCB;
+    exchangeGhost(in, 1-parity);
+
+    if (virtualNode) {
+      if (precision == QUDA_DOUBLE_PRECISION)
+	hopVN<double>(out, gauge, in, ghost, volumeCB, vnHop[parity], vnLanes[parity], parity, dagger, x, a);
+      else
+	hopVN<float>(out, gauge, in, ghost, volumeCB, vnHop[parity], vnLanes[parity], parity, dagger, x, a);
+      flops += (x ? 1368ll : 1320ll) * volumeCB;
+      return;
+    }
+
+    switch (storage) {
+    case QUDA_DOUBLE_STORAGE:
+      hopCpu<NativeStorage<double> >(out, gauge, in, ghost, reconstruct, X, anisotropy, tBoundary,
+					 nbr[parity], sites[parity], parity, dagger, x, a);
+      break;
+    case QUDA_SINGLE_STORAGE:
+      hopCpu<NativeStorage<float> >(out, gauge, in, ghost, reconstruct, X, anisotropy, tBoundary,
+					 nbr[parity], sites[parity], parity, dagger, x, a);
+      break;
+    case QUDA_HALF_STORAGE:
+      hopCpu<HalfStorage>(out, gauge, in, ghost, reconstruct, X, anisotropy, tBoundary,
+					 nbr[parity], sites[parity], parity, dagger, x, a);
+      break;
+    case QUDA_BFLOAT16_STORAGE:
+      hopCpu<BFloat16Storage>(out, gauge, in, ghost, reconstruct, X, anisotropy, tBoundary,
+					 nbr[parity], sites[parity], parity, dagger, x, a);
+      break;
+    default:
+      errorQuda("Storage type %d not supported", storage);
+    }
+
+    flops += (x ? 1368ll : 1320ll) * volumeCB;
+  }
+
+  void DiracWilsonCpu::applyM(void *out, const void *in, int dagger) const
+  {
+    if (type == QUDA_WILSONPC_DIRAC) {
+      const int p = (matpcType == QUDA_MATPC_EVEN_EVEN) ? 0 : 1;
+      hop(tmp[0], in, 1-p, dagger, 0, 0.0);
+      hop(out, tmp[0], p, dagger, in, -kappa*kappa);
+    } else {
+      const size_t parityBytes = (size_t)volumeCB*siteBytes;
+      const char *even = (const char*)in, *odd = even + parityBytes;
+      hop(out, odd, 0, dagger, even, -kappa);
+      hop((char*)out + parityBytes, even, 1, dagger, odd, -kappa);
+    }
+  }
+
+  void DiracWilsonCpu::Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+			      const QudaParity parity) const
+  {
+    checkField(out, QUDA_PARITY_SITE_SUBSET);
+    checkField(in, QUDA_PARITY_SITE_SUBSET);
+    if (virtualNode) {
+      relayout(layoutBuf[0], in.V(), 1-parity, true);
+      hop(layoutBuf[1], layoutBuf[0], parity, dagger == QUDA_DAG_YES, 0, 0.0);
+      relayout(out.V(), layoutBuf[1], parity, false);
+    } else {
+      hop(out.V(), in.V(), parity, dagger == QUDA_DAG_YES, 0, 0.0);
+    }
+  }
+
+  void DiracWilsonCpu::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+				  const QudaParity parity, const cpuColorSpinorField &x,
+				  const double &k) const
+  {
+    checkField(out, QUDA_PARITY_SITE_SUBSET);
+    checkField(in, QUDA_PARITY_SITE_SUBSET);
+    checkField(x, QUDA_PARITY_SITE_SUBSET);
+    if (virtualNode) {
+      relayout(layoutBuf[0], in.V(), 1-parity, true);
+      relayout(layoutBuf[2], x.V(), parity, true);
+      hop(layoutBuf[1], layoutBuf[0], parity, dagger == QUDA_DAG_YES, layoutBuf[2], k);
+      relayout(out.V(), layoutBuf[1], parity, false);
+    } else {
+      hop(out.V(), in.V(), parity, dagger == QUDA_DAG_YES, x.V(), k);
+    }
+  }
+
+  void DiracWilsonCpu::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkField(out, SiteSubset());
+    checkField(in, SiteSubset());
+    if (virtualNode) {
+      ToLayout(layoutBuf[0], in.V());
+      applyM(layoutBuf[1], layoutBuf[0], dagger == QUDA_DAG_YES);
+      FromLayout(out.V(), layoutBuf[1]);
+    } else {
+      applyM(out.V(), in.V(), dagger == QUDA_DAG_YES);
+    }
+  }
+
+  void DiracWilsonCpu::Mdag(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkField(out, SiteSubset());
+    checkField(in, SiteSubset());
+    if (virtualNode) {
+      ToLayout(layoutBuf[0], in.V());
+      applyM(layoutBuf[1], layoutBuf[0], dagger != QUDA_DAG_YES);
+      FromLayout(out.V(), layoutBuf[1]);
+    } else {
+      applyM(out.V(), in.V(), dagger != QUDA_DAG_YES);
+    }
+  }
+
+  void DiracWilsonCpu::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkField(out, SiteSubset());
+    checkField(in, SiteSubset());
+    const int dag = (dagger == QUDA_DAG_YES);
+    if (virtualNode) {
+      ToLayout(layoutBuf[0], in.V());
+      applyM(tmp[1], layoutBuf[0], dag);
+      applyM(layoutBuf[1], tmp[1], !dag);
+      FromLayout(out.V(), layoutBuf[1]);
+    } else {
+      applyM(tmp[1], in.V(), dag);
+      applyM(out.V(), tmp[1], !dag);
+    }
+  }
+
+  void DiracWilsonCpu::M(void *out, const void *in) const
+  {
+    applyM(out, in, dagger == QUDA_DAG_YES);
+  }
+
+  void DiracWilsonCpu::MdagM(void *out, const void *in) const
+  {
+    const int dag = (dagger == QUDA_DAG_YES);
+    applyM(tmp[1], in, dag);
+    applyM(out, tmp[1], !dag);
+  }
+
+} // namespace quda
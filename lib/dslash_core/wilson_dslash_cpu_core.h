@@ -0,0 +1,1196 @@
+// *** CPU DSLASH ***
+
+// input spinor
+#define i00_re I[0]
+#define i00_im I[1]
+#define i01_re I[2]
+#define i01_im I[3]
+#define i02_re I[4]
+#define i02_im I[5]
+#define i10_re I[6]
+#define i10_im I[7]
+#define i11_re I[8]
+#define i11_im I[9]
+#define i12_re I[10]
+#define i12_im I[11]
+#define i20_re I[12]
+#define i20_im I[13]
+#define i21_re I[14]
+#define i21_im I[15]
+#define i22_re I[16]
+#define i22_im I[17]
+#define i30_re I[18]
+#define i30_im I[19]
+#define i31_re I[20]
+#define i31_im I[21]
+#define i32_re I[22]
+#define i32_im I[23]
+
+// gauge link
+#define g00_re G[0]
+#define g00_im G[1]
+#define g01_re G[2]
+#define g01_im G[3]
+#define g02_re G[4]
+#define g02_im G[5]
+#define g10_re G[6]
+#define g10_im G[7]
+#define g11_re G[8]
+#define g11_im G[9]
+#define g12_re G[10]
+#define g12_im G[11]
+#define g20_re G[12]
+#define g20_im G[13]
+#define g21_re G[14]
+#define g21_im G[15]
+#define g22_re G[16]
+#define g22_im G[17]
+
+// output spinor
+#define o00_re O[0]
+#define o00_im O[1]
+#define o01_re O[2]
+#define o01_im O[3]
+#define o02_re O[4]
+#define o02_im O[5]
+#define o10_re O[6]
+#define o10_im O[7]
+#define o11_re O[8]
+#define o11_im O[9]
+#define o12_re O[10]
+#define o12_im O[11]
+#define o20_re O[12]
+#define o20_im O[13]
+#define o21_re O[14]
+#define o21_im O[15]
+#define o22_re O[16]
+#define o22_im O[17]
+#define o30_re O[18]
+#define o30_im O[19]
+#define o31_re O[20]
+#define o31_im O[21]
+#define o32_re O[22]
+#define o32_im O[23]
+
+{
+  // Projector P0-
+  // 1 0 0 -i 
+  // 0 1 -i 0 
+  // 0 i 1 0 
+  // i 0 0 1 
+  
+  CPU_READ_SPINOR(0);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re + i30_im;
+  spinorFloat a0_im = i00_im - i30_re;
+  spinorFloat a1_re = i01_re + i31_im;
+  spinorFloat a1_im = i01_im - i31_re;
+  spinorFloat a2_re = i02_re + i32_im;
+  spinorFloat a2_im = i02_im - i32_re;
+  spinorFloat b0_re = i10_re + i20_im;
+  spinorFloat b0_im = i10_im - i20_re;
+  spinorFloat b1_re = i11_re + i21_im;
+  spinorFloat b1_im = i11_im - i21_re;
+  spinorFloat b2_re = i12_re + i22_im;
+  spinorFloat b2_im = i12_im - i22_re;
+  
+  CPU_READ_GAUGE(0);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fnmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g01_re, a1_re, A0_re);
+  A0_re = fnmadd(g01_im, a1_im, A0_re);
+  A0_re = fmadd(g02_re, a2_re, A0_re);
+  A0_re = fnmadd(g02_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g01_re, a1_im, A0_im);
+  A0_im = fmadd(g01_im, a1_re, A0_im);
+  A0_im = fmadd(g02_re, a2_im, A0_im);
+  A0_im = fmadd(g02_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fnmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g01_re, b1_re, B0_re);
+  B0_re = fnmadd(g01_im, b1_im, B0_re);
+  B0_re = fmadd(g02_re, b2_re, B0_re);
+  B0_re = fnmadd(g02_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g01_re, b1_im, B0_im);
+  B0_im = fmadd(g01_im, b1_re, B0_im);
+  B0_im = fmadd(g02_re, b2_im, B0_im);
+  B0_im = fmadd(g02_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g10_re * a0_re;
+  A1_re = fnmadd(g10_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fnmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g12_re, a2_re, A1_re);
+  A1_re = fnmadd(g12_im, a2_im, A1_re);
+  spinorFloat A1_im = g10_re * a0_im;
+  A1_im = fmadd(g10_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g12_re, a2_im, A1_im);
+  A1_im = fmadd(g12_im, a2_re, A1_im);
+  spinorFloat B1_re = g10_re * b0_re;
+  B1_re = fnmadd(g10_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fnmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g12_re, b2_re, B1_re);
+  B1_re = fnmadd(g12_im, b2_im, B1_re);
+  spinorFloat B1_im = g10_re * b0_im;
+  B1_im = fmadd(g10_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g12_re, b2_im, B1_im);
+  B1_im = fmadd(g12_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g20_re * a0_re;
+  A2_re = fnmadd(g20_im, a0_im, A2_re);
+  A2_re = fmadd(g21_re, a1_re, A2_re);
+  A2_re = fnmadd(g21_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fnmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g20_re * a0_im;
+  A2_im = fmadd(g20_im, a0_re, A2_im);
+  A2_im = fmadd(g21_re, a1_im, A2_im);
+  A2_im = fmadd(g21_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g20_re * b0_re;
+  B2_re = fnmadd(g20_im, b0_im, B2_re);
+  B2_re = fmadd(g21_re, b1_re, B2_re);
+  B2_re = fnmadd(g21_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fnmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g20_re * b0_im;
+  B2_im = fmadd(g20_im, b0_re, B2_im);
+  B2_im = fmadd(g21_re, b1_im, B2_im);
+  B2_im = fmadd(g21_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re -= B0_im;
+  o20_im += B0_re;
+  o30_re -= A0_im;
+  o30_im += A0_re;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re -= B1_im;
+  o21_im += B1_re;
+  o31_re -= A1_im;
+  o31_im += A1_re;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re -= B2_im;
+  o22_im += B2_re;
+  o32_re -= A2_im;
+  o32_im += A2_re;
+  
+}
+
+{
+  // Projector P0+
+  // 1 0 0 i 
+  // 0 1 i 0 
+  // 0 -i 1 0 
+  // -i 0 0 1 
+  
+  CPU_READ_SPINOR(1);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re - i30_im;
+  spinorFloat a0_im = i00_im + i30_re;
+  spinorFloat a1_re = i01_re - i31_im;
+  spinorFloat a1_im = i01_im + i31_re;
+  spinorFloat a2_re = i02_re - i32_im;
+  spinorFloat a2_im = i02_im + i32_re;
+  spinorFloat b0_re = i10_re - i20_im;
+  spinorFloat b0_im = i10_im + i20_re;
+  spinorFloat b1_re = i11_re - i21_im;
+  spinorFloat b1_im = i11_im + i21_re;
+  spinorFloat b2_re = i12_re - i22_im;
+  spinorFloat b2_im = i12_im + i22_re;
+  
+  CPU_READ_GAUGE(1);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g10_re, a1_re, A0_re);
+  A0_re = fmadd(g10_im, a1_im, A0_re);
+  A0_re = fmadd(g20_re, a2_re, A0_re);
+  A0_re = fmadd(g20_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fnmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g10_re, a1_im, A0_im);
+  A0_im = fnmadd(g10_im, a1_re, A0_im);
+  A0_im = fmadd(g20_re, a2_im, A0_im);
+  A0_im = fnmadd(g20_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g10_re, b1_re, B0_re);
+  B0_re = fmadd(g10_im, b1_im, B0_re);
+  B0_re = fmadd(g20_re, b2_re, B0_re);
+  B0_re = fmadd(g20_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fnmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g10_re, b1_im, B0_im);
+  B0_im = fnmadd(g10_im, b1_re, B0_im);
+  B0_im = fmadd(g20_re, b2_im, B0_im);
+  B0_im = fnmadd(g20_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g01_re * a0_re;
+  A1_re = fmadd(g01_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g21_re, a2_re, A1_re);
+  A1_re = fmadd(g21_im, a2_im, A1_re);
+  spinorFloat A1_im = g01_re * a0_im;
+  A1_im = fnmadd(g01_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fnmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g21_re, a2_im, A1_im);
+  A1_im = fnmadd(g21_im, a2_re, A1_im);
+  spinorFloat B1_re = g01_re * b0_re;
+  B1_re = fmadd(g01_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g21_re, b2_re, B1_re);
+  B1_re = fmadd(g21_im, b2_im, B1_re);
+  spinorFloat B1_im = g01_re * b0_im;
+  B1_im = fnmadd(g01_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fnmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g21_re, b2_im, B1_im);
+  B1_im = fnmadd(g21_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g02_re * a0_re;
+  A2_re = fmadd(g02_im, a0_im, A2_re);
+  A2_re = fmadd(g12_re, a1_re, A2_re);
+  A2_re = fmadd(g12_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g02_re * a0_im;
+  A2_im = fnmadd(g02_im, a0_re, A2_im);
+  A2_im = fmadd(g12_re, a1_im, A2_im);
+  A2_im = fnmadd(g12_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fnmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g02_re * b0_re;
+  B2_re = fmadd(g02_im, b0_im, B2_re);
+  B2_re = fmadd(g12_re, b1_re, B2_re);
+  B2_re = fmadd(g12_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g02_re * b0_im;
+  B2_im = fnmadd(g02_im, b0_re, B2_im);
+  B2_im = fmadd(g12_re, b1_im, B2_im);
+  B2_im = fnmadd(g12_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fnmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re += B0_im;
+  o20_im -= B0_re;
+  o30_re += A0_im;
+  o30_im -= A0_re;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re += B1_im;
+  o21_im -= B1_re;
+  o31_re += A1_im;
+  o31_im -= A1_re;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re += B2_im;
+  o22_im -= B2_re;
+  o32_re += A2_im;
+  o32_im -= A2_re;
+  
+}
+
+{
+  // Projector P1-
+  // 1 0 0 1 
+  // 0 1 -1 0 
+  // 0 -1 1 0 
+  // 1 0 0 1 
+  
+  CPU_READ_SPINOR(2);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re + i30_re;
+  spinorFloat a0_im = i00_im + i30_im;
+  spinorFloat a1_re = i01_re + i31_re;
+  spinorFloat a1_im = i01_im + i31_im;
+  spinorFloat a2_re = i02_re + i32_re;
+  spinorFloat a2_im = i02_im + i32_im;
+  spinorFloat b0_re = i10_re - i20_re;
+  spinorFloat b0_im = i10_im - i20_im;
+  spinorFloat b1_re = i11_re - i21_re;
+  spinorFloat b1_im = i11_im - i21_im;
+  spinorFloat b2_re = i12_re - i22_re;
+  spinorFloat b2_im = i12_im - i22_im;
+  
+  CPU_READ_GAUGE(2);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fnmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g01_re, a1_re, A0_re);
+  A0_re = fnmadd(g01_im, a1_im, A0_re);
+  A0_re = fmadd(g02_re, a2_re, A0_re);
+  A0_re = fnmadd(g02_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g01_re, a1_im, A0_im);
+  A0_im = fmadd(g01_im, a1_re, A0_im);
+  A0_im = fmadd(g02_re, a2_im, A0_im);
+  A0_im = fmadd(g02_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fnmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g01_re, b1_re, B0_re);
+  B0_re = fnmadd(g01_im, b1_im, B0_re);
+  B0_re = fmadd(g02_re, b2_re, B0_re);
+  B0_re = fnmadd(g02_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g01_re, b1_im, B0_im);
+  B0_im = fmadd(g01_im, b1_re, B0_im);
+  B0_im = fmadd(g02_re, b2_im, B0_im);
+  B0_im = fmadd(g02_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g10_re * a0_re;
+  A1_re = fnmadd(g10_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fnmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g12_re, a2_re, A1_re);
+  A1_re = fnmadd(g12_im, a2_im, A1_re);
+  spinorFloat A1_im = g10_re * a0_im;
+  A1_im = fmadd(g10_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g12_re, a2_im, A1_im);
+  A1_im = fmadd(g12_im, a2_re, A1_im);
+  spinorFloat B1_re = g10_re * b0_re;
+  B1_re = fnmadd(g10_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fnmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g12_re, b2_re, B1_re);
+  B1_re = fnmadd(g12_im, b2_im, B1_re);
+  spinorFloat B1_im = g10_re * b0_im;
+  B1_im = fmadd(g10_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g12_re, b2_im, B1_im);
+  B1_im = fmadd(g12_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g20_re * a0_re;
+  A2_re = fnmadd(g20_im, a0_im, A2_re);
+  A2_re = fmadd(g21_re, a1_re, A2_re);
+  A2_re = fnmadd(g21_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fnmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g20_re * a0_im;
+  A2_im = fmadd(g20_im, a0_re, A2_im);
+  A2_im = fmadd(g21_re, a1_im, A2_im);
+  A2_im = fmadd(g21_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g20_re * b0_re;
+  B2_re = fnmadd(g20_im, b0_im, B2_re);
+  B2_re = fmadd(g21_re, b1_re, B2_re);
+  B2_re = fnmadd(g21_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fnmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g20_re * b0_im;
+  B2_im = fmadd(g20_im, b0_re, B2_im);
+  B2_im = fmadd(g21_re, b1_im, B2_im);
+  B2_im = fmadd(g21_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re -= B0_re;
+  o20_im -= B0_im;
+  o30_re += A0_re;
+  o30_im += A0_im;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re -= B1_re;
+  o21_im -= B1_im;
+  o31_re += A1_re;
+  o31_im += A1_im;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re -= B2_re;
+  o22_im -= B2_im;
+  o32_re += A2_re;
+  o32_im += A2_im;
+  
+}
+
+{
+  // Projector P1+
+  // 1 0 0 -1 
+  // 0 1 1 0 
+  // 0 1 1 0 
+  // -1 0 0 1 
+  
+  CPU_READ_SPINOR(3);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re - i30_re;
+  spinorFloat a0_im = i00_im - i30_im;
+  spinorFloat a1_re = i01_re - i31_re;
+  spinorFloat a1_im = i01_im - i31_im;
+  spinorFloat a2_re = i02_re - i32_re;
+  spinorFloat a2_im = i02_im - i32_im;
+  spinorFloat b0_re = i10_re + i20_re;
+  spinorFloat b0_im = i10_im + i20_im;
+  spinorFloat b1_re = i11_re + i21_re;
+  spinorFloat b1_im = i11_im + i21_im;
+  spinorFloat b2_re = i12_re + i22_re;
+  spinorFloat b2_im = i12_im + i22_im;
+  
+  CPU_READ_GAUGE(3);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g10_re, a1_re, A0_re);
+  A0_re = fmadd(g10_im, a1_im, A0_re);
+  A0_re = fmadd(g20_re, a2_re, A0_re);
+  A0_re = fmadd(g20_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fnmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g10_re, a1_im, A0_im);
+  A0_im = fnmadd(g10_im, a1_re, A0_im);
+  A0_im = fmadd(g20_re, a2_im, A0_im);
+  A0_im = fnmadd(g20_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g10_re, b1_re, B0_re);
+  B0_re = fmadd(g10_im, b1_im, B0_re);
+  B0_re = fmadd(g20_re, b2_re, B0_re);
+  B0_re = fmadd(g20_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fnmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g10_re, b1_im, B0_im);
+  B0_im = fnmadd(g10_im, b1_re, B0_im);
+  B0_im = fmadd(g20_re, b2_im, B0_im);
+  B0_im = fnmadd(g20_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g01_re * a0_re;
+  A1_re = fmadd(g01_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g21_re, a2_re, A1_re);
+  A1_re = fmadd(g21_im, a2_im, A1_re);
+  spinorFloat A1_im = g01_re * a0_im;
+  A1_im = fnmadd(g01_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fnmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g21_re, a2_im, A1_im);
+  A1_im = fnmadd(g21_im, a2_re, A1_im);
+  spinorFloat B1_re = g01_re * b0_re;
+  B1_re = fmadd(g01_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g21_re, b2_re, B1_re);
+  B1_re = fmadd(g21_im, b2_im, B1_re);
+  spinorFloat B1_im = g01_re * b0_im;
+  B1_im = fnmadd(g01_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fnmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g21_re, b2_im, B1_im);
+  B1_im = fnmadd(g21_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g02_re * a0_re;
+  A2_re = fmadd(g02_im, a0_im, A2_re);
+  A2_re = fmadd(g12_re, a1_re, A2_re);
+  A2_re = fmadd(g12_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g02_re * a0_im;
+  A2_im = fnmadd(g02_im, a0_re, A2_im);
+  A2_im = fmadd(g12_re, a1_im, A2_im);
+  A2_im = fnmadd(g12_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fnmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g02_re * b0_re;
+  B2_re = fmadd(g02_im, b0_im, B2_re);
+  B2_re = fmadd(g12_re, b1_re, B2_re);
+  B2_re = fmadd(g12_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g02_re * b0_im;
+  B2_im = fnmadd(g02_im, b0_re, B2_im);
+  B2_im = fmadd(g12_re, b1_im, B2_im);
+  B2_im = fnmadd(g12_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fnmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re += B0_re;
+  o20_im += B0_im;
+  o30_re -= A0_re;
+  o30_im -= A0_im;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re += B1_re;
+  o21_im += B1_im;
+  o31_re -= A1_re;
+  o31_im -= A1_im;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re += B2_re;
+  o22_im += B2_im;
+  o32_re -= A2_re;
+  o32_im -= A2_im;
+  
+}
+
+{
+  // Projector P2-
+  // 1 0 -i 0 
+  // 0 1 0 i 
+  // i 0 1 0 
+  // 0 -i 0 1 
+  
+  CPU_READ_SPINOR(4);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re + i20_im;
+  spinorFloat a0_im = i00_im - i20_re;
+  spinorFloat a1_re = i01_re + i21_im;
+  spinorFloat a1_im = i01_im - i21_re;
+  spinorFloat a2_re = i02_re + i22_im;
+  spinorFloat a2_im = i02_im - i22_re;
+  spinorFloat b0_re = i10_re - i30_im;
+  spinorFloat b0_im = i10_im + i30_re;
+  spinorFloat b1_re = i11_re - i31_im;
+  spinorFloat b1_im = i11_im + i31_re;
+  spinorFloat b2_re = i12_re - i32_im;
+  spinorFloat b2_im = i12_im + i32_re;
+  
+  CPU_READ_GAUGE(4);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fnmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g01_re, a1_re, A0_re);
+  A0_re = fnmadd(g01_im, a1_im, A0_re);
+  A0_re = fmadd(g02_re, a2_re, A0_re);
+  A0_re = fnmadd(g02_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g01_re, a1_im, A0_im);
+  A0_im = fmadd(g01_im, a1_re, A0_im);
+  A0_im = fmadd(g02_re, a2_im, A0_im);
+  A0_im = fmadd(g02_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fnmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g01_re, b1_re, B0_re);
+  B0_re = fnmadd(g01_im, b1_im, B0_re);
+  B0_re = fmadd(g02_re, b2_re, B0_re);
+  B0_re = fnmadd(g02_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g01_re, b1_im, B0_im);
+  B0_im = fmadd(g01_im, b1_re, B0_im);
+  B0_im = fmadd(g02_re, b2_im, B0_im);
+  B0_im = fmadd(g02_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g10_re * a0_re;
+  A1_re = fnmadd(g10_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fnmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g12_re, a2_re, A1_re);
+  A1_re = fnmadd(g12_im, a2_im, A1_re);
+  spinorFloat A1_im = g10_re * a0_im;
+  A1_im = fmadd(g10_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g12_re, a2_im, A1_im);
+  A1_im = fmadd(g12_im, a2_re, A1_im);
+  spinorFloat B1_re = g10_re * b0_re;
+  B1_re = fnmadd(g10_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fnmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g12_re, b2_re, B1_re);
+  B1_re = fnmadd(g12_im, b2_im, B1_re);
+  spinorFloat B1_im = g10_re * b0_im;
+  B1_im = fmadd(g10_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g12_re, b2_im, B1_im);
+  B1_im = fmadd(g12_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g20_re * a0_re;
+  A2_re = fnmadd(g20_im, a0_im, A2_re);
+  A2_re = fmadd(g21_re, a1_re, A2_re);
+  A2_re = fnmadd(g21_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fnmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g20_re * a0_im;
+  A2_im = fmadd(g20_im, a0_re, A2_im);
+  A2_im = fmadd(g21_re, a1_im, A2_im);
+  A2_im = fmadd(g21_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g20_re * b0_re;
+  B2_re = fnmadd(g20_im, b0_im, B2_re);
+  B2_re = fmadd(g21_re, b1_re, B2_re);
+  B2_re = fnmadd(g21_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fnmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g20_re * b0_im;
+  B2_im = fmadd(g20_im, b0_re, B2_im);
+  B2_im = fmadd(g21_re, b1_im, B2_im);
+  B2_im = fmadd(g21_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re -= A0_im;
+  o20_im += A0_re;
+  o30_re += B0_im;
+  o30_im -= B0_re;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re -= A1_im;
+  o21_im += A1_re;
+  o31_re += B1_im;
+  o31_im -= B1_re;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re -= A2_im;
+  o22_im += A2_re;
+  o32_re += B2_im;
+  o32_im -= B2_re;
+  
+}
+
+{
+  // Projector P2+
+  // 1 0 i 0 
+  // 0 1 0 -i 
+  // -i 0 1 0 
+  // 0 i 0 1 
+  
+  CPU_READ_SPINOR(5);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re - i20_im;
+  spinorFloat a0_im = i00_im + i20_re;
+  spinorFloat a1_re = i01_re - i21_im;
+  spinorFloat a1_im = i01_im + i21_re;
+  spinorFloat a2_re = i02_re - i22_im;
+  spinorFloat a2_im = i02_im + i22_re;
+  spinorFloat b0_re = i10_re + i30_im;
+  spinorFloat b0_im = i10_im - i30_re;
+  spinorFloat b1_re = i11_re + i31_im;
+  spinorFloat b1_im = i11_im - i31_re;
+  spinorFloat b2_re = i12_re + i32_im;
+  spinorFloat b2_im = i12_im - i32_re;
+  
+  CPU_READ_GAUGE(5);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g10_re, a1_re, A0_re);
+  A0_re = fmadd(g10_im, a1_im, A0_re);
+  A0_re = fmadd(g20_re, a2_re, A0_re);
+  A0_re = fmadd(g20_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fnmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g10_re, a1_im, A0_im);
+  A0_im = fnmadd(g10_im, a1_re, A0_im);
+  A0_im = fmadd(g20_re, a2_im, A0_im);
+  A0_im = fnmadd(g20_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g10_re, b1_re, B0_re);
+  B0_re = fmadd(g10_im, b1_im, B0_re);
+  B0_re = fmadd(g20_re, b2_re, B0_re);
+  B0_re = fmadd(g20_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fnmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g10_re, b1_im, B0_im);
+  B0_im = fnmadd(g10_im, b1_re, B0_im);
+  B0_im = fmadd(g20_re, b2_im, B0_im);
+  B0_im = fnmadd(g20_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g01_re * a0_re;
+  A1_re = fmadd(g01_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g21_re, a2_re, A1_re);
+  A1_re = fmadd(g21_im, a2_im, A1_re);
+  spinorFloat A1_im = g01_re * a0_im;
+  A1_im = fnmadd(g01_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fnmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g21_re, a2_im, A1_im);
+  A1_im = fnmadd(g21_im, a2_re, A1_im);
+  spinorFloat B1_re = g01_re * b0_re;
+  B1_re = fmadd(g01_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g21_re, b2_re, B1_re);
+  B1_re = fmadd(g21_im, b2_im, B1_re);
+  spinorFloat B1_im = g01_re * b0_im;
+  B1_im = fnmadd(g01_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fnmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g21_re, b2_im, B1_im);
+  B1_im = fnmadd(g21_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g02_re * a0_re;
+  A2_re = fmadd(g02_im, a0_im, A2_re);
+  A2_re = fmadd(g12_re, a1_re, A2_re);
+  A2_re = fmadd(g12_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g02_re * a0_im;
+  A2_im = fnmadd(g02_im, a0_re, A2_im);
+  A2_im = fmadd(g12_re, a1_im, A2_im);
+  A2_im = fnmadd(g12_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fnmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g02_re * b0_re;
+  B2_re = fmadd(g02_im, b0_im, B2_re);
+  B2_re = fmadd(g12_re, b1_re, B2_re);
+  B2_re = fmadd(g12_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g02_re * b0_im;
+  B2_im = fnmadd(g02_im, b0_re, B2_im);
+  B2_im = fmadd(g12_re, b1_im, B2_im);
+  B2_im = fnmadd(g12_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fnmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re += A0_im;
+  o20_im -= A0_re;
+  o30_re -= B0_im;
+  o30_im += B0_re;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re += A1_im;
+  o21_im -= A1_re;
+  o31_re -= B1_im;
+  o31_im += B1_re;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re += A2_im;
+  o22_im -= A2_re;
+  o32_re -= B2_im;
+  o32_im += B2_re;
+  
+}
+
+{
+  // Projector P3-
+  // 1 0 -1 0 
+  // 0 1 0 -1 
+  // -1 0 1 0 
+  // 0 -1 0 1 
+  
+  CPU_READ_SPINOR(6);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re - i20_re;
+  spinorFloat a0_im = i00_im - i20_im;
+  spinorFloat a1_re = i01_re - i21_re;
+  spinorFloat a1_im = i01_im - i21_im;
+  spinorFloat a2_re = i02_re - i22_re;
+  spinorFloat a2_im = i02_im - i22_im;
+  spinorFloat b0_re = i10_re - i30_re;
+  spinorFloat b0_im = i10_im - i30_im;
+  spinorFloat b1_re = i11_re - i31_re;
+  spinorFloat b1_im = i11_im - i31_im;
+  spinorFloat b2_re = i12_re - i32_re;
+  spinorFloat b2_im = i12_im - i32_im;
+  
+  CPU_READ_GAUGE(6);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fnmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g01_re, a1_re, A0_re);
+  A0_re = fnmadd(g01_im, a1_im, A0_re);
+  A0_re = fmadd(g02_re, a2_re, A0_re);
+  A0_re = fnmadd(g02_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g01_re, a1_im, A0_im);
+  A0_im = fmadd(g01_im, a1_re, A0_im);
+  A0_im = fmadd(g02_re, a2_im, A0_im);
+  A0_im = fmadd(g02_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fnmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g01_re, b1_re, B0_re);
+  B0_re = fnmadd(g01_im, b1_im, B0_re);
+  B0_re = fmadd(g02_re, b2_re, B0_re);
+  B0_re = fnmadd(g02_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g01_re, b1_im, B0_im);
+  B0_im = fmadd(g01_im, b1_re, B0_im);
+  B0_im = fmadd(g02_re, b2_im, B0_im);
+  B0_im = fmadd(g02_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g10_re * a0_re;
+  A1_re = fnmadd(g10_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fnmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g12_re, a2_re, A1_re);
+  A1_re = fnmadd(g12_im, a2_im, A1_re);
+  spinorFloat A1_im = g10_re * a0_im;
+  A1_im = fmadd(g10_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g12_re, a2_im, A1_im);
+  A1_im = fmadd(g12_im, a2_re, A1_im);
+  spinorFloat B1_re = g10_re * b0_re;
+  B1_re = fnmadd(g10_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fnmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g12_re, b2_re, B1_re);
+  B1_re = fnmadd(g12_im, b2_im, B1_re);
+  spinorFloat B1_im = g10_re * b0_im;
+  B1_im = fmadd(g10_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g12_re, b2_im, B1_im);
+  B1_im = fmadd(g12_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g20_re * a0_re;
+  A2_re = fnmadd(g20_im, a0_im, A2_re);
+  A2_re = fmadd(g21_re, a1_re, A2_re);
+  A2_re = fnmadd(g21_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fnmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g20_re * a0_im;
+  A2_im = fmadd(g20_im, a0_re, A2_im);
+  A2_im = fmadd(g21_re, a1_im, A2_im);
+  A2_im = fmadd(g21_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g20_re * b0_re;
+  B2_re = fnmadd(g20_im, b0_im, B2_re);
+  B2_re = fmadd(g21_re, b1_re, B2_re);
+  B2_re = fnmadd(g21_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fnmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g20_re * b0_im;
+  B2_im = fmadd(g20_im, b0_re, B2_im);
+  B2_im = fmadd(g21_re, b1_im, B2_im);
+  B2_im = fmadd(g21_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re -= A0_re;
+  o20_im -= A0_im;
+  o30_re -= B0_re;
+  o30_im -= B0_im;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re -= A1_re;
+  o21_im -= A1_im;
+  o31_re -= B1_re;
+  o31_im -= B1_im;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re -= A2_re;
+  o22_im -= A2_im;
+  o32_re -= B2_re;
+  o32_im -= B2_im;
+  
+}
+
+{
+  // Projector P3+
+  // 1 0 1 0 
+  // 0 1 0 1 
+  // 1 0 1 0 
+  // 0 1 0 1 
+  
+  CPU_READ_SPINOR(7);
+  
+  // project spinor into half spinors
+  spinorFloat a0_re = i00_re + i20_re;
+  spinorFloat a0_im = i00_im + i20_im;
+  spinorFloat a1_re = i01_re + i21_re;
+  spinorFloat a1_im = i01_im + i21_im;
+  spinorFloat a2_re = i02_re + i22_re;
+  spinorFloat a2_im = i02_im + i22_im;
+  spinorFloat b0_re = i10_re + i30_re;
+  spinorFloat b0_im = i10_im + i30_im;
+  spinorFloat b1_re = i11_re + i31_re;
+  spinorFloat b1_im = i11_im + i31_im;
+  spinorFloat b2_re = i12_re + i32_re;
+  spinorFloat b2_im = i12_im + i32_im;
+  
+  CPU_READ_GAUGE(7);
+  
+  // multiply row 0
+  spinorFloat A0_re = g00_re * a0_re;
+  A0_re = fmadd(g00_im, a0_im, A0_re);
+  A0_re = fmadd(g10_re, a1_re, A0_re);
+  A0_re = fmadd(g10_im, a1_im, A0_re);
+  A0_re = fmadd(g20_re, a2_re, A0_re);
+  A0_re = fmadd(g20_im, a2_im, A0_re);
+  spinorFloat A0_im = g00_re * a0_im;
+  A0_im = fnmadd(g00_im, a0_re, A0_im);
+  A0_im = fmadd(g10_re, a1_im, A0_im);
+  A0_im = fnmadd(g10_im, a1_re, A0_im);
+  A0_im = fmadd(g20_re, a2_im, A0_im);
+  A0_im = fnmadd(g20_im, a2_re, A0_im);
+  spinorFloat B0_re = g00_re * b0_re;
+  B0_re = fmadd(g00_im, b0_im, B0_re);
+  B0_re = fmadd(g10_re, b1_re, B0_re);
+  B0_re = fmadd(g10_im, b1_im, B0_re);
+  B0_re = fmadd(g20_re, b2_re, B0_re);
+  B0_re = fmadd(g20_im, b2_im, B0_re);
+  spinorFloat B0_im = g00_re * b0_im;
+  B0_im = fnmadd(g00_im, b0_re, B0_im);
+  B0_im = fmadd(g10_re, b1_im, B0_im);
+  B0_im = fnmadd(g10_im, b1_re, B0_im);
+  B0_im = fmadd(g20_re, b2_im, B0_im);
+  B0_im = fnmadd(g20_im, b2_re, B0_im);
+  
+  // multiply row 1
+  spinorFloat A1_re = g01_re * a0_re;
+  A1_re = fmadd(g01_im, a0_im, A1_re);
+  A1_re = fmadd(g11_re, a1_re, A1_re);
+  A1_re = fmadd(g11_im, a1_im, A1_re);
+  A1_re = fmadd(g21_re, a2_re, A1_re);
+  A1_re = fmadd(g21_im, a2_im, A1_re);
+  spinorFloat A1_im = g01_re * a0_im;
+  A1_im = fnmadd(g01_im, a0_re, A1_im);
+  A1_im = fmadd(g11_re, a1_im, A1_im);
+  A1_im = fnmadd(g11_im, a1_re, A1_im);
+  A1_im = fmadd(g21_re, a2_im, A1_im);
+  A1_im = fnmadd(g21_im, a2_re, A1_im);
+  spinorFloat B1_re = g01_re * b0_re;
+  B1_re = fmadd(g01_im, b0_im, B1_re);
+  B1_re = fmadd(g11_re, b1_re, B1_re);
+  B1_re = fmadd(g11_im, b1_im, B1_re);
+  B1_re = fmadd(g21_re, b2_re, B1_re);
+  B1_re = fmadd(g21_im, b2_im, B1_re);
+  spinorFloat B1_im = g01_re * b0_im;
+  B1_im = fnmadd(g01_im, b0_re, B1_im);
+  B1_im = fmadd(g11_re, b1_im, B1_im);
+  B1_im = fnmadd(g11_im, b1_re, B1_im);
+  B1_im = fmadd(g21_re, b2_im, B1_im);
+  B1_im = fnmadd(g21_im, b2_re, B1_im);
+  
+  // multiply row 2
+  spinorFloat A2_re = g02_re * a0_re;
+  A2_re = fmadd(g02_im, a0_im, A2_re);
+  A2_re = fmadd(g12_re, a1_re, A2_re);
+  A2_re = fmadd(g12_im, a1_im, A2_re);
+  A2_re = fmadd(g22_re, a2_re, A2_re);
+  A2_re = fmadd(g22_im, a2_im, A2_re);
+  spinorFloat A2_im = g02_re * a0_im;
+  A2_im = fnmadd(g02_im, a0_re, A2_im);
+  A2_im = fmadd(g12_re, a1_im, A2_im);
+  A2_im = fnmadd(g12_im, a1_re, A2_im);
+  A2_im = fmadd(g22_re, a2_im, A2_im);
+  A2_im = fnmadd(g22_im, a2_re, A2_im);
+  spinorFloat B2_re = g02_re * b0_re;
+  B2_re = fmadd(g02_im, b0_im, B2_re);
+  B2_re = fmadd(g12_re, b1_re, B2_re);
+  B2_re = fmadd(g12_im, b1_im, B2_re);
+  B2_re = fmadd(g22_re, b2_re, B2_re);
+  B2_re = fmadd(g22_im, b2_im, B2_re);
+  spinorFloat B2_im = g02_re * b0_im;
+  B2_im = fnmadd(g02_im, b0_re, B2_im);
+  B2_im = fmadd(g12_re, b1_im, B2_im);
+  B2_im = fnmadd(g12_im, b1_re, B2_im);
+  B2_im = fmadd(g22_re, b2_im, B2_im);
+  B2_im = fnmadd(g22_im, b2_re, B2_im);
+  
+  o00_re += A0_re;
+  o00_im += A0_im;
+  o10_re += B0_re;
+  o10_im += B0_im;
+  o20_re += A0_re;
+  o20_im += A0_im;
+  o30_re += B0_re;
+  o30_im += B0_im;
+  
+  o01_re += A1_re;
+  o01_im += A1_im;
+  o11_re += B1_re;
+  o11_im += B1_im;
+  o21_re += A1_re;
+  o21_im += A1_im;
+  o31_re += B1_re;
+  o31_im += B1_im;
+  
+  o02_re += A2_re;
+  o02_im += A2_im;
+  o12_re += B2_re;
+  o12_im += B2_im;
+  o22_re += A2_re;
+  o22_im += A2_im;
+  o32_re += B2_re;
+  o32_im += B2_im;
+  
+}
+
+#undef i00_re
+#undef i00_im
+#undef i01_re
+#undef i01_im
+#undef i02_re
+#undef i02_im
+#undef i10_re
+#undef i10_im
+#undef i11_re
+#undef i11_im
+#undef i12_re
+#undef i12_im
+#undef i20_re
+#undef i20_im
+#undef i21_re
+#undef i21_im
+#undef i22_re
+#undef i22_im
+#undef i30_re
+#undef i30_im
+#undef i31_re
+#undef i31_im
+#undef i32_re
+#undef i32_im
+#undef g00_re
+#undef g00_im
+#undef g01_re
+#undef g01_im
+#undef g02_re
+#undef g02_im
+#undef g10_re
+#undef g10_im
+#undef g11_re
+#undef g11_im
+#undef g12_re
+#undef g12_im
+#undef g20_re
+#undef g20_im
+#undef g21_re
+#undef g21_im
+#undef g22_re
+#undef g22_im
+#undef o00_re
+#undef o00_im
+#undef o01_re
+#undef o01_im
+#undef o02_re
+#undef o02_im
+#undef o10_re
+#undef o10_im
+#undef o11_re
+#undef o11_im
+#undef o12_re
+#undef o12_im
+#undef o20_re
+#undef o20_im
+#undef o21_re
+#undef o21_im
+#undef o22_re
+#undef o22_im
+#undef o30_re
+#undef o30_im
+#undef o31_re
+#undef o31_im
+#undef o32_re
+#undef o32_im
@@ -69,6 +69,8 @@ namespace quda {
 
   }
 
+#ifndef QUDA_HOST_ONLY
+
   /**
      Generic GPU gauge ghost extraction and packing
      NB This routines is specialized to four dimensions
@@ -173,6 +175,18 @@ namespace quda {
     } 
   };
 
+#else // QUDA_HOST_ONLY
+
+  // no kernels in the host-only library, so device ghosts cannot be extracted
+  template <typename Float, int length, int nDim, typename Order>
+  class ExtractGhost {
+  public:
+    ExtractGhost(ExtractGhostArg<Order,nDim> &arg) { ; }
+    void apply(const cudaStream_t &stream) { errorQuda("Device ghost extraction is not available in the host-only build"); }
+  };
+
+#endif // QUDA_HOST_ONLY
+
 
   /**
      Generic CPU gauge ghost extraction and packing
@@ -221,8 +235,7 @@ namespace quda {
 
     const int length = 18;
 
-    QudaFieldLocation location = 
-      (typeid(u)==typeid(cudaGaugeField)) ? QUDA_CUDA_FIELD_LOCATION : QUDA_CPU_FIELD_LOCATION;
+    QudaFieldLocation location = u.Location();
 
     if (u.Order() == QUDA_FLOAT2_GAUGE_ORDER) {
       if (u.Reconstruct() == QUDA_RECONSTRUCT_NO) {
@@ -313,6 +326,15 @@ namespace quda {
       errorQuda("BQCD interface has not been built\n");
 #endif
 
+    } else if (u.Order() == QUDA_AOSOA4_GAUGE_ORDER) {
+      extractGhost<Float,length>(AoSoAOrder<Float,length,4>(u, 0, Ghost),
+				 u.Nface(), u.SurfaceCB(), u.X(), location);
+    } else if (u.Order() == QUDA_AOSOA8_GAUGE_ORDER) {
+      extractGhost<Float,length>(AoSoAOrder<Float,length,8>(u, 0, Ghost),
+				 u.Nface(), u.SurfaceCB(), u.X(), location);
+    } else if (u.Order() == QUDA_AOSOA16_GAUGE_ORDER) {
+      extractGhost<Float,length>(AoSoAOrder<Float,length,16>(u, 0, Ghost),
+				 u.Nface(), u.SurfaceCB(), u.X(), location);
     } else {
       errorQuda("Gauge field %d order not supported", u.Order());
     }
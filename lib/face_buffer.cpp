@@ -204,6 +204,8 @@ void FaceBuffer::flushPinnedCache()
 }
 
 
+#ifndef QUDA_HOST_ONLY // the spinor halos of the device fields
+
 void FaceBuffer::pack(cudaColorSpinorField &in, int parity, int dagger, 
 		      cudaStream_t *stream_p, bool zeroCopyPack)
 {
@@ -249,6 +251,8 @@ void FaceBuffer::gather(cudaColorSpinorField &in, int dagger, int dir)
   }
 }
 
+#endif // QUDA_HOST_ONLY
+
 
 // experimenting with callbacks for GPU -> MPI interaction.
 // much slower though because callbacks are done on a background thread
@@ -350,6 +354,8 @@ int FaceBuffer::commsQuery(int dir)
 }
 
 
+#ifndef QUDA_HOST_ONLY
+
 void FaceBuffer::scatter(cudaColorSpinorField &out, int dagger, int dir)
 {
   int dim = dir/2;
@@ -363,6 +369,8 @@ void FaceBuffer::scatter(cudaColorSpinorField &out, int dagger, int dir)
   }
 }
 
+#endif // QUDA_HOST_ONLY
+
 
 // This is just an initial hack for CPU comms - should be creating the message handlers at instantiation
 void FaceBuffer::exchangeCpuSpinor(cpuColorSpinorField &spinor, int oddBit, int dagger)
@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <comm_quda.h>
+#include <gauge_force_quda.h>
+
+#include "cpu_gauge_util.h"
+
+/*
+ * Host gauge force
+ *
+ * The loops of each direction are compiled into a prefix tree before
+ * any site is touched: a node of the tree is the product of the links
+ * along a path prefix, so a prefix shared by several loops (e.g., the
+ * first links common to a plaquette staple and the rectangles and
+ * chairs that extend it) is multiplied once per site rather than once
+ * per loop.  The tree is evaluated depth first over blocks of sites,
+ * with the sites of a block innermost, so that every link product is
+ * a vectorizable loop; the blocks are threaded.
+ */
+
+namespace quda {
+
+  // sites evaluated together in one pass over a path tree
+  static const int forceBlock = 16;
+
+  /**
+     The paths of one direction compiled into a prefix tree.  Every
+     node extends the product of its parent by one link; the nodes are
+     held in depth-first order, so the product of a node's parent is
+     always the last one evaluated one level up.
+   */
+  struct PathTree {
+    struct Node {
+      int dir;       // direction of the link
+      int dagger;    // whether the link is traversed backwards
+      int offset;    // offset of the link's site from x on the extended lattice
+      int depth;     // number of links in the product, from 1
+      double coeff;  // summed coefficient of the paths ending at this node
+    };
+
+    std::vector<Node> node;
+    int maxDepth;
+
+    PathTree(int mu, int **path, const int *length, const double *coeff, int num_paths,
+	     const ExtendedLattice &lat) : maxDepth(0) {
+      // build the tree with child lists, then flatten it depth first
+      std::vector<Node> trie;
+      std::vector<std::vector<int> > child(1);
+      trie.push_back(Node());
+
+      for (int i=0; i<num_paths; i++) {
+	// the paths start at x+mu and return to x
+	int pos[4] = {0, 0, 0, 0};
+	pos[mu] = 1;
+	int n = 0;
+
+	for (int j=0; j<length[i]; j++) {
+	  const int step = path[i][j];
+	  if (step < 0 || step > 7) errorQuda("Invalid direction %d in path %d", step, i);
+	  const int forwards = (step <= 3);
+	  const int d = forwards ? step : 7 - step;
+	  if (!forwards) pos[d]--;
+
+	  int offset = 0;
+	  for (int dim=0; dim<4; dim++) {
+	    if (pos[dim] < -2 || pos[dim] > 2)
+	      errorQuda("Path %d of direction %d leaves the two-site border in dimension %d", i, mu, dim);
+	    offset += pos[dim] * lat.stride[dim];
+	  }
+	  if (forwards) pos[d]++;
+
+	  int next = -1;
+	  for (unsigned int c=0; c<child[n].size(); c++) {
+	    const Node &m = trie[child[n][c]];
+	    if (m.dir == d && m.dagger == !forwards && m.offset == offset) { next = child[n][c]; break; }
+	  }
+
+	  if (next < 0) {
+	    Node m;
+	    m.dir = d;
+	    m.dagger = !forwards;
+	    m.offset = offset;
+	    m.depth = j+1;
+	    m.coeff = 0.0;
+	    next = trie.size();
+	    trie.push_back(m);
+	    child.push_back(std::vector<int>());
+	    child[n].push_back(next);
+	  }
+	  n = next;
+	}
+	if (n == 0) errorQuda("Path %d of direction %d is empty", i, mu);
+	trie[n].coeff += coeff[i];
+      }
+
+      std::vector<int> stack(child[0].rbegin(), child[0].rend());
+      while (!stack.empty()) {
+	const int n = stack.back();
+	stack.pop_back();
+	node.push_back(trie[n]);
+	if (trie[n].depth > maxDepth) maxDepth = trie[n].depth;
+	stack.insert(stack.end(), child[n].rbegin(), child[n].rend());
+      }
+    }
+  };
+
+  // c = a * b (or a * b^dagger) for a block of links held as [18][forceBlock]
+  template <typename Float, bool dagger>
+  static inline void blockMul(Float *c, const Float *a, const Float *b) {
+    const int B = forceBlock;
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) {
+	Float *c_re = c + (6*i+2*j)*B, *c_im = c_re + B;
+	for (int s=0; s<B; s++) { c_re[s] = 0.0; c_im[s] = 0.0; }
+	for (int k=0; k<3; k++) {
+	  const Float *a_re = a + (6*i+2*k)*B, *a_im = a_re + B;
+	  const Float *b_re = b + (dagger ? 6*j+2*k : 6*k+2*j)*B, *b_im = b_re + B;
+	  for (int s=0; s<B; s++) {
+	    if (dagger) {
+	      c_re[s] += a_re[s]*b_re[s] + a_im[s]*b_im[s];
+	      c_im[s] += a_im[s]*b_re[s] - a_re[s]*b_im[s];
+	    } else {
+	      c_re[s] += a_re[s]*b_re[s] - a_im[s]*b_im[s];
+	      c_im[s] += a_re[s]*b_im[s] + a_im[s]*b_re[s];
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  // mom = ah(mom - eb3 * U * staple), with mom in the 10-real anti-Hermitian format
+  template <typename Float>
+  static inline void updateMom(Float *mom, const Float *U, const Float *staple, Float eb3) {
+    Float f[18], m[18];
+    su3MulNN(U, staple, f);
+
+    m[0] = 0.0;     m[1] = mom[6];
+    m[8] = 0.0;     m[9] = mom[7];
+    m[16] = 0.0;    m[17] = mom[8];
+    m[2] = mom[0];  m[3] = mom[1];  m[6] = -mom[0];  m[7] = mom[1];
+    m[4] = mom[2];  m[5] = mom[3];  m[12] = -mom[2]; m[13] = mom[3];
+    m[10] = mom[4]; m[11] = mom[5]; m[14] = -mom[4]; m[15] = mom[5];
+    for (int i=0; i<18; i++) m[i] -= eb3*f[i];
+
+    const Float trace = (m[1] + m[9] + m[17]) * (Float)0.33333333333333333;
+    mom[6] = m[1] - trace;
+    mom[7] = m[9] - trace;
+    mom[8] = m[17] - trace;
+    mom[0] = (m[2] - m[6])*(Float)0.5;
+    mom[2] = (m[4] - m[12])*(Float)0.5;
+    mom[4] = (m[10] - m[14])*(Float)0.5;
+    mom[1] = (m[3] + m[7])*(Float)0.5;
+    mom[3] = (m[5] + m[13])*(Float)0.5;
+    mom[5] = (m[11] + m[15])*(Float)0.5;
+  }
+
+  template <typename Float>
+  static void gaugeForceCpu(void *mom, const Float *U, const std::vector<PathTree> &tree,
+			    const int *X, Float eb3, const ExtendedLattice &lat) {
+    const int B = forceBlock;
+    const int V = X[0]*X[1]*X[2]*X[3];
+    const int nBlocks = (V + B - 1) / B;
+    int maxDepth = 0;
+    for (int mu=0; mu<4; mu++) if (tree[mu].maxDepth > maxDepth) maxDepth = tree[mu].maxDepth;
+
+#pragma omp parallel
+    {
+      // the product at each depth, the link being applied and the staple sum
+      std::vector<Float> buffer((maxDepth + 2) * 18 * B);
+      Float *prod = &buffer[0];
+      Float *link = prod + maxDepth*18*B;
+      Float *staple = link + 18*B;
+
+#pragma omp for
+      for (int b=0; b<nBlocks; b++) {
+	const int n = (V - b*B < B) ? V - b*B : B;
+	int site[forceBlock], idx[forceBlock];
+	for (int s=0; s<B; s++) {
+	  // the lanes past the end of the lattice repeat the last site
+	  int x[4], c = b*B + (s < n ? s : n-1);
+	  for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; }
+	  site[s] = (((x[3]+2)*lat.E[2] + x[2]+2)*lat.E[1] + x[1]+2)*lat.E[0] + x[0]+2;
+	  idx[s] = cbIndex(x, X);
+	}
+
+	for (int mu=0; mu<4; mu++) {
+	  for (int i=0; i<18*B; i++) staple[i] = 0.0;
+
+	  for (unsigned int k=0; k<tree[mu].node.size(); k++) {
+	    const PathTree::Node &node = tree[mu].node[k];
+	    Float *p = prod + (node.depth-1)*18*B;
+
+	    if (node.depth == 1) {
+	      for (int s=0; s<B; s++) {
+		const Float *l = U + ((site[s] + node.offset)*4 + node.dir)*18;
+		if (node.dagger) {
+		  for (int i=0; i<3; i++)
+		    for (int j=0; j<3; j++) {
+		      p[(6*i+2*j+0)*B+s] = l[6*j+2*i+0];
+		      p[(6*i+2*j+1)*B+s] = -l[6*j+2*i+1];
+		    }
+		} else {
+		  for (int i=0; i<18; i++) p[i*B+s] = l[i];
+		}
+	      }
+	    } else {
+	      for (int s=0; s<B; s++) {
+		const Float *l = U + ((site[s] + node.offset)*4 + node.dir)*18;
+		for (int i=0; i<18; i++) link[i*B+s] = l[i];
+	      }
+	      if (node.dagger) blockMul<Float,true>(p, p - 18*B, link);
+	      else blockMul<Float,false>(p, p - 18*B, link);
+	    }
+
+	    if (node.coeff != 0.0) {
+	      const Float coeff = node.coeff;
+	      for (int i=0; i<18*B; i++) staple[i] += coeff*p[i];
+	    }
+	  }
+
+	  for (int s=0; s<n; s++) {
+	    Float st[18];
+	    for (int i=0; i<18; i++) st[i] = staple[i*B+s];
+	    updateMom((Float*)mom + (idx[s]*4+mu)*10, U + (site[s]*4+mu)*18, st, eb3);
+	  }
+	}
+      }
+    }
+  }
+
+  void gaugeForceCpu(cpuGaugeField &mom, double eb3, cpuGaugeField &sitelink, int ***input_path,
+		     const int *length, const void *path_coeff, int num_paths)
+  {
+    QUDA_PERF_SCOPE("gaugeForceCpu");
+    const int *X = mom.X();
+    bool extended = true;
+    for (int d=0; d<4; d++) {
+      if (sitelink.X()[d] == X[d]) extended = false;
+      else if (sitelink.X()[d] != X[d] + 4)
+	errorQuda("Site links must be on the local or the extended lattice (X[%d] = %d)", d, sitelink.X()[d]);
+    }
+    if (!extended && comm_size() > 1)
+      errorQuda("Site links must be extended by 2 sites in each direction when running on more than one process");
+    if (mom.Order() != QUDA_MILC_GAUGE_ORDER) errorQuda("Host momentum must be in MILC order");
+    if (sitelink.Order() != QUDA_QDP_GAUGE_ORDER && sitelink.Order() != QUDA_MILC_GAUGE_ORDER)
+      errorQuda("Site link order %d not supported", sitelink.Order());
+    if (sitelink.Precision() != mom.Precision())
+      errorQuda("Mixed precision gauge force not supported");
+
+    const ExtendedLattice lat(X);
+    std::vector<double> coeff(num_paths);
+    for (int i=0; i<num_paths; i++)
+      coeff[i] = (mom.Precision() == QUDA_DOUBLE_PRECISION) ?
+	((const double*)path_coeff)[i] : ((const float*)path_coeff)[i];
+
+    std::vector<PathTree> tree;
+    int links = 0, products = 0;
+    for (int mu=0; mu<4; mu++) {
+      tree.push_back(PathTree(mu, input_path[mu], length, &coeff[0], num_paths, lat));
+      for (int i=0; i<num_paths; i++) links += length[i];
+      products += tree[mu].node.size();
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Gauge force (host): %d path links compiled to %d link products per site\n", links, products);
+
+    if (mom.Precision() == QUDA_DOUBLE_PRECISION) {
+      double *U = (double*)safe_malloc(4*(size_t)lat.volume*18*sizeof(double));
+      packExtendedLinks(U, sitelink.Gauge_p(), sitelink.Order(), X, extended, lat);
+      gaugeForceCpu<double>(mom.Gauge_p(), U, tree, X, eb3, lat);
+      host_free(U);
+    } else if (mom.Precision() == QUDA_SINGLE_PRECISION) {
+      float *U = (float*)safe_malloc(4*(size_t)lat.volume*18*sizeof(float));
+      packExtendedLinks(U, sitelink.Gauge_p(), sitelink.Order(), X, extended, lat);
+      gaugeForceCpu<float>(mom.Gauge_p(), U, tree, X, eb3, lat);
+      host_free(U);
+    } else {
+      errorQuda("Precision %d not supported", mom.Precision());
+    }
+  }
+
+} // namespace quda
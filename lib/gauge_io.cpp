@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <gauge_io.h>
+
+#include "cpu_gauge_util.h"
+#include "lime_util.h"
+
+/*
+ * Native gauge configuration reader
+ *
+ * The file is memory-mapped by every rank and each rank reads the
+ * sites of its own sub-volume straight from the mapping, threaded
+ * over the local sites, converting byte order and precision on the
+ * fly.  The checksums are accumulated in the same pass: per thread,
+ * then over the ranks.  All three formats store the links of a site
+ * contiguously, sites in lexicographic order with x running fastest
+ * and the four directions in the order x, y, z, t.
+ *
+ *   NERSC  ASCII header, 3x2 or 3x3 links, 32 or 64 bit, either byte
+ *          order.  CHECKSUM is the 32-bit sum of the data words.
+ *   MILC   binary header (magic number 20103), 3x3 single-precision
+ *          links in natural order, sum29/sum31 checksum.
+ *   LIME   ILDG or SciDAC records, 3x3 big-endian links, SciDAC
+ *          (crc32 based) checksum record.
+ */
+
+namespace quda {
+
+  enum GaugeChecksum {
+    GAUGE_CHECKSUM_NONE,
+    GAUGE_CHECKSUM_NERSC,
+    GAUGE_CHECKSUM_MILC,
+    GAUGE_CHECKSUM_SCIDAC
+  };
+
+  struct GaugeFile {
+    const char *format;
+    int dims[4];          // global dimensions
+    size_t offset;        // byte offset of the site data
+    size_t length;        // bytes of site data (0 if not known from the file)
+    int precision;        // bytes per real, 4 or 8 (0 if not known yet)
+    int rows;             // rows stored per link, 2 or 3
+    bool bigEndian;
+    GaugeChecksum checksum;
+    unsigned int sum[2];  // checksum from the file
+    bool hasTrace;
+    double linkTrace;     // NERSC LINK_TRACE
+
+    GaugeFile() : format(""), offset(0), length(0), precision(0), rows(3), bigEndian(true),
+		  checksum(GAUGE_CHECKSUM_NONE), hasTrace(false), linkTrace(0.0) {
+      for (int d=0; d<4; d++) dims[d] = 0;
+      sum[0] = sum[1] = 0;
+    }
+
+    size_t siteBytes() const { return (size_t)4*rows*6*precision; }
+  };
+
+  // value of <tag>...</tag> in an XML record, empty if absent
+  static std::string xmlValue(const std::string &xml, const char *tag) {
+    const std::string open = std::string("<") + tag + ">";
+    const size_t b = xml.find(open);
+    if (b == std::string::npos) return "";
+    const size_t e = xml.find('<', b + open.size());
+    return xml.substr(b + open.size(), e == std::string::npos ? std::string::npos : e - b - open.size());
+  }
+
+  static bool parseNersc(const char *map, size_t size, GaugeFile &f) {
+    const char begin[] = "BEGIN_HEADER";
+    if (size < sizeof(begin) || strncmp(map, begin, sizeof(begin)-1)) return false;
+
+    const std::string header(map, size < 65536 ? size : 65536);
+    const size_t end = header.find("END_HEADER");
+    if (end == std::string::npos) errorQuda("NERSC header is not terminated");
+    const size_t eol = header.find('\n', end);
+    if (eol == std::string::npos) errorQuda("NERSC header is not terminated");
+    f.format = "NERSC";
+    f.offset = eol + 1;
+
+    std::string datatype, fp;
+    bool hasChecksum = false;
+    size_t pos = 0;
+    while (pos < end) {
+      size_t next = header.find('\n', pos);
+      if (next == std::string::npos) next = end;
+      const std::string line = header.substr(pos, next - pos);
+      pos = next + 1;
+
+      char key[64], val[256];
+      if (sscanf(line.c_str(), " %63[^= ] = %255s", key, val) != 2) continue;
+      if (!strcmp(key, "DATATYPE")) datatype = val;
+      else if (!strcmp(key, "FLOATING_POINT")) fp = val;
+      else if (!strcmp(key, "CHECKSUM")) { f.sum[0] = strtoul(val, 0, 16); hasChecksum = true; }
+      else if (!strcmp(key, "LINK_TRACE")) { f.linkTrace = atof(val); f.hasTrace = true; }
+      else if (!strncmp(key, "DIMENSION_", 10)) {
+	const int d = atoi(key + 10) - 1;
+	if (d >= 0 && d < 4) f.dims[d] = atoi(val);
+      }
+    }
+
+    if (datatype == "4D_SU3_GAUGE") f.rows = 2;
+    else if (datatype == "4D_SU3_GAUGE_3x3") f.rows = 3;
+    else errorQuda("NERSC DATATYPE %s not supported", datatype.c_str());
+
+    if (fp == "IEEE32" || fp == "IEEE32BIG") { f.precision = 4; f.bigEndian = true; }
+    else if (fp == "IEEE32LITTLE") { f.precision = 4; f.bigEndian = false; }
+    else if (fp == "IEEE64BIG") { f.precision = 8; f.bigEndian = true; }
+    else if (fp == "IEEE64LITTLE") { f.precision = 8; f.bigEndian = false; }
+    else errorQuda("NERSC FLOATING_POINT %s not supported", fp.c_str());
+
+    if (hasChecksum) f.checksum = GAUGE_CHECKSUM_NERSC;
+    return true;
+  }
+
+  static bool parseMilc(const char *map, size_t size, GaugeFile &f) {
+    const unsigned int milcMagic = 20103;
+    // magic, dims[4], time stamp[64], order, sum29, sum31
+    const size_t headerBytes = 4 + 16 + 64 + 4 + 8;
+    if (size < headerBytes) return false;
+
+    unsigned int w[5];
+    memcpy(w, map, sizeof(w));
+    bool swap;
+    if (w[0] == milcMagic) swap = false;
+    else if (swap32(w[0]) == milcMagic) swap = true;
+    else return false;
+
+    f.format = "MILC";
+    for (int d=0; d<4; d++) f.dims[d] = swap ? swap32(w[1+d]) : w[1+d];
+
+    unsigned int order, sum[2];
+    memcpy(&order, map + 84, 4);
+    memcpy(sum, map + 88, 8);
+    if (swap) {
+      order = swap32(order);
+      for (int i=0; i<2; i++) sum[i] = swap32(sum[i]);
+    }
+    if (order != 0) errorQuda("MILC files with a site list (order %u) are not supported", order);
+
+    f.offset = headerBytes;
+    f.precision = 4;
+    f.rows = 3;
+    f.bigEndian = (hostBigEndian() != swap);
+    f.checksum = GAUGE_CHECKSUM_MILC;
+    f.sum[0] = sum[0];
+    f.sum[1] = sum[1];
+    return true;
+  }
+
+  static bool parseLime(const char *map, size_t size, GaugeFile &f) {
+    const size_t recordHeader = limeHeaderBytes;
+    if (size < recordHeader || readBE32(map) != limeMagic) return false;
+
+    f.format = "LIME";
+    f.rows = 3;
+    f.bigEndian = true;
+    bool data = false;
+
+    size_t pos = 0;
+    while (pos + recordHeader <= size) {
+      if (readBE32(map + pos) != limeMagic) errorQuda("Corrupt LIME record at byte %lu", (unsigned long)pos);
+      const size_t length = readBE64(map + pos + 8);
+      char type[129];
+      memcpy(type, map + pos + 16, 128);
+      type[128] = '\0';
+      const size_t body = pos + recordHeader;
+      if (body + length > size) errorQuda("LIME record %s is truncated", type);
+      const std::string xml(map + body, (!strcmp(type, "ildg-binary-data") || !strcmp(type, "scidac-binary-data")) ? 0 : length);
+
+      if (!strcmp(type, "ildg-format")) {
+	f.format = "ILDG";
+	const char *tag[4] = { "lx", "ly", "lz", "lt" };
+	for (int d=0; d<4; d++) {
+	  const std::string v = xmlValue(xml, tag[d]);
+	  if (!v.empty()) f.dims[d] = atoi(v.c_str());
+	}
+	const std::string p = xmlValue(xml, "precision");
+	if (!p.empty()) f.precision = atoi(p.c_str()) / 8;
+      } else if (!strcmp(type, "scidac-private-file-xml")) {
+	const std::string v = xmlValue(xml, "dims");
+	int x[4];
+	if (!f.dims[0] && sscanf(v.c_str(), "%d %d %d %d", x, x+1, x+2, x+3) == 4)
+	  for (int d=0; d<4; d++) f.dims[d] = x[d];
+      } else if (!strcmp(type, "scidac-private-record-xml")) {
+	const std::string p = xmlValue(xml, "precision");
+	if (!f.precision && p == "F") f.precision = 4;
+	if (!f.precision && p == "D") f.precision = 8;
+      } else if (!strcmp(type, "scidac-checksum")) {
+	f.sum[0] = strtoul(xmlValue(xml, "suma").c_str(), 0, 16);
+	f.sum[1] = strtoul(xmlValue(xml, "sumb").c_str(), 0, 16);
+	f.checksum = GAUGE_CHECKSUM_SCIDAC;
+      } else if (!data && (!strcmp(type, "ildg-binary-data") || !strcmp(type, "scidac-binary-data"))) {
+	f.offset = body;
+	f.length = length;
+	data = true;
+      }
+
+      pos = body + limePadded(length);
+    }
+
+    if (!data) errorQuda("No binary data record found in LIME file");
+    return true;
+  }
+
+  /**
+     Read the local sites from the mapped data and accumulate the
+     checksums.  The checksum words are the data as stored, in host
+     byte order; the NERSC sum is also formed over the completed 3x3
+     links (sum[2]), since writers of the 3x2 format differ on this.
+   */
+  template <typename Out, typename In>
+  static void readSites(void *gauge, QudaGaugeFieldOrder order, const char *data, const GaugeFile &f,
+			const int *X, const int *offset, unsigned int sum[3], double &trace) {
+    const bool swap = (f.bigEndian != hostBigEndian());
+    const size_t siteBytes = f.siteBytes();
+    const int reals = 6*f.rows;
+    const int words = (int)(siteBytes / 4);
+    const int V = X[0]*X[1]*X[2]*X[3];
+
+    unsigned int s0 = 0, s1 = 0; // MILC and SciDAC checksums, combined by xor
+    unsigned int n0 = 0, n2 = 0; // NERSC sums of the stored words and of the 3x3 links
+    double tr = 0.0;
+
+#pragma omp parallel for reduction(^:s0,s1) reduction(+:n0,n2,tr)
+    for (int s=0; s<V; s++) {
+      int x[4], g[4], c = s;
+      for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; g[d] = x[d] + offset[d]; }
+      const size_t r = (((size_t)g[3]*f.dims[2] + g[2])*f.dims[1] + g[1])*f.dims[0] + g[0];
+      const char *src = data + r*siteBytes;
+
+      In link[4][18];
+      for (int d=0; d<4; d++) {
+	In *u = link[d];
+	for (int i=0; i<reals; i++) {
+	  char b[sizeof(In)];
+	  memcpy(b, src + (d*reals + i)*sizeof(In), sizeof(In));
+	  if (swap) for (size_t k=0; k<sizeof(In)/2; k++) { char t = b[k]; b[k] = b[sizeof(In)-1-k]; b[sizeof(In)-1-k] = t; }
+	  memcpy(u + i, b, sizeof(In));
+	}
+	// third row = (row 1 x row 2)^*
+	if (f.rows == 2) {
+	  for (int k=0; k<3; k++) {
+	    const int i = 2*((k+1)%3), j = 2*((k+2)%3);
+	    u[12+2*k+0] = u[i]*u[6+j] - u[i+1]*u[6+j+1] - u[j]*u[6+i] + u[j+1]*u[6+i+1];
+	    u[12+2*k+1] = -(u[i]*u[6+j+1] + u[i+1]*u[6+j] - u[j]*u[6+i+1] - u[j+1]*u[6+i]);
+	  }
+	}
+	tr += u[0] + u[8] + u[16];
+
+	Out *out = hostLink<Out>(gauge, order, cbIndex(x, X), d);
+	for (int i=0; i<18; i++) out[i] = u[i];
+      }
+
+      switch (f.checksum) {
+      case GAUGE_CHECKSUM_NERSC:
+	for (int d=0; d<4; d++) {
+	  const unsigned int *w = (const unsigned int*)link[d];
+	  const int n = reals*sizeof(In)/4;
+	  for (int k=0; k<n; k++) n0 += w[k];
+	  for (int k=0; k<(int)(18*sizeof(In)/4); k++) n2 += w[k];
+	}
+	break;
+      case GAUGE_CHECKSUM_MILC:
+	for (int d=0, k=0; d<4; d++) {
+	  const unsigned int *w = (const unsigned int*)link[d];
+	  for (int i=0; i<(int)(reals*sizeof(In)/4); i++, k++) {
+	    const size_t idx = r*words + k;
+	    s0 ^= rotl(w[i], idx % 29);
+	    s1 ^= rotl(w[i], idx % 31);
+	  }
+	}
+	break;
+      case GAUGE_CHECKSUM_SCIDAC:
+	{
+	  unsigned int t[2] = { 0, 0 };
+	  scidacChecksum(t, src, siteBytes, r);
+	  s0 ^= t[0];
+	  s1 ^= t[1];
+	}
+	break;
+      default:
+	break;
+      }
+    }
+
+    sum[0] = (f.checksum == GAUGE_CHECKSUM_NERSC) ? n0 : s0;
+    sum[1] = s1;
+    sum[2] = n2;
+    trace = tr;
+  }
+
+  void readGaugeFile(void *gauge, const char *filename, QudaGaugeFieldOrder order,
+		     QudaPrecision precision, const int *X)
+  {
+    if (order != QUDA_QDP_GAUGE_ORDER && order != QUDA_MILC_GAUGE_ORDER)
+      errorQuda("Gauge order %d not supported", order);
+    if (precision != QUDA_DOUBLE_PRECISION && precision != QUDA_SINGLE_PRECISION)
+      errorQuda("Precision %d not supported", precision);
+
+    Timer timer;
+    timer.Start();
+
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0) errorQuda("Cannot open gauge file %s", filename);
+    struct stat st;
+    if (fstat(fd, &st)) errorQuda("Cannot stat gauge file %s", filename);
+    const size_t size = st.st_size;
+    char *map = (char*)mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) errorQuda("Cannot map gauge file %s", filename);
+    close(fd);
+
+    GaugeFile f;
+    if (!parseNersc(map, size, f) && !parseMilc(map, size, f) && !parseLime(map, size, f))
+      errorQuda("Format of gauge file %s not recognized", filename);
+
+    size_t volume = 1;
+    int offset[4];
+    for (int d=0; d<4; d++) {
+      if (f.dims[d] != X[d]*comm_dim(d))
+	errorQuda("%s lattice dimension %d = %d does not match %d x %d", f.format, d, f.dims[d], X[d], comm_dim(d));
+      offset[d] = comm_coord(d)*X[d];
+      volume *= f.dims[d];
+    }
+    if (!f.precision && f.length) f.precision = f.length / (volume*4*18);
+    if (f.precision != 4 && f.precision != 8) errorQuda("%s data precision could not be determined", f.format);
+    if (f.length && f.length != volume*f.siteBytes())
+      errorQuda("%s data record has %lu bytes, expected %lu", f.format, (unsigned long)f.length,
+		(unsigned long)(volume*f.siteBytes()));
+    if (f.offset + volume*f.siteBytes() > size) errorQuda("Gauge file %s is truncated", filename);
+
+    // prefetch the range holding this rank's sites
+    {
+      const size_t page = sysconf(_SC_PAGESIZE);
+      const size_t first = f.offset + ((((size_t)offset[3]*f.dims[2] + offset[2])*f.dims[1] + offset[1])*f.dims[0]
+				       + offset[0])*f.siteBytes();
+      const size_t last = f.offset + ((((size_t)(offset[3]+X[3]-1)*f.dims[2] + offset[2]+X[2]-1)*f.dims[1]
+				       + offset[1]+X[1]-1)*f.dims[0] + offset[0]+X[0])*f.siteBytes();
+      const size_t begin = first / page * page;
+      madvise(map + begin, last - begin, MADV_WILLNEED);
+    }
+
+    initCrcTable();
+    unsigned int sum[3];
+    double trace;
+    const char *data = map + f.offset;
+    if (precision == QUDA_DOUBLE_PRECISION) {
+      if (f.precision == 8) readSites<double,double>(gauge, order, data, f, X, offset, sum, trace);
+      else readSites<double,float>(gauge, order, data, f, X, offset, sum, trace);
+    } else {
+      if (f.precision == 8) readSites<float,double>(gauge, order, data, f, X, offset, sum, trace);
+      else readSites<float,float>(gauge, order, data, f, X, offset, sum, trace);
+    }
+    munmap(map, size);
+
+    switch (f.checksum) {
+    case GAUGE_CHECKSUM_NERSC:
+      sum[0] = reduceWord(sum[0], false);
+      sum[2] = reduceWord(sum[2], false);
+      if (sum[0] != f.sum[0] && sum[2] != f.sum[0])
+	errorQuda("NERSC checksum mismatch in %s: file %x, computed %x", filename, f.sum[0], sum[0]);
+      break;
+    case GAUGE_CHECKSUM_MILC:
+    case GAUGE_CHECKSUM_SCIDAC:
+      sum[0] = reduceWord(sum[0], true);
+      sum[1] = reduceWord(sum[1], true);
+      if (sum[0] != f.sum[0] || sum[1] != f.sum[1])
+	errorQuda("%s checksum mismatch in %s: file %x %x, computed %x %x", f.checksum == GAUGE_CHECKSUM_MILC ?
+		  "MILC" : "SciDAC", filename, f.sum[0], f.sum[1], sum[0], sum[1]);
+      break;
+    default:
+      if (getVerbosity() >= QUDA_SUMMARIZE) warningQuda("Gauge file %s has no checksum", filename);
+    }
+
+    if (f.hasTrace) {
+      comm_allreduce(&trace);
+      trace /= 3.0*4.0*volume;
+      if (fabs(trace - f.linkTrace) > 1e-6*(fabs(f.linkTrace) + 1.0))
+	errorQuda("NERSC link trace mismatch in %s: header %e, computed %e", filename, f.linkTrace, trace);
+    }
+
+    timer.Stop();
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Read %s gauge field %s (%dx%dx%dx%d, %d bit) in %g secs\n", f.format, filename,
+		 f.dims[0], f.dims[1], f.dims[2], f.dims[3], 8*f.precision, timer.Last());
+  }
+
+} // namespace quda
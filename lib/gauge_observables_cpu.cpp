@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <comm_quda.h>
+#include <gauge_observables.h>
+
+#include "cpu_gauge_util.h"
+#include "lime_util.h"
+
+/*
+ * Host gauge observables
+ *
+ * The loops are formed on a copy of the links on the lattice extended
+ * by two sites in every direction, with the border filled from the
+ * neighboring processes, so that every local site sees its forward
+ * neighbors (up to x+2mu+nu for the rectangles) at a fixed offset.
+ * The Polyakov loop is formed per process along t and the partial
+ * products are then combined around the ring of processes in t.  The
+ * checksums are taken in the same pass over the original field.
+ */
+
+namespace quda {
+
+  // Re tr(a b^dagger)
+  template <typename Float>
+  static inline double reTraceNA(const Float *a, const Float *b) {
+    double t = 0.0;
+    for (int i=0; i<18; i++) t += a[i]*b[i];
+    return t;
+  }
+
+  template <typename Float>
+  static void loopSums(double plaq[2], double rect[2], double &trace, const Float *U,
+		       const ExtendedLattice &lat, int V) {
+    double ps = 0.0, pt = 0.0, rs = 0.0, rt = 0.0, tr = 0.0;
+
+#pragma omp parallel for reduction(+:ps,pt,rs,rt,tr)
+    for (int n=0; n<V; n++) {
+      const int s = lat.boxSite(n, 2);
+      Float a[18], b[18], c[18], e[18];
+
+      for (int mu=0; mu<4; mu++) {
+	const Float *Umu = U + ((size_t)s*4 + mu)*18;
+	tr += Umu[0] + Umu[8] + Umu[16];
+
+	for (int nu=0; nu<4; nu++) {
+	  if (nu == mu) continue;
+	  const Float *Unu = U + ((size_t)s*4 + nu)*18;
+	  const Float *Umu_xmu = U + ((size_t)(s + lat.stride[mu])*4 + mu)*18;
+	  const Float *Unu_xmu = U + ((size_t)(s + lat.stride[mu])*4 + nu)*18;
+	  const Float *Umu_xnu = U + ((size_t)(s + lat.stride[nu])*4 + mu)*18;
+
+	  // U_mu(x) U_nu(x+mu) U_mu(x+nu)^dag U_nu(x)^dag
+	  if (mu < nu) {
+	    su3MulNN(Umu, Unu_xmu, a);
+	    su3MulNN(Unu, Umu_xnu, b);
+	    if (nu == 3) pt += reTraceNA(a, b);
+	    else ps += reTraceNA(a, b);
+	  }
+
+	  // the 2x1 rectangle, long in mu
+	  su3MulNN(Umu, Umu_xmu, a);
+	  su3MulNN(a, U + ((size_t)(s + 2*lat.stride[mu])*4 + nu)*18, c);
+	  su3MulNN(Unu, Umu_xnu, b);
+	  su3MulNN(b, U + ((size_t)(s + lat.stride[mu] + lat.stride[nu])*4 + mu)*18, e);
+	  if (mu == 3 || nu == 3) rt += reTraceNA(c, e);
+	  else rs += reTraceNA(c, e);
+	}
+      }
+    }
+
+    plaq[0] = ps; plaq[1] = pt;
+    rect[0] = rs; rect[1] = rt;
+    trace = tr;
+  }
+
+  template <typename Float>
+  static void polyakovSum(double poly[2], const Float *U, const ExtendedLattice &lat, const int *X) {
+    const int Vs = X[0]*X[1]*X[2];
+    std::vector<double> P((size_t)Vs*18);
+
+#pragma omp parallel for
+    for (int n=0; n<Vs; n++) {
+      double p[18], q[18], u[18];
+      for (int i=0; i<18; i++) p[i] = (i == 0 || i == 8 || i == 16) ? 1.0 : 0.0;
+      const int x0 = n % X[0] + 2, x1 = (n / X[0]) % X[1] + 2, x2 = n / (X[0]*X[1]) + 2;
+      for (int t=0; t<X[3]; t++) {
+	const int s = (((t+2)*lat.E[2] + x2)*lat.E[1] + x1)*lat.E[0] + x0;
+	for (int i=0; i<18; i++) u[i] = U[((size_t)s*4 + 3)*18 + i];
+	su3MulNN(p, u, q);
+	memcpy(p, q, sizeof(p));
+      }
+      memcpy(&P[(size_t)n*18], p, sizeof(p));
+    }
+
+    // With t partitioned, the partial products R are passed backwards
+    // around the ring; after the last step each process holds a cyclic
+    // permutation of the full loop, which has the same trace.
+    if (comm_dim_partitioned(3)) {
+      const size_t bytes = (size_t)Vs*18*sizeof(double);
+      std::vector<double> R(P), recv((size_t)Vs*18);
+      for (int step=1; step<comm_dim(3); step++) {
+	MsgHandle *mh_send = comm_declare_send_relative(&R[0], 3, -1, bytes);
+	MsgHandle *mh_recv = comm_declare_receive_relative(&recv[0], 3, +1, bytes);
+	comm_start(mh_recv);
+	comm_start(mh_send);
+	comm_wait(mh_send);
+	comm_wait(mh_recv);
+	comm_free(mh_send);
+	comm_free(mh_recv);
+	R.swap(recv);
+
+#pragma omp parallel for
+	for (int n=0; n<Vs; n++) {
+	  double q[18];
+	  su3MulNN(&P[(size_t)n*18], &R[(size_t)n*18], q);
+	  memcpy(&P[(size_t)n*18], q, sizeof(q));
+	}
+      }
+    }
+
+    double re = 0.0, im = 0.0;
+#pragma omp parallel for reduction(+:re,im)
+    for (int n=0; n<Vs; n++) {
+      const double *p = &P[(size_t)n*18];
+      re += p[0] + p[8] + p[16];
+      im += p[1] + p[9] + p[17];
+    }
+    poly[0] = re; poly[1] = im;
+  }
+
+  template <typename Float>
+  static void checksums(unsigned int &nersc, unsigned int scidac[2], const void *gauge,
+			QudaGaugeFieldOrder order, const int *X) {
+    initCrcTable();
+
+    int dims[4], offset[4];
+    for (int d=0; d<4; d++) {
+      dims[d] = X[d]*comm_dim(d);
+      offset[d] = X[d]*comm_coord(d);
+    }
+    const int V = X[0]*X[1]*X[2]*X[3];
+    const int words = sizeof(Float)/4;
+
+    unsigned int sum = 0, suma = 0, sumb = 0;
+
+#pragma omp parallel for reduction(+:sum) reduction(^:suma,sumb)
+    for (int n=0; n<V; n++) {
+      int x[4], c = n;
+      for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; }
+      const size_t r = (((size_t)(x[3]+offset[3])*dims[2] + x[2]+offset[2])*dims[1] + x[1]+offset[1])*dims[0]
+	+ x[0]+offset[0];
+      const int idx = cbIndex(x, X);
+
+      char site[4*18*sizeof(Float)];
+      for (int d=0; d<4; d++) {
+	const Float *u = hostLink<Float>(const_cast<void*>(gauge), order, idx, d);
+	for (int i=0; i<18; i++) {
+	  unsigned int w[sizeof(Float)/4];
+	  memcpy(w, u + i, sizeof(Float));
+	  for (int k=0; k<words; k++) sum += w[k];
+	  putBE(site + (d*18 + i)*sizeof(Float), u[i]);
+	}
+      }
+
+      unsigned int t[2] = { 0, 0 };
+      scidacChecksum(t, site, sizeof(site), r);
+      suma ^= t[0];
+      sumb ^= t[1];
+    }
+
+    nersc = reduceWord(sum, false);
+    scidac[0] = reduceWord(suma, true);
+    scidac[1] = reduceWord(sumb, true);
+  }
+
+  template <typename Float>
+  static void gaugeObservablesCpu(QudaGaugeObservables &obs, const void *gauge, QudaGaugeFieldOrder order,
+				  const int *X) {
+    const ExtendedLattice lat(X);
+    const int V = X[0]*X[1]*X[2]*X[3];
+
+    Float *U = (Float*)safe_malloc(4*(size_t)lat.volume*18*sizeof(Float));
+    packExtendedLinks(U, const_cast<void*>(gauge), order, X, false, lat);
+    exchangeExtendedLinks(U, X, lat);
+
+    double sum[8];
+    loopSums(sum, sum+2, sum[4], U, lat, V);
+    polyakovSum(sum+5, U, lat, X);
+    sum[7] = 0.0;
+    comm_allreduce_array(sum, 8);
+
+    const double volume = (double)V*comm_size();
+    obs.plaquette[1] = sum[0] / (3.0*3*volume);
+    obs.plaquette[2] = sum[1] / (3.0*3*volume);
+    obs.plaquette[0] = 0.5*(obs.plaquette[1] + obs.plaquette[2]);
+    obs.rectangle[1] = sum[2] / (3.0*6*volume);
+    obs.rectangle[2] = sum[3] / (3.0*6*volume);
+    obs.rectangle[0] = 0.5*(obs.rectangle[1] + obs.rectangle[2]);
+    obs.link_trace = sum[4] / (3.0*4*volume);
+    // every process along t holds the loops of its spatial sites
+    const double spatial = (double)X[0]*X[1]*X[2]*comm_size();
+    obs.polyakov[0] = sum[5] / (3.0*spatial);
+    obs.polyakov[1] = sum[6] / (3.0*spatial);
+
+    host_free(U);
+
+    checksums<Float>(obs.nersc_checksum, obs.scidac_checksum, gauge, order, X);
+  }
+
+  void gaugeObservablesCpu(QudaGaugeObservables &obs, const void *gauge, QudaGaugeFieldOrder order,
+			   QudaPrecision precision, const int *X)
+  {
+    QUDA_PERF_SCOPE("gaugeObservablesCpu");
+    if (order != QUDA_QDP_GAUGE_ORDER && order != QUDA_MILC_GAUGE_ORDER)
+      errorQuda("Gauge order %d not supported", order);
+    for (int d=0; d<4; d++)
+      if (X[d] < 2 || X[d] % 2) errorQuda("Local dimension X[%d] = %d must be even and at least 2", d, X[d]);
+
+    if (precision == QUDA_DOUBLE_PRECISION) gaugeObservablesCpu<double>(obs, gauge, order, X);
+    else if (precision == QUDA_SINGLE_PRECISION) gaugeObservablesCpu<float>(obs, gauge, order, X);
+    else errorQuda("Precision %d not supported", precision);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Gauge observables: plaquette = %.12f (%.12f, %.12f), rectangle = %.12f, "
+		 "Polyakov loop = (%.12f, %.12f), link trace = %.12f\n",
+		 obs.plaquette[0], obs.plaquette[1], obs.plaquette[2], obs.rectangle[0],
+		 obs.polyakov[0], obs.polyakov[1], obs.link_trace);
+  }
+
+  void gaugeObservablesCpu(QudaGaugeObservables &obs, const cpuGaugeField &u)
+  {
+    if (u.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Reconstruct type %d not supported", u.Reconstruct());
+    if (u.Geometry() != QUDA_VECTOR_GEOMETRY) errorQuda("Gauge geometry %d not supported", u.Geometry());
+    gaugeObservablesCpu(obs, u.Gauge_p(), u.Order(), u.Precision(), u.X());
+  }
+
+} // namespace quda
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <gauge_smear.h>
+
+#include "cpu_gauge_util.h"
+
+/*
+ * Host gauge smearing
+ *
+ * As for the link fattening, the links are held on the lattice
+ * extended by two sites in every direction, so that the staples of
+ * every local site are found at fixed offsets.  A step computes the
+ * new links of the local sites into a local work field, which is then
+ * copied back over the local sites of the extended field before its
+ * border is refilled from the neighboring processes.  The HYP levels
+ * are held in the same way, with 16 links per site indexed by the
+ * link direction and the decorating direction.  All work fields are
+ * allocated once for all the steps.
+ */
+
+namespace quda {
+
+  template <typename Float>
+  static inline const Float* link(const Float *U, int s, int nLinks, int l) {
+    return U + ((size_t)s*nLinks + l)*18;
+  }
+
+  // s += a b c^dag (upper staple) or a^dag b c (lower staple)
+  template <typename Float>
+  static inline void addStaple(double *s, const Float *a, const Float *b, const Float *c, bool lower) {
+    double A[18], B[18], C[18], t[18], r[18];
+    for (int i=0; i<18; i++) { A[i] = a[i]; B[i] = b[i]; C[i] = c[i]; }
+    if (lower) {
+      su3MulAN(A, B, t);
+      su3MulNN(t, C, r);
+    } else {
+      su3MulNN(A, B, t);
+      su3MulNA(t, C, r);
+    }
+    for (int i=0; i<18; i++) s[i] += r[i];
+  }
+
+  /**
+     Add the two staples in the (mu,nu) plane of the mu link at x,
+     with the nu links taken from link nuLink and the mu links from
+     link muLink of fields with nLinks links per site.
+   */
+  template <typename Float>
+  static inline void stapleSum(double *S, const Float *N, int nuLink, const Float *M, int muLink, int nLinks,
+			       int x, int mu, int nu, const ExtendedLattice &lat) {
+    const int fmu = lat.stride[mu], fnu = lat.stride[nu], y = x - fnu;
+    addStaple(S, link(N, x, nLinks, nuLink), link(M, x+fnu, nLinks, muLink), link(N, x+fmu, nLinks, nuLink), false);
+    addStaple(S, link(N, y, nLinks, nuLink), link(M, y, nLinks, muLink), link(N, y+fmu, nLinks, nuLink), true);
+  }
+
+  // V = Proj_SU(3)[(1-alpha) U + beta S]
+  template <typename Float>
+  static inline void blockLink(Float *V, const Float *U, const double *S, double alpha, double beta) {
+    double a[18];
+    for (int i=0; i<18; i++) a[i] = (1.0-alpha)*U[i] + beta*S[i];
+    su3Project(a);
+    for (int i=0; i<18; i++) V[i] = a[i];
+  }
+
+  // V = exp(iQ) U with Q the traceless hermitian part of -i Omega, Omega = rho S U^dag
+  template <typename Float>
+  static inline void stoutLink(Float *V, const Float *U, const double *S, double rho) {
+    double u[18], C[18], omega[18], Q[18], e[18], v[18];
+    for (int i=0; i<18; i++) { u[i] = U[i]; C[i] = rho*S[i]; }
+    su3MulNA(C, u, omega);
+
+    // Q = (i/2) (A - tr(A)/3) with the anti-hermitian A = Omega^dag - Omega
+    double trace = 0.0;
+    for (int i=0; i<3; i++) trace -= 2.0*omega[8*i+1];
+    for (int i=0; i<3; i++) {
+      for (int j=0; j<3; j++) {
+	const double re = omega[6*j+2*i+0] - omega[6*i+2*j+0];
+	double im = -omega[6*j+2*i+1] - omega[6*i+2*j+1];
+	if (i == j) im -= trace/3.0;
+	Q[6*i+2*j+0] = -0.5*im;
+	Q[6*i+2*j+1] = 0.5*re;
+      }
+    }
+
+    su3ExpiQ(Q, e);
+    su3MulNN(e, u, v);
+    for (int i=0; i<18; i++) V[i] = v[i];
+  }
+
+  template <typename Float>
+  static void apeStoutStep(Float *Unew, const Float *U, QudaGaugeSmearType type, double coeff, int nDim,
+			   const ExtendedLattice &lat, int V) {
+    const double beta = coeff / (2*(nDim-1));
+
+#pragma omp parallel for
+    for (int n=0; n<V; n++) {
+      const int s = lat.boxSite(n, 2);
+      for (int mu=0; mu<nDim; mu++) {
+	double S[18] = { 0.0 };
+	for (int nu=0; nu<nDim; nu++) if (nu != mu) stapleSum(S, U, nu, U, mu, 4, s, mu, nu, lat);
+	if (type == QUDA_GAUGE_SMEAR_APE) blockLink(Unew + ((size_t)n*4+mu)*18, link(U, s, 4, mu), S, coeff, beta);
+	else stoutLink(Unew + ((size_t)n*4+mu)*18, link(U, s, 4, mu), S, coeff);
+      }
+    }
+  }
+
+  /**
+     One HYP step (Hasenfratz and Knechtli, hep-lat/0103029).  L3 holds
+     the links Vbar_{mu;nu,rho} as link mu*4+eta, eta being the only
+     direction other than mu, nu and rho; L2 holds Vtilde_{mu;nu} as
+     link mu*4+nu.
+   */
+  template <typename Float>
+  static void hypStep(Float *Unew, const Float *U, Float *L3, Float *L2, const double *alpha, const int *X,
+		      const ExtendedLattice &lat, int V) {
+#pragma omp parallel for
+    for (int n=0; n<V; n++) {
+      const int s = lat.boxSite(n, 2);
+      for (int mu=0; mu<4; mu++) {
+	for (int eta=0; eta<4; eta++) {
+	  if (eta == mu) continue;
+	  double S[18] = { 0.0 };
+	  stapleSum(S, U, eta, U, mu, 4, s, mu, eta, lat);
+	  blockLink(L3 + ((size_t)s*16 + mu*4+eta)*18, link(U, s, 4, mu), S, alpha[2], alpha[2]/2);
+	}
+      }
+    }
+    refreshExtendedBorder(L3, X, lat, 16);
+
+#pragma omp parallel for
+    for (int n=0; n<V; n++) {
+      const int s = lat.boxSite(n, 2);
+      for (int mu=0; mu<4; mu++) {
+	for (int nu=0; nu<4; nu++) {
+	  if (nu == mu) continue;
+	  double S[18] = { 0.0 };
+	  for (int rho=0; rho<4; rho++) {
+	    if (rho == mu || rho == nu) continue;
+	    const int eta = 6 - mu - nu - rho;
+	    stapleSum(S, L3, rho*4+eta, L3, mu*4+eta, 16, s, mu, rho, lat);
+	  }
+	  blockLink(L2 + ((size_t)s*16 + mu*4+nu)*18, link(U, s, 4, mu), S, alpha[1], alpha[1]/4);
+	}
+      }
+    }
+    refreshExtendedBorder(L2, X, lat, 16);
+
+#pragma omp parallel for
+    for (int n=0; n<V; n++) {
+      const int s = lat.boxSite(n, 2);
+      for (int mu=0; mu<4; mu++) {
+	double S[18] = { 0.0 };
+	for (int nu=0; nu<4; nu++) if (nu != mu) stapleSum(S, L2, nu*4+mu, L2, mu*4+nu, 16, s, mu, nu, lat);
+	blockLink(Unew + ((size_t)n*4+mu)*18, link(U, s, 4, mu), S, alpha[0], alpha[0]/6);
+      }
+    }
+  }
+
+  template <typename Float>
+  static void smearGaugeCpu(void *gauge, QudaGaugeFieldOrder order, const int *X, QudaGaugeSmearType type,
+			    const double *coeff, int nSteps, bool spatial) {
+    const ExtendedLattice lat(X);
+    const int V = X[0]*X[1]*X[2]*X[3];
+    const int nDim = spatial ? 3 : 4;
+    const size_t linkBytes = 18*sizeof(Float);
+
+    Float *U = (Float*)safe_malloc(4*(size_t)lat.volume*linkBytes);
+    packExtendedLinks(U, gauge, order, X, false, lat);
+    exchangeExtendedLinks(U, X, lat);
+
+    Float *Unew = (Float*)safe_malloc(4*(size_t)V*linkBytes);
+    Float *L3 = 0, *L2 = 0;
+    if (type == QUDA_GAUGE_SMEAR_HYP) {
+      // the links with equal indices are never set but are exchanged
+      L3 = (Float*)safe_malloc(16*(size_t)lat.volume*linkBytes);
+      L2 = (Float*)safe_malloc(16*(size_t)lat.volume*linkBytes);
+      memset(L3, 0, 16*(size_t)lat.volume*linkBytes);
+      memset(L2, 0, 16*(size_t)lat.volume*linkBytes);
+    }
+
+    for (int step=0; step<nSteps; step++) {
+      if (type == QUDA_GAUGE_SMEAR_HYP) hypStep(Unew, U, L3, L2, coeff, X, lat, V);
+      else apeStoutStep(Unew, U, type, coeff[0], nDim, lat, V);
+
+#pragma omp parallel for
+      for (int n=0; n<V; n++) memcpy(U + (size_t)lat.boxSite(n, 2)*4*18, Unew + (size_t)n*4*18, nDim*linkBytes);
+
+      if (step < nSteps-1) refreshExtendedBorder(U, X, lat);
+    }
+
+    // write the smeared links back to the host field
+#pragma omp parallel for
+    for (int n=0; n<V; n++) {
+      int x[4], c = n;
+      for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; }
+      const int s = lat.boxSite(n, 2);
+      const int idx = cbIndex(x, X);
+      for (int d=0; d<nDim; d++) memcpy(hostLink<Float>(gauge, order, idx, d), U + ((size_t)s*4+d)*18, linkBytes);
+    }
+
+    if (L2) host_free(L2);
+    if (L3) host_free(L3);
+    host_free(Unew);
+    host_free(U);
+  }
+
+  void smearGaugeCpu(void *gauge, QudaGaugeFieldOrder order, QudaPrecision precision, const int *X,
+		     QudaGaugeSmearType type, const double *coeff, int nSteps, bool spatial)
+  {
+    QUDA_PERF_SCOPE("smearGaugeCpu");
+    if (order != QUDA_QDP_GAUGE_ORDER && order != QUDA_MILC_GAUGE_ORDER)
+      errorQuda("Gauge order %d not supported", order);
+    if (type != QUDA_GAUGE_SMEAR_APE && type != QUDA_GAUGE_SMEAR_STOUT && type != QUDA_GAUGE_SMEAR_HYP)
+      errorQuda("Smearing type %d not supported", type);
+    if (type == QUDA_GAUGE_SMEAR_HYP && spatial) errorQuda("Spatial HYP smearing not supported");
+    if (nSteps < 0) errorQuda("Invalid number of smearing steps %d", nSteps);
+    for (int d=0; d<4; d++)
+      if (X[d] < 2 || X[d] % 2) errorQuda("Local dimension X[%d] = %d must be even and at least 2", d, X[d]);
+
+    if (precision == QUDA_DOUBLE_PRECISION) smearGaugeCpu<double>(gauge, order, X, type, coeff, nSteps, spatial);
+    else if (precision == QUDA_SINGLE_PRECISION) smearGaugeCpu<float>(gauge, order, X, type, coeff, nSteps, spatial);
+    else errorQuda("Precision %d not supported", precision);
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      const char *name[] = { "APE", "stout", "HYP" };
+      printfQuda("Applied %d %s%s smearing steps\n", nSteps, spatial ? "spatial " : "", name[type]);
+    }
+  }
+
+  void smearGaugeCpu(cpuGaugeField &u, QudaGaugeSmearType type, const double *coeff, int nSteps, bool spatial)
+  {
+    if (u.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Reconstruct type %d not supported", u.Reconstruct());
+    if (u.Geometry() != QUDA_VECTOR_GEOMETRY) errorQuda("Gauge geometry %d not supported", u.Geometry());
+    smearGaugeCpu(u.Gauge_p(), u.Order(), u.Precision(), u.X(), type, coeff, nSteps, spatial);
+  }
+
+} // namespace quda
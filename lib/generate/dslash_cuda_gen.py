@@ -1217,6 +1217,169 @@ def generate_dslash_kernels(arch):
 
 
 
+### host kernels ########################################################################
+#
+# The same projector algebra emitted for the host hopping term.  Each
+# variable is a vector of sites (spinorFloat is one of the types in
+# lib/cpu_simd.h), the spinor and link of every hop are loaded by the
+# CPU_READ_SPINOR and CPU_READ_GAUGE macros of the including function
+# (wilsonHopSimd in lib/wilson_cpu_core.h), and the color multiply is
+# written as a chain of fused multiply-adds.  The host spinors are in
+# the DeGrand-Rossi basis, which shares gamma1 and gamma3 with the
+# basis above but not gamma2 (opposite sign) and gamma4.
+
+gamma2DR = complexify([
+    0, 0, 0, -1,
+    0, 0, 1,  0,
+    0, 1, 0,  0,
+    -1, 0, 0,  0
+])
+
+gamma4DR = complexify([
+    0, 0, 1, 0,
+    0, 0, 0, 1,
+    1, 0, 0, 0,
+    0, 1, 0, 0
+])
+
+cpuProjectors = [
+    gminus(id,gamma1), gplus(id,gamma1),
+    gminus(id,gamma2DR), gplus(id,gamma2DR),
+    gminus(id,gamma3), gplus(id,gamma3),
+    gminus(id,gamma4DR), gplus(id,gamma4DR),
+]
+
+def cpu_def_spinor(name, arr):
+    str = ""
+    for s in range(0,4):
+        for c in range(0,3):
+            i = 3*s+c
+            str += "#define "+spinor(name,s,c,0)+" "+arr+"["+`(2*i+0)`+"]\n"
+            str += "#define "+spinor(name,s,c,1)+" "+arr+"["+`(2*i+1)`+"]\n"
+    return str
+
+def cpu_prolog():
+    str = ("// *** CPU DSLASH ***\n\n" if not dagger else "// *** CPU DSLASH DAGGER ***\n\n")
+    str += "// input spinor\n"
+    str += cpu_def_spinor("i", "I")
+    str += "\n// gauge link\n"
+    for m in range(0,3):
+        for n in range(0,3):
+            i = 3*m+n
+            str += "#define "+g_re(0,m,n)+" G["+`(2*i+0)`+"]\n"
+            str += "#define "+g_im(0,m,n)+" G["+`(2*i+1)`+"]\n"
+    str += "\n// output spinor\n"
+    str += cpu_def_spinor("o", "O")
+    str += "\n"
+    return str
+
+def cpu_epilog():
+    str = ""
+    for s in range(0,4):
+        for c in range(0,3):
+            for z in range(0,2):
+                str += "#undef "+spinor("i",s,c,z)+"\n"
+    for m in range(0,3):
+        for n in range(0,3):
+            str += "#undef "+g_re(0,m,n)+"\n"
+            str += "#undef "+g_im(0,m,n)+"\n"
+    for s in range(0,4):
+        for c in range(0,3):
+            for z in range(0,2):
+                str += "#undef "+spinor("o",s,c,z)+"\n"
+    return str
+
+def cpu_gen(dir):
+    projIdx = dir if not dagger else dir + (1 - 2*(dir%2))
+    projStr = projectorToStr(cpuProjectors[projIdx])
+    def proj(i,j):
+        return cpuProjectors[projIdx][4*i+j]
+
+    # the lower rows of (1 -/+ gamma_mu) are multiples of the upper rows
+    def row(i):
+        if proj(i,0) == 0j:
+            return (1, proj(i,1))
+        if proj(i,1) == 0j:
+            return (0, proj(i,0))
+
+    def term(x, name):
+        str = sign(x)+name
+        return str[1:] if str[0] == "+" else str
+
+    str = ""
+    projName = "P"+`dir/2`+["-","+"][projIdx%2]
+    str += "// Projector "+projName+"\n"
+    for l in projStr.splitlines():
+        str += "// "+l+"\n"
+    str += "\n"
+
+    body = "CPU_READ_SPINOR("+`dir`+");\n\n"
+
+    body += "// project spinor into half spinors\n"
+    for h in range(0, 2):
+        for c in range(0, 3):
+            strRe = ""
+            strIm = ""
+            for s in range(0, 4):
+                re = proj(h,s).real
+                im = proj(h,s).imag
+                if re==0 and im==0: ()
+                elif im==0:
+                    strRe += (term(re, in_re(s,c)) if strRe == "" else " "+sign(re)+" "+in_re(s,c))
+                    strIm += (term(re, in_im(s,c)) if strIm == "" else " "+sign(re)+" "+in_im(s,c))
+                elif re==0:
+                    strRe += (term(-im, in_im(s,c)) if strRe == "" else " "+sign(-im)+" "+in_im(s,c))
+                    strIm += (term(im, in_re(s,c)) if strIm == "" else " "+sign(im)+" "+in_re(s,c))
+            body += "spinorFloat "+h1_re(h,c)+" = "+strRe+";\n"
+            body += "spinorFloat "+h1_im(h,c)+" = "+strIm+";\n"
+    body += "\n"
+
+    body += "CPU_READ_GAUGE("+`dir`+");\n\n"
+
+    # U h for forward hops, U^dagger h for backward hops, with U^dagger(m,c) = conj U(c,m)
+    for m in range(0,3):
+        body += "// multiply row "+`m`+"\n"
+        for h in range(0,2):
+            re = []
+            im = []
+            for c in range(0,3):
+                if dir % 2 == 0:
+                    (gre, gim) = (g_re(0,m,c), g_im(0,m,c))
+                    re += [("fmadd", gre, h1_re(h,c)), ("fnmadd", gim, h1_im(h,c))]
+                    im += [("fmadd", gre, h1_im(h,c)), ("fmadd", gim, h1_re(h,c))]
+                else:
+                    (gre, gim) = (g_re(0,c,m), g_im(0,c,m))
+                    re += [("fmadd", gre, h1_re(h,c)), ("fmadd", gim, h1_im(h,c))]
+                    im += [("fmadd", gre, h1_im(h,c)), ("fnmadd", gim, h1_re(h,c))]
+            for (name, ops) in [(h2_re(h,m), re), (h2_im(h,m), im)]:
+                body += "spinorFloat "+name+" = "+ops[0][1]+" * "+ops[0][2]+";\n"
+                for (op, g, v) in ops[1:]:
+                    body += name+" = "+op+"("+g+", "+v+", "+name+");\n"
+        body += "\n"
+
+    for m in range(0,3):
+        for h in range(0,2):
+            body += out_re(h, m) + " += " + h2_re(h,m) + ";\n"
+            body += out_im(h, m) + " += " + h2_im(h,m) + ";\n"
+        for s in range(2,4):
+            (h,c) = row(s)
+            re = c.real
+            im = c.imag
+            if im == 0:
+                body += out_re(s, m) + " " + sign(re) + "= " + h2_re(h,m) + ";\n"
+                body += out_im(s, m) + " " + sign(re) + "= " + h2_im(h,m) + ";\n"
+            elif re == 0:
+                body += out_re(s, m) + " " + sign(-im) + "= " + h2_im(h,m) + ";\n"
+                body += out_im(s, m) + " " + sign(+im) + "= " + h2_re(h,m) + ";\n"
+        body += "\n"
+
+    return block(str + body)+"\n\n"
+# end def cpu_gen
+
+def generate_cpu_dslash():
+    return cpu_prolog() + ''.join([cpu_gen(dir) for dir in range(0,8)]) + cpu_epilog()
+
+
 dslash = False
 dagger = False
 twist = False
@@ -1266,3 +1429,20 @@ print sys.argv[0] + ": generating clover_core.h";
 f = open('dslash_core/clover_core.h', 'w')
 f.write(generate_clover())
 f.close()
+clover = False
+
+# generate host kernels
+dslash = True
+dagger = False
+print sys.argv[0] + ": generating wilson_dslash_cpu_core.h";
+f = open('dslash_core/wilson_dslash_cpu_core.h', 'w')
+f.write(generate_cpu_dslash())
+f.close()
+
+dagger = True
+print sys.argv[0] + ": generating wilson_dslash_dagger_cpu_core.h";
+f = open('dslash_core/wilson_dslash_dagger_cpu_core.h', 'w')
+f.write(generate_cpu_dslash())
+f.close()
+dagger = False
+dslash = False
@@ -0,0 +1,571 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <comm_quda.h>
+#include <hisq_force_quda.h>
+#include <stencil_index.h>
+
+#include "cpu_gauge_util.h"
+
+/*
+ * Host HISQ fermion force
+ *
+ * These are the host counterparts of hisqStaplesForceCuda,
+ * hisqLongLinkForceCuda and hisqCompleteForceCuda, together with the
+ * outer product that feeds them.  They follow the device kernels
+ * term by term: the staple force is a recursion over the middle,
+ * side and all-link terms of the 3-, 5- and 7-staples and the Lepage
+ * term, whose intermediates (P and Q in the device code) are
+ * allocated once per call and overwritten at every level.  Every
+ * term is a threaded pass over the sites; each pass writes any given
+ * site of a field from exactly one site, so no locking is needed.
+ *
+ * The fields are either on the local lattice, in which case the
+ * neighbours are periodic and a single process is required, or on
+ * the lattice extended by two sites in every dimension (as in the
+ * MULTI_GPU build), in which case sites whose neighbours are off the
+ * extended lattice are skipped.
+ */
+
+namespace quda {
+  namespace fermion_force {
+
+    static inline int OPP_DIR(int dir) { return 7-dir; }
+    static inline bool GOES_FORWARDS(int dir) { return dir <= 3; }
+
+    /**
+       Site geometry of the host fields.  Sites are in the even-odd
+       order of the host gauge fields; the neighbour table is indexed
+       by the path directions, 0-3 forwards and 7-dir backwards.
+     */
+    struct HisqLattice {
+      int X[4];       // local dimensions
+      int D[4];       // dimensions of the fields
+      bool extended;
+      int volume;     // sites of the fields
+      int volumeCB;
+      int localVolume;
+      int *nbr;       // [site][8], -1 off the edge of an extended lattice
+      int *local;     // index in the fields of each local site (extended fields only)
+
+      HisqLattice(const int *X_, bool extended) : extended(extended), local(0) {
+	volume = 1;
+	localVolume = 1;
+	for (int d=0; d<4; d++) {
+	  X[d] = X_[d];
+	  D[d] = extended ? X[d] + 4 : X[d];
+	  volume *= D[d];
+	  localVolume *= X[d];
+	}
+	volumeCB = volume / 2;
+
+	// the shared per-parity tables, in the path directions and
+	// indexed by the full even-odd index
+	StencilIndex::Boundary boundary[4];
+	for (int d=0; d<4; d++) boundary[d] = extended ? StencilIndex::OPEN : StencilIndex::PERIODIC;
+	const StencilIndex *stencil = StencilIndex::Acquire(D, boundary, QUDA_LEXICOGRAPHIC_STENCIL_ORDER);
+	nbr = (int*)safe_malloc(8*(size_t)volume*sizeof(int));
+	for (int p=0; p<2; p++) {
+	  const int *n = stencil->Neighbors(p);
+#pragma omp parallel for
+	  for (int h=0; h<volumeCB; h++) {
+	    for (int dir=0; dir<8; dir++) {
+	      const int m = GOES_FORWARDS(dir) ? n[8*h+2*dir] : n[8*h+2*OPP_DIR(dir)+1];
+	      nbr[((size_t)p*volumeCB + h)*8+dir] = (m < 0) ? -1 : (1-p)*volumeCB + m;
+	    }
+	  }
+	}
+	StencilIndex::Release(stencil);
+
+	if (extended) {
+	  local = (int*)safe_malloc((size_t)localVolume*sizeof(int));
+#pragma omp parallel for
+	  for (int n=0; n<localVolume; n++) {
+	    int x[4];
+	    coords(x, n, X);
+	    for (int d=0; d<4; d++) x[d] += 2;
+	    local[n] = cbIndex(x, D);
+	  }
+	}
+      }
+
+      ~HisqLattice() {
+	host_free(nbr);
+	if (local) host_free(local);
+      }
+
+      // coordinates of site s of the even-odd ordered lattice D
+      static void coords(int x[4], int s, const int *D) {
+	const int vCB = D[0]*D[1]*D[2]*D[3]/2;
+	const int parity = s / vCB;
+	int h = s % vCB;
+	const int x0h = h % (D[0]/2);
+	h /= D[0]/2;
+	x[1] = h % D[1];
+	h /= D[1];
+	x[2] = h % D[2];
+	x[3] = h / D[2];
+	x[0] = 2*x0h + ((x[1] + x[2] + x[3] + parity) & 1);
+      }
+
+      // index in the fields of the local site n
+      inline int localSite(int n) const { return extended ? local[n] : n; }
+
+      inline int odd(int s) const { return s >= volumeCB; }
+    };
+
+    template <typename Float>
+    struct LinkField {
+      void *gauge;
+      QudaGaugeFieldOrder order;
+      LinkField(cpuGaugeField &field) : gauge(field.Gauge_p()), order(field.Order()) { }
+      inline Float* operator()(int idx, int d) const { return hostLink<Float>(gauge, order, idx, d); }
+    };
+
+    template <typename Float>
+    static inline void su3Adj(const Float *a, Float *c) {
+      for (int i=0; i<3; i++) {
+	for (int j=0; j<3; j++) {
+	  c[6*i+2*j+0] =  a[6*j+2*i+0];
+	  c[6*i+2*j+1] = -a[6*j+2*i+1];
+	}
+      }
+    }
+
+    template <typename Float>
+    static inline void su3Add(Float *a, Float coeff, const Float *b) {
+      for (int i=0; i<18; i++) a[i] += coeff*b[i];
+    }
+
+    /**
+       Middle link of a staple in the (sig,mu) plane.  At the first
+       level (Qprev == 0) the incoming field is the outer product, a
+       link field; otherwise it is the P field of the previous level.
+     */
+    template <typename Float>
+    static void middleLink(const HisqLattice &lat, int sig, int mu, Float coeff,
+			   const LinkField<Float> &oprod, const Float *Pprev, const Float *Qprev,
+			   const LinkField<Float> &U, Float *Pmu, Float *P3, Float *Qmu,
+			   const LinkField<Float> &newOprod) {
+      const bool mu_positive = GOES_FORWARDS(mu);
+      const bool sig_positive = GOES_FORWARDS(sig);
+
+#pragma omp parallel for
+      for (int x=0; x<lat.volume; x++) {
+	const int d = lat.nbr[x*8+OPP_DIR(mu)];
+	const int b = lat.nbr[x*8+sig];
+	if (d < 0 || b < 0) continue;
+	const int c = lat.nbr[d*8+sig];
+	if (c < 0) continue;
+
+	Float W[18], Y[18], T[18], ad[18];
+	const Float *ab = sig_positive ? U(x, sig) : U(b, OPP_DIR(sig));
+	const Float *bc = mu_positive ? U(c, mu) : U(b, OPP_DIR(mu));
+
+	if (!Qprev) {
+	  if (sig_positive) memcpy(Y, oprod(d, sig), sizeof(Y));
+	  else su3Adj(oprod(c, OPP_DIR(sig)), Y);
+	} else {
+	  memcpy(Y, Pprev + c*18, sizeof(Y));
+	}
+
+	if (mu_positive) su3MulAN(bc, Y, W);
+	else su3MulNN(bc, Y, W);
+	if (Pmu) memcpy(Pmu + b*18, W, sizeof(W));
+
+	if (sig_positive) su3MulNN(ab, W, Y);
+	else su3MulAN(ab, W, Y);
+	memcpy(P3 + x*18, Y, sizeof(Y));
+
+	if (mu_positive) memcpy(ad, U(d, mu), sizeof(ad));
+	else su3Adj(U(x, OPP_DIR(mu)), ad);
+
+	if (!Qprev) {
+	  if (sig_positive) su3MulNN(W, ad, Y);
+	  if (Qmu) memcpy(Qmu + x*18, ad, sizeof(ad));
+	} else if (Qmu || sig_positive) {
+	  su3MulNN(Qprev + d*18, ad, T);
+	  if (Qmu) memcpy(Qmu + x*18, T, sizeof(T));
+	  if (sig_positive) su3MulNN(W, T, Y);
+	}
+
+	if (sig_positive) su3Add(newOprod(x, sig), coeff, Y);
+      }
+    }
+
+    /**
+       Side link of a staple in the (sig,mu) plane, accumulating
+       accumu_coeff times the staple into the P field of the level
+       below (shortP), if any.
+     */
+    template <typename Float>
+    static void sideLink(const HisqLattice &lat, int sig, int mu, Float coeff, Float accumu_coeff,
+			 const Float *P3, const Float *Qprod, const LinkField<Float> &U,
+			 Float *shortP, const LinkField<Float> &newOprod) {
+      const bool mu_positive = GOES_FORWARDS(mu);
+      const bool sig_positive = GOES_FORWARDS(sig);
+
+#pragma omp parallel for
+      for (int x=0; x<lat.volume; x++) {
+	const int d = lat.nbr[x*8+OPP_DIR(mu)];
+	if (d < 0) continue;
+	const int odd = lat.odd(x);
+	const Float *Y = P3 + x*18;
+	Float W[18], T[18];
+
+	if (shortP) {
+	  if (mu_positive) su3MulNN(U(d, mu), Y, W);
+	  else su3MulAN(U(x, OPP_DIR(mu)), Y, W);
+	  su3Add(shortP + d*18, accumu_coeff, W);
+	}
+
+	Float mycoeff = ((sig_positive && odd) || (!sig_positive && !odd)) ? coeff : -coeff;
+
+	if (mu_positive) {
+	  if (!odd) mycoeff = -mycoeff;
+	  if (Qprod) {
+	    su3MulNN(Y, Qprod + d*18, W);
+	    su3Add(newOprod(d, mu), mycoeff, W);
+	  } else {
+	    su3Add(newOprod(d, mu), mycoeff, Y);
+	  }
+	} else {
+	  if (odd) mycoeff = -mycoeff;
+	  if (Qprod) {
+	    su3MulNN(Y, Qprod + d*18, T);
+	    su3Adj(T, W);
+	  } else {
+	    su3Adj(Y, W);
+	  }
+	  su3Add(newOprod(x, OPP_DIR(mu)), mycoeff, W);
+	}
+      }
+    }
+
+    /**
+       The 7-staple, whose middle and side links are both computed
+       here since it is the last level of the recursion.
+     */
+    template <typename Float>
+    static void allLink(const HisqLattice &lat, int sig, int mu, Float coeff, Float accumu_coeff,
+			const Float *Pprev, const Float *Qprev, const LinkField<Float> &U,
+			Float *shortP, const LinkField<Float> &newOprod) {
+      const bool mu_positive = GOES_FORWARDS(mu);
+      const bool sig_positive = GOES_FORWARDS(sig);
+      const int m = mu_positive ? mu : OPP_DIR(mu);
+
+#pragma omp parallel for
+      for (int x=0; x<lat.volume; x++) {
+	const int d = lat.nbr[x*8+OPP_DIR(mu)];
+	const int b = lat.nbr[x*8+sig];
+	if (d < 0 || b < 0) continue;
+	const int c = lat.nbr[d*8+sig];
+	if (c < 0) continue;
+	const int odd = lat.odd(x);
+	const Float sign = odd ? -1.0 : 1.0;
+	const Float mycoeff = ((sig_positive && odd) || (!sig_positive && !odd)) ? coeff : -coeff;
+
+	const Float *X = Qprev + d*18;
+	const Float *ab = sig_positive ? U(x, sig) : U(b, OPP_DIR(sig));
+	Float W[18], Y[18], Z[18], T[18];
+
+	if (mu_positive) {
+	  const Float *ad = U(d, m);
+	  su3MulAN(U(c, m), Pprev + c*18, Z);
+	  if (sig_positive) {
+	    su3MulNN(X, ad, T);
+	    su3MulNN(Z, T, W);
+	    su3Add(newOprod(x, sig), sign*mycoeff, W);
+	  }
+	  if (sig_positive) su3MulNN(ab, Z, Y);
+	  else su3MulAN(ab, Z, Y);
+	  su3MulNN(Y, X, W);
+	  su3Add(newOprod(d, m), -sign*mycoeff, W);
+	  su3MulNN(ad, Y, W);
+	  su3Add(shortP + d*18, accumu_coeff, W);
+	} else {
+	  const Float *ad = U(x, m);
+	  su3MulNN(U(b, m), Pprev + c*18, Z);
+	  if (sig_positive) {
+	    su3MulNA(X, ad, T);
+	    su3MulNN(Z, T, W);
+	    su3Add(newOprod(x, sig), sign*mycoeff, W);
+	  }
+	  if (sig_positive) su3MulNN(ab, Z, Y);
+	  else su3MulAN(ab, Z, Y);
+	  su3MulNN(Y, X, T);
+	  su3Adj(T, W);
+	  su3Add(newOprod(x, m), sign*mycoeff, W);
+	  su3MulAN(ad, Y, W);
+	  su3Add(shortP + d*18, accumu_coeff, W);
+	}
+      }
+    }
+
+    template <typename Float>
+    static void hisqStaplesForceCpu(const HisqLattice &lat, const double path_coeff[6],
+				    const LinkField<Float> &oprod, const LinkField<Float> &U,
+				    const LinkField<Float> &newOprod) {
+      const Float OneLink = path_coeff[0];
+      const Float ThreeSt = path_coeff[2];
+      const Float FiveSt = path_coeff[3];
+      const Float SevenSt = path_coeff[4];
+      const Float Lepage = path_coeff[5];
+
+      // one-link term, on the local volume only
+#pragma omp parallel for
+      for (int n=0; n<lat.localVolume; n++) {
+	const int x = lat.localSite(n);
+	for (int sig=0; sig<4; sig++) su3Add(newOprod(x, sig), OneLink, oprod(x, sig));
+      }
+
+      // the intermediates are reused by every staple
+      const size_t bytes = (size_t)lat.volume*18*sizeof(Float);
+      Float *Pmu = (Float*)safe_malloc(bytes);
+      Float *P3 = (Float*)safe_malloc(bytes);
+      Float *P5 = (Float*)safe_malloc(bytes);
+      Float *Pnumu = (Float*)safe_malloc(bytes);
+      Float *Qmu = (Float*)safe_malloc(bytes);
+      Float *Qnumu = (Float*)safe_malloc(bytes);
+      // sites skipped at the edge of an extended lattice are still read
+      memset(Pmu, 0, bytes); memset(P3, 0, bytes); memset(P5, 0, bytes);
+      memset(Pnumu, 0, bytes); memset(Qmu, 0, bytes); memset(Qnumu, 0, bytes);
+
+      // sig labels the net displacement of the staple
+      for (int sig=0; sig<8; sig++) {
+	for (int mu=0; mu<8; mu++) {
+	  if (mu == sig || mu == OPP_DIR(sig)) continue;
+
+	  // 3-staple: middle link
+	  middleLink(lat, sig, mu, -ThreeSt, oprod, (const Float*)0, (const Float*)0, U, Pmu, P3, Qmu, newOprod);
+
+	  for (int nu=0; nu<8; nu++) {
+	    if (nu == mu || nu == OPP_DIR(mu) || nu == sig || nu == OPP_DIR(sig)) continue;
+
+	    // 5-staple: middle link
+	    middleLink(lat, sig, nu, FiveSt, oprod, Pmu, Qmu, U, Pnumu, P5, Qnumu, newOprod);
+
+	    for (int rho=0; rho<8; rho++) {
+	      if (rho == sig || rho == OPP_DIR(sig) || rho == mu || rho == OPP_DIR(mu) ||
+		  rho == nu || rho == OPP_DIR(nu)) continue;
+
+	      // 7-staple: middle and side link
+	      allLink(lat, sig, rho, SevenSt, FiveSt != 0 ? SevenSt/FiveSt : (Float)0,
+		      Pnumu, Qnumu, U, P5, newOprod);
+	    }
+
+	    // 5-staple: side link
+	    sideLink(lat, sig, nu, -FiveSt, ThreeSt != 0 ? FiveSt/ThreeSt : (Float)0,
+		     P5, Qmu, U, P3, newOprod);
+	  }
+
+	  // Lepage term
+	  if (Lepage != 0.0) {
+	    middleLink(lat, sig, mu, Lepage, oprod, Pmu, Qmu, U, (Float*)0, P5, (Float*)0, newOprod);
+	    sideLink(lat, sig, mu, -Lepage, ThreeSt != 0 ? Lepage/ThreeSt : (Float)0,
+		     P5, Qmu, U, P3, newOprod);
+	  }
+
+	  // 3-staple: side link
+	  sideLink(lat, sig, mu, ThreeSt, (Float)0, P3, (const Float*)0, U, (Float*)0, newOprod);
+	}
+      }
+
+      host_free(Qnumu);
+      host_free(Qmu);
+      host_free(Pnumu);
+      host_free(P5);
+      host_free(P3);
+      host_free(Pmu);
+    }
+
+    template <typename Float>
+    static void hisqLongLinkForceCpu(const HisqLattice &lat, Float coeff, const LinkField<Float> &oprod,
+				     const LinkField<Float> &U, const LinkField<Float> &newOprod) {
+#pragma omp parallel for
+      for (int n=0; n<lat.localVolume; n++) {
+	const int c = lat.localSite(n);
+	for (int sig=0; sig<4; sig++) {
+	  const int d = lat.nbr[c*8+sig];
+	  const int e = lat.nbr[d*8+sig];
+	  const int b = lat.nbr[c*8+OPP_DIR(sig)];
+	  const int a = lat.nbr[b*8+OPP_DIR(sig)];
+	  Float V[18], T[18], W[18];
+
+	  // V = de ef Z - de Y bc + X ab bc
+	  su3MulNN(U(e, sig), oprod(c, sig), T);
+	  su3MulNN(oprod(b, sig), U(b, sig), W);
+	  for (int i=0; i<18; i++) T[i] -= W[i];
+	  su3MulNN(U(d, sig), T, V);
+	  su3MulNN(oprod(a, sig), U(a, sig), T);
+	  su3MulNN(T, U(b, sig), W);
+	  for (int i=0; i<18; i++) V[i] += W[i];
+
+	  su3Add(newOprod(c, sig), coeff, V);
+	}
+      }
+    }
+
+    template <typename Float>
+    static void hisqCompleteForceCpu(const HisqLattice &lat, const LinkField<Float> &oprod,
+				     const LinkField<Float> &U, Float *mom) {
+#pragma omp parallel for
+      for (int n=0; n<lat.localVolume; n++) {
+	const int x = lat.localSite(n);
+	const Float coeff = (n >= lat.localVolume/2) ? -1.0 : 1.0;
+	for (int sig=0; sig<4; sig++) {
+	  Float m[18];
+	  su3MulNN(U(x, sig), oprod(x, sig), m);
+
+	  // traceless anti-hermitian part, as stored by the device code
+	  Float *f = mom + (n*4 + sig)*10;
+	  f[0] = (m[2] - m[6])*0.5*coeff;
+	  f[1] = (m[3] + m[7])*0.5*coeff;
+	  f[2] = (m[4] - m[12])*0.5*coeff;
+	  f[3] = (m[5] + m[13])*0.5*coeff;
+	  f[4] = (m[10] - m[14])*0.5*coeff;
+	  f[5] = (m[11] + m[15])*0.5*coeff;
+	  const Float trace = (m[1] + m[9] + m[17])/3.0;
+	  f[6] = (m[1] - trace)*coeff;
+	  f[7] = (m[9] - trace)*coeff;
+	  f[8] = (m[17] - trace)*coeff;
+	  f[9] = 0.0;
+	}
+      }
+    }
+
+    template <typename Float>
+    static void hisqOuterProductCpu(const HisqLattice &lat, const void *const *quark, const double *coeff,
+				    int num_terms, void *oprod, QudaGaugeFieldOrder oprodOrder,
+				    void *longOprod, QudaGaugeFieldOrder longOrder) {
+#pragma omp parallel for
+      for (int x=0; x<lat.volume; x++) {
+	for (int dir=0; dir<4; dir++) {
+	  int y = lat.nbr[x*8+dir];
+	  int z = lat.nbr[lat.nbr[y*8+dir]*8+dir];
+	  Float one[18], three[18];
+	  for (int i=0; i<18; i++) one[i] = three[i] = 0.0;
+
+	  // every shift is summed before the links are written
+	  for (int k=0; k<num_terms; k++) {
+	    const Float *q = (const Float*)quark[k];
+	    const Float *a = q + x*6;
+	    const Float c = coeff[k];
+	    for (int i=0; i<3; i++) {
+	      for (int j=0; j<3; j++) {
+		const Float *b = q + y*6;
+		one[6*i+2*j+0] += c*(b[2*i]*a[2*j] + b[2*i+1]*a[2*j+1]);
+		one[6*i+2*j+1] += c*(b[2*i+1]*a[2*j] - b[2*i]*a[2*j+1]);
+		if (longOprod) {
+		  b = q + z*6;
+		  three[6*i+2*j+0] += c*(b[2*i]*a[2*j] + b[2*i+1]*a[2*j+1]);
+		  three[6*i+2*j+1] += c*(b[2*i+1]*a[2*j] - b[2*i]*a[2*j+1]);
+		}
+	      }
+	    }
+	  }
+
+	  memcpy(hostLink<Float>(oprod, oprodOrder, x, dir), one, sizeof(one));
+	  if (longOprod) memcpy(hostLink<Float>(longOprod, longOrder, x, dir), three, sizeof(three));
+	}
+      }
+    }
+
+    static bool isExtended(const cpuGaugeField &field, const int *X) {
+      for (int d=0; d<4; d++) if (field.X()[d] != X[d] + 4) return false;
+      return true;
+    }
+
+    static void checkHostFields(const QudaGaugeParam &param, const cpuGaugeField &a, const cpuGaugeField &b,
+				const char *func) {
+      if (a.Precision() != b.Precision())
+	errorQuda("%s: mixed precision is not supported", func);
+      if (a.Precision() != QUDA_DOUBLE_PRECISION && a.Precision() != QUDA_SINGLE_PRECISION)
+	errorQuda("%s: precision %d not supported", func, a.Precision());
+      for (int d=0; d<4; d++)
+	if (a.X()[d] != b.X()[d])
+	  errorQuda("%s: field dimensions do not match (X[%d] = %d, %d)", func, d, a.X()[d], b.X()[d]);
+      if (!isExtended(a, param.X) && comm_size() > 1)
+	errorQuda("%s: fields must be extended by 2 sites in each direction with %d processes",
+		  func, comm_size());
+    }
+
+    void hisqStaplesForceCpu(const double path_coeff[6], const QudaGaugeParam &param,
+			     cpuGaugeField &oprod, cpuGaugeField &link, cpuGaugeField *newOprod)
+    {
+      QUDA_PERF_SCOPE("hisqStaplesForceCpu");
+      checkHostFields(param, link, oprod, __FUNCTION__);
+      checkHostFields(param, link, *newOprod, __FUNCTION__);
+      const HisqLattice lat(param.X, isExtended(link, param.X));
+
+      if (link.Precision() == QUDA_DOUBLE_PRECISION) {
+	hisqStaplesForceCpu<double>(lat, path_coeff, oprod, link, *newOprod);
+      } else {
+	hisqStaplesForceCpu<float>(lat, path_coeff, oprod, link, *newOprod);
+      }
+    }
+
+    void hisqLongLinkForceCpu(double coeff, const QudaGaugeParam &param, cpuGaugeField &oprod,
+			      cpuGaugeField &link, cpuGaugeField *newOprod)
+    {
+      QUDA_PERF_SCOPE("hisqLongLinkForceCpu");
+      checkHostFields(param, link, oprod, __FUNCTION__);
+      checkHostFields(param, link, *newOprod, __FUNCTION__);
+      const HisqLattice lat(param.X, isExtended(link, param.X));
+
+      if (link.Precision() == QUDA_DOUBLE_PRECISION) {
+	hisqLongLinkForceCpu<double>(lat, coeff, oprod, link, *newOprod);
+      } else {
+	hisqLongLinkForceCpu<float>(lat, coeff, oprod, link, *newOprod);
+      }
+    }
+
+    void hisqCompleteForceCpu(const QudaGaugeParam &param, cpuGaugeField &oprod, cpuGaugeField &link,
+			      cpuGaugeField *mom)
+    {
+      QUDA_PERF_SCOPE("hisqCompleteForceCpu");
+      checkHostFields(param, link, oprod, __FUNCTION__);
+      if (mom->Order() != QUDA_MILC_GAUGE_ORDER || mom->Reconstruct() != QUDA_RECONSTRUCT_10)
+	errorQuda("%s: the momentum must be a MILC-ordered field of 10 reals per link", __FUNCTION__);
+      if (mom->Precision() != link.Precision())
+	errorQuda("%s: mixed precision is not supported", __FUNCTION__);
+      const HisqLattice lat(param.X, isExtended(link, param.X));
+
+      if (link.Precision() == QUDA_DOUBLE_PRECISION) {
+	hisqCompleteForceCpu<double>(lat, oprod, link, (double*)mom->Gauge_p());
+      } else {
+	hisqCompleteForceCpu<float>(lat, oprod, link, (float*)mom->Gauge_p());
+      }
+    }
+
+    void hisqOuterProductCpu(const void *const *quark, const double *coeff, int num_terms,
+			     const QudaGaugeParam &param, cpuGaugeField &oprod, cpuGaugeField *longOprod)
+    {
+      if (comm_size() > 1)
+	errorQuda("%s: the quark halo is not exchanged, so only a single process is supported", __FUNCTION__);
+      if (isExtended(oprod, param.X) || (longOprod && isExtended(*longOprod, param.X)))
+	errorQuda("%s: the outer product is computed on the local lattice", __FUNCTION__);
+      if (longOprod && longOprod->Precision() != oprod.Precision())
+	errorQuda("%s: mixed precision is not supported", __FUNCTION__);
+      if (param.cpu_prec != oprod.Precision())
+	errorQuda("%s: quark precision %d does not match the outer product precision %d",
+		  __FUNCTION__, param.cpu_prec, oprod.Precision());
+      const HisqLattice lat(param.X, false);
+
+      void *longGauge = longOprod ? longOprod->Gauge_p() : 0;
+      const QudaGaugeFieldOrder longOrder = longOprod ? longOprod->Order() : oprod.Order();
+      if (oprod.Precision() == QUDA_DOUBLE_PRECISION) {
+	hisqOuterProductCpu<double>(lat, quark, coeff, num_terms, oprod.Gauge_p(), oprod.Order(),
+				    longGauge, longOrder);
+      } else if (oprod.Precision() == QUDA_SINGLE_PRECISION) {
+	hisqOuterProductCpu<float>(lat, quark, coeff, num_terms, oprod.Gauge_p(), oprod.Order(),
+				   longGauge, longOrder);
+      } else {
+	errorQuda("%s: precision %d not supported", __FUNCTION__, oprod.Precision());
+      }
+    }
+
+  } // namespace fermion_force
+} // namespace quda
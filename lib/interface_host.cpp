@@ -0,0 +1,145 @@
+#include <stdio.h>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <gauge_io.h>
+#include <gauge_observables.h>
+#include <gauge_smear.h>
+
+/*
+ * The entry points of the interface that need no device: the
+ * parameter structs, the communications grid and the host gauge
+ * routines.  They are shared by libquda and by the host-only
+ * library (see "make host"), which is built without CUDA.
+ */
+
+// define newQudaGaugeParam() and newQudaInvertParam()
+#define INIT_PARAM
+#include "check_params.h"
+#undef INIT_PARAM
+
+// define printQudaGaugeParam() and printQudaInvertParam()
+#define PRINT_PARAM
+#include "check_params.h"
+#undef PRINT_PARAM
+
+using namespace quda;
+
+
+typedef struct {
+  int ndim;
+  int dims[QUDA_MAX_DIM];
+} LexMapData;
+
+/**
+ * For MPI, the default node mapping is lexicographical with t varying fastest.
+ */
+static int lex_rank_from_coords(const int *coords, void *fdata)
+{
+  LexMapData *md = static_cast<LexMapData *>(fdata);
+
+  int rank = coords[0];
+  for (int i = 1; i < md->ndim; i++) {
+    rank = md->dims[i] * rank + coords[i];
+  }
+  return rank;
+}
+
+#ifdef QMP_COMMS
+/**
+ * For QMP, we use the existing logical topology if already declared.
+ */
+static int qmp_rank_from_coords(const int *coords, void *fdata)
+{
+  return QMP_get_node_number_from(coords);
+}
+#endif
+
+
+bool comms_initialized = false;
+
+void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata)
+{
+  if (nDim != 4) {
+    errorQuda("Number of communication grid dimensions must be 4");
+  }
+
+  LexMapData map_data; // referenced by fdata until comm_init returns
+
+  if (!func) {
+
+#if QMP_COMMS
+    if (QMP_logical_topology_is_declared()) {
+      if (QMP_get_logical_number_of_dimensions() != 4) {
+        errorQuda("QMP logical topology must have 4 dimensions");
+      }
+      for (int i=0; i<nDim; i++) {
+        int qdim = QMP_get_logical_dimensions()[i];
+        if(qdim != dims[i]) {
+          errorQuda("QMP logical dims[%d]=%d does not match dims[%d]=%d argument", i, qdim, i, dims[i]);
+        }
+      }
+      fdata = NULL;
+      func = qmp_rank_from_coords;
+    } else {
+      warningQuda("QMP logical topology is undeclared; using default lexicographical ordering");
+#endif
+
+      map_data.ndim = nDim;
+      for (int i=0; i<nDim; i++) {
+        map_data.dims[i] = dims[i];
+      }
+      fdata = (void *) &map_data;
+      func = lex_rank_from_coords;
+
+#if QMP_COMMS
+    }
+#endif      
+
+  }
+  comm_init(nDim, dims, func, fdata);
+  comms_initialized = true;
+}
+
+
+void init_default_comms()
+{
+#if defined(QMP_COMMS)
+  if (QMP_logical_topology_is_declared()) {
+    int ndim = QMP_get_logical_number_of_dimensions();
+    const int *dims = QMP_get_logical_dimensions();
+    initCommsGridQuda(ndim, dims, NULL, NULL);
+  } else {
+    errorQuda("initQuda() called without prior call to initCommsGridQuda(),"
+        " and QMP logical topology has not been declared");
+  }
+#elif defined(MPI_COMMS)
+  errorQuda("When using MPI for communications, initCommsGridQuda() must be called before initQuda()");
+#else // single-GPU
+  const int dims[4] = {1, 1, 1, 1};
+  initCommsGridQuda(4, dims, NULL, NULL);
+#endif
+}
+
+
+void readGaugeFileQuda(void *h_gauge, const char *filename, QudaGaugeParam *param)
+{
+  if (!comms_initialized) init_default_comms();
+  readGaugeFile(h_gauge, filename, param->gauge_order, param->cpu_prec, param->X);
+}
+
+
+void gaugeObservablesQuda(QudaGaugeObservables *obs, void *h_gauge, QudaGaugeParam *param)
+{
+  if (!comms_initialized) init_default_comms();
+  gaugeObservablesCpu(*obs, h_gauge, param->gauge_order, param->cpu_prec, param->X);
+}
+
+
+void smearGaugeQuda(void *h_gauge, QudaGaugeParam *param, QudaGaugeSmearType type,
+		    const double *coeff, int n_steps, int spatial)
+{
+  if (!comms_initialized) init_default_comms();
+  smearGaugeCpu(h_gauge, param->gauge_order, param->cpu_prec, param->X, type, coeff, n_steps, spatial);
+}
@@ -1,14 +1,19 @@
 #include <iostream>
+#include <map>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
 #include <sys/time.h>
+#include <pthread.h>
+#include <deque>
 
 #include <quda.h>
 #include <quda_internal.h>
 #include <comm_quda.h>
 #include <tune_quda.h>
+#include <kernel_stats.h>
+#include <quda_new_interace.h>
 #include <blas_quda.h>
 #include <gauge_field.h>
 #include <dirac_quda.h>
@@ -19,6 +24,10 @@
 #include <llfat_quda.h>
 #include <fat_force_quda.h>
 #include <hisq_links_quda.h>
+#include <gauge_io.h>
+#include <spinor_io.h>
+#include <gauge_observables.h>
+#include <gauge_smear.h>
 
 #ifdef NUMA_AFFINITY
 #include <numa_affinity.h>
@@ -42,21 +51,11 @@ extern void exchange_cpu_sitelink_ex(int* X, int *R, void** sitelink, QudaGaugeF
 
 #define MAX_GPU_NUM_PER_NODE 16
 
-// define newQudaGaugeParam() and newQudaInvertParam()
-#define INIT_PARAM
-#include "check_params.h"
-#undef INIT_PARAM
-
 // define (static) checkGaugeParam() and checkInvertParam()
 #define CHECK_PARAM
 #include "check_params.h"
 #undef CHECK_PARAM
 
-// define printQudaGaugeParam() and printQudaInvertParam()
-#define PRINT_PARAM
-#include "check_params.h"
-#undef PRINT_PARAM
-
 #include "face_quda.h"
 
 int numa_affinity_enabled = 1;
@@ -86,6 +85,9 @@ cudaStream_t *streams;
 
 static bool initialized = false;
 
+//!< The device used, which each host thread of the library must select
+static int quda_device = -1;
+
 //!< Profiler for initQuda
 static TimeProfile profileInit("initQuda");
 
@@ -113,6 +115,11 @@ static TimeProfile profileGaugeForce("computeGaugeForceQuda");
 //!< Profiler for endQuda
 static TimeProfile profileEnd("endQuda");
 
+//!< Solution history for chronological forecasting, keyed by QudaInvertParam::chrono_index
+static std::map<int, ChronoHistory*> chronoHistory;
+
+static void drainInvertQueue();
+
 void setVerbosityQuda(QudaVerbosity verbosity, const char prefix[], FILE *outfile)
 {
   setVerbosity(verbosity);
@@ -121,99 +128,15 @@ void setVerbosityQuda(QudaVerbosity verbosity, const char prefix[], FILE *outfil
 }
 
 
-typedef struct {
-  int ndim;
-  int dims[QUDA_MAX_DIM];
-} LexMapData;
-
-/**
- * For MPI, the default node mapping is lexicographical with t varying fastest.
- */
-static int lex_rank_from_coords(const int *coords, void *fdata)
+void setCheckpointQuda(const char path[])
 {
-  LexMapData *md = static_cast<LexMapData *>(fdata);
-
-  int rank = coords[0];
-  for (int i = 1; i < md->ndim; i++) {
-    rank = md->dims[i] * rank + coords[i];
-  }
-  return rank;
+  setCheckpointPath(path);
 }
 
-#ifdef QMP_COMMS
-/**
- * For QMP, we use the existing logical topology if already declared.
- */
-static int qmp_rank_from_coords(const int *coords, void *fdata)
-{
-  return QMP_get_node_number_from(coords);
-}
-#endif
-
 
-static bool comms_initialized = false;
-
-void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata)
-{
-  if (nDim != 4) {
-    errorQuda("Number of communication grid dimensions must be 4");
-  }
-
-  if (!func) {
-
-#if QMP_COMMS
-    if (QMP_logical_topology_is_declared()) {
-      if (QMP_get_logical_number_of_dimensions() != 4) {
-        errorQuda("QMP logical topology must have 4 dimensions");
-      }
-      for (int i=0; i<nDim; i++) {
-        int qdim = QMP_get_logical_dimensions()[i];
-        if(qdim != dims[i]) {
-          errorQuda("QMP logical dims[%d]=%d does not match dims[%d]=%d argument", i, qdim, i, dims[i]);
-        }
-      }
-      fdata = NULL;
-      func = qmp_rank_from_coords;
-    } else {
-      warningQuda("QMP logical topology is undeclared; using default lexicographical ordering");
-#endif
-
-      LexMapData map_data;
-      map_data.ndim = nDim;
-      for (int i=0; i<nDim; i++) {
-        map_data.dims[i] = dims[i];
-      }
-      fdata = (void *) &map_data;
-      func = lex_rank_from_coords;
-
-#if QMP_COMMS
-    }
-#endif      
-
-  }
-  comm_init(nDim, dims, func, fdata);
-  comms_initialized = true;
-}
-
-
-static void init_default_comms()
-{
-#if defined(QMP_COMMS)
-  if (QMP_logical_topology_is_declared()) {
-    int ndim = QMP_get_logical_number_of_dimensions();
-    const int *dims = QMP_get_logical_dimensions();
-    initCommsGridQuda(ndim, dims, NULL, NULL);
-  } else {
-    errorQuda("initQuda() called without prior call to initCommsGridQuda(),"
-        " and QMP logical topology has not been declared");
-  }
-#elif defined(MPI_COMMS)
-  errorQuda("When using MPI for communications, initCommsGridQuda() must be called before initQuda()");
-#else // single-GPU
-  const int dims[4] = {1, 1, 1, 1};
-  initCommsGridQuda(4, dims, NULL, NULL);
-#endif
-}
+// the communications grid is set up in interface_host.cpp
+extern bool comms_initialized;
+void init_default_comms();
 
 
 /*
@@ -276,6 +199,7 @@ void initQudaDevice(int dev) {
   cudaSetDevice(dev);
   checkCudaErrorNoSync(); // "NoSync" for correctness in HOST_DEBUG mode
 #endif
+  quda_device = dev;
 
 #ifdef NUMA_AFFINITY
   if(numa_affinity_enabled){
@@ -347,6 +271,7 @@ void initQuda(int dev)
 
 void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 {
+  drainInvertQueue();
   profileGauge.Start(QUDA_PROFILE_TOTAL);
 
   if (!initialized) errorQuda("QUDA not initialized");
@@ -447,6 +372,7 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 
 void saveGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 {
+  drainInvertQueue();
   profileGauge.Start(QUDA_PROFILE_TOTAL);
 
   if (param->location != QUDA_CPU_FIELD_LOCATION) 
@@ -481,8 +407,35 @@ void saveGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 }
 
 
+void writeSpinorQuda(const char *filename, void *h_x, QudaInvertParam *param)
+{
+  pushVerbosity(param->verbosity);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+  if (!gaugePrecise) errorQuda("Gauge field not allocated");
+  if (param->solution_type == QUDA_MATPC_SOLUTION || param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION)
+    errorQuda("Only full-lattice solutions can be written");
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH)
+    errorQuda("Domain wall solutions not supported");
+  if (param->dirac_order == QUDA_QDPJIT_DIRAC_ORDER || param->dirac_order == QUDA_INTERNAL_DIRAC_ORDER)
+    errorQuda("Dirac order %d not supported", param->dirac_order);
+
+  ColorSpinorParam cpuParam(h_x, *param, gaugePrecise->X(), false);
+  writeSpinorFile(filename, cpuParam);
+
+  popVerbosity();
+}
+
+
+void flushSpinorWriterQuda(void)
+{
+  flushSpinorWriter();
+}
+
+
 void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
 {
+  drainInvertQueue();
   profileClover.Start(QUDA_PROFILE_TOTAL);
 
   pushVerbosity(inv_param->verbosity);
@@ -608,6 +561,7 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
 
 void freeGaugeQuda(void) 
 {  
+  drainInvertQueue();
   if (!initialized) errorQuda("QUDA not initialized");
   if (gaugeSloppy != gaugePrecondition && gaugePrecondition) delete gaugePrecondition;
   if (gaugePrecise != gaugeSloppy && gaugeSloppy) delete gaugeSloppy;
@@ -637,6 +591,7 @@ void freeGaugeQuda(void)
 
 void freeCloverQuda(void)
 {
+  drainInvertQueue();
   if (!initialized) errorQuda("QUDA not initialized");
   if (cloverPrecondition != cloverSloppy && cloverPrecondition) delete cloverPrecondition;
   if (cloverSloppy != cloverPrecise && cloverSloppy) delete cloverSloppy;
@@ -650,6 +605,7 @@ void freeCloverQuda(void)
 
 void endQuda(void)
 {
+  drainInvertQueue();
   profileEnd.Start(QUDA_PROFILE_TOTAL);
 
   if (!initialized) return;
@@ -661,6 +617,8 @@ void endQuda(void)
   FaceBuffer::flushPinnedCache();
   freeGaugeQuda();
   freeCloverQuda();
+  flushChronoQuda(-1);
+  flushSpinorWriterQuda();
 
   endBlas();
 
@@ -696,6 +654,8 @@ void endQuda(void)
     profileFatLink.Print();
     profileGaugeForce.Print();
     profileEnd.Print();
+    char *top = getenv("QUDA_KERNEL_STATS_TOP");
+    kernelStatsPrint(top ? atoi(top) : 20);
 
     printfQuda("\n");
     printPeakMemUsage();
@@ -706,6 +666,45 @@ void endQuda(void)
 }
 
 
+int getKernelStatsQuda(QudaKernelStats *stats, int n)
+{
+  drainInvertQueue(); // the queued solves record into the statistics
+  std::vector<std::pair<TuneKey, KernelStats> > top;
+  kernelStatsTop(top, n);
+
+  for (size_t i=0; i<top.size(); i++) {
+    const TuneKey &key = top[i].first;
+    QudaKernelStats &s = stats[i];
+    strncpy(s.name, key.name.c_str(), sizeof(s.name)-1);
+    s.name[sizeof(s.name)-1] = '\0';
+    strncpy(s.volume, key.volume.c_str(), sizeof(s.volume)-1);
+    s.volume[sizeof(s.volume)-1] = '\0';
+    strncpy(s.aux, key.aux.c_str(), sizeof(s.aux)-1);
+    s.aux[sizeof(s.aux)-1] = '\0';
+    s.calls = top[i].second.calls;
+    s.untimed_calls = top[i].second.untimed;
+    s.secs = top[i].second.secs;
+    s.gflops = 1e-9*top[i].second.flops;
+    s.gbytes = 1e-9*top[i].second.bytes;
+  }
+  return top.size();
+}
+
+
+void printKernelStatsQuda(int n)
+{
+  drainInvertQueue();
+  kernelStatsPrint(n);
+}
+
+
+void resetKernelStatsQuda(void)
+{
+  drainInvertQueue();
+  kernelStatsReset();
+}
+
+
 namespace quda {
 
   void setDiracParam(DiracParam &diracParam, QudaInvertParam *inv_param, const bool pc)
@@ -920,6 +919,7 @@ namespace quda {
 
 void dslashQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity parity)
 {
+  drainInvertQueue();
   if (inv_param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
 
   if (gaugePrecise == NULL) errorQuda("Gauge field not allocated");
@@ -984,88 +984,100 @@ void dslashQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity
 }
 
 
-void MatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
+/**
+   Whether a field is a device field in the layout of the device
+   fields described by param, so that it can be used in place instead
+   of being copied.
+*/
+static bool deviceLayout(const ColorSpinorField &f, const ColorSpinorParam &param)
+{
+  return f.Location() == QUDA_CUDA_FIELD_LOCATION && f.Precision() == param.precision &&
+    f.FieldOrder() == param.fieldOrder && f.GammaBasis() == param.gammaBasis &&
+    f.SiteSubset() == param.siteSubset && f.Pad() == param.pad;
+}
+
+
+/**
+   Apply M, or MdagM if normal, to fields of any location and layout.
+   The device fields already in the layout of the operator are used
+   in place; the others are copied in and out.
+*/
+static void applyMatQuda(ColorSpinorField &out_h, ColorSpinorField &in_h, QudaInvertParam *inv_param, bool normal)
 {
   pushVerbosity(inv_param->verbosity);
 
   if (inv_param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
+
+  if (!initialized) errorQuda("QUDA not initialized");
   if (gaugePrecise == NULL) errorQuda("Gauge field not allocated");
   if (cloverPrecise == NULL && inv_param->dslash_type == QUDA_CLOVER_WILSON_DSLASH) 
     errorQuda("Clover field not allocated");
+  if (&out_h == &in_h) errorQuda("The output and input fields must differ");
   if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(inv_param);
 
   bool pc = (inv_param->solution_type == QUDA_MATPC_SOLUTION ||
       inv_param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
 
-  ColorSpinorParam cpuParam(h_in, *inv_param, gaugePrecise->X(), pc);
-  ColorSpinorField *in_h = (inv_param->input_location == QUDA_CPU_FIELD_LOCATION) ?
-    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
-    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
-
+  ColorSpinorParam cpuParam(in_h);
   ColorSpinorParam cudaParam(cpuParam, *inv_param);
-  cudaColorSpinorField in(*in_h, cudaParam);
+  cudaColorSpinorField *in = deviceLayout(in_h, cudaParam) ?
+    static_cast<cudaColorSpinorField*>(&in_h) : new cudaColorSpinorField(in_h, cudaParam);
 
   if (getVerbosity() >= QUDA_VERBOSE) {
-    double cpu = norm2(*in_h);
-    double gpu = norm2(in);
+    double cpu = norm2(in_h);
+    double gpu = norm2(*in);
     printfQuda("In CPU %e CUDA %e\n", cpu, gpu);
   }
 
   cudaParam.create = QUDA_NULL_FIELD_CREATE;
-  cudaColorSpinorField out(in, cudaParam);
+  cudaColorSpinorField *out = deviceLayout(out_h, cudaParam) ?
+    static_cast<cudaColorSpinorField*>(&out_h) : new cudaColorSpinorField(*in, cudaParam);
 
   DiracParam diracParam;
   setDiracParam(diracParam, inv_param, pc);
 
   Dirac *dirac = Dirac::create(diracParam); // create the Dirac operator
-  dirac->M(out, in); // apply the operator
+  if (normal) dirac->MdagM(*out, *in); // apply the operator
+  else dirac->M(*out, *in);
   delete dirac; // clean up
 
   double kappa = inv_param->kappa;
+  double scale = 1.0;
   if (pc) {
     if (inv_param->mass_normalization == QUDA_MASS_NORMALIZATION) {
-      axCuda(0.25/(kappa*kappa), out);
+      scale = normal ? 1.0/pow(2.0*kappa,4) : 0.25/(kappa*kappa);
     } else if (inv_param->mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-      axCuda(0.5/kappa, out);
+      scale = normal ? 0.25/(kappa*kappa) : 0.5/kappa;
     }
   } else {
     if (inv_param->mass_normalization == QUDA_MASS_NORMALIZATION ||
         inv_param->mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-      axCuda(0.5/kappa, out);
+      scale = normal ? 0.25/(kappa*kappa) : 0.5/kappa;
     }
   }
+  if (scale != 1.0) axCuda(scale, *out);
 
-  cpuParam.v = h_out;
-
-  ColorSpinorField *out_h = (inv_param->output_location == QUDA_CPU_FIELD_LOCATION) ?
-    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
-    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
-  *out_h = out;
+  if (out != &out_h) out_h = *out;
 
   if (getVerbosity() >= QUDA_VERBOSE) {
-    double cpu = norm2(*out_h);
-    double gpu = norm2(out);
+    double cpu = norm2(out_h);
+    double gpu = norm2(*out);
     printfQuda("Out CPU %e CUDA %e\n", cpu, gpu);
   }
 
-  delete out_h;
-  delete in_h;
+  if (out != &out_h) delete out;
+  if (in != &in_h) delete in;
 
   popVerbosity();
 }
 
 
-void MatDagMatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
+/**
+   Wrap the host pointers of the MatQuda and MatDagMatQuda calls.
+*/
+static void applyMatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, bool normal)
 {
-  pushVerbosity(inv_param->verbosity);
-
-  if (inv_param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
-
-  if (!initialized) errorQuda("QUDA not initialized");
   if (gaugePrecise == NULL) errorQuda("Gauge field not allocated");
-  if (cloverPrecise == NULL && inv_param->dslash_type == QUDA_CLOVER_WILSON_DSLASH) 
-    errorQuda("Clover field not allocated");
-  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(inv_param);
 
   bool pc = (inv_param->solution_type == QUDA_MATPC_SOLUTION ||
       inv_param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
@@ -1073,61 +1085,31 @@ void MatDagMatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
   ColorSpinorParam cpuParam(h_in, *inv_param, gaugePrecise->X(), pc);
   ColorSpinorField *in_h = (inv_param->input_location == QUDA_CPU_FIELD_LOCATION) ?
     static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
-    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));  
-
-  ColorSpinorParam cudaParam(cpuParam, *inv_param);
-  cudaColorSpinorField in(*in_h, cudaParam);
-
-  if (getVerbosity() >= QUDA_VERBOSE) {
-    double cpu = norm2(*in_h);
-    double gpu = norm2(in);
-    printfQuda("In CPU %e CUDA %e\n", cpu, gpu);
-  }
-
-  cudaParam.create = QUDA_NULL_FIELD_CREATE;
-  cudaColorSpinorField out(in, cudaParam);
-
-  //  double kappa = inv_param->kappa;
-  //  if (inv_param->dirac_order == QUDA_CPS_WILSON_DIRAC_ORDER) kappa *= gaugePrecise->anisotropy;
-
-  DiracParam diracParam;
-  setDiracParam(diracParam, inv_param, pc);
-
-  Dirac *dirac = Dirac::create(diracParam); // create the Dirac operator
-  dirac->MdagM(out, in); // apply the operator
-  delete dirac; // clean up
-
-  double kappa = inv_param->kappa;
-  if (pc) {
-    if (inv_param->mass_normalization == QUDA_MASS_NORMALIZATION) {
-      axCuda(1.0/pow(2.0*kappa,4), out);
-    } else if (inv_param->mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-      axCuda(0.25/(kappa*kappa), out);
-    }
-  } else {
-    if (inv_param->mass_normalization == QUDA_MASS_NORMALIZATION ||
-        inv_param->mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-      axCuda(0.25/(kappa*kappa), out);
-    }
-  }
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
 
   cpuParam.v = h_out;
-
   ColorSpinorField *out_h = (inv_param->output_location == QUDA_CPU_FIELD_LOCATION) ?
     static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
     static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
-  *out_h = out;
 
-  if (getVerbosity() >= QUDA_VERBOSE) {
-    double cpu = norm2(*out_h);
-    double gpu = norm2(out);
-    printfQuda("Out CPU %e CUDA %e\n", cpu, gpu);
-  }
+  applyMatQuda(*out_h, *in_h, inv_param, normal);
 
   delete out_h;
   delete in_h;
+}
 
-  popVerbosity();
+
+void MatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
+{
+  drainInvertQueue();
+  applyMatQuda(h_out, h_in, inv_param, false);
+}
+
+
+void MatDagMatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
+{
+  drainInvertQueue();
+  applyMatQuda(h_out, h_in, inv_param, true);
 }
 
 quda::cudaGaugeField* checkGauge(QudaInvertParam *param) {
@@ -1153,6 +1135,7 @@ quda::cudaGaugeField* checkGauge(QudaInvertParam *param) {
 
 void cloverQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity parity, int inverse)
 {
+  drainInvertQueue();
   pushVerbosity(inv_param->verbosity);
 
   if (!initialized) errorQuda("QUDA not initialized");
@@ -1223,7 +1206,77 @@ void cloverQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity
 }
 
 
-void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
+/**
+   Mixed-precision CG run on the host threads, directly on the user's
+   host fields.  The inner solver vectors are kept in the
+   cpu_storage_sloppy format, and the links of the sloppy operator
+   are compressed as given by cpu_reconstruct_sloppy.  With
+   cpu_virtual_node_sloppy the sloppy operator and the inner vectors
+   use the virtual-node layout.  Both operators visit the sites in the
+   cpu_stencil_order, and share their neighbor tables.
+*/
+static void invertHost(ColorSpinorField &h_x, ColorSpinorField &h_b, QudaInvertParam *param,
+		       bool pc_solution, bool pc_solve)
+{
+  if (param->dslash_type != QUDA_WILSON_DSLASH)
+    errorQuda("Host solver only supports the Wilson dslash");
+  if (param->inv_type != QUDA_CG_INVERTER)
+    errorQuda("Host solver only supports CG");
+  if (param->solve_type != QUDA_NORMOP_SOLVE && param->solve_type != QUDA_NORMOP_PC_SOLVE)
+    errorQuda("Host solver requires a NORMOP or NORMOP_PC solve type");
+  if (pc_solution != pc_solve)
+    errorQuda("Host solver requires matching solution and solve preconditioning");
+  if (h_b.Location() != QUDA_CPU_FIELD_LOCATION || h_x.Location() != QUDA_CPU_FIELD_LOCATION)
+    errorQuda("Host solver requires host input and output fields");
+  if (param->chrono_max_dim > 0 && getVerbosity() >= QUDA_SUMMARIZE)
+    warningQuda("Chronological forecasting is not supported by the host solver, ignoring chrono_max_dim");
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, param, pc_solve);
+  DiracWilsonCpu dirac(diracParam, param->cpu_prec == QUDA_DOUBLE_PRECISION ?
+		       QUDA_DOUBLE_STORAGE : QUDA_SINGLE_STORAGE, QUDA_RECONSTRUCT_NO, false,
+		       param->cpu_stencil_order);
+  DiracWilsonCpu diracSloppy(diracParam, param->cpu_storage_sloppy, param->cpu_reconstruct_sloppy,
+			     param->cpu_virtual_node_sloppy != 0, param->cpu_stencil_order);
+
+  cpuColorSpinorField &x = static_cast<cpuColorSpinorField&>(h_x);
+
+  double nb = normCpu(static_cast<cpuColorSpinorField&>(h_b));
+  if (nb==0.0) errorQuda("Solution has zero norm");
+
+  // rescale a copy of the source and the solution to help prevent the onset of underflow
+  cpuColorSpinorField b(static_cast<cpuColorSpinorField&>(h_b));
+  axCpu(1.0/sqrt(nb), b);
+  if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) axCpu(1.0/sqrt(nb), x);
+  else x.zero();
+
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) || (param->solution_type ==  QUDA_MATPC_SOLUTION);
+  if (mat_solution) { // prepare source: b' = A^dag b
+    cpuColorSpinorField tmp(b);
+    dirac.Mdag(b, tmp);
+  }
+
+  double scale = 1.0;
+  massRescaleCoeff(param->dslash_type, param->kappa, param->solution_type, param->mass_normalization, scale);
+  if (scale != 1.0) axCpu(scale, b);
+
+  {
+    SolverParam solverParam(*param);
+    CGCpu cg(dirac, diracSloppy, solverParam, profileInvert);
+    cg(x, b);
+    solverParam.updateInvertParam(*param);
+  }
+
+  axCpu(sqrt(nb), x);
+  if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Solution = %g\n", normCpu(x));
+}
+
+/**
+   Solve on fields of any location and layout.  A device solution
+   field already in the layout of the solver is solved in place; the
+   other fields are copied in and out.
+*/
+static void invertFieldsQuda(ColorSpinorField *h_x, ColorSpinorField *h_b, QudaInvertParam *param)
 {
 
   if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
@@ -1266,6 +1319,17 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   param->gflops = 0;
   param->iter = 0;
 
+  if ((h_b->SiteSubset() == QUDA_PARITY_SITE_SUBSET) != pc_solution ||
+      (h_x->SiteSubset() == QUDA_PARITY_SITE_SUBSET) != pc_solution)
+    errorQuda("Site subset of the fields does not match the solution type %d", param->solution_type);
+
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION) {
+    invertHost(*h_x, *h_b, param, pc_solution, pc_solve);
+    popVerbosity();
+    profileInvert.Stop(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   Dirac *d = NULL;
   Dirac *dSloppy = NULL;
   Dirac *dPre = NULL;
@@ -1284,24 +1348,14 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   cudaColorSpinorField *in = NULL;
   cudaColorSpinorField *out = NULL;
 
-  const int *X = cudaGauge->X();
-
-  // wrap CPU host side pointers
-  ColorSpinorParam cpuParam(hp_b, *param, X, pc_solution);
-  ColorSpinorField *h_b = (param->input_location == QUDA_CPU_FIELD_LOCATION) ?
-    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
-    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
-
-  cpuParam.v = hp_x;
-  ColorSpinorField *h_x = (param->output_location == QUDA_CPU_FIELD_LOCATION) ?
-    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
-    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
-
   // download source
+  ColorSpinorParam cpuParam(*h_b);
   ColorSpinorParam cudaParam(cpuParam, *param);
   cudaParam.create = QUDA_COPY_FIELD_CREATE;
   b = new cudaColorSpinorField(*h_b, cudaParam); 
 
+  const bool in_place = deviceLayout(*h_x, cudaParam) && h_x != h_b;
+
   if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) { // download initial guess
     // initial guess only supported for single-pass solvers
     if ((param->solution_type == QUDA_MATDAG_MAT_SOLUTION || param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION) &&
@@ -1309,7 +1363,11 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
       errorQuda("Initial guess not supported for two-pass solver");
     }
 
-    x = new cudaColorSpinorField(*h_x, cudaParam); // solution  
+    if (in_place) x = static_cast<cudaColorSpinorField*>(h_x);
+    else x = new cudaColorSpinorField(*h_x, cudaParam); // solution  
+  } else if (in_place) {
+    x = static_cast<cudaColorSpinorField*>(h_x);
+    x->zero();
   } else { // zero initial guess
     cudaParam.create = QUDA_ZERO_FIELD_CREATE;
     x = new cudaColorSpinorField(cudaParam); // solution
@@ -1400,12 +1458,35 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   } else {
     DiracMdagM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     SolverParam solverParam(*param);
+
+    // forecast the initial guess from the previous solutions of this channel
+    ChronoHistory *history = NULL;
+    if (param->chrono_max_dim > 0) {
+      if (chronoHistory.find(param->chrono_index) == chronoHistory.end())
+	chronoHistory[param->chrono_index] = new ChronoHistory();
+      history = chronoHistory[param->chrono_index];
+
+      if (history->Size() > 0 && param->use_init_guess == QUDA_USE_INIT_GUESS_NO) {
+	history->forecast(*out, *in, m, profileInvert);
+	solverParam.use_init_guess = QUDA_USE_INIT_GUESS_YES;
+      }
+    }
+
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
     delete solve;
+
+    if (history) {
+      profileInvert.Start(QUDA_PROFILE_CHRONO);
+      history->push(*out, param->chrono_max_dim, param->chrono_precision);
+      profileInvert.Stop(QUDA_PROFILE_CHRONO);
+    }
   }
 
+  if (param->chrono_max_dim > 0 && direct_solve && getVerbosity() >= QUDA_SUMMARIZE)
+    warningQuda("Chronological forecasting requires a normal-operator solve, ignoring chrono_max_dim");
+
   if (getVerbosity() >= QUDA_VERBOSE){
     double nx = norm2(*x);
     printfQuda("Solution = %g\n",nx);
@@ -1416,7 +1497,7 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   axCuda(sqrt(nb), *x);
 
   profileInvert.Start(QUDA_PROFILE_D2H);
-  *h_x = *x;
+  if (x != h_x) *h_x = *x;
   profileInvert.Stop(QUDA_PROFILE_D2H);
 
   if (getVerbosity() >= QUDA_VERBOSE){
@@ -1425,10 +1506,8 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     printfQuda("Reconstructed: CUDA solution = %g, CPU copy = %g\n", nx, nh_x);
   }
 
-  delete h_b;
-  delete h_x;
   delete b;
-  delete x;
+  if (x != h_x) delete x;
 
   delete d;
   delete dSloppy;
@@ -1443,6 +1522,371 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
 }
 
 
+static void invertPointersQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  // check the gauge fields have been created
+  cudaGaugeField *cudaGauge = checkGauge(param);
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || 
+    (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+
+  // wrap CPU host side pointers
+  ColorSpinorParam cpuParam(hp_b, *param, cudaGauge->X(), pc_solution);
+  ColorSpinorField *h_b = (param->input_location == QUDA_CPU_FIELD_LOCATION) ?
+    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+  cpuParam.v = hp_x;
+  ColorSpinorField *h_x = (param->output_location == QUDA_CPU_FIELD_LOCATION) ?
+    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+  invertFieldsQuda(h_x, h_b, param);
+
+  delete h_b;
+  delete h_x;
+}
+
+
+void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+  drainInvertQueue();
+  invertPointersQuda(hp_x, hp_b, param);
+}
+
+
+/*
+ * Asynchronous solves
+ *
+ * invertQudaAsync queues the solve and returns; a single solver
+ * thread runs the queued solves in order, directly on the arrays of
+ * the application.  The solves share the device, the gauge fields and
+ * the rest of the library state, so they are not run concurrently,
+ * and the other entry points that use that state first wait for the
+ * queue to drain (which also stops the thread).
+ */
+
+struct QudaInvertJob_s {
+  void *h_x;
+  void *h_b;
+  QudaInvertParam *param;
+  bool done;
+};
+
+static pthread_t invertThread;
+static pthread_mutex_t invertMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t invertCond = PTHREAD_COND_INITIALIZER;
+static bool invertRunning = false;
+static bool invertStop = false;
+static std::deque<QudaInvertJob_s*> invertQueue; // the front job is the one being solved
+
+static void* invertLoop(void *)
+{
+  // the current device is per host thread, and a new thread starts on device 0
+  cudaSetDevice(quda_device);
+  checkCudaErrorNoSync();
+
+  pthread_mutex_lock(&invertMutex);
+  while (true) {
+    while (invertQueue.empty() && !invertStop) pthread_cond_wait(&invertCond, &invertMutex);
+    if (invertQueue.empty()) break;
+    QudaInvertJob_s *job = invertQueue.front();
+    pthread_mutex_unlock(&invertMutex);
+
+    invertPointersQuda(job->h_x, job->h_b, job->param);
+
+    pthread_mutex_lock(&invertMutex);
+    invertQueue.pop_front();
+    job->done = true;
+    pthread_cond_broadcast(&invertCond);
+  }
+  pthread_mutex_unlock(&invertMutex);
+  return 0;
+}
+
+static void drainInvertQueue()
+{
+  if (!invertRunning) return;
+  pthread_mutex_lock(&invertMutex);
+  invertStop = true;
+  pthread_cond_broadcast(&invertCond);
+  pthread_mutex_unlock(&invertMutex);
+  pthread_join(invertThread, 0);
+  invertRunning = false;
+}
+
+
+QudaInvertHandle invertQudaAsync(void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  QudaInvertJob_s *job = new QudaInvertJob_s;
+  job->h_x = hp_x;
+  job->h_b = hp_b;
+  job->param = param;
+  job->done = false;
+
+  pthread_mutex_lock(&invertMutex);
+  invertQueue.push_back(job);
+  if (!invertRunning) {
+    invertStop = false;
+    if (pthread_create(&invertThread, 0, invertLoop, 0)) errorQuda("Failed to start the solver thread");
+    invertRunning = true;
+  }
+  pthread_cond_broadcast(&invertCond);
+  pthread_mutex_unlock(&invertMutex);
+
+  return job;
+}
+
+
+int invertQudaTest(QudaInvertHandle handle)
+{
+  pthread_mutex_lock(&invertMutex);
+  const bool done = handle->done;
+  pthread_mutex_unlock(&invertMutex);
+  return done ? 1 : 0;
+}
+
+
+void invertQudaWait(QudaInvertHandle handle)
+{
+  pthread_mutex_lock(&invertMutex);
+  while (!handle->done) pthread_cond_wait(&invertCond, &invertMutex);
+  pthread_mutex_unlock(&invertMutex);
+  delete handle;
+}
+
+
+void flushChronoQuda(int index)
+{
+  drainInvertQueue(); // the queued solves use the histories
+  for (std::map<int, ChronoHistory*>::iterator it = chronoHistory.begin(); it != chronoHistory.end(); ) {
+    if (index < 0 || it->first == index) {
+      delete it->second;
+      chronoHistory.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+
+QUDA_DiracFieldParam QUDA_newDiracFieldParam(void)
+{
+  QUDA_DiracFieldParam param;
+  for (int d=0; d<4; d++) param.X[d] = 0;
+  param.Ls = 1;
+  param.Nc = 3;
+  param.Ns = 4;
+  param.twist_flavor = QUDA_TWIST_NO;
+  param.pad = 0;
+  param.precision = QUDA_INVALID_PRECISION;
+  param.location = QUDA_INVALID_FIELD_LOCATION;
+  param.site_subset = QUDA_FULL_SITE_SUBSET;
+  param.dirac_order = QUDA_INVALID_DIRAC_ORDER;
+  param.gamma_basis = QUDA_INVALID_GAMMA_BASIS;
+  return param;
+}
+
+
+/**
+   Create the field of a handle, through the same description of the
+   field as invertQuda() uses for the application fields.
+*/
+static QUDA_DiracField* newDiracField(void *v, const QUDA_DiracFieldParam *param, QudaFieldCreate create)
+{
+  if (param->Nc != 3) errorQuda("Number of colors %d not supported", param->Nc);
+  if (param->Ns != 1 && param->Ns != 4) errorQuda("Number of spins %d not supported", param->Ns);
+  if (param->site_subset != QUDA_FULL_SITE_SUBSET && param->site_subset != QUDA_PARITY_SITE_SUBSET)
+    errorQuda("Site subset %d not supported", param->site_subset);
+  if (param->location != QUDA_CPU_FIELD_LOCATION && param->location != QUDA_CUDA_FIELD_LOCATION)
+    errorQuda("Field location %d not supported", param->location);
+
+  QudaInvertParam inv_param = newQudaInvertParam();
+  if (param->Ns == 1) inv_param.dslash_type = QUDA_ASQTAD_DSLASH;
+  else if (param->Ls > 1) inv_param.dslash_type = QUDA_DOMAIN_WALL_DSLASH;
+  else if (param->twist_flavor == QUDA_TWIST_NONDEG_DOUBLET) inv_param.dslash_type = QUDA_TWISTED_MASS_DSLASH;
+  else inv_param.dslash_type = QUDA_WILSON_DSLASH;
+  inv_param.Ls = param->Ls;
+  inv_param.twist_flavor = param->twist_flavor;
+  inv_param.cpu_prec = param->precision;
+  inv_param.dirac_order = param->dirac_order;
+  inv_param.gamma_basis = param->gamma_basis;
+
+  ColorSpinorParam csParam(v, inv_param, param->X, param->site_subset == QUDA_PARITY_SITE_SUBSET);
+  csParam.pad = param->pad;
+  csParam.create = create;
+
+  QUDA_DiracField *field = new QUDA_DiracField;
+  field->dirac_order = param->dirac_order;
+  if (param->location == QUDA_CPU_FIELD_LOCATION) {
+    if (param->dirac_order == QUDA_INTERNAL_DIRAC_ORDER) errorQuda("Host fields require a host Dirac order");
+    field->field = new cpuColorSpinorField(csParam);
+  } else {
+    field->field = new cudaColorSpinorField(csParam);
+  }
+  return field;
+}
+
+
+QUDA_DiracField* QUDA_createDiracField(const QUDA_DiracFieldParam *param)
+{
+  return newDiracField(0, param, QUDA_ZERO_FIELD_CREATE);
+}
+
+
+QUDA_DiracField* QUDA_wrapDiracField(void *v, const QUDA_DiracFieldParam *param)
+{
+  if (!v) errorQuda("Cannot wrap a null pointer");
+  if (param->location == QUDA_CUDA_FIELD_LOCATION && param->precision == QUDA_HALF_PRECISION)
+    errorQuda("Half precision device fields cannot be wrapped");
+  return newDiracField(v, param, QUDA_REFERENCE_FIELD_CREATE);
+}
+
+
+void QUDA_destroyDiracField(QUDA_DiracField *field)
+{
+  if (!field) return;
+  delete static_cast<ColorSpinorField*>(field->field);
+  delete field;
+}
+
+
+void* QUDA_diracFieldData(QUDA_DiracField *field)
+{
+  return static_cast<ColorSpinorField*>(field->field)->V();
+}
+
+
+void QUDA_copyDiracField(QUDA_DiracField *dst, QUDA_DiracField *src)
+{
+  drainInvertQueue();
+  if (dst == src) return;
+  *static_cast<ColorSpinorField*>(dst->field) = *static_cast<ColorSpinorField*>(src->field);
+}
+
+
+double QUDA_normDiracField(QUDA_DiracField *field)
+{
+  drainInvertQueue();
+  return norm2(*static_cast<ColorSpinorField*>(field->field));
+}
+
+
+/**
+   The fields of a call, whose site subset must match the solution
+   type.
+*/
+static void getDiracFields(ColorSpinorField *&x, ColorSpinorField *&y, QUDA_DiracField *x_, QUDA_DiracField *y_,
+			   const QudaInvertParam *param)
+{
+  x = static_cast<ColorSpinorField*>(x_->field);
+  y = static_cast<ColorSpinorField*>(y_->field);
+  const bool pc = (param->solution_type == QUDA_MATPC_SOLUTION || param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  const QudaSiteSubset subset = pc ? QUDA_PARITY_SITE_SUBSET : QUDA_FULL_SITE_SUBSET;
+  if (x->SiteSubset() != subset || y->SiteSubset() != subset)
+    errorQuda("Site subset of the fields does not match the solution type %d", param->solution_type);
+}
+
+
+void QUDA_MatDiracField(QUDA_DiracField *out, QUDA_DiracField *in, QudaInvertParam *inv_param)
+{
+  drainInvertQueue();
+  ColorSpinorField *out_h, *in_h;
+  getDiracFields(out_h, in_h, out, in, inv_param);
+  applyMatQuda(*out_h, *in_h, inv_param, false);
+}
+
+
+void QUDA_MatDagMatDiracField(QUDA_DiracField *out, QUDA_DiracField *in, QudaInvertParam *inv_param)
+{
+  drainInvertQueue();
+  ColorSpinorField *out_h, *in_h;
+  getDiracFields(out_h, in_h, out, in, inv_param);
+  applyMatQuda(*out_h, *in_h, inv_param, true);
+}
+
+
+void QUDA_invertDiracField(QUDA_DiracField *x, QUDA_DiracField *b, QudaInvertParam *param)
+{
+  drainInvertQueue();
+  if (!initialized) errorQuda("QUDA not initialized");
+  ColorSpinorField *h_x, *h_b;
+  getDiracFields(h_x, h_b, x, b, param);
+  if (h_x->Precision() != h_b->Precision() || x->dirac_order != b->dirac_order)
+    errorQuda("The solution and source fields must have the same precision and order");
+
+  param->input_location = h_b->Location();
+  param->output_location = h_x->Location();
+  param->cpu_prec = h_b->Precision();
+  param->dirac_order = b->dirac_order;
+  invertFieldsQuda(h_x, h_b, param);
+}
+
+
+/**
+   Multi-shift CG run on the host threads, directly on the user's host
+   fields.  Only the gauge field is taken from the device (once, when
+   the host operator is constructed).  The operator visits the sites
+   in the cpu_stencil_order.
+*/
+static void invertMultiShiftHost(void **hp_x, void *hp_b, QudaInvertParam *param, bool pc_solve)
+{
+  if (param->dslash_type != QUDA_WILSON_DSLASH)
+    errorQuda("Host multi-shift solver only supports the Wilson dslash");
+  if (param->input_location != QUDA_CPU_FIELD_LOCATION || param->output_location != QUDA_CPU_FIELD_LOCATION)
+    errorQuda("Host multi-shift solver requires host input and output fields");
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, param, pc_solve);
+  DiracWilsonCpu dirac(diracParam, param->cpu_prec == QUDA_DOUBLE_PRECISION ?
+		       QUDA_DOUBLE_STORAGE : QUDA_SINGLE_STORAGE, QUDA_RECONSTRUCT_NO, false,
+		       param->cpu_stencil_order);
+
+  ColorSpinorParam cpuParam(hp_b, *param, gaugePrecise->X(), pc_solve);
+  cpuColorSpinorField h_b(cpuParam);
+
+  cpuColorSpinorField *x[QUDA_MAX_MULTI_SHIFT];
+  for (int i=0; i<param->num_offset; i++) {
+    cpuParam.v = hp_x[i];
+    x[i] = new cpuColorSpinorField(cpuParam);
+  }
+
+  // rescale a copy of the source to help prevent the onset of underflow
+  cpuColorSpinorField b(h_b);
+  double nb = normCpu(b);
+  if (nb==0.0) errorQuda("Solution has zero norm");
+
+  double scale = 1.0/sqrt(nb);
+  massRescaleCoeff(param->dslash_type, param->kappa, param->solution_type, param->mass_normalization, scale);
+  axCpu(scale, b);
+
+  double unscaled_shifts[QUDA_MAX_MULTI_SHIFT];
+  for (int i=0; i < param->num_offset; i++) {
+    unscaled_shifts[i] = param->offset[i];
+    massRescaleCoeff(param->dslash_type, param->kappa, param->solution_type, param->mass_normalization, param->offset[i]);
+  }
+
+  {
+    SolverParam solverParam(*param);
+    MultiShiftCGCpu cg_m(dirac, solverParam, profileMulti);
+    cg_m(x, b);
+    solverParam.updateInvertParam(*param);
+  }
+
+  // restore shifts -- avoid side effects
+  for (int i=0; i < param->num_offset; i++) param->offset[i] = unscaled_shifts[i];
+
+  for (int i=0; i < param->num_offset; i++) {
+    axCpu(sqrt(nb), *x[i]);
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Solution %d = %g\n", i, normCpu(*x[i]));
+    delete x[i];
+  }
+}
+
 /*! 
  * Generic version of the multi-shift solver. Should work for
  * most fermions. Note that offset[0] is not folded into the mass parameter.
@@ -1453,6 +1897,7 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
  */
 void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
 {
+  drainInvertQueue();
   profileMulti.Start(QUDA_PROFILE_TOTAL);
 
   if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
@@ -1513,6 +1958,13 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
     }
   }
 
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION) {
+    invertMultiShiftHost(_hp_x, _hp_b, param, pc_solve);
+    popVerbosity();
+    profileMulti.Stop(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   // Host pointers for x, take a copy of the input host pointers
   void** hp_x;
   hp_x = new void* [ param->num_offset ];
@@ -1742,6 +2194,7 @@ void invertMultiShiftQuda(void **_hp_x, void *_hp_b, QudaInvertParam *param)
 /*   @method  
  *   QUDA_COMPUTE_FAT_STANDARD: standard method (default)
  *   QUDA_COMPUTE_FAT_EXTENDED_VOLUME, extended volume method
+ *   QUDA_COMPUTE_FAT_HOST, extended volume method on the host threads
  *
  */
 #include <sys/time.h>
@@ -1847,16 +2300,69 @@ namespace quda {
 
 
 
+/**
+   Link fattening on the host threads.  As with the extended volume
+   method, the site links are given on the extended volume and their
+   border is exchanged here.
+*/
+static void computeKSLinkHost(void* fatlink, void* longlink, void** sitelink, double* act_path_coeff,
+			      QudaGaugeParam* qudaGaugeParam)
+{
+  GaugeFieldParam gParam(0, *qudaGaugeParam);
+  gParam.pad = 0;
+  gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+  gParam.order = QUDA_MILC_GAUGE_ORDER;
+
+  gParam.link_type = QUDA_ASQTAD_FAT_LINKS;
+  gParam.gauge = fatlink;
+  cpuGaugeField cpuFatLink(gParam);
+
+  cpuGaugeField *cpuLongLink = NULL;
+  if (longlink) {
+    gParam.link_type = QUDA_ASQTAD_LONG_LINKS;
+    gParam.gauge = longlink;
+    cpuLongLink = new cpuGaugeField(gParam);
+  }
+
+  gParam.link_type = qudaGaugeParam->type;
+  gParam.order = qudaGaugeParam->gauge_order;
+  gParam.gauge = sitelink;
+  for (int dir=0; dir<4; dir++) gParam.x[dir] = qudaGaugeParam->X[dir] + 4;
+  cpuGaugeField cpuSiteLink(gParam);
+  profileFatLink.Stop(QUDA_PROFILE_INIT);
+
+#ifdef MULTI_GPU
+  profileFatLink.Start(QUDA_PROFILE_COMMS);
+  int R[4] = {2, 2, 2, 2}; // radius of the extended region in each dimension / direction
+  exchange_cpu_sitelink_ex(qudaGaugeParam->X, R, (void**)cpuSiteLink.Gauge_p(),
+			   cpuSiteLink.Order(), qudaGaugeParam->cpu_prec, 0);
+  profileFatLink.Stop(QUDA_PROFILE_COMMS);
+#endif
+
+  profileFatLink.Start(QUDA_PROFILE_COMPUTE);
+  llfatCpu(cpuFatLink, cpuLongLink, cpuSiteLink, act_path_coeff);
+  profileFatLink.Stop(QUDA_PROFILE_COMPUTE);
+
+  if (cpuLongLink) delete cpuLongLink;
+}
+
   int
 computeKSLinkQuda(void* fatlink, void* longlink, void** sitelink, double* act_path_coeff, 
     QudaGaugeParam* qudaGaugeParam, 
     QudaComputeFatMethod method)
 {
+  drainInvertQueue();
 
   profileFatLink.Start(QUDA_PROFILE_TOTAL);
 
   profileFatLink.Start(QUDA_PROFILE_INIT);
 
+  if (method == QUDA_COMPUTE_FAT_HOST) {
+    computeKSLinkHost(fatlink, longlink, sitelink, act_path_coeff, qudaGaugeParam);
+    profileFatLink.Stop(QUDA_PROFILE_TOTAL);
+    return 0;
+  }
+
   static cpuGaugeField* cpuFatLink=NULL, *cpuSiteLink=NULL, *cpuLongLink=NULL;
   static cudaGaugeField* cudaFatLink=NULL, *cudaSiteLink=NULL, *cudaLongLink=NULL;
   int flag = qudaGaugeParam->preserve_gauge;
@@ -2024,14 +2530,68 @@ computeKSLinkQuda(void* fatlink, void* longlink, void** sitelink, double* act_pa
 #endif
 
 #ifdef GPU_GAUGE_FORCE
+/**
+   Gauge force on the host threads.  The site links are given as for
+   the device force: on the extended volume for multi-GPU, where their
+   border is exchanged here, and on the local volume otherwise.
+*/
+static void computeGaugeForceHost(void* mom, void* sitelink, int*** input_path_buf, int* path_length,
+				  void* loop_coeff, int num_paths, double eb3, QudaGaugeParam* qudaGaugeParam)
+{
+  GaugeFieldParam gParam(0, *qudaGaugeParam);
+  gParam.pad = 0;
+  gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+
+  gParam.order = QUDA_MILC_GAUGE_ORDER;
+  gParam.reconstruct = QUDA_RECONSTRUCT_10;
+  gParam.link_type = QUDA_ASQTAD_MOM_LINKS;
+  gParam.gauge = mom;
+  cpuGaugeField cpuMom(gParam);
+
+  gParam.order = qudaGaugeParam->gauge_order;
+  gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  gParam.link_type = qudaGaugeParam->type;
+  gParam.gauge = sitelink;
+#ifdef MULTI_GPU
+  for (int dir=0; dir<4; dir++) gParam.x[dir] = qudaGaugeParam->X[dir] + 4;
+#endif
+  cpuGaugeField cpuSiteLink(gParam);
+  profileGaugeForce.Stop(QUDA_PROFILE_INIT);
+
+#ifdef MULTI_GPU
+  profileGaugeForce.Start(QUDA_PROFILE_COMMS);
+  int R[4] = {2, 2, 2, 2}; // radius of the extended region in each dimension / direction
+  exchange_cpu_sitelink_ex(qudaGaugeParam->X, R, (void**)cpuSiteLink.Gauge_p(),
+			   cpuSiteLink.Order(), qudaGaugeParam->cpu_prec, 1);
+  profileGaugeForce.Stop(QUDA_PROFILE_COMMS);
+#endif
+
+  profileGaugeForce.Start(QUDA_PROFILE_COMPUTE);
+  gaugeForceCpu(cpuMom, eb3, cpuSiteLink, input_path_buf, path_length, loop_coeff, num_paths);
+  profileGaugeForce.Stop(QUDA_PROFILE_COMPUTE);
+}
+
   int
 computeGaugeForceQuda(void* mom, void* sitelink,  int*** input_path_buf, int* path_length,
     void* loop_coeff, int num_paths, int max_length, double eb3,
     QudaGaugeParam* qudaGaugeParam, double* timeinfo)
 {
+  drainInvertQueue();
   profileGaugeForce.Start(QUDA_PROFILE_TOTAL);
 
   profileGaugeForce.Start(QUDA_PROFILE_INIT);
+
+  if (qudaGaugeParam->force_location == QUDA_CPU_FIELD_LOCATION) {
+    computeGaugeForceHost(mom, sitelink, input_path_buf, path_length, loop_coeff, num_paths,
+			  eb3, qudaGaugeParam);
+    profileGaugeForce.Stop(QUDA_PROFILE_TOTAL);
+    if (timeinfo) {
+      timeinfo[0] = 0.0;
+      timeinfo[1] = profileGaugeForce.Last(QUDA_PROFILE_COMPUTE);
+      timeinfo[2] = 0.0;
+    }
+    return 0;
+  }
 #ifdef MULTI_GPU
   int E[4];
   QudaGaugeParam qudaGaugeParam_ex_buf;
@@ -2148,6 +2708,8 @@ computeGaugeForceQuda(void* mom, void* sitelink,  int*** input_path_buf, int* pa
 
 void init_quda_(int *dev) { initQuda(*dev); }
 void end_quda_() { endQuda(); }
+void print_kernel_stats_quda_(int *n) { printKernelStatsQuda(*n); }
+void reset_kernel_stats_quda_() { resetKernelStatsQuda(); }
 void load_gauge_quda_(void *h_gauge, QudaGaugeParam *param) { loadGaugeQuda(h_gauge, param); }
 void free_gauge_quda_() { freeGaugeQuda(); }
 void load_clover_quda_(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param) 
@@ -2163,6 +2725,7 @@ void mat_dag_mat_quda_(void *h_out, void *h_in, QudaInvertParam *inv_param)
 { MatDagMatQuda(h_out, h_in, inv_param); }
 void invert_quda_(void *hp_x, void *hp_b, QudaInvertParam *param) 
 { invertQuda(hp_x, hp_b, param); }    
+void flush_chrono_quda_(int *index) { flushChronoQuda(*index); }
 void new_quda_gauge_param_(QudaGaugeParam *param) {
   *param = newQudaGaugeParam();
 }
@@ -128,6 +128,38 @@ namespace quda {
     cudaColorSpinorField &xSloppy = *x_sloppy;
     cudaColorSpinorField &r0 = *r_0;
 
+    // Checkpoints are taken at reliable updates, where the state is
+    // the accumulated solution y, p, v and the scalar recurrences; the
+    // residual is recomputed from y.
+    SolverCheckpoint checkpoint(param, "BiCGstab", b2, r2);
+
+    int k = 0;
+    int rUpdate = 0;
+  
+    Complex rho(1.0, 0.0);
+    Complex rho0 = rho;
+    Complex alpha(1.0, 0.0);
+    Complex omega(1.0, 0.0);
+    Complex beta;
+
+    double saved[9];
+    const bool resumed = checkpoint.Load(k, saved, 9, 3);
+    if (resumed) {
+      rho = Complex(saved[0], saved[1]);
+      rho0 = Complex(saved[2], saved[3]);
+      alpha = Complex(saved[4], saved[5]);
+      omega = Complex(saved[6], saved[7]);
+      rUpdate = (int)saved[8];
+
+      checkpoint.Restore(y, 0);
+      checkpoint.Restore(p, 1);
+      checkpoint.Restore(v, 2);
+      mat(r, y, x);
+      r2 = xmyNormCuda(b, r);
+      if (&rSloppy != &r) copyCuda(rSloppy, r);
+      zeroCuda(xSloppy);
+    }
+
     SolverParam solve_param_inner(param);
     fillInnerSolveParam(solve_param_inner, param);
 
@@ -135,20 +167,11 @@ namespace quda {
 
     const bool use_heavy_quark_res = 
       (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
-    double heavy_quark_res = use_heavy_quark_res ? sqrt(HeavyQuarkResidualNormCuda(x,r).z) : 0.0;
+    double heavy_quark_res = use_heavy_quark_res ? sqrt(HeavyQuarkResidualNormCuda(resumed ? y : x,r).z) : 0.0;
     int heavy_quark_check = 10; // how often to check the heavy quark residual
 
     double delta = param.delta;
 
-    int k = 0;
-    int rUpdate = 0;
-  
-    Complex rho(1.0, 0.0);
-    Complex rho0 = rho;
-    Complex alpha(1.0, 0.0);
-    Complex omega(1.0, 0.0);
-    Complex beta;
-
     double3 rho_r2;
     double3 omega_t2;
   
@@ -236,7 +259,7 @@ namespace quda {
       //int updateR = (rNorm < delta*maxrr && r0Norm <= maxrr) ? 1 : 0;
       //int updateX = (rNorm < delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
     
-      int updateR = (rNorm < delta*maxrr) ? 1 : 0;
+      int updateR = (rNorm < delta*maxrr || checkpoint.Due(k+1)) ? 1 : 0;
 
       if (updateR) {
 	if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
@@ -258,6 +281,13 @@ namespace quda {
     
       k++;
 
+      if (updateR && checkpoint.Due(k)) {
+	double state[9] = { real(rho), imag(rho), real(rho0), imag(rho0), real(alpha), imag(alpha),
+			    real(omega), imag(omega), (double)rUpdate };
+	cudaColorSpinorField *field[3] = { &y, &p, &v };
+	checkpoint.Save(k, state, 9, field, 3);
+      }
+
       PrintStats("BiCGstab", k, r2, b2, heavy_quark_res);
       if (getVerbosity() >= QUDA_DEBUG_VERBOSE) 
 	printfQuda("BiCGstab debug: x2=%e, r2=%e, v2=%e, p2=%e, tmp2=%e r0=%e t2=%e\n", 
@@ -268,6 +298,8 @@ namespace quda {
     if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
     xpyCuda(y, x);
 
+    checkpoint.Remove(k);
+
     profile.Stop(QUDA_PROFILE_COMPUTE);
     profile.Start(QUDA_PROFILE_EPILOGUE);
 
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+#include <face_quda.h>
+
+#include "cpu_spinor_storage.h"
+
+/*!
+ * Host mixed-precision CG
+ *
+ * The outer loop solves MdagM x = b by defect correction in the
+ * precision of the host fields: each pass normalizes the true
+ * residual, solves for the correction with an inner CG on the sloppy
+ * operator, and accumulates it into x.  The inner r, p and Ap are
+ * kept in the storage format of the sloppy operator, so with half or
+ * bfloat16 storage the inner iterations stream half or a quarter of
+ * the bytes of the single or double precision solver.
+ *
+ */
+
+namespace quda {
+
+  template <typename Storage, typename Float>
+  static void encode(char *out, const Float *in, double scale, int nSites) {
+    typedef typename Storage::RegType RegType;
+#pragma omp parallel for
+    for (int n=0; n<nSites; n++) {
+      RegType v[24];
+      for (int i=0; i<24; i++) v[i] = scale * in[24*n+i];
+      Storage::store(out + (size_t)n*Storage::bytes, v);
+    }
+  }
+
+  template <typename Storage>
+  static double dot(const char *a, const char *b, int nSites) {
+    typedef typename Storage::RegType RegType;
+    double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+    for (int n=0; n<nSites; n++) {
+      RegType a_buf[24], b_buf[24];
+      const RegType *a_ = Storage::load(a + (size_t)n*Storage::bytes, a_buf);
+      const RegType *b_ = Storage::load(b + (size_t)n*Storage::bytes, b_buf);
+      for (int i=0; i<24; i++) sum += a_[i]*b_[i];
+    }
+    reduceDouble(sum);
+    return sum;
+  }
+
+  // e += alpha p, r -= alpha Ap, returns <r,r>
+  template <typename Storage>
+  static double axpyUpdateNorm(typename Storage::RegType *e, char *r, const char *p, const char *Ap,
+			       double alpha, int nSites) {
+    typedef typename Storage::RegType RegType;
+    double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+    for (int n=0; n<nSites; n++) {
+      RegType p_buf[24], Ap_buf[24], r_buf[24], r_new[24];
+      const RegType *p_ = Storage::load(p + (size_t)n*Storage::bytes, p_buf);
+      const RegType *Ap_ = Storage::load(Ap + (size_t)n*Storage::bytes, Ap_buf);
+      const RegType *r_ = Storage::load(r + (size_t)n*Storage::bytes, r_buf);
+      RegType *e_ = e + 24*n;
+      for (int i=0; i<24; i++) {
+	e_[i] += alpha*p_[i];
+	r_new[i] = r_[i] - alpha*Ap_[i];
+	sum += r_new[i]*r_new[i];
+      }
+      Storage::store(r + (size_t)n*Storage::bytes, r_new);
+    }
+    reduceDouble(sum);
+    return sum;
+  }
+
+  // p = r + beta p
+  template <typename Storage>
+  static void xpay(const char *r, double beta, char *p, int nSites) {
+    typedef typename Storage::RegType RegType;
+#pragma omp parallel for
+    for (int n=0; n<nSites; n++) {
+      RegType r_buf[24], p_buf[24], p_new[24];
+      const RegType *r_ = Storage::load(r + (size_t)n*Storage::bytes, r_buf);
+      const RegType *p_ = Storage::load(p + (size_t)n*Storage::bytes, p_buf);
+      for (int i=0; i<24; i++) p_new[i] = r_[i] + beta*p_[i];
+      Storage::store(p + (size_t)n*Storage::bytes, p_new);
+    }
+  }
+
+  /**
+     Solve MdagM e = r / |r| with the sloppy operator until the
+     residual has dropped by a factor of sqrt(stop), then x += |r| e.
+     Returns the number of iterations.
+  */
+  template <typename Float, typename Storage>
+  static int correct(Float *x, const Float *r, double r_norm, const DiracWilsonCpu &mat,
+		     void *work, int nSites, double stop, int maxiter,
+		     unsigned long long &blas_flops) {
+    typedef typename Storage::RegType RegType;
+    const size_t bytes = (size_t)nSites*Storage::bytes;
+    char *r_s = (char*)work;
+    char *p_s = r_s + bytes;
+    char *Ap_s = p_s + bytes;
+    RegType *e = (RegType*)(Ap_s + bytes);
+
+    if (mat.VirtualNode()) { // the sloppy vectors are in the layout of the operator
+      encode<Storage>(p_s, r, 1.0/r_norm, nSites);
+      mat.ToLayout(r_s, p_s);
+    } else {
+      encode<Storage>(r_s, r, 1.0/r_norm, nSites);
+    }
+    memcpy(p_s, r_s, bytes);
+    memset(e, 0, nSites*24*sizeof(RegType));
+
+    double rr = dot<Storage>(r_s, r_s, nSites);
+    stop *= rr;
+
+    int k = 0;
+    while (rr > stop && k < maxiter) {
+      mat.MdagM(Ap_s, p_s);
+      const double alpha = rr / dot<Storage>(p_s, Ap_s, nSites);
+      const double rr_new = axpyUpdateNorm<Storage>(e, r_s, p_s, Ap_s, alpha, nSites);
+      const double beta = rr_new / rr;
+      rr = rr_new;
+      xpay<Storage>(r_s, beta, p_s, nSites);
+      k++;
+    }
+
+    if (mat.VirtualNode()) { // native storage, so e fits in Ap
+      mat.FromLayout(Ap_s, e);
+      e = (RegType*)Ap_s;
+    }
+
+#pragma omp parallel for
+    for (int i=0; i<24*nSites; i++) x[i] += r_norm * e[i];
+
+    blas_flops += (2*k + 2 + 6*k + 2*k + 2 + 2) * 24ll * nSites;
+    return k;
+  }
+
+  template <typename Float>
+  static int correct(Float *x, const Float *r, double r_norm, const DiracWilsonCpu &mat,
+		     void *work, int nSites, double stop, int maxiter,
+		     unsigned long long &blas_flops) {
+    switch (mat.Storage()) {
+    case QUDA_DOUBLE_STORAGE:
+      return correct<Float, NativeStorage<double> >(x, r, r_norm, mat, work, nSites, stop, maxiter, blas_flops);
+    case QUDA_SINGLE_STORAGE:
+      return correct<Float, NativeStorage<float> >(x, r, r_norm, mat, work, nSites, stop, maxiter, blas_flops);
+    case QUDA_HALF_STORAGE:
+      return correct<Float, HalfStorage>(x, r, r_norm, mat, work, nSites, stop, maxiter, blas_flops);
+    case QUDA_BFLOAT16_STORAGE:
+      return correct<Float, BFloat16Storage>(x, r, r_norm, mat, work, nSites, stop, maxiter, blas_flops);
+    default:
+      errorQuda("Storage type %d not supported", mat.Storage());
+    }
+    return 0;
+  }
+
+  CGCpu::CGCpu(const DiracWilsonCpu &mat, const DiracWilsonCpu &matSloppy, SolverParam &param,
+	       TimeProfile &profile)
+    : mat(mat), matSloppy(matSloppy), param(param), profile(profile) {
+
+  }
+
+  CGCpu::~CGCpu() {
+
+  }
+
+  void CGCpu::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    profile.Start(QUDA_PROFILE_INIT);
+
+    if (mat.SiteSubset() != matSloppy.SiteSubset() || mat.VolumeCB() != matSloppy.VolumeCB())
+      errorQuda("Precise and sloppy operators do not match");
+
+    const double b2 = normCpu(b);
+    if (b2 == 0) {
+      profile.Stop(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x.zero();
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    ColorSpinorParam csParam(b);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    cpuColorSpinorField r(csParam);
+
+    mat.MdagM(r, x);
+    double r2 = xmyNormCpu(b, r);
+
+    // inner r, p and Ap in the sloppy storage, plus the correction e
+    const int nSites = (mat.SiteSubset() == QUDA_FULL_SITE_SUBSET ? 2 : 1) * mat.VolumeCB();
+    const size_t eBytes = (size_t)nSites*24*matSloppy.Precision();
+    void *work = safe_malloc(3*(size_t)nSites*matSloppy.SiteBytes() + eBytes);
+
+    profile.Stop(QUDA_PROFILE_INIT);
+    profile.Start(QUDA_PROFILE_PREAMBLE);
+
+    const double stop = b2 * param.tol * param.tol;
+    const double delta2 = param.delta * param.delta;
+    unsigned long long blas_flops = 0;
+    int k = 0;
+    int restarts = 0;
+
+    profile.Stop(QUDA_PROFILE_PREAMBLE);
+    profile.Start(QUDA_PROFILE_COMPUTE);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("CG (host): %d iterations, <r,r> = %e, |r|/|b| = %e\n", k, r2, sqrt(r2/b2));
+
+    while (r2 > stop && k < param.maxiter) {
+      // do not iterate the inner solve past the outer tolerance
+      const double inner_stop = (stop / r2 > delta2) ? stop / r2 : delta2;
+      if (mat.Precision() == QUDA_DOUBLE_PRECISION) {
+	k += correct((double*)x.V(), (const double*)r.V(), sqrt(r2), matSloppy, work, nSites,
+		     inner_stop, param.maxiter - k, blas_flops);
+      } else {
+	k += correct((float*)x.V(), (const float*)r.V(), sqrt(r2), matSloppy, work, nSites,
+		     inner_stop, param.maxiter - k, blas_flops);
+      }
+
+      mat.MdagM(r, x);
+      const double r2_new = xmyNormCpu(b, r);
+      blas_flops += 3 * 24ll * nSites;
+      restarts++;
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("CG (host): %d iterations, <r,r> = %e, |r|/|b| = %e, restart %d\n",
+		   k, r2_new, sqrt(r2_new/b2), restarts);
+
+      // the correction no longer improves on the true residual
+      if (r2_new >= r2) {
+	warningQuda("Defect correction stalled at |r|/|b| = %e", sqrt(r2_new/b2));
+	r2 = r2_new;
+	break;
+      }
+      r2 = r2_new;
+    }
+
+    profile.Stop(QUDA_PROFILE_COMPUTE);
+    profile.Start(QUDA_PROFILE_EPILOGUE);
+
+    if (k==param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas_flops + mat.Flops() + matSloppy.Flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("CG (host): Restarts = %d\n", restarts);
+
+    // r holds the true residual of the final x
+    param.true_res = sqrt(r2 / b2);
+    param.true_res_hq = sqrt(HeavyQuarkResidualNormCpu(x, r).z);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("CG (host): Convergence at %d iterations, L2 relative residual: true = %e\n",
+		 k, param.true_res);
+
+    profile.Stop(QUDA_PROFILE_EPILOGUE);
+    profile.Start(QUDA_PROFILE_FREE);
+
+    host_free(work);
+
+    profile.Stop(QUDA_PROFILE_FREE);
+  }
+
+} // namespace quda
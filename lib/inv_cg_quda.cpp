@@ -17,7 +17,14 @@
 namespace quda {
 
   CG::CG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
-    Solver(param, profile), mat(mat), matSloppy(matSloppy)
+    Solver(param, profile), mat(mat), matSloppy(matSloppy), matPrecon(matSloppy)
+  {
+
+  }
+
+  CG::CG(DiracMatrix &mat, DiracMatrix &matSloppy, DiracMatrix &matPrecon, SolverParam &param,
+	 TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy), matPrecon(matPrecon)
   {
 
   }
@@ -52,41 +59,66 @@ namespace quda {
 //    zeroCuda(y);
 
     double r2 = xmyNormCuda(b, r);
-  
-    csParam.setPrecision(param.precision_sloppy);
-    cudaColorSpinorField Ap(x, csParam);
-    cudaColorSpinorField tmp(x, csParam);
-
-    cudaColorSpinorField *tmp2_p = &tmp;
-    // tmp only needed for multi-gpu Wilson-like kernels
-    if (mat.Type() != typeid(DiracStaggeredPC).name() && 
-	mat.Type() != typeid(DiracStaggered).name()) {
-      tmp2_p = new cudaColorSpinorField(x, csParam);
+
+    SolverCheckpoint checkpoint(param, "CG", b2, r2);
+
+    // In adaptive mode the gap between the iterated and the true
+    // residual is measured at each reliable update.  When it exceeds
+    // param.drift, the reliable updates are first made more frequent
+    // (delta is raised), and once delta has reached maxDelta the
+    // sloppy operator is promoted to the next precision: matPrecon if
+    // its precision lies between the sloppy and the full precision,
+    // then mat itself.
+    const bool adaptive = (param.drift > 0.0);
+    const double maxDelta = 0.5;
+    const DiracMatrix *mSloppy[3] = { &matSloppy, 0, 0 };
+    QudaPrecision precSloppy[3] = { param.precision_sloppy, QUDA_INVALID_PRECISION, QUDA_INVALID_PRECISION };
+    int nLevel = 1;
+    if (adaptive) {
+      if (&matPrecon != &matSloppy && param.precision_precondition > param.precision_sloppy &&
+	  param.precision_precondition < x.Precision()) {
+	mSloppy[nLevel] = &matPrecon;
+	precSloppy[nLevel++] = param.precision_precondition;
+      }
+      if (x.Precision() > param.precision_sloppy) {
+	mSloppy[nLevel] = &mat;
+	precSloppy[nLevel++] = x.Precision();
+      }
     }
-    cudaColorSpinorField &tmp2 = *tmp2_p;
-
-    cudaColorSpinorField *x_sloppy, *r_sloppy;
-    if (param.precision_sloppy == x.Precision()) {
-      csParam.create = QUDA_REFERENCE_FIELD_CREATE;
-      x_sloppy = &x;
-      r_sloppy = &r;
-    } else {
-      csParam.create = QUDA_COPY_FIELD_CREATE;
-      x_sloppy = new cudaColorSpinorField(x, csParam);
-      r_sloppy = new cudaColorSpinorField(r, csParam);
+    int level = 0;
+    double secs = 0.0; // compute time summed over the passes
+    cudaColorSpinorField *p_promote = 0; // search direction carried over to the next precision
+
+    // Checkpoints are taken at reliable updates, where the state is
+    // the accumulated solution y, the search direction p and the
+    // current sloppy level; the residual is recomputed from y.  A
+    // resumed solve enters its level like a promotion.
+    int k=0;
+    int rUpdate = 0;
+    double delta = param.delta;
+    double saved[3];
+    bool resumed = checkpoint.Load(k, saved, 3, 2);
+    if (resumed && (int)saved[0] >= nLevel) {
+      warningQuda("CG: checkpoint precision level %d not available, not resuming", (int)saved[0]);
+      resumed = false;
+      k = 0;
     }
-
-    cudaColorSpinorField &xSloppy = *x_sloppy;
-    cudaColorSpinorField &rSloppy = *r_sloppy;
-    cudaColorSpinorField p(rSloppy);
-
-    if(&x != &xSloppy){
-      copyCuda(y,x);
-      zeroCuda(xSloppy);
-    }else{
-      zeroCuda(y);
+    if (resumed) {
+      level = (int)saved[0];
+      delta = saved[1];
+      rUpdate = (int)saved[2];
+
+      checkpoint.Restore(y, 0);
+      mat(r, y, x);
+      r2 = xmyNormCuda(b, r);
+
+      ColorSpinorParam pParam(x);
+      pParam.create = QUDA_ZERO_FIELD_CREATE;
+      pParam.setPrecision(precSloppy[level]);
+      p_promote = new cudaColorSpinorField(x, pParam);
+      checkpoint.Restore(*p_promote, 1);
     }
-    
+
     const bool use_heavy_quark_res = 
       (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
     
@@ -97,18 +129,16 @@ namespace quda {
     double stop = b2*param.tol*param.tol; // stopping condition of solver
 
     double heavy_quark_res = 0.0; // heavy quark residual
-    if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(x,r).z);
+    if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(resumed ? y : x,r).z);
     int heavy_quark_check = 10; // how often to check the heavy quark residual
 
     double alpha=0.0, beta=0.0;
     double pAp;
-    int rUpdate = 0;
 
     double rNorm = sqrt(r2);
     double r0Norm = rNorm;
     double maxrx = rNorm;
     double maxrr = rNorm;
-    double delta = param.delta;
 
     // this parameter determines how many consective reliable update
     // reisudal increases we tolerate before terminating the solver,
@@ -119,122 +149,226 @@ namespace quda {
     profile.Start(QUDA_PROFILE_COMPUTE);
     blas_flops = 0;
 
-    int k=0;
-    
     PrintStats("CG", k, r2, b2, heavy_quark_res);
 
     int steps_since_reliable = 1;
 
-    while ( !convergence(r2, heavy_quark_res, stop, param.tol_hq) && 
-	    k < param.maxiter) {
-      matSloppy(Ap, p, tmp, tmp2); // tmp as tmp
-    
-      double sigma;
-
-      bool breakdown = false;
-      int pipeline = 0;
-      if (pipeline) {
-	double3 triplet = tripleCGReductionCuda(rSloppy, Ap, p);
-	r2 = triplet.x; double Ap2 = triplet.y; pAp = triplet.z;
-	r2_old = r2;
-
-	alpha = r2 / pAp;        
-	sigma = alpha*(alpha * Ap2 - pAp);
-	if (sigma < 0.0 || steps_since_reliable==0) { // sigma condition has broken down
-	  r2 = axpyNormCuda(-alpha, Ap, rSloppy);
-	  sigma = r2;
-	  breakdown = true;
-	}
+    // one pass per sloppy precision, the search direction and
+    // accumulated solution y carry over from one pass to the next
+    while (true) {
+      const DiracMatrix &sloppy = *mSloppy[level];
+      const QudaPrecision precision_sloppy = precSloppy[level];
+
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      csParam.setPrecision(precision_sloppy);
+      cudaColorSpinorField Ap(x, csParam);
+      cudaColorSpinorField tmp(x, csParam);
+
+      cudaColorSpinorField *tmp2_p = &tmp;
+      // tmp only needed for multi-gpu Wilson-like kernels
+      if (mat.Type() != typeid(DiracStaggeredPC).name() && 
+	  mat.Type() != typeid(DiracStaggered).name()) {
+	tmp2_p = new cudaColorSpinorField(x, csParam);
+      }
+      cudaColorSpinorField &tmp2 = *tmp2_p;
 
-	r2 = sigma;
+      cudaColorSpinorField *x_sloppy, *r_sloppy;
+      if (precision_sloppy == x.Precision()) {
+	csParam.create = QUDA_REFERENCE_FIELD_CREATE;
+	x_sloppy = &x;
+	r_sloppy = &r;
       } else {
-	r2_old = r2;
-	pAp = reDotProductCuda(p, Ap);
-	alpha = r2 / pAp;        
-
-	// here we are deploying the alternative beta computation 
-	Complex cg_norm = axpyCGNormCuda(-alpha, Ap, rSloppy);
-	r2 = real(cg_norm); // (r_new, r_new)
-	sigma = imag(cg_norm) >= 0.0 ? imag(cg_norm) : r2; // use r2 if (r_k+1, r_k+1-r_k) breaks
+	csParam.create = QUDA_COPY_FIELD_CREATE;
+	x_sloppy = new cudaColorSpinorField(x, csParam);
+	r_sloppy = new cudaColorSpinorField(r, csParam);
       }
 
-      // reliable update conditions
-      rNorm = sqrt(r2);
-      if (rNorm > maxrx) maxrx = rNorm;
-      if (rNorm > maxrr) maxrr = rNorm;
-      int updateX = (rNorm < delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
-      int updateR = ((rNorm < delta*maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
-    
-      // force a reliable update if we are within target tolerance (only if doing reliable updates)
-      if ( convergence(r2, heavy_quark_res, stop, param.tol_hq) && delta >= param.tol) updateX = 1;
+      cudaColorSpinorField &xSloppy = *x_sloppy;
+      cudaColorSpinorField &rSloppy = *r_sloppy;
+      cudaColorSpinorField p(p_promote ? *p_promote : rSloppy);
 
-      if ( !(updateR || updateX)) {
-	//beta = r2 / r2_old;
-	beta = sigma / r2_old; // use the alternative beta computation
+      if (p_promote) {
+	// promoted at a reliable update: y holds the solution
+	zeroCuda(xSloppy);
+	delete p_promote;
+	p_promote = 0;
+      } else if(&x != &xSloppy){
+	copyCuda(y,x);
+	zeroCuda(xSloppy);
+      }else{
+	zeroCuda(y);
+      }
 
-	if (pipeline && !breakdown) tripleCGUpdateCuda(alpha, beta, Ap, rSloppy, xSloppy, p);
-	else axpyZpbxCuda(alpha, p, xSloppy, rSloppy, beta);
+      bool promote = false;
 
-	if (use_heavy_quark_res && k%heavy_quark_check==0) { 
-	  copyCuda(tmp,y);
-	  heavy_quark_res = sqrt(xpyHeavyQuarkResidualNormCuda(xSloppy, tmp, rSloppy).z);
+      while ( !convergence(r2, heavy_quark_res, stop, param.tol_hq) && 
+	      k < param.maxiter) {
+	sloppy(Ap, p, tmp, tmp2); // tmp as tmp
+    
+	double sigma;
+
+	bool breakdown = false;
+	int pipeline = 0;
+	if (pipeline) {
+	  double3 triplet = tripleCGReductionCuda(rSloppy, Ap, p);
+	  r2 = triplet.x; double Ap2 = triplet.y; pAp = triplet.z;
+	  r2_old = r2;
+
+	  alpha = r2 / pAp;        
+	  sigma = alpha*(alpha * Ap2 - pAp);
+	  if (sigma < 0.0 || steps_since_reliable==0) { // sigma condition has broken down
+	    r2 = axpyNormCuda(-alpha, Ap, rSloppy);
+	    sigma = r2;
+	    breakdown = true;
+	  }
+
+	  r2 = sigma;
+	} else {
+	  r2_old = r2;
+	  pAp = reDotProductCuda(p, Ap);
+	  alpha = r2 / pAp;        
+
+	  // here we are deploying the alternative beta computation 
+	  Complex cg_norm = axpyCGNormCuda(-alpha, Ap, rSloppy);
+	  r2 = real(cg_norm); // (r_new, r_new)
+	  sigma = imag(cg_norm) >= 0.0 ? imag(cg_norm) : r2; // use r2 if (r_k+1, r_k+1-r_k) breaks
 	}
 
-	steps_since_reliable++;
-      } else {
-	axpyCuda(alpha, p, xSloppy);
-	if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
-      
-	xpyCuda(x, y); // swap these around?
-	mat(r, y, x); // here we can use x as tmp
-	r2 = xmyNormCuda(b, r);
+	// reliable update conditions
+	rNorm = sqrt(r2);
+	if (rNorm > maxrx) maxrx = rNorm;
+	if (rNorm > maxrr) maxrr = rNorm;
+	int updateX = (rNorm < delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
+	int updateR = ((rNorm < delta*maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+    
+	// force a reliable update if we are within target tolerance (only if doing reliable updates)
+	if ( convergence(r2, heavy_quark_res, stop, param.tol_hq) && delta >= param.tol) updateX = 1;
 
-	if (x.Precision() != rSloppy.Precision()) copyCuda(rSloppy, r);            
-	zeroCuda(xSloppy);
+	// force a reliable update when a checkpoint is due
+	if (checkpoint.Due(k+1)) updateR = 1;
 
-	// break-out check if we have reached the limit of the precision
-	static int resIncrease = 0;
-	if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
-	  warningQuda("CG: new reliable residual norm %e is greater than previous reliable residual norm %e", sqrt(r2), r0Norm);
-	  k++;
-	  rUpdate++;
-	  if (++resIncrease > maxResIncrease) break; 
+	if ( !(updateR || updateX)) {
+	  //beta = r2 / r2_old;
+	  beta = sigma / r2_old; // use the alternative beta computation
+
+	  if (pipeline && !breakdown) tripleCGUpdateCuda(alpha, beta, Ap, rSloppy, xSloppy, p);
+	  else axpyZpbxCuda(alpha, p, xSloppy, rSloppy, beta);
+
+	  if (use_heavy_quark_res && k%heavy_quark_check==0) { 
+	    copyCuda(tmp,y);
+	    heavy_quark_res = sqrt(xpyHeavyQuarkResidualNormCuda(xSloppy, tmp, rSloppy).z);
+	  }
+
+	  steps_since_reliable++;
 	} else {
-	  resIncrease = 0;
+	  axpyCuda(alpha, p, xSloppy);
+	  if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
+      
+	  xpyCuda(x, y); // swap these around?
+	  mat(r, y, x); // here we can use x as tmp
+	  r2 = xmyNormCuda(b, r);
+
+	  if (adaptive && &rSloppy != &r) {
+	    // relative gap between the iterated and the true residual
+	    copyCuda(tmp, r);
+	    double drift = sqrt(xmyNormCuda(tmp, rSloppy) / r2);
+	    if (drift > param.drift) {
+	      if (delta < maxDelta) {
+		delta = (sqrt(delta) < maxDelta) ? sqrt(delta) : maxDelta;
+		if (getVerbosity() >= QUDA_VERBOSE)
+		  printfQuda("CG: residual drift %e, raising delta to %e\n", drift, delta);
+	      } else if (level < nLevel-1) {
+		promote = true;
+		if (getVerbosity() >= QUDA_VERBOSE)
+		  printfQuda("CG: residual drift %e, promoting sloppy precision to %d\n", drift, precSloppy[level+1]);
+	      }
+	    }
+	  }
+
+	  if (x.Precision() != rSloppy.Precision()) copyCuda(rSloppy, r);            
+	  zeroCuda(xSloppy);
+
+	  // break-out check if we have reached the limit of the precision
+	  static int resIncrease = 0;
+	  if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+	    warningQuda("CG: new reliable residual norm %e is greater than previous reliable residual norm %e", sqrt(r2), r0Norm);
+	    if (adaptive && level < nLevel-1) {
+	      promote = true; // this sloppy precision has stalled, continue in the next one
+	    } else {
+	      k++;
+	      rUpdate++;
+	      if (++resIncrease > maxResIncrease) break; 
+	    }
+	  } else {
+	    resIncrease = 0;
+	  }
+
+	  rNorm = sqrt(r2);
+	  maxrr = rNorm;
+	  maxrx = rNorm;
+	  r0Norm = rNorm;      
+	  rUpdate++;
+
+	  // explicitly restore the orthogonality of the gradient vector
+	  double rp = reDotProductCuda(rSloppy, p) / (r2);
+	  axpyCuda(-rp, rSloppy, p);
+
+	  beta = r2 / r2_old; 
+	  xpayCuda(rSloppy, beta, p);
+
+	  if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(y,r).z);
+	
+	  steps_since_reliable = 0;
 	}
 
-	rNorm = sqrt(r2);
-	maxrr = rNorm;
-	maxrx = rNorm;
-	r0Norm = rNorm;      
-	rUpdate++;
+	breakdown = false;
+	k++;
+
+	PrintStats("CG", k, r2, b2, heavy_quark_res);
 
-	// explicitly restore the orthogonality of the gradient vector
-	double rp = reDotProductCuda(rSloppy, p) / (r2);
-	axpyCuda(-rp, rSloppy, p);
+	if (steps_since_reliable == 0 && !promote && checkpoint.Due(k)) {
+	  double state[3] = { (double)level, delta, (double)rUpdate };
+	  cudaColorSpinorField *field[2] = { &y, &p };
+	  checkpoint.Save(k, state, 3, field, 2);
+	}
 
-	beta = r2 / r2_old; 
-	xpayCuda(rSloppy, beta, p);
+	if (promote) break;
+      }
 
-	if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(y,r).z);
-	
-	steps_since_reliable = 0;
+      if (promote) {
+	csParam.create = QUDA_COPY_FIELD_CREATE;
+	csParam.setPrecision(precSloppy[level+1]);
+	p_promote = new cudaColorSpinorField(p, csParam);
+      } else {
+	if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
+	xpyCuda(y, x);
       }
 
-      breakdown = false;
-      k++;
+      profile.Stop(QUDA_PROFILE_COMPUTE);
+      secs += profile.Last(QUDA_PROFILE_COMPUTE);
+      profile.Start(QUDA_PROFILE_FREE);
 
-      PrintStats("CG", k, r2, b2, heavy_quark_res);
-    }
+      if (&tmp2 != &tmp) delete tmp2_p;
+
+      if (precision_sloppy != x.Precision()) {
+	delete r_sloppy;
+	delete x_sloppy;
+      }
 
-    if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
-    xpyCuda(y, x);
+      profile.Stop(QUDA_PROFILE_FREE);
+
+      if (!promote) break;
+      level++;
+      profile.Start(QUDA_PROFILE_COMPUTE);
+    }
 
-    profile.Stop(QUDA_PROFILE_COMPUTE);
     profile.Start(QUDA_PROFILE_EPILOGUE);
 
-    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    checkpoint.Remove(k);
+
+    param.secs = secs;
     double gflops = (quda::blas_flops + mat.flops() + matSloppy.flops())*1e-9;
+    if (&matPrecon != &matSloppy) gflops += matPrecon.flops()*1e-9;
     reduceDouble(gflops);
       param.gflops = gflops;
     param.iter += k;
@@ -260,18 +394,9 @@ namespace quda {
     quda::blas_flops = 0;
     mat.flops();
     matSloppy.flops();
+    matPrecon.flops();
 
     profile.Stop(QUDA_PROFILE_EPILOGUE);
-    profile.Start(QUDA_PROFILE_FREE);
-
-    if (&tmp2 != &tmp) delete tmp2_p;
-
-    if (param.precision_sloppy != x.Precision()) {
-      delete r_sloppy;
-      delete x_sloppy;
-    }
-
-    profile.Stop(QUDA_PROFILE_FREE);
 
     return;
   }
@@ -37,6 +37,8 @@ namespace quda {
     inner.gflops = 0;
     inner.secs = 0;
 
+    inner.checkpoint_interval = 0; // only the outer solver is checkpointed
+
     inner.inv_type_precondition = QUDA_GCR_INVERTER; // used to tell the inner solver it is an inner solver
 
     if (outer.inv_type == QUDA_GCR_INVERTER && outer.precision_sloppy != outer.precision_precondition) 
@@ -136,7 +138,11 @@ namespace quda {
 
     fillInnerSolveParam(Kparam, param);
 
-    if (param.inv_type_precondition == QUDA_CG_INVERTER) // inner CG preconditioner
+    if (param.schwarz_location == QUDA_CPU_FIELD_LOCATION) { // block solver on the host
+      if (param.inv_type_precondition != QUDA_MR_INVERTER)
+	errorQuda("Host Schwarz preconditioner only supports an MR block solver");
+      K = new SchwarzCpu(matPrecon, Kparam, profile);
+    } else if (param.inv_type_precondition == QUDA_CG_INVERTER) // inner CG preconditioner
       K = new CG(matPrecon, matPrecon, Kparam, profile);
     else if (param.inv_type_precondition == QUDA_BICGSTAB_INVERTER) // inner BiCGstab preconditioner
       K = new BiCGstab(matPrecon, matPrecon, matPrecon, Kparam, profile);
@@ -265,6 +271,24 @@ namespace quda {
     double r2_old = r2;
     bool l2_converge = false;
 
+    // Checkpoints are taken at restarts, where the Krylov space is
+    // empty and the state is the accumulated solution y; the residual
+    // is recomputed from y.
+    SolverCheckpoint checkpoint(param, "GCR", b2, r2);
+    double saved[3];
+    if (checkpoint.Load(total_iter, saved, 3, 1)) {
+      restart = (int)saved[0];
+      r2_old = saved[1];
+      l2_converge = (saved[2] != 0.0);
+
+      checkpoint.Restore(y, 0);
+      mat(r, y, x);
+      r2 = xmyNormCuda(b, r);
+      if (use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(y, r).z);
+      copyCuda(rSloppy, r);
+      zeroCuda(xSloppy);
+    }
+
     profile.Stop(QUDA_PROFILE_PREAMBLE);
     profile.Start(QUDA_PROFILE_COMPUTE);
 
@@ -285,7 +309,9 @@ namespace quda {
 	    copyCuda(rPre, *rM);
 	  }
 	
-	  if ((parity+m)%2 == 0 || param.schwarz_type == QUDA_ADDITIVE_SCHWARZ) (*K)(pPre, rPre);
+	  // the host preconditioner handles multiplicative Schwarz internally
+	  if ((parity+m)%2 == 0 || param.schwarz_type == QUDA_ADDITIVE_SCHWARZ ||
+	      param.schwarz_location == QUDA_CPU_FIELD_LOCATION) (*K)(pPre, rPre);
 	  else copyCuda(pPre, rPre);
 	
 	  // relaxation p = omega*p + (1-omega)*r
@@ -355,6 +381,12 @@ namespace quda {
 
 	  // prevent ending the Krylov space prematurely if other convergence criteria not met 
 	  if (r2 < stop) l2_converge = true; 
+
+	  if (checkpoint.Due(total_iter)) {
+	    double state[3] = { (double)restart, r2_old, l2_converge ? 1.0 : 0.0 };
+	    cudaColorSpinorField *field[1] = { &y };
+	    checkpoint.Save(total_iter, state, 3, field, 1);
+	  }
 	}
 
       }
@@ -363,6 +395,8 @@ namespace quda {
 
     if (total_iter > 0) copyCuda(x, y);
 
+    checkpoint.Remove(total_iter);
+
     profile.Stop(QUDA_PROFILE_COMPUTE);
     profile.Start(QUDA_PROFILE_EPILOGUE);
 
@@ -108,4 +108,80 @@ namespace quda {
     delete [] beta;
   }
 
+  ChronoHistory::ChronoHistory() : head(0), size(0), max(0) {
+    for (int i=0; i<QUDA_MAX_CHRONO; i++) v[i] = 0;
+  }
+
+  ChronoHistory::~ChronoHistory() {
+    flush();
+  }
+
+  void ChronoHistory::flush() {
+    for (int i=0; i<QUDA_MAX_CHRONO; i++) {
+      if (v[i]) delete v[i];
+      v[i] = 0;
+    }
+    head = 0;
+    size = 0;
+  }
+
+  void ChronoHistory::forecast(cudaColorSpinorField &x, const cudaColorSpinorField &b,
+			       DiracMatrix &mat, TimeProfile &profile) {
+    profile.Start(QUDA_PROFILE_CHRONO);
+
+    if (size == 0) {
+      zeroCuda(x);
+      profile.Stop(QUDA_PROFILE_CHRONO);
+      return;
+    }
+
+    // MinResExt orthonormalizes the basis in place, so work on copies
+    // in the solver precision, most recent solution first
+    ColorSpinorParam csParam(x);
+    csParam.create = QUDA_COPY_FIELD_CREATE;
+    cudaColorSpinorField **p = new cudaColorSpinorField*[size];
+    for (int i=0; i<size; i++) p[i] = new cudaColorSpinorField(*v[(head-1-i+max)%max], csParam);
+
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    cudaColorSpinorField **q = new cudaColorSpinorField*[size];
+    for (int i=0; i<size; i++) q[i] = new cudaColorSpinorField(x, csParam);
+
+    csParam.create = QUDA_COPY_FIELD_CREATE;
+    cudaColorSpinorField r(b, csParam);
+
+    MinResExt mre(mat, profile);
+    mre(x, r, p, q, size);
+
+    for (int i=0; i<size; i++) {
+      delete p[i];
+      delete q[i];
+    }
+    delete []p;
+    delete []q;
+
+    profile.Stop(QUDA_PROFILE_CHRONO);
+  }
+
+  void ChronoHistory::push(const cudaColorSpinorField &x, int max_dim, QudaPrecision precision) {
+    if (max_dim > QUDA_MAX_CHRONO)
+      errorQuda("Requested history %d exceeds QUDA_MAX_CHRONO = %d", max_dim, QUDA_MAX_CHRONO);
+
+    if (size > 0 && (max_dim != max || v[0]->Precision() != precision ||
+		     v[0]->Volume() != x.Volume() || v[0]->SiteSubset() != x.SiteSubset())) flush();
+    max = max_dim;
+    if (max == 0) return;
+
+    if (!v[head]) {
+      ColorSpinorParam csParam(x);
+      csParam.setPrecision(precision);
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      v[head] = new cudaColorSpinorField(x, csParam);
+    } else {
+      copyCuda(*v[head], x);
+    }
+
+    head = (head+1) % max;
+    if (size < max) size++;
+  }
+
 } // namespace quda
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+#include <face_quda.h>
+
+/*!
+ * Host Multi Shift Solver
+ *
+ * Solves (M^dag M + offset[i]) x[i] = b for all shifts with a single
+ * Krylov space generated by the smallest shift, which must be in
+ * offset[0].  Shifts are retired as soon as their iterated residual
+ * has converged; the remaining ones are kept in a compacted list so
+ * that the fused update only streams the vectors still in use.
+ *
+ */
+
+namespace quda {
+
+  MultiShiftCGCpu::MultiShiftCGCpu(const DiracWilsonCpu &dirac, SolverParam &param,
+				   TimeProfile &profile)
+    : dirac(dirac), param(param), profile(profile) {
+
+  }
+
+  MultiShiftCGCpu::~MultiShiftCGCpu() {
+
+  }
+
+  void MultiShiftCGCpu::operator()(cpuColorSpinorField **x, cpuColorSpinorField &b)
+  {
+    profile.Start(QUDA_PROFILE_INIT);
+
+    const int num_offset = param.num_offset;
+    const double *offset = param.offset;
+
+    if (num_offset == 0) return;
+
+    const double b2 = normCpu(b);
+    if (b2 == 0) {
+      profile.Stop(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      for (int i=0; i<num_offset; i++) {
+	x[i]->zero();
+	param.true_res_offset[i] = 0.0;
+	param.true_res_hq_offset[i] = 0.0;
+      }
+      return;
+    }
+
+    cpuColorSpinorField r(b);
+    cpuColorSpinorField *p[QUDA_MAX_MULTI_SHIFT];
+    for (int i=0; i<num_offset; i++) {
+      p[i] = new cpuColorSpinorField(b);
+      x[i]->zero();
+    }
+
+    ColorSpinorParam csParam(b);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    cpuColorSpinorField Ap(csParam);
+
+    profile.Stop(QUDA_PROFILE_INIT);
+    profile.Start(QUDA_PROFILE_PREAMBLE);
+
+    // active shifts, compacted as shifts converge
+    int active[QUDA_MAX_MULTI_SHIFT];
+    int num_active = num_offset;
+    for (int i=0; i<num_offset; i++) active[i] = i;
+    bool base_active = true; // whether shift 0 (which owns the base search vector) is still active
+
+    double zeta[QUDA_MAX_MULTI_SHIFT], zeta_old[QUDA_MAX_MULTI_SHIFT];
+    double r2[QUDA_MAX_MULTI_SHIFT], stop[QUDA_MAX_MULTI_SHIFT];
+    for (int i=0; i<num_offset; i++) {
+      zeta[i] = zeta_old[i] = 1.0;
+      r2[i] = b2;
+      stop[i] = b2 * param.tol_offset[i] * param.tol_offset[i];
+    }
+
+    // coefficients of the fused update, indexed by position in the active list
+    double a[QUDA_MAX_MULTI_SHIFT], z[QUDA_MAX_MULTI_SHIFT], c[QUDA_MAX_MULTI_SHIFT];
+    cpuColorSpinorField *pActive[QUDA_MAX_MULTI_SHIFT], *xActive[QUDA_MAX_MULTI_SHIFT];
+
+    double alpha_old = 1.0, beta_old = 0.0;
+    const size_t length = b.Length();
+    unsigned long long blas_flops = 0;
+    int k = 0;
+
+    profile.Stop(QUDA_PROFILE_PREAMBLE);
+    profile.Start(QUDA_PROFILE_COMPUTE);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("MultiShift CG (host): %d iterations, <r,r> = %e, |r|/|b| = %e\n", k, r2[0], sqrt(r2[0]/b2));
+
+    while (num_active > 0 && k < param.maxiter) {
+      dirac.MdagM(Ap, *p[0]);
+      if (offset[0] != 0.0) axpyCpu(offset[0], *p[0], Ap);
+
+      const double pAp = reDotProductCpu(*p[0], Ap);
+      const double alpha = r2[0] / pAp;
+
+      // shifted step lengths: zeta holds zeta_{k+1}, zeta_old zeta_k after this
+      for (int n=0; n<num_active; n++) {
+	const int j = active[n];
+	if (j == 0) { a[n] = alpha; continue; }
+	const double c0 = zeta[j] * zeta_old[j] * alpha_old;
+	const double c1 = alpha * beta_old * (zeta_old[j] - zeta[j]);
+	const double c2 = zeta_old[j] * alpha_old * (1.0 + (offset[j]-offset[0])*alpha);
+	zeta_old[j] = zeta[j];
+	zeta[j] = c0 / (c1 + c2);
+	a[n] = alpha * zeta[j] / zeta_old[j];
+      }
+
+      const double r2_new = axpyNormCpu(-alpha, Ap, r);
+      const double beta = r2_new / r2[0];
+      r2[0] = r2_new;
+
+      // x_j += alpha_j p_j, p_j = zeta_j r + beta_j p_j for all active shifts at once
+      for (int n=0; n<num_active; n++) {
+	const int j = active[n];
+	const double ratio = zeta[j] / zeta_old[j];
+	z[n] = zeta[j];
+	c[n] = (j == 0) ? beta : beta * ratio * ratio;
+	pActive[n] = p[j];
+	xActive[n] = x[j];
+      }
+      axpyBzpcxCpu(a, pActive, xActive, z, r, c, num_active);
+      if (!base_active) xpayCpu(r, beta, *p[0]); // the base direction outlives shift 0
+
+      blas_flops += (2 + 4 + 4*(unsigned long long)num_active + (base_active ? 0 : 2)) * length;
+
+      alpha_old = alpha;
+      beta_old = beta;
+      k++;
+
+      // retire the converged shifts, keeping the order of the survivors
+      int n_keep = 0;
+      for (int n=0; n<num_active; n++) {
+	const int j = active[n];
+	if (j > 0) r2[j] = zeta[j] * zeta[j] * r2[0];
+	if (r2[j] < stop[j]) {
+	  if (getVerbosity() >= QUDA_VERBOSE)
+	    printfQuda("MultiShift CG (host): Shift %d converged after %d iterations\n", j, k);
+	  if (j == 0) {
+	    base_active = false;
+	  } else {
+	    delete p[j];
+	    p[j] = 0;
+	  }
+	} else {
+	  active[n_keep++] = j;
+	}
+      }
+      num_active = n_keep;
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("MultiShift CG (host): %d iterations, <r,r> = %e, |r|/|b| = %e, %d shifts active\n",
+		   k, r2[0], sqrt(r2[0]/b2), num_active);
+    }
+
+    profile.Stop(QUDA_PROFILE_COMPUTE);
+    profile.Start(QUDA_PROFILE_EPILOGUE);
+
+    if (k==param.maxiter) warningQuda("Exceeded maximum iterations %d\n", param.maxiter);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas_flops + dirac.Flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    for (int i=0; i<num_offset; i++) {
+      dirac.MdagM(Ap, *x[i]);
+      axpyCpu(offset[i], *x[i], Ap);
+      const double true_res = xmyNormCpu(b, Ap);
+      param.true_res_offset[i] = sqrt(true_res/b2);
+      param.true_res_hq_offset[i] = sqrt(HeavyQuarkResidualNormCpu(*x[i], Ap).z);
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("MultiShift CG (host): Converged after %d iterations\n", k);
+      for (int i=0; i<num_offset; i++) {
+	printfQuda(" shift=%d, relative residua: iterated = %e, true = %e\n",
+		   i, sqrt(r2[i]/b2), param.true_res_offset[i]);
+      }
+    }
+
+    // reset the flops counters
+    dirac.Flops();
+
+    profile.Stop(QUDA_PROFILE_EPILOGUE);
+    profile.Start(QUDA_PROFILE_FREE);
+
+    for (int i=0; i<num_offset; i++) if (p[i]) delete p[i];
+
+    profile.Stop(QUDA_PROFILE_FREE);
+  }
+
+} // namespace quda
@@ -166,6 +166,30 @@ namespace quda {
     int rUpdate = 0;
     quda::blas_flops = 0;
 
+    // The checkpoints are exact snapshots: the iterated residual, the
+    // solutions, search directions and (with reliable updates)
+    // accumulators of every shift and all the shift recurrences.
+    SolverCheckpoint checkpoint(param, "MultiShiftCG", b2, b2);
+    double *const state_arrays[9] = { zeta, zeta_old, alpha, beta, r2, rNorm, r0Norm, maxrx, maxrr };
+    const int nScalar = 2 + 9*num_offset;
+    const int nField = (reliable ? 3 : 2)*num_offset + 1;
+    cudaColorSpinorField **field = new cudaColorSpinorField*[nField];
+    field[0] = r_sloppy;
+    for (int i=0; i<num_offset; i++) {
+      field[1+i] = x_sloppy[i];
+      field[1+num_offset+i] = p[i];
+      if (reliable) field[1+2*num_offset+i] = y[i];
+    }
+    double *state = new double[nScalar];
+
+    if (checkpoint.Load(k, state, nScalar, nField)) {
+      rUpdate = (int)state[0];
+      num_offset_now = (int)state[1];
+      for (int a=0; a<9; a++)
+	for (int i=0; i<num_offset; i++) state_arrays[a][i] = state[2 + a*num_offset + i];
+      for (int i=0; i<nField; i++) checkpoint.Restore(*field[i], i);
+    }
+
     profile.Stop(QUDA_PROFILE_PREAMBLE);
     profile.Start(QUDA_PROFILE_COMPUTE);
 
@@ -268,7 +292,19 @@ namespace quda {
       
       if (getVerbosity() >= QUDA_VERBOSE) 
 	printfQuda("MultiShift CG: %d iterations, <r,r> = %e, |r|/|b| = %e\n", k, r2[0], sqrt(r2[0]/b2));
+
+      if (checkpoint.Due(k)) {
+	state[0] = rUpdate;
+	state[1] = num_offset_now;
+	for (int a=0; a<9; a++)
+	  for (int i=0; i<num_offset; i++) state[2 + a*num_offset + i] = state_arrays[a][i];
+	checkpoint.Save(k, state, nScalar, field, nField);
+      }
     }
+
+    checkpoint.Remove(k);
+    delete []state;
+    delete []field;
     
     
     for (int i=0; i<num_offset; i++) {
@@ -0,0 +1,466 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <complex>
+#include <typeinfo>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <quda_internal.h>
+#include <blas_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+#include <face_quda.h>
+
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+
+#include "wilson_cpu_core.h"
+
+/**
+   Host-side restricted additive / multiplicative Schwarz
+   preconditioner.  The local volume is decomposed into equally sized
+   blocks with even extents, the fields are gathered into a
+   block-major checkerboarded layout so that each block is contiguous
+   in memory, and each block system is solved independently with
+   block-local MR using Dirichlet boundary conditions.  Hops that leave
+   a block (or leave the node in a partitioned dimension) are dropped,
+   so the preconditioner performs no communication at all.
+
+   For multiplicative Schwarz the blocks are two-colored using the
+   global block coordinates: the first color is solved, the residual
+   on the second color is updated with the node-local coupling, and
+   then the second color is solved.  Coupling between blocks on
+   different nodes is always treated additively.
+ */
+
+namespace quda {
+
+  /**
+     The block decomposition and the block-major copies of the gauge
+     field and of the work vectors.  Abstract base so that the
+     precision-templated implementation can be hidden in this file.
+   */
+  class SchwarzBlocks {
+
+  protected:
+    int X[4];             // local lattice dimensions
+    int B[4];             // block dimensions
+    int nBlock[4];        // number of blocks in each dimension
+    int nBlocks;          // total number of blocks on this node
+    int blockVolumeCB;    // checkerboard volume of each block
+    int volumeCB;         // local checkerboard volume
+
+    int *index[2];        // block-major site -> checkerboard index
+    int *nbr[2];          // node-local neighbor table (-1 if dropped)
+    int *nbrBlock[2];     // block-local neighbor table (-1 if dropped)
+    int *color;           // color of each block (multiplicative Schwarz)
+
+    double kappa;
+    bool pc;              // whether the operator is even-odd preconditioned
+    int matParity;        // parity of the preconditioned system
+    int dagger;
+
+  public:
+    SchwarzBlocks(const Dirac &dirac, bool multiplicative);
+    virtual ~SchwarzBlocks();
+
+    virtual void gather(const cpuColorSpinorField &in) = 0;
+    virtual void scatter(cpuColorSpinorField &out) const = 0;
+    virtual int solve(int maxiter, double tol, QudaSchwarzType schwarz_type) = 0;
+
+    int Blocks() const { return nBlocks; }
+    const int* BlockDim() const { return B; }
+
+    unsigned long long flops;
+  };
+
+  SchwarzBlocks::SchwarzBlocks(const Dirac &dirac, bool multiplicative)
+    : nBlocks(1), kappa(dirac.Kappa()), dagger(dirac.Dagger() == QUDA_DAG_YES ? 1 : 0), flops(0)
+  {
+    initHalfProjector();
+
+    pc = (typeid(dirac) == typeid(DiracWilsonPC));
+    if (!pc && typeid(dirac) != typeid(DiracWilson))
+      errorQuda("Host Schwarz preconditioner not supported for %s", typeid(dirac).name());
+
+    matParity = 0;
+    if (pc) {
+      if (dirac.getMatPCType() == QUDA_MATPC_EVEN_EVEN) matParity = 0;
+      else if (dirac.getMatPCType() == QUDA_MATPC_ODD_ODD) matParity = 1;
+      else errorQuda("MatPCType %d not supported", dirac.getMatPCType());
+    }
+
+    const cudaGaugeField &gauge = dirac.Gauge();
+    for (int d=0; d<4; d++) { X[d] = gauge.X()[d]; B[d] = X[d]; }
+    volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+
+    // halve the largest dimension until we have enough blocks to
+    // keep every thread busy (for each color in the multiplicative
+    // case), keeping the block extents even
+    int target = (multiplicative ? 2 : 1) * nthreads;
+    while (nBlocks < target) {
+      int dim = -1;
+      for (int d=3; d>=0; d--) if (B[d] % 4 == 0 && (dim < 0 || B[d] > B[dim])) dim = d;
+      if (dim < 0) break;
+      B[dim] /= 2;
+      nBlocks *= 2;
+    }
+
+    for (int d=0; d<4; d++) nBlock[d] = X[d] / B[d];
+    blockVolumeCB = B[0]*B[1]*B[2]*B[3]/2;
+
+    for (int p=0; p<2; p++) {
+      index[p] = (int*)safe_malloc(volumeCB*sizeof(int));
+      nbr[p] = (int*)safe_malloc(8*volumeCB*sizeof(int));
+      nbrBlock[p] = (int*)safe_malloc(8*volumeCB*sizeof(int));
+    }
+    color = (int*)safe_malloc(nBlocks*sizeof(int));
+
+    for (int b=0; b<nBlocks; b++) {
+      int bc[4] = { b % nBlock[0], (b/nBlock[0]) % nBlock[1],
+		    (b/(nBlock[0]*nBlock[1])) % nBlock[2], b/(nBlock[0]*nBlock[1]*nBlock[2]) };
+      int sum = 0;
+      for (int d=0; d<4; d++) sum += commCoords(d)*nBlock[d] + bc[d];
+      color[b] = sum % 2;
+    }
+
+    // block-major index of local site x
+#define BLOCK_INDEX(x)							\
+    ((((((x)[3]/B[3])*nBlock[2] + (x)[2]/B[2])*nBlock[1] + (x)[1]/B[1])*nBlock[0] + (x)[0]/B[0]) * blockVolumeCB + \
+     (((((x)[3]%B[3])*B[2] + (x)[2]%B[2])*B[1] + (x)[1]%B[1])*B[0] + (x)[0]%B[0]) / 2)
+
+    int x[4];
+    for (x[3]=0; x[3]<X[3]; x[3]++) {
+      for (x[2]=0; x[2]<X[2]; x[2]++) {
+	for (x[1]=0; x[1]<X[1]; x[1]++) {
+	  for (x[0]=0; x[0]<X[0]; x[0]++) {
+	    int lex = ((x[3]*X[2] + x[2])*X[1] + x[1])*X[0] + x[0];
+	    int p = (x[0] + x[1] + x[2] + x[3]) % 2;
+	    int n = BLOCK_INDEX(x);
+	    index[p][n] = lex / 2;
+
+	    for (int dir=0; dir<8; dir++) {
+	      int d = dir/2;
+	      int y[4] = {x[0], x[1], x[2], x[3]};
+	      bool wrap = false;
+	      if (dir % 2 == 0) {
+		y[d]++;
+		if (y[d] == X[d]) { y[d] = 0; wrap = true; }
+	      } else {
+		y[d]--;
+		if (y[d] < 0) { y[d] = X[d]-1; wrap = true; }
+	      }
+
+	      int m = (wrap && commDimPartitioned(d)) ? -1 : BLOCK_INDEX(y);
+	      nbr[p][8*n+dir] = m;
+	      nbrBlock[p][8*n+dir] = (m >= 0 && m / blockVolumeCB == n / blockVolumeCB) ? m : -1;
+	    }
+	  }
+	}
+      }
+    }
+
+#undef BLOCK_INDEX
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Host Schwarz: %d blocks of %dx%dx%dx%d on %d threads\n",
+		 nBlocks, B[0], B[1], B[2], B[3], nthreads);
+  }
+
+  SchwarzBlocks::~SchwarzBlocks() {
+    for (int p=0; p<2; p++) {
+      host_free(index[p]);
+      host_free(nbr[p]);
+      host_free(nbrBlock[p]);
+    }
+    host_free(color);
+  }
+
+  /**
+     Apply the hopping term to the sites of parity oddBit in block b,
+     out = x + a * D in, or out = D in if x is NULL.  Uses neighbor
+     table nbr to decide which hops are retained.  The output may
+     alias x.
+   */
+  template <typename Float>
+  static void blockDslash(Float *out, const Float *const *gauge, const Float *in, const int *nbr,
+			  int oddBit, int dagger, const Float *x, double a, int b, int blockVolumeCB) {
+    typedef SpinorAccessor<NativeStorage<Float> > Spinor;
+    const Spinor o(out), i(in), xs(x);
+    const LinkAccessor<Float,18> links((const void *const *)gauge);
+    for (int n=b*blockVolumeCB; n<(b+1)*blockVolumeCB; n++)
+      wilsonHopSite(o, links, i, nbr, n, oddBit, dagger, x ? &xs : (const Spinor*)0, a);
+  }
+
+  template <typename Float>
+  class SchwarzBlocksImpl : public SchwarzBlocks {
+
+  private:
+    Float *gauge[2];   // block-major gauge field [site][dim][18] for each parity
+    Float *r[2];       // residual
+    Float *x[2];       // solution
+    Float *Ar[2];      // matrix-vector product
+    Float *tmp[2];     // temporary for the preconditioned operator
+
+    int nParity() const { return pc ? 1 : 2; }
+    int parity(int i) const { return pc ? matParity : i; }
+
+    /**
+       Apply the Wilson matrix restricted to block b to in, storing the
+       result in out.  If local is false, node-local hops leaving the
+       block are retained.
+     */
+    void M(Float **out, Float **in, int b, bool local) {
+      const int *const *n = local ? nbrBlock : nbr;
+      if (pc) {
+	const int p = matParity;
+	blockDslash(tmp[1-p], gauge, in[p], n[1-p], 1-p, dagger, (Float*)0, 0.0, b, blockVolumeCB);
+	blockDslash(out[p], gauge, tmp[1-p], n[p], p, dagger, in[p], -kappa*kappa, b, blockVolumeCB);
+      } else {
+	for (int p=0; p<2; p++)
+	  blockDslash(out[p], gauge, in[1-p], n[p], p, dagger, in[p], -kappa, b, blockVolumeCB);
+      }
+    }
+
+    /**
+       Block-local MR solve of M x_b = r_b, starting from zero.  The
+       residual r_b is overwritten.  Returns the number of iterations.
+     */
+    int blockMR(int b, int maxiter, double tol) {
+      const int begin = 24*b*blockVolumeCB;
+      const int end = 24*(b+1)*blockVolumeCB;
+
+      double b2 = 0.0;
+      for (int i=0; i<nParity(); i++) {
+	const int p = parity(i);
+	for (int j=begin; j<end; j++) { x[p][j] = 0.0; b2 += r[p][j]*r[p][j]; }
+      }
+      if (b2 == 0.0) return 0;
+
+      // block-wise normalization of the residual to prevent underflow
+      const double scale = 1.0/sqrt(b2);
+      for (int i=0; i<nParity(); i++)
+	for (int j=begin; j<end; j++) r[parity(i)][j] *= scale;
+
+      double r2 = 1.0;
+      int k = 0;
+      while (k < maxiter && r2 > tol*tol) {
+	M(Ar, r, b, true);
+
+	double dot_re = 0.0, dot_im = 0.0, Ar2 = 0.0;
+	for (int i=0; i<nParity(); i++) {
+	  const Float *a = Ar[parity(i)], *v = r[parity(i)];
+	  for (int j=begin; j<end; j+=2) {
+	    dot_re += a[j]*v[j] + a[j+1]*v[j+1];
+	    dot_im += a[j]*v[j+1] - a[j+1]*v[j];
+	    Ar2 += a[j]*a[j] + a[j+1]*a[j+1];
+	  }
+	}
+	if (Ar2 == 0.0) break;
+	const double alpha_re = dot_re / Ar2, alpha_im = dot_im / Ar2;
+
+	// x += alpha*r, r -= alpha*Ar, r2 = norm2(r)
+	r2 = 0.0;
+	for (int i=0; i<nParity(); i++) {
+	  Float *xp = x[parity(i)], *rp = r[parity(i)];
+	  const Float *a = Ar[parity(i)];
+	  for (int j=begin; j<end; j+=2) {
+	    xp[j+0] += alpha_re*rp[j+0] - alpha_im*rp[j+1];
+	    xp[j+1] += alpha_re*rp[j+1] + alpha_im*rp[j+0];
+	    rp[j+0] -= alpha_re*a[j+0] - alpha_im*a[j+1];
+	    rp[j+1] -= alpha_re*a[j+1] + alpha_im*a[j+0];
+	    r2 += rp[j]*rp[j] + rp[j+1]*rp[j+1];
+	  }
+	}
+	k++;
+      }
+
+      const double unscale = sqrt(b2);
+      for (int i=0; i<nParity(); i++)
+	for (int j=begin; j<end; j++) x[parity(i)][j] *= unscale;
+
+      return k;
+    }
+
+  public:
+    SchwarzBlocksImpl(const Dirac &dirac, bool multiplicative)
+      : SchwarzBlocks(dirac, multiplicative) {
+      const QudaPrecision prec = sizeof(Float) == sizeof(double) ?
+	QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
+
+      // copy the gauge field to the host in QDP order
+      const cudaGaugeField &u = dirac.Gauge();
+      GaugeFieldParam gParam(X, prec, QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY);
+      gParam.order = QUDA_QDP_GAUGE_ORDER;
+      gParam.create = QUDA_NULL_FIELD_CREATE;
+      gParam.link_type = QUDA_WILSON_LINKS;
+      gParam.t_boundary = u.TBoundary();
+      gParam.anisotropy = u.Anisotropy();
+      gParam.nFace = 1;
+      cpuGaugeField cpu(gParam);
+      u.saveCPUField(cpu, QUDA_CPU_FIELD_LOCATION);
+
+      const size_t bytes = volumeCB*24*sizeof(Float);
+      for (int p=0; p<2; p++) {
+	gauge[p] = (Float*)safe_malloc(4*volumeCB*18*sizeof(Float));
+	r[p] = (Float*)safe_malloc(bytes);
+	x[p] = (Float*)safe_malloc(bytes);
+	Ar[p] = (Float*)safe_malloc(bytes);
+	tmp[p] = (Float*)safe_malloc(bytes);
+
+	const Float *const *qdp = (const Float *const *)cpu.Gauge_p();
+#pragma omp parallel for
+	for (int n=0; n<volumeCB; n++)
+	  for (int d=0; d<4; d++)
+	    memcpy(gauge[p] + (4*n+d)*18, qdp[d] + (p*volumeCB + index[p][n])*18, 18*sizeof(Float));
+      }
+    }
+
+    virtual ~SchwarzBlocksImpl() {
+      for (int p=0; p<2; p++) {
+	host_free(gauge[p]);
+	host_free(r[p]);
+	host_free(x[p]);
+	host_free(Ar[p]);
+	host_free(tmp[p]);
+      }
+    }
+
+    void gather(const cpuColorSpinorField &in) {
+      for (int i=0; i<nParity(); i++) {
+	const int p = parity(i);
+	const Float *v = (const Float*)in.V() + (pc ? 0 : p*volumeCB*24);
+#pragma omp parallel for
+	for (int n=0; n<volumeCB; n++) memcpy(r[p] + 24*n, v + 24*index[p][n], 24*sizeof(Float));
+      }
+    }
+
+    void scatter(cpuColorSpinorField &out) const {
+      for (int i=0; i<nParity(); i++) {
+	const int p = parity(i);
+	Float *v = (Float*)out.V() + (pc ? 0 : p*volumeCB*24);
+#pragma omp parallel for
+	for (int n=0; n<volumeCB; n++) memcpy(v + 24*index[p][n], x[p] + 24*n, 24*sizeof(Float));
+      }
+    }
+
+    int solve(int maxiter, double tol, QudaSchwarzType schwarz_type) {
+      const bool multiplicative = (schwarz_type == QUDA_MULTIPLICATIVE_SCHWARZ);
+      int iter = 0;
+
+      // blockMR only zeroes the blocks it solves, so clear the second
+      // color left from the previous application before it is coupled in
+      if (multiplicative)
+	for (int i=0; i<nParity(); i++) memset(x[parity(i)], 0, volumeCB*24*sizeof(Float));
+
+      for (int c=0; c<(multiplicative ? 2 : 1); c++) {
+
+	if (c == 1) {
+	  // update the residual on the second color with the node-local
+	  // coupling to the first color solution: r -= M x, where x
+	  // vanishes on the second color
+	  if (pc) {
+	    const int p = matParity;
+#pragma omp parallel for
+	    for (int b=0; b<nBlocks; b++)
+	      blockDslash(tmp[1-p], gauge, x[p], nbr[1-p], 1-p, dagger, (Float*)0, 0.0, b, blockVolumeCB);
+#pragma omp parallel for
+	    for (int b=0; b<nBlocks; b++)
+	      if (color[b] == 1)
+		blockDslash(r[p], gauge, tmp[1-p], nbr[p], p, dagger, r[p], kappa*kappa, b, blockVolumeCB);
+	  } else {
+#pragma omp parallel for
+	    for (int b=0; b<nBlocks; b++)
+	      if (color[b] == 1)
+		for (int p=0; p<2; p++)
+		  blockDslash(r[p], gauge, x[1-p], nbr[p], p, dagger, r[p], kappa, b, blockVolumeCB);
+	  }
+	  flops += (pc ? 2 : 1) * 1320ll * nBlocks * blockVolumeCB;
+	}
+
+#pragma omp parallel for reduction(+:iter)
+	for (int b=0; b<nBlocks; b++)
+	  if (!multiplicative || color[b] == c) iter += blockMR(b, maxiter, tol);
+      }
+
+      // dslash plus MR linear algebra per site of each parity
+      flops += (unsigned long long)iter * blockVolumeCB * nParity() *
+	((pc ? 2 : 1) * 1368ll + 24*8);
+
+      return iter;
+    }
+
+  };
+
+  SchwarzCpu::SchwarzCpu(DiracMatrix &mat, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), blocks(0), hIn(0), hOut(0), init(false)
+  {
+    if (typeid(mat) != typeid(DiracM))
+      errorQuda("Host Schwarz preconditioner requires DiracM operator");
+
+    const bool multiplicative = (param.schwarz_type == QUDA_MULTIPLICATIVE_SCHWARZ);
+    if (param.precision_precondition == QUDA_DOUBLE_PRECISION) {
+      blocks = new SchwarzBlocksImpl<double>(*mat.Expose(), multiplicative);
+    } else {
+      blocks = new SchwarzBlocksImpl<float>(*mat.Expose(), multiplicative);
+    }
+  }
+
+  SchwarzCpu::~SchwarzCpu() {
+    if (init) {
+      delete hIn;
+      delete hOut;
+      host_free(hInBuffer);
+      host_free(hOutBuffer);
+    }
+    delete blocks;
+  }
+
+  void SchwarzCpu::operator()(cudaColorSpinorField &out, cudaColorSpinorField &in)
+  {
+    if (!init) {
+      ColorSpinorParam csParam(in);
+      csParam.precision = (param.precision_precondition == QUDA_DOUBLE_PRECISION) ?
+	QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
+      csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+      csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+      csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+      csParam.pad = 0;
+      csParam.create = QUDA_REFERENCE_FIELD_CREATE;
+
+      // reference fields so that the host copies are not reallocated every application
+      const size_t bytes = (size_t)in.Volume() * in.Ncolor() * in.Nspin() * 2 * csParam.precision;
+      hInBuffer = safe_malloc(bytes);
+      hOutBuffer = safe_malloc(bytes);
+      csParam.v = hInBuffer;
+      hIn = new cpuColorSpinorField(csParam);
+      csParam.v = hOutBuffer;
+      hOut = new cpuColorSpinorField(csParam);
+      init = true;
+    }
+
+    *hIn = in;
+    blocks->gather(*hIn);
+    int iter = blocks->solve(param.maxiter_precondition, param.tol_precondition, param.schwarz_type);
+    blocks->scatter(*hOut);
+    out = *hOut;
+
+    blas_flops += blocks->flops;
+    blocks->flops = 0;
+
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+      printfQuda("Host Schwarz: %d block iterations over %d blocks\n", iter, blocks->Blocks());
+  }
+
+} // namespace quda
@@ -0,0 +1,87 @@
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include <tune_quda.h>
+#include <kernel_stats.h>
+
+namespace quda {
+
+  typedef std::map<TuneKey, KernelStats> KernelTable;
+
+  // the table of each thread, and the list of all of them
+  static __thread KernelTable *kernelTable = 0;
+  static std::vector<KernelTable*> kernelTables;
+
+  void kernelStatsRecord(const TuneKey &key, const KernelStats &stats)
+  {
+    if (!kernelTable) {
+      kernelTable = new KernelTable;
+#pragma omp critical (kernel_stats)
+      kernelTables.push_back(kernelTable);
+    }
+    (*kernelTable)[key] += stats;
+  }
+
+  static void kernelStatsMerge(KernelTable &all)
+  {
+    for (size_t t=0; t<kernelTables.size(); t++)
+      for (KernelTable::const_iterator it = kernelTables[t]->begin(); it != kernelTables[t]->end(); ++it)
+	all[it->first] += it->second;
+  }
+
+  bool kernelStatsQuery(const TuneKey &key, KernelStats &stats)
+  {
+    stats = KernelStats();
+    for (size_t t=0; t<kernelTables.size(); t++) {
+      KernelTable::const_iterator it = kernelTables[t]->find(key);
+      if (it != kernelTables[t]->end()) stats += it->second;
+    }
+    return stats.calls > 0;
+  }
+
+  static bool slower(const std::pair<TuneKey, KernelStats> &a, const std::pair<TuneKey, KernelStats> &b)
+  {
+    return a.second.secs > b.second.secs;
+  }
+
+  void kernelStatsTop(std::vector<std::pair<TuneKey, KernelStats> > &top, int n)
+  {
+    KernelTable all;
+    kernelStatsMerge(all);
+    top.assign(all.begin(), all.end());
+    std::stable_sort(top.begin(), top.end(), slower);
+    if (n > 0 && (size_t)n < top.size()) top.resize(n);
+  }
+
+  void kernelStatsPrint(int n)
+  {
+    std::vector<std::pair<TuneKey, KernelStats> > top;
+    kernelStatsTop(top, 0);
+    if (top.empty()) return;
+
+    double total = 0.0;
+    for (size_t i=0; i<top.size(); i++) total += top[i].second.secs;
+    if (n > 0 && (size_t)n < top.size()) top.resize(n);
+
+    printfQuda("\n   Kernels by time\n");
+    for (size_t i=0; i<top.size(); i++) {
+      const TuneKey &key = top[i].first;
+      const KernelStats &k = top[i].second;
+      printfQuda("     %-40s %-16s = %f secs (%6.3g%%), with %10lld calls, %8.2f Gflop/s, %8.2f GB/s\n",
+		 key.name.c_str(), key.volume.c_str(), k.secs, total > 0.0 ? 100*k.secs/total : 0.0, k.calls,
+		 k.secs > 0.0 ? 1e-9*k.flops/k.secs : 0.0, k.secs > 0.0 ? 1e-9*k.bytes/k.secs : 0.0);
+      if (k.untimed > 0) printfQuda("       %s (%lld calls untimed)\n", key.aux.c_str(), k.untimed);
+      else printfQuda("       %s\n", key.aux.c_str());
+#ifdef PERF_COUNTERS
+      perfCountersPrint(k.count, k.secs);
+#endif
+    }
+  }
+
+  void kernelStatsReset()
+  {
+    for (size_t t=0; t<kernelTables.size(); t++) kernelTables[t]->clear();
+  }
+
+} // namespace quda
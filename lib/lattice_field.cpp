@@ -45,12 +45,14 @@ namespace quda {
 
   QudaFieldLocation LatticeField::Location() const { 
     QudaFieldLocation location = QUDA_INVALID_FIELD_LOCATION;
-    if (typeid(*this)==typeid(cudaCloverField) || 
-	typeid(*this)==typeid(cudaGaugeField)) {
-      location = QUDA_CUDA_FIELD_LOCATION; 
-    } else if (typeid(*this)==typeid(cpuCloverField) || 
-	       typeid(*this)==typeid(cpuGaugeField)) {
+    if (typeid(*this)==typeid(cpuCloverField) || 
+	typeid(*this)==typeid(cpuGaugeField)) {
       location = QUDA_CPU_FIELD_LOCATION;
+#ifndef QUDA_HOST_ONLY
+    } else if (typeid(*this)==typeid(cudaCloverField) || 
+	       typeid(*this)==typeid(cudaGaugeField)) {
+      location = QUDA_CUDA_FIELD_LOCATION; 
+#endif
     } else {
       errorQuda("Unknown field %s, so cannot determine location", typeid(*this).name());
     }
@@ -0,0 +1,117 @@
+#ifndef _LIME_UTIL_H
+#define _LIME_UTIL_H
+
+#include <string.h>
+#include <comm_quda.h>
+
+/**
+   Helpers shared by the native gauge reader, the spinor writer and
+   the solver checkpoints: big-endian access, the LIME record header
+   and the checksums of the SciDAC and MILC formats.
+ */
+
+namespace quda {
+
+  static const unsigned int limeMagic = 0x456789ab;
+  static const size_t limeHeaderBytes = 144;
+
+  static inline bool hostBigEndian() {
+    const unsigned int one = 1;
+    return *(const char*)&one == 0;
+  }
+
+  static inline unsigned int swap32(unsigned int w) {
+    return (w >> 24) | ((w >> 8) & 0xff00) | ((w << 8) & 0xff0000) | (w << 24);
+  }
+
+  static inline unsigned int readBE32(const char *p) {
+    const unsigned char *u = (const unsigned char*)p;
+    return ((unsigned int)u[0] << 24) | ((unsigned int)u[1] << 16) | ((unsigned int)u[2] << 8) | u[3];
+  }
+
+  static inline unsigned long long readBE64(const char *p) {
+    return ((unsigned long long)readBE32(p) << 32) | readBE32(p+4);
+  }
+
+  static inline void writeBE(char *p, unsigned long long v, int bytes) {
+    for (int i=0; i<bytes; i++) p[i] = (char)(v >> 8*(bytes-1-i));
+  }
+
+  // store a real in big-endian byte order
+  static inline void putBE(char *p, double v) {
+    unsigned long long u;
+    memcpy(&u, &v, sizeof(u));
+    writeBE(p, u, 8);
+  }
+
+  static inline void putBE(char *p, float v) {
+    unsigned int u;
+    memcpy(&u, &v, sizeof(u));
+    writeBE(p, u, 4);
+  }
+
+  // records are padded to a multiple of 8 bytes
+  static inline size_t limePadded(size_t length) { return (length + 7) / 8 * 8; }
+
+  /**
+     Fill in the header of a LIME record; begin and end mark the first
+     and last record of a message.
+   */
+  static inline void limeHeader(char header[limeHeaderBytes], const char *type, size_t length,
+				bool begin, bool end) {
+    memset(header, 0, limeHeaderBytes);
+    writeBE(header, limeMagic, 4);
+    writeBE(header + 4, 1, 2); // version
+    writeBE(header + 6, (begin ? 0x8000 : 0) | (end ? 0x4000 : 0), 2);
+    writeBE(header + 8, length, 8);
+    strncpy(header + 16, type, 128);
+  }
+
+  static inline unsigned int rotl(unsigned int w, int n) {
+    return n ? (w << n) | (w >> (32-n)) : w;
+  }
+
+  // the zlib crc32, as used by the SciDAC checksum
+  static unsigned int crcTable[256];
+  static bool crcTableInit = false;
+
+  static inline void initCrcTable() {
+    if (crcTableInit) return;
+    for (unsigned int n=0; n<256; n++) {
+      unsigned int c = n;
+      for (int k=0; k<8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      crcTable[n] = c;
+    }
+    crcTableInit = true;
+  }
+
+  static inline unsigned int crc32(const char *buf, size_t len) {
+    unsigned int c = 0xffffffffu;
+    for (size_t i=0; i<len; i++) c = crcTable[(c ^ (unsigned char)buf[i]) & 0xff] ^ (c >> 8);
+    return c ^ 0xffffffffu;
+  }
+
+  // contribution of site r (global lexicographic index) to the SciDAC checksum
+  static inline void scidacChecksum(unsigned int sum[2], const char *site, size_t bytes, size_t r) {
+    const unsigned int crc = crc32(site, bytes);
+    sum[0] ^= rotl(crc, r % 29);
+    sum[1] ^= rotl(crc, r % 31);
+  }
+
+  // combine a per-rank word over all ranks, by xor or by addition
+  static inline unsigned int reduceWord(unsigned int w, bool xorReduce) {
+    const int n = comm_size();
+    if (n == 1) return w;
+    double *v = new double[n];
+    for (int i=0; i<n; i++) v[i] = 0.0;
+    v[comm_rank()] = w;
+    comm_allreduce_array(v, n);
+    unsigned int rtn = 0;
+    for (int i=0; i<n; i++) rtn = xorReduce ? rtn ^ (unsigned int)v[i] : rtn + (unsigned int)v[i];
+    delete []v;
+    return rtn;
+  }
+
+} // namespace quda
+
+#endif // _LIME_UTIL_H
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <gauge_field.h>
+#include <llfat_quda.h>
+
+#include "cpu_gauge_util.h"
+
+/*
+ * Host link fattening
+ *
+ * The fat and long links are computed from a site-link field with a
+ * border of two sites in every dimension, so that no communication is
+ * needed between the staple levels.  For each direction mu and each
+ * nu the 3-staple field is computed once and reused for the Lepage
+ * term and for the 5-staples of every rho; each 5-staple field is in
+ * turn reused for the 7-staples of the remaining sig.  Upper and
+ * lower staples are fused in one pass over the sites, and every pass
+ * is threaded over the sites of the (extended) lattice.
+ */
+
+namespace quda {
+
+  /**
+     Generalized staple in the (mu,nu) plane with the mu link M,
+       S(x) = U_nu(x) M(x+nu) U_nu^dag(x+mu) + U_nu^dag(x-nu) M(x-nu) U_nu(x-nu+mu).
+     If staple is set, S is stored on the box with margin 1;
+     otherwise it is only evaluated on the local volume.  In both cases
+     coeff * S is accumulated into fat on the local volume.
+   */
+  template <typename Float>
+  static void genStaple(Float *staple, Float *fat, const Float *U, const Float *M, int mStride,
+			int mu, int nu, Float coeff, const ExtendedLattice &lat) {
+    const int margin = staple ? 1 : 2;
+    const int sites = lat.boxVolume(margin);
+    const int fnu = lat.stride[nu], fmu = lat.stride[mu];
+
+#pragma omp parallel for
+    for (int n=0; n<sites; n++) {
+      const int x = lat.boxSite(n, margin);
+      Float t[18], s[18], l[18];
+
+      // upper staple
+      su3MulNN(U + (x*4+nu)*18, M + (x+fnu)*mStride, t);
+      su3MulNA(t, U + ((x+fmu)*4+nu)*18, s);
+
+      // lower staple
+      const int y = x - fnu;
+      su3MulAN(U + (y*4+nu)*18, M + y*mStride, t);
+      su3MulNN(t, U + ((y+fmu)*4+nu)*18, l);
+
+      for (int i=0; i<18; i++) s[i] += l[i];
+      if (staple) memcpy(staple + x*18, s, 18*sizeof(Float));
+
+      // the local volume is the box with margin 2
+      int c = x, interior = 1;
+      for (int d=0; d<4; d++) {
+	const int xd = c % lat.E[d];
+	c /= lat.E[d];
+	if (xd < 2 || xd >= lat.E[d]-2) interior = 0;
+      }
+      if (interior) for (int i=0; i<18; i++) fat[x*18+i] += coeff*s[i];
+    }
+  }
+
+  template <typename Float>
+  static void llfatCpu(void *fatlink, void *longlink, void *sitelink, QudaGaugeFieldOrder siteOrder,
+		       const int *X, const double *act_path_coeff) {
+    const ExtendedLattice lat(X);
+    const size_t linkBytes = 18*sizeof(Float);
+
+    // repack the site links to [site][dim][18]
+    Float *U = (Float*)safe_malloc(4*(size_t)lat.volume*linkBytes);
+    packExtendedLinks(U, sitelink, siteOrder, X, true, lat);
+
+    Float *fat = (Float*)safe_malloc((size_t)lat.volume*linkBytes);
+    Float *staple3 = (Float*)safe_malloc((size_t)lat.volume*linkBytes);
+    Float *staple5 = (Float*)safe_malloc((size_t)lat.volume*linkBytes);
+    // the staples are never evaluated on the outer layer, which is
+    // only read when computing staples that are not used
+    memset(staple3, 0, lat.volume*linkBytes);
+    memset(staple5, 0, lat.volume*linkBytes);
+
+    // the Lepage term is included by a trick that requires modifying c_1
+    const Float one_link = act_path_coeff[0] - 6.0*act_path_coeff[5];
+    const Float c3 = act_path_coeff[2], c5 = act_path_coeff[3];
+    const Float c7 = act_path_coeff[4], cLepage = act_path_coeff[5];
+    const int V = X[0]*X[1]*X[2]*X[3];
+
+    for (int mu=0; mu<4; mu++) {
+#pragma omp parallel for
+      for (int s=0; s<lat.volume; s++)
+	for (int i=0; i<18; i++) fat[s*18+i] = one_link * U[(s*4+mu)*18+i];
+
+      for (int nu=0; nu<4; nu++) {
+	if (nu == mu) continue;
+	genStaple(staple3, fat, U, U + mu*18, 72, mu, nu, c3, lat);
+	genStaple((Float*)0, fat, U, staple3, 18, mu, nu, cLepage, lat);
+
+	for (int rho=0; rho<4; rho++) {
+	  if (rho == mu || rho == nu) continue;
+	  genStaple(staple5, fat, U, staple3, 18, mu, rho, c5, lat);
+
+	  for (int sig=0; sig<4; sig++) {
+	    if (sig == mu || sig == nu || sig == rho) continue;
+	    genStaple((Float*)0, fat, U, staple5, 18, mu, sig, c7, lat);
+	  }
+	}
+      }
+
+      // copy the local volume to the (MILC-ordered) output fields
+#pragma omp parallel for
+      for (int s=0; s<V; s++) {
+	int x[4], c = s;
+	for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; }
+	const int e = (((x[3]+2)*lat.E[2] + x[2]+2)*lat.E[1] + x[1]+2)*lat.E[0] + x[0]+2;
+	const int idx = cbIndex(x, X);
+	memcpy(hostLink<Float>(fatlink, QUDA_MILC_GAUGE_ORDER, idx, mu), fat + e*18, linkBytes);
+
+	if (longlink) {
+	  Float t[18];
+	  Float *l = hostLink<Float>(longlink, QUDA_MILC_GAUGE_ORDER, idx, mu);
+	  const int f = lat.stride[mu];
+	  su3MulNN(U + (e*4+mu)*18, U + ((e+f)*4+mu)*18, t);
+	  su3MulNN(t, U + ((e+2*f)*4+mu)*18, l);
+	  for (int i=0; i<18; i++) l[i] *= act_path_coeff[1];
+	}
+      }
+    }
+
+    host_free(staple5);
+    host_free(staple3);
+    host_free(fat);
+    host_free(U);
+  }
+
+  void llfatCpu(cpuGaugeField &fatlink, cpuGaugeField *longlink, cpuGaugeField &sitelink,
+		const double *act_path_coeff)
+  {
+    QUDA_PERF_SCOPE("llfatCpu");
+    const int *X = fatlink.X();
+    for (int d=0; d<4; d++)
+      if (sitelink.X()[d] != X[d] + 4)
+	errorQuda("Site links must be extended by 2 sites in each direction (X[%d] = %d, expected %d)",
+		  d, sitelink.X()[d], X[d] + 4);
+    if (fatlink.Order() != QUDA_MILC_GAUGE_ORDER || (longlink && longlink->Order() != QUDA_MILC_GAUGE_ORDER))
+      errorQuda("Host fat and long links must be in MILC order");
+    if (sitelink.Order() != QUDA_QDP_GAUGE_ORDER && sitelink.Order() != QUDA_MILC_GAUGE_ORDER)
+      errorQuda("Site link order %d not supported", sitelink.Order());
+    if (sitelink.Precision() != fatlink.Precision() || (longlink && longlink->Precision() != fatlink.Precision()))
+      errorQuda("Mixed precision link fattening not supported");
+
+    void *longGauge = longlink ? longlink->Gauge_p() : 0;
+    if (fatlink.Precision() == QUDA_DOUBLE_PRECISION) {
+      llfatCpu<double>(fatlink.Gauge_p(), longGauge, sitelink.Gauge_p(), sitelink.Order(), X, act_path_coeff);
+    } else if (fatlink.Precision() == QUDA_SINGLE_PRECISION) {
+      llfatCpu<float>(fatlink.Gauge_p(), longGauge, sitelink.Gauge_p(), sitelink.Order(), X, act_path_coeff);
+    } else {
+      errorQuda("Precision %d not supported", fatlink.Precision());
+    }
+  }
+
+} // namespace quda
@@ -43,6 +43,12 @@ namespace quda {
       max = maxGauge<Float,Nc>(MILCOrder<Float,2*Nc*Nc>(u, (Float*)u.Gauge_p()),u.Volume(),4);
     } else if (u.Order() == QUDA_BQCD_GAUGE_ORDER) {
       max = maxGauge<Float,Nc>(BQCDOrder<Float,2*Nc*Nc>(u, (Float*)u.Gauge_p()),u.Volume(),4);
+    } else if (u.Order() == QUDA_AOSOA4_GAUGE_ORDER) {
+      max = maxGauge<Float,Nc>(AoSoAOrder<Float,2*Nc*Nc,4>(u, (Float*)u.Gauge_p()),u.Volume(),4);
+    } else if (u.Order() == QUDA_AOSOA8_GAUGE_ORDER) {
+      max = maxGauge<Float,Nc>(AoSoAOrder<Float,2*Nc*Nc,8>(u, (Float*)u.Gauge_p()),u.Volume(),4);
+    } else if (u.Order() == QUDA_AOSOA16_GAUGE_ORDER) {
+      max = maxGauge<Float,Nc>(AoSoAOrder<Float,2*Nc*Nc,16>(u, (Float*)u.Gauge_p()),u.Volume(),4);
     } else {
       errorQuda("Gauge field %d order not supported", u.Order());
     }
@@ -0,0 +1,213 @@
+#include <string.h>
+#include <sys/time.h>
+
+#if defined(PERF_COUNTERS) && defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <tune_quda.h>
+#include <perf_counters.h>
+#include <kernel_stats.h>
+
+namespace quda {
+
+  static const char *perfEventName[] = { "cycles", "instructions", "LLC read misses", "LLC write misses" };
+
+  static double wallTime()
+  {
+    timeval t;
+    gettimeofday(&t, NULL);
+    return t.tv_sec + 1e-6*t.tv_usec;
+  }
+
+#if defined(PERF_COUNTERS) && defined(__linux__)
+
+  static bool perfAvailable = true;
+  static bool perfSupported[PERF_EVENT_COUNT] = { true, true, true, true };
+
+  // the counter group of each thread, opened on first use (-2) or failed (-1)
+  static __thread int perfLeader = -2;
+  static __thread int perfNumEvents = 0;
+  static __thread int perfEvent[PERF_EVENT_COUNT]; // event of each member of the group
+
+  static int perfOpen(int event, int group)
+  {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const unsigned long long ll = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    switch (event) {
+    case PERF_CYCLES:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PERF_INSTRUCTIONS:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PERF_LLC_READ_MISSES:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = ll | (PERF_COUNT_HW_CACHE_OP_READ << 8);
+      break;
+    case PERF_LLC_WRITE_MISSES:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = ll | (PERF_COUNT_HW_CACHE_OP_WRITE << 8);
+      break;
+    }
+
+    // counting this thread on any cpu
+    return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+  }
+
+  /**
+     Open the group of the calling thread: the cycles lead, and the
+     events the processor does not provide are left out.
+   */
+  static void perfOpenThread()
+  {
+    perfLeader = perfOpen(PERF_CYCLES, -1);
+    if (perfLeader < 0) {
+#pragma omp critical (perf_counters)
+      {
+	if (perfAvailable)
+	  warningQuda("perf_event_open failed, hardware counters disabled (see /proc/sys/kernel/perf_event_paranoid)");
+	perfAvailable = false;
+      }
+      perfLeader = -1;
+      return;
+    }
+    perfEvent[perfNumEvents++] = PERF_CYCLES;
+
+    for (int e=PERF_INSTRUCTIONS; e<PERF_EVENT_COUNT; e++) {
+      int fd = perfOpen(e, perfLeader);
+      if (fd < 0) {
+#pragma omp critical (perf_counters)
+	perfSupported[e] = false;
+	continue;
+      }
+      perfEvent[perfNumEvents++] = e;
+    }
+  }
+
+  static void perfReadThread(PerfCount &c)
+  {
+    if (perfLeader == -2) perfOpenThread();
+    if (perfLeader < 0) return;
+
+    // nr, time enabled, time running, then the values of the group
+    unsigned long long buf[3 + PERF_EVENT_COUNT];
+    if (read(perfLeader, buf, sizeof(buf)) < (ssize_t)(3 + perfNumEvents)*(ssize_t)sizeof(unsigned long long)) return;
+
+    // scale up if the group was multiplexed with others
+    const double scale = (buf[2] > 0 && buf[2] < buf[1]) ? (double)buf[1] / buf[2] : 1.0;
+    for (int i=0; i<perfNumEvents; i++) c.count[perfEvent[i]] += (unsigned long long)(scale * buf[3+i]);
+  }
+
+  bool perfCountersRead(PerfCount &c)
+  {
+    c = PerfCount();
+    if (!perfAvailable) return false;
+
+#ifdef _OPENMP
+    if (!omp_in_parallel()) {
+#pragma omp parallel
+      {
+	PerfCount t;
+	perfReadThread(t);
+#pragma omp critical (perf_counters)
+	c += t;
+      }
+      return perfAvailable;
+    }
+#endif
+
+    perfReadThread(c);
+    return perfAvailable;
+  }
+
+  static bool perfEventSupported(int e) { return perfSupported[e]; }
+
+#else
+
+  bool perfCountersRead(PerfCount &c)
+  {
+    c = PerfCount();
+#ifdef PERF_COUNTERS
+    static bool warned = false;
+    if (!warned) warningQuda("Hardware counters are only supported on Linux");
+    warned = true;
+#endif
+    return false;
+  }
+
+  static bool perfEventSupported(int) { return false; }
+
+#endif // PERF_COUNTERS && __linux__
+
+  void perfCountersPrint(const PerfCount &c, double secs)
+  {
+    if (c.count[PERF_CYCLES] == 0) return;
+
+    char line[512];
+    int n = sprintf(line, "    ");
+    for (int e=0; e<PERF_EVENT_COUNT; e++) {
+      if (!perfEventSupported(e)) continue;
+      n += sprintf(line + n, " %s = %.3e,", perfEventName[e], (double)c.count[e]);
+    }
+    if (perfEventSupported(PERF_INSTRUCTIONS))
+      n += sprintf(line + n, " IPC = %.2f,", (double)c.count[PERF_INSTRUCTIONS] / c.count[PERF_CYCLES]);
+    if (perfEventSupported(PERF_LLC_READ_MISSES) && secs > 0.0) {
+      const double bytes = 64.0*(c.count[PERF_LLC_READ_MISSES] + c.count[PERF_LLC_WRITE_MISSES]);
+      n += sprintf(line + n, " ~%.2f GB/s,", 1e-9*bytes/secs);
+    }
+    line[n-1] = '\0';
+    printfQuda("%s\n", line);
+  }
+
+  // number of open scopes of each thread
+  static __thread int perfScopeDepth = 0;
+
+  PerfScope::PerfScope(const char *name) : name(name), outer(perfScopeDepth++ == 0), counters(true),
+					     flops(0), bytes(0)
+  {
+    if (!outer) return;
+#ifdef _OPENMP
+    if (omp_in_parallel()) counters = false; // the counts of the other threads would be lost
+#endif
+#ifdef PERF_COUNTERS
+    if (counters) counters = perfCountersRead(startCount);
+#else
+    counters = false;
+#endif
+    start = wallTime();
+  }
+
+  PerfScope::~PerfScope()
+  {
+    perfScopeDepth--;
+    if (!outer) return;
+
+    KernelStats k;
+    k.calls = 1;
+    k.secs = wallTime() - start;
+    k.flops = flops;
+    k.bytes = bytes;
+    if (counters) {
+      perfCountersRead(k.count);
+      k.count -= startCount;
+    }
+    kernelStatsRecord(TuneKey("-", name, "host"), k);
+  }
+
+} // namespace quda
@@ -17,7 +17,7 @@ namespace quda {
     switch (param.inv_type) {
     case QUDA_CG_INVERTER:
       report("CG");
-      solver = new CG(mat, matSloppy, param, profile);
+      solver = new CG(mat, matSloppy, matPrecon, param, profile);
       break;
     case QUDA_BICGSTAB_INVERTER:
       report("BiCGstab");
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <quda_internal.h>
+#include <invert_quda.h>
+#include <comm_quda.h>
+
+#include "lime_util.h"
+
+/*
+ * Solver checkpoint file layout (native byte order, local to each
+ * process):
+ *
+ *   char[8] magic, int version, int iter, int nScalar, int nField,
+ *   unsigned long long key
+ *   double scalar[nScalar]
+ *   for each field: int precision, int 0, unsigned long long bytes,
+ *     unsigned long long norm_bytes, field data, norm data
+ *   unsigned int crc32 of all of the above
+ */
+
+namespace quda {
+
+  static const char checkpointMagic[8] = { 'Q', 'U', 'D', 'A', 'C', 'K', 'P', 'T' };
+  static const int checkpointVersion = 1;
+  static const size_t headerBytes = 8 + 4*sizeof(int) + sizeof(unsigned long long);
+  static const size_t fieldHeaderBytes = 2*sizeof(int) + 2*sizeof(unsigned long long);
+
+  static char checkpointPath[256] = "quda_checkpoint";
+
+  void setCheckpointPath(const char *path) {
+    strncpy(checkpointPath, path, sizeof(checkpointPath)-1);
+    checkpointPath[sizeof(checkpointPath)-1] = '\0';
+  }
+
+  // 64-bit FNV-1a hash
+  static void hash(unsigned long long &key, const void *p, size_t bytes) {
+    const unsigned char *c = (const unsigned char*)p;
+    for (size_t i=0; i<bytes; i++) key = (key ^ c[i]) * 0x100000001b3ull;
+  }
+
+  static void append(std::vector<char> &buf, const void *p, size_t bytes) {
+    const size_t o = buf.size();
+    buf.resize(o + bytes);
+    memcpy(&buf[o], p, bytes);
+  }
+
+  template <typename T>
+  static T get(const std::vector<char> &buf, size_t offset) {
+    T v;
+    memcpy(&v, &buf[offset], sizeof(T));
+    return v;
+  }
+
+  SolverCheckpoint::SolverCheckpoint(const SolverParam &param, const char *solver, double b2, double r2)
+    : param(param), solver(solver), last(0)
+  {
+    key = 0xcbf29ce484222325ull;
+    hash(key, solver, strlen(solver));
+    hash(key, &b2, sizeof(b2));
+    hash(key, &r2, sizeof(r2));
+    hash(key, &param.num_offset, sizeof(param.num_offset));
+    hash(key, param.offset, param.num_offset*sizeof(double));
+    const int size = comm_size();
+    hash(key, &size, sizeof(size));
+    sprintf(filename, "%s.%s.%016llx.%d", checkpointPath, solver, key, comm_rank());
+  }
+
+  void SolverCheckpoint::Save(int k, const double *scalar, int nScalar,
+			      cudaColorSpinorField *const *field, int nField)
+  {
+    initCrcTable();
+
+    std::vector<char> buf;
+    append(buf, checkpointMagic, sizeof(checkpointMagic));
+    append(buf, &checkpointVersion, sizeof(int));
+    append(buf, &k, sizeof(int));
+    append(buf, &nScalar, sizeof(int));
+    append(buf, &nField, sizeof(int));
+    append(buf, &key, sizeof(key));
+    append(buf, scalar, nScalar*sizeof(double));
+
+    for (int i=0; i<nField; i++) {
+      const int precision = field[i]->Precision();
+      const int zero = 0;
+      const unsigned long long bytes = field[i]->Bytes();
+      const unsigned long long norm_bytes = field[i]->NormBytes();
+      append(buf, &precision, sizeof(int));
+      append(buf, &zero, sizeof(int));
+      append(buf, &bytes, sizeof(bytes));
+      append(buf, &norm_bytes, sizeof(norm_bytes));
+      const size_t o = buf.size();
+      buf.resize(o + bytes + norm_bytes);
+      cudaMemcpy(&buf[o], field[i]->V(), bytes, cudaMemcpyDeviceToHost);
+      if (norm_bytes) cudaMemcpy(&buf[o+bytes], field[i]->Norm(), norm_bytes, cudaMemcpyDeviceToHost);
+    }
+    checkCudaError();
+
+    const unsigned int crc = crc32(&buf[0], buf.size());
+    append(buf, &crc, sizeof(crc));
+
+    // write a new file and rename it over the previous checkpoint
+    char tmp[sizeof(filename)+4];
+    sprintf(tmp, "%s.tmp", filename);
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp || fwrite(&buf[0], 1, buf.size(), fp) != buf.size() || fflush(fp) || fsync(fileno(fp))) {
+      warningQuda("%s: failed to write checkpoint %s", solver, tmp);
+      if (fp) fclose(fp);
+      return;
+    }
+    fclose(fp);
+    if (rename(tmp, filename)) {
+      warningQuda("%s: failed to rename checkpoint %s", solver, tmp);
+      return;
+    }
+
+    last = k;
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("%s: checkpoint at %d iterations written to %s\n", solver, k, filename);
+  }
+
+  bool SolverCheckpoint::Load(int &k, double *scalar, int nScalar, int nField)
+  {
+    if (!Enabled()) return false;
+
+    data.clear();
+    fieldOffset.clear();
+
+    int iter = -1;
+    FILE *fp = fopen(filename, "rb");
+    if (fp) {
+      fseek(fp, 0, SEEK_END);
+      const long size = ftell(fp);
+      fseek(fp, 0, SEEK_SET);
+      if (size > (long)(headerBytes + sizeof(unsigned int))) {
+	data.resize(size);
+	if (fread(&data[0], 1, size, fp) != (size_t)size) data.clear();
+      }
+      fclose(fp);
+    }
+
+    if (data.size()) {
+      initCrcTable();
+      const size_t body = data.size() - sizeof(unsigned int);
+      bool valid = (memcmp(&data[0], checkpointMagic, sizeof(checkpointMagic)) == 0 &&
+		    get<int>(data, 8) == checkpointVersion && get<int>(data, 16) == nScalar &&
+		    get<int>(data, 20) == nField && get<unsigned long long>(data, 24) == key &&
+		    crc32(&data[0], body) == get<unsigned int>(data, body));
+
+      size_t o = headerBytes + nScalar*sizeof(double);
+      for (int i=0; valid && i<nField; i++) {
+	if (o + fieldHeaderBytes > body) { valid = false; break; }
+	fieldOffset.push_back(o);
+	o += fieldHeaderBytes + get<unsigned long long>(data, o + 8) + get<unsigned long long>(data, o + 16);
+      }
+      if (valid && o == body) iter = get<int>(data, 12);
+      else warningQuda("%s: ignoring corrupt checkpoint %s", solver, filename);
+    }
+
+    // resume only if every process holds the same iteration
+    double iterMax = iter, iterMin = -iter;
+    comm_allreduce_max(&iterMax);
+    comm_allreduce_max(&iterMin);
+    iterMin = -iterMin;
+
+    if (iterMin < 0 || iterMin != iterMax) {
+      if (iterMax >= 0) warningQuda("%s: checkpoints are missing or inconsistent across processes, not resuming", solver);
+      data.clear();
+      fieldOffset.clear();
+      return false;
+    }
+
+    for (int i=0; i<nScalar; i++) scalar[i] = get<double>(data, headerBytes + i*sizeof(double));
+    k = iter;
+    last = iter;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("%s: resuming from checkpoint at %d iterations\n", solver, k);
+
+    return true;
+  }
+
+  void SolverCheckpoint::Restore(cudaColorSpinorField &field, int i) const
+  {
+    if (i >= (int)fieldOffset.size()) errorQuda("Checkpoint field %d not loaded", i);
+
+    const size_t o = fieldOffset[i];
+    const int precision = get<int>(data, o);
+    const unsigned long long bytes = get<unsigned long long>(data, o + 8);
+    const unsigned long long norm_bytes = get<unsigned long long>(data, o + 16);
+    if (precision != field.Precision() || bytes != field.Bytes() || norm_bytes != field.NormBytes())
+      errorQuda("Checkpoint field %d (precision %d, %llu bytes) does not match the solver field (precision %d, %lu bytes)",
+		i, precision, bytes, field.Precision(), (unsigned long)field.Bytes());
+
+    cudaMemcpy(field.V(), &data[o + fieldHeaderBytes], bytes, cudaMemcpyHostToDevice);
+    if (norm_bytes) cudaMemcpy(field.Norm(), &data[o + fieldHeaderBytes + bytes], norm_bytes, cudaMemcpyHostToDevice);
+    checkCudaError();
+  }
+
+  void SolverCheckpoint::Remove(int k)
+  {
+    data.clear();
+    fieldOffset.clear();
+    if (Enabled() && k < param.maxiter) unlink(filename);
+  }
+
+} // namespace quda
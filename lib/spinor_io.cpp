@@ -0,0 +1,370 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <spinor_io.h>
+
+#include "lime_util.h"
+
+/*
+ * Background spinor writer
+ *
+ * writeSpinorFile copies the host field and queues it; a single
+ * writer thread reorders each queued field into the SciDAC file
+ * layout (global lexicographic sites, [spin][color][complex],
+ * big-endian), accumulates the local checksum and writes the local
+ * sites of every rank straight into the shared file with pwrite.
+ * The layout of a file is fixed by the sequence of writes, so every
+ * rank computes the same offsets without communication; rank 0 adds
+ * the LIME headers and XML records.  The checksums need a reduction
+ * over the ranks, which is only done on the calling thread by
+ * flushSpinorWriter, which then fills in the checksum records.
+ *
+ * The writer thread never touches the tracked allocator: the field
+ * copies are allocated and freed by the calling thread.  Nor does it
+ * call errorQuda: a failed write is recorded in the job and reported
+ * by the next writeSpinorFile or flushSpinorWriter.
+ */
+
+namespace quda {
+
+  struct SpinorWriteJob {
+    std::string filename;
+    char *v;                  // copy of the host field
+    int X[4];                 // local dimensions
+    int dims[4];              // global dimensions
+    int offset[4];            // global coordinates of the local origin
+    int nSpin;
+    QudaPrecision precision;
+    QudaFieldOrder fieldOrder;
+    QudaSiteOrder siteOrder;
+    bool fileHeader;          // write the file header message first
+    size_t recordOffset;      // offset of the record message
+    size_t dataOffset;        // offset of the site data
+    size_t checksumOffset;    // offset of the checksum record body
+    std::string fileXml[2];   // private and user file XML
+    std::string recordXml[2]; // private and user record XML
+    unsigned int sum[2];      // local checksum, set by the writer thread
+    double seconds;           // time spent by the writer thread
+    std::string error;        // why the write failed, set by the writer thread
+
+    size_t siteBytes() const { return (size_t)nSpin*3*2*precision; }
+  };
+
+  // maximum number of fields queued or being written
+  static const size_t maxPending = 4;
+
+  static pthread_t writer;
+  static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+  static pthread_cond_t writerCond = PTHREAD_COND_INITIALIZER;
+  static bool writerRunning = false;
+  static bool writerStop = false;
+  static std::deque<SpinorWriteJob*> pending; // the front job is the one being written
+  static std::vector<SpinorWriteJob*> written;
+  static std::map<std::string, size_t> fileEnd; // end of each open file
+
+  static const char checksumXml[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><scidacChecksum>"
+    "<version>1.0</version><suma>%08x</suma><sumb>%08x</sumb></scidacChecksum>";
+
+  static std::string formatChecksum(unsigned int suma, unsigned int sumb) {
+    char buf[sizeof(checksumXml)];
+    sprintf(buf, checksumXml, suma, sumb);
+    return buf;
+  }
+
+  // returns false if the write failed
+  static bool pwriteAll(int fd, const char *buf, size_t bytes, size_t offset) {
+    while (bytes) {
+      const ssize_t n = pwrite(fd, buf, bytes, offset);
+      if (n <= 0) return false;
+      buf += n;
+      bytes -= n;
+      offset += n;
+    }
+    return true;
+  }
+
+  // write a LIME record, or only its header and padding if body is NULL;
+  // ok is cleared if a write fails
+  static size_t writeRecord(int fd, size_t offset, const char *type, const char *body, size_t length,
+			    bool begin, bool end, bool &ok) {
+    char header[limeHeaderBytes];
+    limeHeader(header, type, length, begin, end);
+    ok = ok && pwriteAll(fd, header, limeHeaderBytes, offset);
+    if (body) ok = ok && pwriteAll(fd, body, length, offset + limeHeaderBytes);
+    const char zero[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    if (limePadded(length) > length)
+      ok = ok && pwriteAll(fd, zero, limePadded(length) - length, offset + limeHeaderBytes + length);
+    return limeHeaderBytes + limePadded(length);
+  }
+
+  /**
+     Reorder the local sites into the file layout, in local
+     lexicographic order, and accumulate their checksum
+   */
+  template <typename Float>
+  static void reorderSites(char *out, const SpinorWriteJob &job) {
+    const int *X = job.X;
+    const int V = X[0]*X[1]*X[2]*X[3];
+    const int nSpin = job.nSpin;
+    const int siteReals = nSpin*3*2;
+    const size_t siteBytes = job.siteBytes();
+    const Float *v = (const Float*)job.v;
+
+    unsigned int sum[2] = { 0, 0 };
+    for (int s=0; s<V; s++) {
+      int x[4], c = s;
+      for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; }
+      const int parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+      const int idx = (job.siteOrder == QUDA_EVEN_ODD_SITE_ORDER ? parity : 1-parity)*(V/2) + s/2;
+      const Float *in = v + (size_t)idx*siteReals;
+      char *o = out + (size_t)s*siteBytes;
+
+      for (int spin=0; spin<nSpin; spin++) {
+	for (int col=0; col<3; col++) {
+	  const int i = (job.fieldOrder == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) ? spin*3 + col : col*nSpin + spin;
+	  putBE(o + (spin*3 + col)*2*sizeof(Float), in[2*i+0]);
+	  putBE(o + ((spin*3 + col)*2 + 1)*sizeof(Float), in[2*i+1]);
+	}
+      }
+
+      size_t r = 0;
+      for (int d=3; d>=0; d--) r = r*job.dims[d] + x[d] + job.offset[d];
+      scidacChecksum(sum, o, siteBytes, r);
+    }
+
+    SpinorWriteJob &j = const_cast<SpinorWriteJob&>(job);
+    j.sum[0] = sum[0];
+    j.sum[1] = sum[1];
+  }
+
+  static void writeJob(SpinorWriteJob &job, std::vector<char> &staging) {
+    Timer timer;
+    timer.Start();
+
+    const int *X = job.X;
+    const int V = X[0]*X[1]*X[2]*X[3];
+    const size_t siteBytes = job.siteBytes();
+    staging.resize((size_t)V*siteBytes);
+    if (job.precision == QUDA_DOUBLE_PRECISION) reorderSites<double>(&staging[0], job);
+    else reorderSites<float>(&staging[0], job);
+
+    const int fd = open(job.filename.c_str(), O_WRONLY);
+    if (fd < 0) {
+      job.error = "Cannot open " + job.filename + " for writing";
+      return;
+    }
+
+    bool ok = true;
+    if (comm_rank() == 0) {
+      if (job.fileHeader) {
+	size_t o = 0;
+	o += writeRecord(fd, o, "scidac-private-file-xml", job.fileXml[0].c_str(), job.fileXml[0].size(), true, false, ok);
+	writeRecord(fd, o, "scidac-file-xml", job.fileXml[1].c_str(), job.fileXml[1].size(), false, true, ok);
+      }
+      size_t o = job.recordOffset;
+      o += writeRecord(fd, o, "scidac-private-record-xml", job.recordXml[0].c_str(), job.recordXml[0].size(), true, false, ok);
+      o += writeRecord(fd, o, "scidac-record-xml", job.recordXml[1].c_str(), job.recordXml[1].size(), false, false, ok);
+      size_t global = siteBytes;
+      for (int d=0; d<4; d++) global *= job.dims[d];
+      o += writeRecord(fd, o, "scidac-binary-data", 0, global, false, false, ok);
+      const std::string sum = formatChecksum(0, 0); // filled in by the flush
+      writeRecord(fd, o, "scidac-checksum", sum.c_str(), sum.size(), false, true, ok);
+    }
+
+    // sites that are consecutive in the file: whole rows, or more
+    // when the lower dimensions are not partitioned
+    int run = X[0];
+    for (int d=0; d<3 && X[d] == job.dims[d]; d++) run *= X[d+1];
+    for (int s=0; s<V && ok; s+=run) {
+      int c = s;
+      size_t r = 0, stride = 1;
+      for (int d=0; d<4; d++) {
+	r += (c % X[d] + job.offset[d])*stride;
+	c /= X[d];
+	stride *= job.dims[d];
+      }
+      ok = pwriteAll(fd, &staging[(size_t)s*siteBytes], run*siteBytes, job.dataOffset + r*siteBytes);
+    }
+    close(fd);
+    if (!ok) job.error = "Spinor writer failed to write " + job.filename;
+
+    timer.Stop();
+    job.seconds = timer.Last();
+  }
+
+  static void* writerLoop(void *) {
+    std::vector<char> staging;
+    pthread_mutex_lock(&writerMutex);
+    while (true) {
+      while (pending.empty() && !writerStop) pthread_cond_wait(&writerCond, &writerMutex);
+      if (pending.empty()) break;
+      SpinorWriteJob *job = pending.front();
+      pthread_mutex_unlock(&writerMutex);
+
+      writeJob(*job, staging);
+
+      pthread_mutex_lock(&writerMutex);
+      pending.pop_front();
+      written.push_back(job);
+      pthread_cond_broadcast(&writerCond);
+    }
+    pthread_mutex_unlock(&writerMutex);
+    return 0;
+  }
+
+  // free the field copies of the jobs the writer thread has finished,
+  // and report the first failed write
+  static void reclaimWritten() {
+    std::string error;
+    pthread_mutex_lock(&writerMutex);
+    for (size_t i=0; i<written.size(); i++) {
+      if (written[i]->v) host_free(written[i]->v);
+      written[i]->v = 0;
+      if (error.empty()) error = written[i]->error;
+    }
+    pthread_mutex_unlock(&writerMutex);
+    if (!error.empty()) errorQuda("%s", error.c_str());
+  }
+
+  void writeSpinorFile(const char *filename, const ColorSpinorParam &param)
+  {
+    if (param.nDim != 4 || param.nColor != 3 || (param.nSpin != 1 && param.nSpin != 4))
+      errorQuda("Only 4-d Nc=3 fields with 1 or 4 spins can be written");
+    if (param.siteSubset != QUDA_FULL_SITE_SUBSET)
+      errorQuda("Only full-lattice fields can be written");
+    if (param.fieldOrder != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER && param.fieldOrder != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER)
+      errorQuda("Field order %d not supported", param.fieldOrder);
+    if (param.siteOrder != QUDA_EVEN_ODD_SITE_ORDER && param.siteOrder != QUDA_ODD_EVEN_SITE_ORDER)
+      errorQuda("Site order %d not supported", param.siteOrder);
+    if (param.precision != QUDA_DOUBLE_PRECISION && param.precision != QUDA_SINGLE_PRECISION)
+      errorQuda("Precision %d not supported", param.precision);
+
+    initCrcTable(); // before the writer thread uses it
+
+    SpinorWriteJob *job = new SpinorWriteJob;
+    job->filename = filename;
+    job->nSpin = param.nSpin;
+    job->precision = param.precision;
+    job->fieldOrder = param.fieldOrder;
+    job->siteOrder = param.siteOrder;
+    job->sum[0] = job->sum[1] = 0;
+    job->seconds = 0.0;
+    size_t V = 1, global = 1;
+    for (int d=0; d<4; d++) {
+      job->X[d] = param.x[d];
+      job->dims[d] = param.x[d]*comm_dim(d);
+      job->offset[d] = param.x[d]*comm_coord(d);
+      V *= job->X[d];
+      global *= job->dims[d];
+    }
+    const size_t siteBytes = job->siteBytes();
+
+    char buf[512];
+    const char p = (param.precision == QUDA_DOUBLE_PRECISION) ? 'D' : 'F';
+    sprintf(buf, "<?xml version=\"1.0\" encoding=\"UTF-8\"?><scidacRecord><version>1.1</version>"
+	    "<recordtype>0</recordtype><datatype>USQCD_%c3_%s</datatype><precision>%c</precision>"
+	    "<colors>3</colors><spins>%d</spins><typesize>%lu</typesize><datacount>1</datacount></scidacRecord>",
+	    p, param.nSpin == 4 ? "DiracFermion" : "ColorVector", p, param.nSpin, (unsigned long)siteBytes);
+    job->recordXml[0] = buf;
+
+    // a new file starts with the file header message
+    std::map<std::string, size_t>::iterator f = fileEnd.find(job->filename);
+    job->fileHeader = (f == fileEnd.end());
+    if (job->fileHeader) {
+      if (comm_rank() == 0) {
+	const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) errorQuda("Cannot create %s", filename);
+	close(fd);
+      }
+      comm_barrier();
+
+      sprintf(buf, "<?xml version=\"1.0\" encoding=\"UTF-8\"?><scidacFile><version>1.1</version>"
+	      "<spacetime>4</spacetime><dims>%d %d %d %d </dims><volfmt>0</volfmt></scidacFile>",
+	      job->dims[0], job->dims[1], job->dims[2], job->dims[3]);
+      job->fileXml[0] = buf;
+      job->fileXml[1] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><quda><propagator/></quda>";
+      f = fileEnd.insert(std::make_pair(job->filename, limeHeaderBytes + limePadded(job->fileXml[0].size()) +
+					limeHeaderBytes + limePadded(job->fileXml[1].size()))).first;
+    }
+
+    // the records are numbered from the end of the file header message
+    sprintf(buf, "<?xml version=\"1.0\" encoding=\"UTF-8\"?><quda><gamma_basis>%d</gamma_basis></quda>",
+	    param.gammaBasis);
+    job->recordXml[1] = buf;
+
+    job->recordOffset = f->second;
+    job->dataOffset = job->recordOffset + limeHeaderBytes + limePadded(job->recordXml[0].size())
+      + limeHeaderBytes + limePadded(job->recordXml[1].size()) + limeHeaderBytes;
+    job->checksumOffset = job->dataOffset + limePadded(global*siteBytes) + limeHeaderBytes;
+    f->second = job->checksumOffset + limePadded(formatChecksum(0, 0).size());
+
+    reclaimWritten();
+
+    // wait for room in the queue, then hand over a copy of the field
+    pthread_mutex_lock(&writerMutex);
+    while (pending.size() >= maxPending) pthread_cond_wait(&writerCond, &writerMutex);
+    pthread_mutex_unlock(&writerMutex);
+
+    job->v = (char*)safe_malloc(V*siteBytes);
+    memcpy(job->v, param.v, V*siteBytes);
+
+    pthread_mutex_lock(&writerMutex);
+    pending.push_back(job);
+    if (!writerRunning) {
+      writerStop = false;
+      if (pthread_create(&writer, 0, writerLoop, 0)) errorQuda("Failed to start the spinor writer thread");
+      writerRunning = true;
+    }
+    pthread_cond_broadcast(&writerCond);
+    pthread_mutex_unlock(&writerMutex);
+  }
+
+  void flushSpinorWriter()
+  {
+    if (writerRunning) {
+      pthread_mutex_lock(&writerMutex);
+      writerStop = true;
+      pthread_cond_broadcast(&writerCond);
+      pthread_mutex_unlock(&writerMutex);
+      pthread_join(writer, 0);
+      writerRunning = false;
+    }
+    reclaimWritten();
+
+    // the jobs were queued in the same order on every rank
+    double seconds = 0.0, bytes = 0.0;
+    for (size_t i=0; i<written.size(); i++) {
+      SpinorWriteJob &job = *written[i];
+      const unsigned int suma = reduceWord(job.sum[0], true);
+      const unsigned int sumb = reduceWord(job.sum[1], true);
+      if (comm_rank() == 0) {
+	const int fd = open(job.filename.c_str(), O_WRONLY);
+	if (fd < 0) errorQuda("Cannot open %s for writing", job.filename.c_str());
+	const std::string sum = formatChecksum(suma, sumb);
+	if (!pwriteAll(fd, sum.c_str(), sum.size(), job.checksumOffset))
+	  errorQuda("Failed to write the checksum of %s", job.filename.c_str());
+	close(fd);
+      }
+      seconds += job.seconds;
+      bytes += (double)job.siteBytes()*job.X[0]*job.X[1]*job.X[2]*job.X[3];
+      delete written[i];
+    }
+
+    if (written.size() && getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Spinor writer: %lu fields written in %g secs of background I/O (%g GB/s per rank)\n",
+		 (unsigned long)written.size(), seconds, seconds > 0.0 ? bytes / seconds * 1e-9 : 0.0);
+
+    written.clear();
+    fileEnd.clear();
+  }
+
+} // namespace quda
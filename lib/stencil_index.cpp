@@ -0,0 +1,195 @@
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#include <stencil_index.h>
+
+namespace quda {
+
+  // the tables of the geometries in use
+  static std::vector<StencilIndex*> stencilIndices;
+
+  const StencilIndex* StencilIndex::Acquire(const int *X, const Boundary *boundary, QudaStencilOrder order)
+  {
+    for (size_t i=0; i<stencilIndices.size(); i++) {
+      StencilIndex *s = stencilIndices[i];
+      bool match = (s->order == order);
+      for (int d=0; d<4; d++) if (s->X[d] != X[d] || s->boundary[d] != boundary[d]) match = false;
+      if (match) {
+	s->refCount++;
+	return s;
+      }
+    }
+
+    StencilIndex *s = new StencilIndex(X, boundary, order);
+    stencilIndices.push_back(s);
+    return s;
+  }
+
+  void StencilIndex::Release(const StencilIndex *index)
+  {
+    for (size_t i=0; i<stencilIndices.size(); i++) {
+      if (stencilIndices[i] != index) continue;
+      if (--stencilIndices[i]->refCount == 0) {
+	delete stencilIndices[i];
+	stencilIndices.erase(stencilIndices.begin() + i);
+      }
+      return;
+    }
+    errorQuda("Stencil index %p not found", index);
+  }
+
+  StencilIndex::StencilIndex(const int *X_, const Boundary *boundary_, QudaStencilOrder order)
+    : order(order), ghostCB(0), refCount(1)
+  {
+    for (int d=0; d<4; d++) {
+      X[d] = X_[d];
+      boundary[d] = boundary_[d];
+      if (X[d] < 2 || X[d] % 2) errorQuda("Local dimension X[%d] = %d must be even and at least 2", d, X[d]);
+    }
+    if (order != QUDA_LEXICOGRAPHIC_STENCIL_ORDER && order != QUDA_MORTON_STENCIL_ORDER &&
+	order != QUDA_HILBERT_STENCIL_ORDER)
+      errorQuda("Stencil order %d not supported", order);
+    volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+
+    for (int d=0; d<4; d++) {
+      faceCB[d] = volumeCB / X[d];
+      ghostOffset[d][0] = ghostOffset[d][1] = 0;
+      if (boundary[d] != HALO) continue;
+      ghostOffset[d][0] = ghostCB;
+      ghostOffset[d][1] = ghostCB + faceCB[d];
+      ghostCB += 2*faceCB[d];
+    }
+
+    buildTables();
+    buildOrder();
+  }
+
+  StencilIndex::~StencilIndex()
+  {
+    for (int p=0; p<2; p++) {
+      host_free(nbr[p]);
+      host_free(sites[p]);
+      for (int d=0; d<4; d++)
+	for (int e=0; e<2; e++) host_free(face[d][e][p]);
+    }
+  }
+
+  void StencilIndex::buildTables()
+  {
+    int fill[4][2][2];
+    for (int d=0; d<4; d++)
+      for (int e=0; e<2; e++)
+	for (int p=0; p<2; p++) {
+	  face[d][e][p] = (int*)safe_malloc(faceCB[d]*sizeof(int));
+	  fill[d][e][p] = 0;
+	}
+
+    for (int p=0; p<2; p++) nbr[p] = (int*)safe_malloc(8*(size_t)volumeCB*sizeof(int));
+
+    int x[4];
+    for (x[3]=0; x[3]<X[3]; x[3]++) {
+      for (x[2]=0; x[2]<X[2]; x[2]++) {
+	for (x[1]=0; x[1]<X[1]; x[1]++) {
+	  for (x[0]=0; x[0]<X[0]; x[0]++) {
+	    const int p = (x[0] + x[1] + x[2] + x[3]) % 2;
+	    const int n = (((x[3]*X[2] + x[2])*X[1] + x[1])*X[0] + x[0]) / 2;
+
+	    for (int d=0; d<4; d++) {
+	      int y[4] = {x[0], x[1], x[2], x[3]};
+	      y[d] = (x[d] + 1) % X[d];
+	      nbr[p][8*n+2*d+0] = (((y[3]*X[2] + y[2])*X[1] + y[1])*X[0] + y[0]) / 2;
+	      y[d] = (x[d] - 1 + X[d]) % X[d];
+	      nbr[p][8*n+2*d+1] = (((y[3]*X[2] + y[2])*X[1] + y[1])*X[0] + y[0]) / 2;
+
+	      if (x[d] == 0) face[d][0][p][fill[d][0][p]++] = n;
+	      if (x[d] == X[d]-1) face[d][1][p][fill[d][1][p]++] = n;
+	    }
+	  }
+	}
+      }
+    }
+
+    // redirect or drop the hops leaving the lattice
+    for (int d=0; d<4; d++) {
+      if (boundary[d] == PERIODIC) continue;
+      for (int p=0; p<2; p++) {
+	for (int k=0; k<faceCB[d]; k++) {
+	  const bool halo = (boundary[d] == HALO);
+	  nbr[p][8*face[d][1][p][k]+2*d+0] = halo ? volumeCB + ghostOffset[d][1] + k : -1;
+	  nbr[p][8*face[d][0][p][k]+2*d+1] = halo ? volumeCB + ghostOffset[d][0] + k : -1;
+	}
+      }
+    }
+  }
+
+  /**
+     Hilbert index of the point x of the cube of side 2^bits in four
+     dimensions: the coordinates are transformed in place into the
+     transposed index (J. Skilling, AIP Conf. Proc. 707, 381 (2004)),
+     whose bits are then interleaved as for the Morton index.
+   */
+  static void hilbertTranspose(unsigned int *x, int bits) {
+    const unsigned int M = 1u << (bits-1);
+    for (unsigned int Q=M; Q>1; Q>>=1) {
+      const unsigned int P = Q - 1;
+      for (int i=0; i<4; i++) {
+	if (x[i] & Q) {
+	  x[0] ^= P;
+	} else {
+	  const unsigned int t = (x[0] ^ x[i]) & P;
+	  x[0] ^= t;
+	  x[i] ^= t;
+	}
+      }
+    }
+    for (int i=1; i<4; i++) x[i] ^= x[i-1];
+    unsigned int t = 0;
+    for (unsigned int Q=M; Q>1; Q>>=1) if (x[3] & Q) t ^= Q - 1;
+    for (int i=0; i<4; i++) x[i] ^= t;
+  }
+
+  static unsigned long long interleave(const unsigned int *x, int bits) {
+    unsigned long long key = 0;
+    for (int b=bits-1; b>=0; b--)
+      for (int i=3; i>=0; i--) key = (key << 1) | ((x[i] >> b) & 1);
+    return key;
+  }
+
+  /**
+     The curves are taken through the points (x0/2, x1, x2, x3) of the
+     sites of a parity, embedded in the smallest power-of-two cube;
+     the sites are sorted by their index along the curve.
+   */
+  void StencilIndex::buildOrder()
+  {
+    const int D[4] = { X[0]/2, X[1], X[2], X[3] };
+    int bits = 1;
+    for (int d=0; d<4; d++) while ((1 << bits) < D[d]) bits++;
+    if (4*bits > 64)
+      errorQuda("Local lattice %dx%dx%dx%d too large for stencil order %d", X[0], X[1], X[2], X[3], order);
+
+    for (int p=0; p<2; p++) sites[p] = (int*)safe_malloc(volumeCB*sizeof(int));
+
+    if (order == QUDA_LEXICOGRAPHIC_STENCIL_ORDER) {
+      for (int n=0; n<volumeCB; n++) sites[0][n] = n;
+    } else {
+      std::vector<std::pair<unsigned long long,int> > key(volumeCB);
+#pragma omp parallel for
+      for (int n=0; n<volumeCB; n++) {
+	unsigned int y[4];
+	int r = n;
+	for (int d=0; d<3; d++) { y[d] = r % D[d]; r /= D[d]; }
+	y[3] = r;
+	if (order == QUDA_HILBERT_STENCIL_ORDER) hilbertTranspose(y, bits);
+	key[n] = std::make_pair(interleave(y, bits), n);
+      }
+      std::sort(key.begin(), key.end());
+      for (int n=0; n<volumeCB; n++) sites[0][n] = key[n].second;
+    }
+
+    // the checkerboard index does not depend on the parity of x0
+    memcpy(sites[1], sites[0], volumeCB*sizeof(int));
+  }
+
+} // namespace quda
@@ -7,6 +7,9 @@ namespace quda {
     if (profile[QUDA_PROFILE_TOTAL].time > 0.0) {
       printfQuda("\n   %20s Total time = %g secs\n", fname.c_str(), 
 		 profile[QUDA_PROFILE_TOTAL].time);
+#ifdef PERF_COUNTERS
+      perfCountersPrint(profile[QUDA_PROFILE_TOTAL].counts, profile[QUDA_PROFILE_TOTAL].time);
+#endif
     }
 
     double accounted = 0.0;
@@ -16,6 +19,9 @@ namespace quda {
 		   (const char*)&pname[i][0],  profile[i].time, 
 		   100*profile[i].time/profile[QUDA_PROFILE_TOTAL].time,
 		   profile[i].count, 1e6*profile[i].time/profile[i].count);
+#ifdef PERF_COUNTERS
+	perfCountersPrint(profile[i].counts, profile[i].time);
+#endif
 	accounted += profile[i].time;
       }
     }
@@ -39,7 +45,7 @@ namespace quda {
 				       "gather", "scatter", "event record", 
 				       "event query", "stream wait event", 
 				       "comms", "comms start", "comms query", "constant", 
-				       "total" };
+				       "chrono", "total" };
   
 }
 
@@ -1,4 +1,5 @@
 #include <tune_quda.h>
+#include <kernel_stats.h>
 #include <comm_quda.h>
 #include <quda.h> // for QUDA_VERSION_STRING
 #include <sys/stat.h> // for stat()
@@ -230,6 +231,21 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 #endif
   }
 
+  /**
+   * Time of a launch with parameters loaded from the cache, from the
+   * performance recorded when it was tuned: the comment starts with
+   * the perfString() of the launch.
+   */
+  static float launchTime(long long flops, long long bytes, const TuneParam &param)
+  {
+    double gflops = 0.0, gbytes = 0.0;
+    if (sscanf(param.comment.c_str(), "# %lf Gflop/s, %lf GB/s", &gflops, &gbytes) != 2) return 0.0;
+    if (flops > 0 && gflops > 0.0) return flops / (1e9 * gflops);
+    if (bytes > 0 && gbytes > 0.0) return bytes / (1e9 * gbytes);
+    return 0.0;
+  }
+
+
   /**
    * Return the optimal launch parameters for a given kernel, either by retrieving them from tunecache or autotuning
    * on the spot.
@@ -256,7 +272,9 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
       tunable.defaultTuneParam(param);
       tunable.checkLaunchParam(param);
     } else if (tunecache.count(key)) {
-      param = tunecache[key];
+      TuneParam &cached = tunecache[key];
+      if (cached.time < 0.0) cached.time = launchTime(tunable.flops(), tunable.bytes(), cached);
+      param = cached;
       tunable.checkLaunchParam(param);
     } else if (!tuning) {
 
@@ -313,6 +331,7 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
       time(&now);
       best_param.comment = "# " + tunable.perfString(best_time) + ", tuned ";
       best_param.comment += ctime(&now); // includes a newline
+      best_param.time = best_time;
 
       cudaEventDestroy(start);
       cudaEventDestroy(end);
@@ -326,6 +345,18 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
       errorQuda("Unexpected call to tuneLaunch() in %s::apply()", typeid(tunable).name());
     }
 
+    // the launches made while tuning are not counted
+    if (!tuning) {
+      KernelStats stats;
+      stats.calls = 1;
+      // with tuning disabled the launch has no time estimate
+      stats.untimed = param.time > 0.0 ? 0 : 1;
+      stats.secs = param.time > 0.0 ? param.time : 0.0;
+      stats.flops = tunable.flops();
+      stats.bytes = tunable.bytes();
+      kernelStatsRecord(key, stats);
+    }
+
     // restore the original reduction state
     globalReduce = reduceState;
 
@@ -541,51 +541,55 @@ static double HOST_REUNIT_SVD_ABS_ERROR;
     } // getUnitarizeForceField
 
 
-    void unitarizeForceCPU(const QudaGaugeParam& param, cpuGaugeField& cpuOldForce, cpuGaugeField& cpuGauge, cpuGaugeField* cpuNewForce)
+    template <typename Float>
+    static int unitarizeForceCPU(cpuGaugeField& cpuOldForce, cpuGaugeField& cpuGauge, cpuGaugeField* cpuNewForce)
     {
-      
-      int num_failures = 0;	
-      Matrix<double2,3> old_force, new_force, v;
-
-      // I can change this code to make it much more compact
-
       const QudaGaugeFieldOrder order = cpuGauge.Order();
+      if(order != QUDA_MILC_GAUGE_ORDER && order != QUDA_QDP_GAUGE_ORDER){
+        errorQuda("Only MILC and QDP gauge orders supported\n");
+      }
+
+      const int volume = cpuGauge.Volume();
+      int num_failures = 0;
 
-      if(order == QUDA_MILC_GAUGE_ORDER){
-        for(int i=0; i<cpuGauge.Volume(); ++i){
-	  for(int dir=0; dir<4; ++dir){
-	    if(param.cpu_prec == QUDA_SINGLE_PRECISION){
-	      copyArrayToLink(&old_force, ((float*)(cpuOldForce.Gauge_p()) + (i*4 + dir)*18)); 
-	      copyArrayToLink(&v, ((float*)(cpuGauge.Gauge_p()) + (i*4 + dir)*18)); 
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
-	      copyLinkToArray(((float*)(cpuNewForce->Gauge_p()) + (i*4 + dir)*18), new_force); 
-	    }else if(param.cpu_prec == QUDA_DOUBLE_PRECISION){
-	      copyArrayToLink(&old_force, ((double*)(cpuOldForce.Gauge_p()) + (i*4 + dir)*18)); 
-	      copyArrayToLink(&v, ((double*)(cpuGauge.Gauge_p()) + (i*4 + dir)*18)); 
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
-	      copyLinkToArray(((double*)(cpuNewForce->Gauge_p()) + (i*4 + dir)*18), new_force); 
-	    } // precision?
-	  } // dir
-        } // i
-      }else if(order == QUDA_QDP_GAUGE_ORDER){
+      // the sites are independent, so the threads only share the failure count
+#pragma omp parallel for reduction(+:num_failures)
+      for(int i=0; i<volume; ++i){
+        Matrix<double2,3> old_force, new_force, v;
         for(int dir=0; dir<4; ++dir){
-          for(int i=0; i<cpuGauge.Volume(); ++i){
-	    if(param.cpu_prec == QUDA_SINGLE_PRECISION){
-	      copyArrayToLink(&old_force, ((float**)(cpuOldForce.Gauge_p()))[dir] + i*18);
-	      copyArrayToLink(&v, ((float**)(cpuGauge.Gauge_p()))[dir] + i*18);
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
-	      copyLinkToArray(((float**)(cpuNewForce->Gauge_p()))[dir] + i*18, new_force);
-	    }else if(param.cpu_prec == QUDA_DOUBLE_PRECISION){
-	      copyArrayToLink(&old_force, ((double**)(cpuOldForce.Gauge_p()))[dir] + i*18);
-	      copyArrayToLink(&v, ((double**)(cpuGauge.Gauge_p()))[dir] + i*18);
-	      getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
-	      copyLinkToArray(((double**)(cpuNewForce->Gauge_p()))[dir] + i*18, new_force);
-	    }
+          Float *f, *u, *g;
+          if(order == QUDA_MILC_GAUGE_ORDER){
+            f = (Float*)cpuOldForce.Gauge_p() + (i*4 + dir)*18;
+            u = (Float*)cpuGauge.Gauge_p() + (i*4 + dir)*18;
+            g = (Float*)cpuNewForce->Gauge_p() + (i*4 + dir)*18;
+          }else{
+            f = ((Float**)cpuOldForce.Gauge_p())[dir] + i*18;
+            u = ((Float**)cpuGauge.Gauge_p())[dir] + i*18;
+            g = ((Float**)cpuNewForce->Gauge_p())[dir] + i*18;
           }
-        }
+          copyArrayToLink(&old_force, f);
+          copyArrayToLink(&v, u);
+          getUnitarizeForceSite<double2>(v, old_force, &new_force, &num_failures);
+          copyLinkToArray(g, new_force);
+        } // dir
+      } // i
+      return num_failures;
+    }
+
+    void unitarizeForceCPU(const QudaGaugeParam& param, cpuGaugeField& cpuOldForce, cpuGaugeField& cpuGauge, cpuGaugeField* cpuNewForce,
+			   int* unitarization_failed)
+    {
+      int num_failures = 0;
+      if(param.cpu_prec == QUDA_SINGLE_PRECISION){
+        num_failures = unitarizeForceCPU<float>(cpuOldForce, cpuGauge, cpuNewForce);
+      }else if(param.cpu_prec == QUDA_DOUBLE_PRECISION){
+        num_failures = unitarizeForceCPU<double>(cpuOldForce, cpuGauge, cpuNewForce);
       }else{
-        errorQuda("Only MILC and QDP gauge orders supported\n");
+        errorQuda("Unsupported precision %d\n", param.cpu_prec);
       }
+
+      if(num_failures > 0) warningQuda("Unitarization of the force failed at %d links", num_failures);
+      if(unitarization_failed) *unitarization_failed += num_failures;
       return;
     } // unitarize_force_cpu
 
@@ -1,5 +1,6 @@
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <cuda.h>
@@ -492,27 +493,266 @@ namespace quda{
     unitarizeLinks.apply(0);
   }
 
-  void unitarizeLinksCPU(const QudaGaugeParam& param, cpuGaugeField& infield, cpuGaugeField* outfield)
+  // links unitarized together on the host, one per lane of the batch
+  static const int unitarizeBatch = 8;
+
+  // c = a * b, or a^dagger * b, for every lane of a batch of links held as [element][lane]
+  template <bool dagger_a>
+  static inline void batchMul(const double a[18][unitarizeBatch], const double b[18][unitarizeBatch],
+			      double c[18][unitarizeBatch])
+  {
+    for(int i=0; i<3; ++i){
+      for(int j=0; j<3; ++j){
+	double re[unitarizeBatch], im[unitarizeBatch];
+	for(int l=0; l<unitarizeBatch; ++l) re[l] = im[l] = 0.0;
+	for(int k=0; k<3; ++k){
+	  const int ia = dagger_a ? 6*k+2*i : 6*i+2*k;
+	  const double s = dagger_a ? -1.0 : 1.0;
+	  for(int l=0; l<unitarizeBatch; ++l){
+	    re[l] += a[ia][l]*b[6*k+2*j][l] - s*a[ia+1][l]*b[6*k+2*j+1][l];
+	    im[l] += a[ia][l]*b[6*k+2*j+1][l] + s*a[ia+1][l]*b[6*k+2*j][l];
+	  }
+	}
+	for(int l=0; l<unitarizeBatch; ++l){
+	  c[6*i+2*j][l] = re[l];
+	  c[6*i+2*j+1][l] = im[l];
+	}
+      }
+    }
+  }
+
+  /**
+     Analytic (Cayley-Hamilton) unitarization of a batch of links,
+     out = v (v^dagger v)^{-1/2}, as in reciprocalRoot.  The matrix
+     products run over the lanes; the eigenvalues are computed lane by
+     lane.  Lanes where the eigenvalues are not accurate enough, judged
+     by the determinant of v^dagger v, are flagged in fallback and
+     their output is not set.
+   */
+  static void reciprocalRootBatch(const double v[18][unitarizeBatch], double out[18][unitarizeBatch],
+				  bool fallback[unitarizeBatch])
   {
+    double q[18][unitarizeBatch], qsq[18][unitarizeBatch], t[18][unitarizeBatch];
+    batchMul<true>(v, v, q);
+    batchMul<false>(q, q, qsq);
+
+    for(int l=0; l<unitarizeBatch; ++l){
+      double c[3], g[3];
+      c[0] = q[0][l] + q[8][l] + q[16][l];
+      c[1] = (qsq[0][l] + qsq[8][l] + qsq[16][l])/2.0;
+      c[2] = 0.0;
+      for(int i=0; i<3; ++i){
+	for(int k=0; k<3; ++k){
+	  c[2] += qsq[6*i+2*k][l]*q[6*k+2*i][l] - qsq[6*i+2*k+1][l]*q[6*k+2*i+1][l];
+	}
+      }
+      c[2] /= 3.0;
+
+      g[0] = g[1] = g[2] = c[0]/3.;
+      const double s = c[1]/3. - c[0]*c[0]/18;
+      if(fabs(s) >= HOST_FL_UNITARIZE_EPS){
+	const double sqrt_s = sqrt(s);
+	const double r = c[2]/2. - (c[0]/3.)*(c[1] - c[0]*c[0]/9.);
+	const double cosTheta = r/(sqrt_s*sqrt_s*sqrt_s);
+	double theta;
+	if(fabs(cosTheta) >= 1.0){
+	  theta = (r > 0) ? 0.0 : FL_UNITARIZE_PI;
+	}else{
+	  theta = acos(cosTheta);
+	}
+	g[0] = c[0]/3 + 2*sqrt_s*cos( theta/3 );
+	g[1] = c[0]/3 + 2*sqrt_s*cos( theta/3 + FL_UNITARIZE_PI23 );
+	g[2] = c[0]/3 + 2*sqrt_s*cos( theta/3 + 2*FL_UNITARIZE_PI23 );
+      }
+
+      // real part of the determinant of q
+#define Q(i,j,reim) q[6*(i)+2*(j)+(reim)][l]
+      double m_re = Q(1,1,0)*Q(2,2,0) - Q(1,1,1)*Q(2,2,1) - Q(1,2,0)*Q(2,1,0) + Q(1,2,1)*Q(2,1,1);
+      double m_im = Q(1,1,0)*Q(2,2,1) + Q(1,1,1)*Q(2,2,0) - Q(1,2,0)*Q(2,1,1) - Q(1,2,1)*Q(2,1,0);
+      double det = Q(0,0,0)*m_re - Q(0,0,1)*m_im;
+      m_re = Q(1,0,0)*Q(2,2,0) - Q(1,0,1)*Q(2,2,1) - Q(1,2,0)*Q(2,0,0) + Q(1,2,1)*Q(2,0,1);
+      m_im = Q(1,0,0)*Q(2,2,1) + Q(1,0,1)*Q(2,2,0) - Q(1,2,0)*Q(2,0,1) - Q(1,2,1)*Q(2,0,0);
+      det -= Q(0,1,0)*m_re - Q(0,1,1)*m_im;
+      m_re = Q(1,0,0)*Q(2,1,0) - Q(1,0,1)*Q(2,1,1) - Q(1,1,0)*Q(2,0,0) + Q(1,1,1)*Q(2,0,1);
+      m_im = Q(1,0,0)*Q(2,1,1) + Q(1,0,1)*Q(2,1,0) - Q(1,1,0)*Q(2,0,1) - Q(1,1,1)*Q(2,0,0);
+      det += Q(0,2,0)*m_re - Q(0,2,1)*m_im;
+#undef Q
+
+      fallback[l] = fabs(det) < HOST_FL_REUNIT_SVD_ABS_ERROR ||
+	!checkRelativeError(g[0]*g[1]*g[2], det, HOST_FL_REUNIT_SVD_REL_ERROR);
+
+      // the coefficients of (v^dagger v)^{-1/2} = f0 + f1 q + f2 q^2
+      for(int i=0; i<3; ++i) c[i] = sqrt(g[i]);
+      const double u = c[0]+c[1]+c[2];
+      const double w = c[0]*c[1] + c[0]*c[2] + c[1]*c[2];
+      const double z = c[0]*c[1]*c[2];
+      const double denominator = z*(u*w - z);
+      const double f0 = (u*w*w - z*(u*u + w))/denominator;
+      const double f1 = (-u*u*u - z + 2.*u*w)/denominator;
+      const double f2 = u/denominator;
+
+      for(int i=0; i<18; ++i) t[i][l] = f1*q[i][l] + f2*qsq[i][l];
+      t[0][l] += f0;
+      t[8][l] += f0;
+      t[16][l] += f0;
+    }
+
+    batchMul<false>(v, t, out);
+  }
+
+  // largest deviation of u^dagger u from the identity in each lane
+  static void unitarityErrorBatch(const double u[18][unitarizeBatch], double error[unitarizeBatch])
+  {
+    double id[18][unitarizeBatch];
+    batchMul<true>(u, u, id);
+    for(int l=0; l<unitarizeBatch; ++l){
+      id[0][l] -= 1.0;
+      id[8][l] -= 1.0;
+      id[16][l] -= 1.0;
+      error[l] = 0.0;
+    }
+    for(int i=0; i<18; ++i){
+      for(int l=0; l<unitarizeBatch; ++l){
+	if(fabs(id[i][l]) > error[l]) error[l] = fabs(id[i][l]);
+      }
+    }
+  }
+
+  template <typename Float>
+  static Float* unitarizeHostLink(void *field, QudaGaugeFieldOrder order, int link)
+  {
+    if(order == QUDA_QDP_GAUGE_ORDER) return ((Float**)field)[link%4] + (link/4)*18;
+    return (Float*)field + link*18;
+  }
+
+  template <typename Float>
+  static int unitarizeLinksCPU(cpuGaugeField& infield, cpuGaugeField& outfield,
+			       int* site_failures, UnitarizeLinksStats& stats)
+  {
+    const int nLinks = 4*infield.Volume();
+    if(nLinks % unitarizeBatch != 0) errorQuda("Number of links %d is not a multiple of %d", nLinks, unitarizeBatch);
+
+    long long analytic = 0, svd = 0;
+    int failures = 0;
+    double max_error = 0.0;
+
+#pragma omp parallel
+    {
+      long long my_analytic = 0, my_svd = 0;
+      int my_failures = 0;
+      double my_max_error = 0.0;
+
+#pragma omp for
+      for(int b=0; b<nLinks; b+=unitarizeBatch){
+	double v[18][unitarizeBatch], u[18][unitarizeBatch], error[unitarizeBatch];
+	bool fallback[unitarizeBatch], failed[unitarizeBatch];
+
+	// links are processed in site-major order, so a batch covers whole sites
+	for(int l=0; l<unitarizeBatch; ++l){
+	  const Float *in = unitarizeHostLink<Float>(infield.Gauge_p(), infield.Order(), b+l);
+	  for(int i=0; i<18; ++i) v[i][l] = in[i];
+	  fallback[l] = true;
+	  failed[l] = false;
+	}
+
+	if(!HOST_FL_REUNIT_SVD_ONLY) reciprocalRootBatch(v, u, fallback);
+
+	// the links rejected by the analytic method go through the SVD one by one
+	for(int l=0; l<unitarizeBatch; ++l){
+	  if(!fallback[l]){
+	    my_analytic++;
+	    continue;
+	  }
+	  if(!HOST_FL_REUNIT_ALLOW_SVD){
+	    failed[l] = true;
+	    for(int i=0; i<18; ++i) u[i][l] = v[i][l];
+	    continue;
+	  }
+	  Matrix<double2,3> in, left, right, result;
+	  double singular_values[3];
+	  for(int i=0; i<3; ++i){
+	    for(int j=0; j<3; ++j){
+	      in(i,j).x = v[6*i+2*j][l];
+	      in(i,j).y = v[6*i+2*j+1][l];
+	    }
+	  }
+	  computeSVD<double2>(in, left, right, singular_values);
+	  result = left*conj(right);
+	  for(int i=0; i<3; ++i){
+	    for(int j=0; j<3; ++j){
+	      u[6*i+2*j][l] = result(i,j).x;
+	      u[6*i+2*j+1][l] = result(i,j).y;
+	    }
+	  }
+	  my_svd++;
+	}
+
+	if(HOST_FL_CHECK_UNITARIZATION){
+	  unitarityErrorBatch(u, error);
+	  for(int l=0; l<unitarizeBatch; ++l){
+	    if(error[l] > HOST_FL_MAX_ERROR) failed[l] = true;
+	    if(error[l] > my_max_error) my_max_error = error[l];
+	  }
+	}
+
+	for(int l=0; l<unitarizeBatch; ++l){
+	  Float *out = unitarizeHostLink<Float>(outfield.Gauge_p(), outfield.Order(), b+l);
+	  for(int i=0; i<18; ++i) out[i] = u[i][l];
+	  if(failed[l]){
+	    my_failures++;
+	    if(site_failures) site_failures[(b+l)/4]++;
+	  }
+	}
+      }
+
+#pragma omp critical
+      {
+	analytic += my_analytic;
+	svd += my_svd;
+	failures += my_failures;
+	if(my_max_error > max_error) max_error = my_max_error;
+      }
+    }
+
+    stats.analytic += analytic;
+    stats.svd += svd;
+    stats.failures += failures;
+    if(max_error > stats.max_error) stats.max_error = max_error;
+    return failures;
+  }
+
+  int unitarizeLinksCPU(const QudaGaugeParam& param, cpuGaugeField& infield, cpuGaugeField* outfield,
+			int* site_failures, UnitarizeLinksStats* stats)
+  {
+    QUDA_PERF_SCOPE("unitarizeLinksCPU");
+    if(infield.Precision() != param.cpu_prec || outfield->Precision() != param.cpu_prec)
+      errorQuda("Field precision does not match cpu_prec %d", param.cpu_prec);
+    for(int d=0; d<4; ++d){
+      if(infield.X()[d] != outfield->X()[d]) errorQuda("Field dimensions do not match");
+    }
+    if((infield.Order() != QUDA_MILC_GAUGE_ORDER && infield.Order() != QUDA_QDP_GAUGE_ORDER) ||
+       (outfield->Order() != QUDA_MILC_GAUGE_ORDER && outfield->Order() != QUDA_QDP_GAUGE_ORDER))
+      errorQuda("Only MILC and QDP gauge orders supported");
+
+    UnitarizeLinksStats local_stats;
+    UnitarizeLinksStats &s = stats ? *stats : local_stats;
+    if(site_failures) memset(site_failures, 0, infield.Volume()*sizeof(int));
+
     int num_failures = 0;
-    Matrix<double2,3> inlink, outlink;
-      
-    for(int i=0; i<infield.Volume(); ++i){
-      for(int dir=0; dir<4; ++dir){
-	if(param.cpu_prec == QUDA_SINGLE_PRECISION){
-	  copyArrayToLink(&inlink, ((float*)(infield.Gauge_p()) + (i*4 + dir)*18)); // order of arguments?
-	  if( unitarizeLinkNewton<double2>(inlink, &outlink) == false ) num_failures++; 
-	  copyLinkToArray(((float*)(outfield->Gauge_p()) + (i*4 + dir)*18), outlink); 
-	}else if(param.cpu_prec == QUDA_DOUBLE_PRECISION){
-	  copyArrayToLink(&inlink, ((double*)(infield.Gauge_p()) + (i*4 + dir)*18)); // order of arguments?
-	  if( unitarizeLinkNewton<double2>(inlink, &outlink) == false ) num_failures++; 
-	  copyLinkToArray(((double*)(outfield->Gauge_p()) + (i*4 + dir)*18), outlink); 
-	} // precision?
-      } // dir
-    }  // loop over volume
-    return;
+    if(param.cpu_prec == QUDA_SINGLE_PRECISION){
+      num_failures = unitarizeLinksCPU<float>(infield, *outfield, site_failures, s);
+    }else if(param.cpu_prec == QUDA_DOUBLE_PRECISION){
+      num_failures = unitarizeLinksCPU<double>(infield, *outfield, site_failures, s);
+    }else{
+      errorQuda("Unsupported precision %d", param.cpu_prec);
+    }
+
+    if(getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("unitarizeLinksCPU: %lld analytic, %lld SVD, %lld failed, max unitarity error %e\n",
+		 s.analytic, s.svd, s.failures, s.max_error);
+    return num_failures;
   }
-    
+
   // CPU function which checks that the gauge field is unitary
   bool isUnitary(const QudaGaugeParam& param, cpuGaugeField& field, double max_error)
   {
@@ -0,0 +1,430 @@
+#ifndef _WILSON_CPU_CORE_H
+#define _WILSON_CPU_CORE_H
+
+#include <gauge_field_order.h>
+#include "cpu_spinor_storage.h"
+#include "cpu_simd.h"
+
+/**
+   Site kernel of the host Wilson hopping term, shared by the host
+   operators (DiracWilsonCpu) and the host Schwarz preconditioner.
+   Spinors are in the DeGrand-Rossi basis with space-spin-color order
+   and are read and written through a SpinorAccessor, so the kernel
+   works on any of the host storage formats.  The gauge field of each
+   parity is stored as [site][dim][N] and read through a LinkAccessor,
+   where N = 18 or, for SU(3) links, the 12- or 8-real compressed
+   forms that are rebuilt in registers.  Neighbors are addressed
+   through a table of eight entries per site (forward and backward
+   hop in each dimension); an entry of -1 drops the hop, and entries
+   at or beyond volumeCB address the halo (and the halo links for
+   backward hops).
+ */
+
+namespace quda {
+
+  // (1 -/+ gamma_mu) in the DeGrand-Rossi basis, indexed as 2*mu + sign
+  static const double projector[8][4][4][2] = {
+    {
+      {{1,0}, {0,0}, {0,0}, {0,-1}},
+      {{0,0}, {1,0}, {0,-1}, {0,0}},
+      {{0,0}, {0,1}, {1,0}, {0,0}},
+      {{0,1}, {0,0}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {0,0}, {0,1}},
+      {{0,0}, {1,0}, {0,1}, {0,0}},
+      {{0,0}, {0,-1}, {1,0}, {0,0}},
+      {{0,-1}, {0,0}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {0,0}, {1,0}},
+      {{0,0}, {1,0}, {-1,0}, {0,0}},
+      {{0,0}, {-1,0}, {1,0}, {0,0}},
+      {{1,0}, {0,0}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {0,0}, {-1,0}},
+      {{0,0}, {1,0}, {1,0}, {0,0}},
+      {{0,0}, {1,0}, {1,0}, {0,0}},
+      {{-1,0}, {0,0}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {0,-1}, {0,0}},
+      {{0,0}, {1,0}, {0,0}, {0,1}},
+      {{0,1}, {0,0}, {1,0}, {0,0}},
+      {{0,0}, {0,-1}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {0,1}, {0,0}},
+      {{0,0}, {1,0}, {0,0}, {0,-1}},
+      {{0,-1}, {0,0}, {1,0}, {0,0}},
+      {{0,0}, {0,1}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {-1,0}, {0,0}},
+      {{0,0}, {1,0}, {0,0}, {-1,0}},
+      {{-1,0}, {0,0}, {1,0}, {0,0}},
+      {{0,0}, {-1,0}, {0,0}, {1,0}}
+    },
+    {
+      {{1,0}, {0,0}, {1,0}, {0,0}},
+      {{0,0}, {1,0}, {0,0}, {1,0}},
+      {{1,0}, {0,0}, {1,0}, {0,0}},
+      {{0,0}, {1,0}, {0,0}, {1,0}}
+    }
+  };
+
+  /**
+     Half-spinor form of a projector: the upper rows are
+     psi_s + c[s]*psi_t[s], and lower row s+2 is k[s] times upper row
+     r[s].
+   */
+  struct HalfProjector {
+    int t[2];
+    double c[2][2];
+    int r[2];
+    double k[2][2];
+  };
+
+  static HalfProjector halfProjector[8];
+  static bool halfProjectorInit = false;
+
+  static void initHalfProjector() {
+    if (halfProjectorInit) return;
+    for (int p=0; p<8; p++) {
+      HalfProjector &P = halfProjector[p];
+      for (int s=0; s<2; s++) {
+	for (int t=2; t<4; t++) {
+	  if (projector[p][s][t][0] != 0.0 || projector[p][s][t][1] != 0.0) {
+	    P.t[s] = t;
+	    P.c[s][0] = projector[p][s][t][0];
+	    P.c[s][1] = projector[p][s][t][1];
+	  }
+	}
+	for (int r=0; r<2; r++) {
+	  if (projector[p][s+2][r][0] != 0.0 || projector[p][s+2][r][1] != 0.0) {
+	    P.r[s] = r;
+	    P.k[s][0] = projector[p][s+2][r][0];
+	    P.k[s][1] = projector[p][s+2][r][1];
+	  }
+	}
+      }
+    }
+    halfProjectorInit = true;
+  }
+
+  /**
+     The links of both parities, held as [site][dim][N] reals.  The
+     compressed links are unpacked with the Reconstruct functors of
+     the device fields (gauge_field_order.h), which apply the
+     anisotropy and, on the last time slice, the temporal boundary
+     condition.  As in the device dslash the boundary belongs to the
+     global lattice: it applies to the local sites only on the last
+     node in time, and to the backward halo links (sites at or beyond
+     volumeCB) only on the first.
+   */
+  template <typename Float, int N>
+  struct LinkAccessor {
+    const Float *gauge[2];
+    Reconstruct<N,Float> reconstruct;
+    int volumeCB;
+    int boundaryIdx; // a checkerboard index on the last time slice
+    bool localBoundary;
+    bool ghostBoundary;
+
+    LinkAccessor(const void *const *gauge_, const int *X=0, double anisotropy=1.0,
+		 QudaTboundary tBoundary=QUDA_PERIODIC_T, bool localBoundary=true, bool ghostBoundary=true)
+      : reconstruct(X, anisotropy, tBoundary), volumeCB(X ? X[0]*X[1]*X[2]*X[3]/2 : 0),
+	boundaryIdx(volumeCB-1), localBoundary(localBoundary), ghostBoundary(ghostBoundary) {
+      gauge[0] = (const Float*)gauge_[0];
+      gauge[1] = (const Float*)gauge_[1];
+    }
+
+    inline const Float* operator()(int parity, int m, int d, Float *buf) const {
+      const Float *link = gauge[parity] + (size_t)(4*m + d)*N;
+      if (N == 18) return link;
+      const bool boundary = (m < volumeCB) ? localBoundary : ghostBoundary;
+      reconstruct.Unpack(buf, link, (m < volumeCB) ? (boundary ? m : 0) : (boundary ? boundaryIdx : 0), d, 0);
+      return buf;
+    }
+  };
+
+  /**
+     Apply the hopping term to site n of parity oddBit, out = x + a * D
+     in, or out = D in if x is NULL.  The output may alias x.
+   */
+  template <typename Spinor, typename Links>
+  inline void wilsonHopSite(const Spinor &out, const Links &gauge, const Spinor &in,
+			    const int *nbr, int n, int oddBit, int dagger, const Spinor *x, double a) {
+    typedef typename Spinor::RegType Float;
+
+    Float acc[4][3][2];
+    for (int s=0; s<4; s++) for (int c=0; c<3; c++) acc[s][c][0] = acc[s][c][1] = 0.0;
+
+    for (int dir=0; dir<8; dir++) {
+      const int m = nbr[8*n+dir];
+      if (m < 0) continue;
+
+      const HalfProjector &P = halfProjector[2*(dir/2) + (dir+dagger)%2];
+      Float buf[24];
+      const Float *psi = in(m, buf);
+
+      // spin projection
+      Float h[2][3][2];
+      for (int s=0; s<2; s++) {
+	const Float *pt = psi + 6*P.t[s];
+	for (int c=0; c<3; c++) {
+	  h[s][c][0] = psi[6*s+2*c+0] + P.c[s][0]*pt[2*c+0] - P.c[s][1]*pt[2*c+1];
+	  h[s][c][1] = psi[6*s+2*c+1] + P.c[s][0]*pt[2*c+1] + P.c[s][1]*pt[2*c+0];
+	}
+      }
+
+      // color multiply: U for forward hops, U^dagger of the neighbor for backward hops
+      Float Uh[2][3][2], link[18];
+      if (dir % 2 == 0) {
+	const Float *U = gauge(oddBit, n, dir/2, link);
+	for (int s=0; s<2; s++) {
+	  for (int i=0; i<3; i++) {
+	    Float re = 0.0, im = 0.0;
+	    for (int j=0; j<3; j++) {
+	      re += U[6*i+2*j+0]*h[s][j][0] - U[6*i+2*j+1]*h[s][j][1];
+	      im += U[6*i+2*j+0]*h[s][j][1] + U[6*i+2*j+1]*h[s][j][0];
+	    }
+	    Uh[s][i][0] = re; Uh[s][i][1] = im;
+	  }
+	}
+      } else {
+	const Float *U = gauge(1-oddBit, m, dir/2, link);
+	for (int s=0; s<2; s++) {
+	  for (int i=0; i<3; i++) {
+	    Float re = 0.0, im = 0.0;
+	    for (int j=0; j<3; j++) {
+	      re += U[6*j+2*i+0]*h[s][j][0] + U[6*j+2*i+1]*h[s][j][1];
+	      im += U[6*j+2*i+0]*h[s][j][1] - U[6*j+2*i+1]*h[s][j][0];
+	    }
+	    Uh[s][i][0] = re; Uh[s][i][1] = im;
+	  }
+	}
+      }
+
+      // spin reconstruction
+      for (int s=0; s<2; s++) {
+	const Float *u = Uh[P.r[s]][0];
+	for (int c=0; c<3; c++) {
+	  acc[s][c][0] += Uh[s][c][0];
+	  acc[s][c][1] += Uh[s][c][1];
+	  acc[s+2][c][0] += P.k[s][0]*u[2*c+0] - P.k[s][1]*u[2*c+1];
+	  acc[s+2][c][1] += P.k[s][0]*u[2*c+1] + P.k[s][1]*u[2*c+0];
+	}
+      }
+    }
+
+    Float *acc_ = acc[0][0];
+    if (x) {
+      Float buf[24];
+      const Float *xs = (*x)(n, buf);
+      for (int i=0; i<24; i++) acc_[i] = xs[i] + a*acc_[i];
+    }
+    out.save(n, acc_);
+  }
+
+  /**
+     Gather the spinors of the hop dir from the sites site[0], ...,
+     site[nSites-1] into the lanes of I.  Hops that are dropped, and
+     the lanes beyond nSites, read a zero spinor.
+   */
+  template <typename V, typename Spinor>
+  inline void gatherSpinorSimd(V *I, const Spinor &in, const int *nbr, const int *site, int nSites, int dir) {
+    typedef typename V::Float Float;
+    Float t[24*V::width];
+    for (int l=0; l<V::width; l++) {
+      const int m = (l < nSites) ? nbr[8*site[l]+dir] : -1;
+      Float buf[24];
+      const Float *psi = (m >= 0) ? in(m, buf) : 0;
+      for (int i=0; i<24; i++) t[i*V::width + l] = psi ? psi[i] : 0.0;
+    }
+    for (int i=0; i<24; i++) I[i] = V::load(t + i*V::width);
+  }
+
+  /**
+     Gather the links of the hop dir into the lanes of G: the link of
+     the site itself for forward hops and that of the neighbor for
+     backward hops, and zero where the hop is dropped.
+   */
+  template <typename V, typename Links>
+  inline void gatherLinkSimd(V *G, const Links &gauge, const int *nbr, const int *site, int nSites, int oddBit,
+			     int dir) {
+    typedef typename V::Float Float;
+    Float t[18*V::width];
+    for (int l=0; l<V::width; l++) {
+      const int m = (l < nSites) ? nbr[8*site[l]+dir] : -1;
+      Float buf[18];
+      const Float *U = (m < 0) ? 0 :
+	(dir % 2 == 0) ? gauge(oddBit, site[l], dir/2, buf) : gauge(1-oddBit, m, dir/2, buf);
+      for (int i=0; i<18; i++) t[i*V::width + l] = U ? U[i] : 0.0;
+    }
+    for (int i=0; i<18; i++) G[i] = V::load(t + i*V::width);
+  }
+
+  /**
+     As wilsonHopSite, for the first min(nSites, V::width) sites of the
+     list site, one site per lane of the vector type V (cpu_simd.h).
+     The spin projection, color multiply and reconstruction are the
+     generated kernels dslash_core/wilson_dslash(_dagger)_cpu_core.h,
+     emitted by lib/generate/dslash_cuda_gen.py from the same
+     projectors as the device kernels; the spinors and links are
+     transposed into the lanes on the way in and out.
+   */
+  template <typename V, typename Spinor, typename Links>
+  inline void wilsonHopSimd(const Spinor &out, const Links &gauge, const Spinor &in,
+			    const int *nbr, const int *site, int nSites, int oddBit, int dagger, const Spinor *x,
+			    double a) {
+    typedef typename Spinor::RegType Float;
+    typedef V spinorFloat;
+
+    V I[24], G[18], O[24];
+    for (int i=0; i<24; i++) O[i] = V(Float(0.0));
+
+#define CPU_READ_SPINOR(dir) gatherSpinorSimd(I, in, nbr, site, nSites, dir)
+#define CPU_READ_GAUGE(dir) gatherLinkSimd(G, gauge, nbr, site, nSites, oddBit, dir)
+    if (dagger) {
+#include "wilson_dslash_dagger_cpu_core.h"
+    } else {
+#include "wilson_dslash_cpu_core.h"
+    }
+#undef CPU_READ_GAUGE
+#undef CPU_READ_SPINOR
+
+    Float t[24*V::width];
+    for (int i=0; i<24; i++) O[i].store(t + i*V::width);
+    for (int l=0; l<V::width && l<nSites; l++) {
+      Float acc[24];
+      for (int i=0; i<24; i++) acc[i] = t[i*V::width + l];
+      if (x) {
+	Float buf[24];
+	const Float *xs = (*x)(site[l], buf);
+	for (int i=0; i<24; i++) acc[i] = xs[i] + a*acc[i];
+      }
+      out.save(site[l], acc);
+    }
+  }
+
+  /**
+     A hop of the virtual-node layout.  In this layout the local
+     lattice is split into V::width sub-lattices, one per vector lane,
+     and the spinors and links of each parity are stored as
+     [outer site][real][lane] (the links as [outer site][dim][real][lane]),
+     so the neighbors of all the lanes of an outer site are the lanes
+     of a single outer site.  Within a sub-lattice the lanes are
+     unchanged; a hop across the boundary between sub-lattices
+     exchanges the lanes of the split dimension, which is a permute
+     in registers.  Only where some of the lanes reach into the halo
+     are the lanes gathered one by one, from the list of per-lane
+     sources at offset lanes: entries below volumeCB are indices
+     (outer site * width + lane) of the layout, the others halo sites.
+   */
+  struct VirtualNodeHop {
+    int site;  // the outer neighbor, or -1 if the lanes are gathered one by one
+    int lanes; // the lane permutation mask, or the offset of the per-lane sources
+  };
+
+  template <typename V>
+  inline void gatherSpinorVN(V *I, const typename V::Float *in, const typename V::Float *ghost, int volumeCB,
+			     const VirtualNodeHop &h, const int *lanes) {
+    typedef typename V::Float Float;
+    const int W = V::width;
+    if (h.site >= 0) {
+      const Float *s = in + (size_t)h.site*24*W;
+      if (h.lanes) for (int i=0; i<24; i++) I[i] = V::load(s + i*W).permute(h.lanes);
+      else for (int i=0; i<24; i++) I[i] = V::load(s + i*W);
+      return;
+    }
+
+    Float t[24*W];
+    for (int l=0; l<W; l++) {
+      const int m = lanes[h.lanes + l];
+      if (m >= volumeCB) {
+	const Float *g = ghost + (size_t)(m-volumeCB)*24;
+	for (int i=0; i<24; i++) t[i*W + l] = g[i];
+      } else {
+	const Float *s = in + (size_t)(m/W)*24*W + m%W;
+	for (int i=0; i<24; i++) t[i*W + l] = s[i*W];
+      }
+    }
+    for (int i=0; i<24; i++) I[i] = V::load(t + i*W);
+  }
+
+  /**
+     The links of the hop dir from outer site b: those of b itself for
+     forward hops, and for backward hops those of the neighbors of the
+     opposite parity, gathered as the spinors.  The halo links follow
+     the local links in the site order, [site][dim][18] for the halo
+     sites at or beyond volumeCB.
+   */
+  template <typename V>
+  inline void gatherLinkVN(V *G, const typename V::Float *const *gauge, int volumeCB, int b, int oddBit,
+			   int dir, const VirtualNodeHop &h, const int *lanes) {
+    typedef typename V::Float Float;
+    const int W = V::width, d = dir/2;
+    if (dir % 2 == 0 || h.site >= 0) {
+      const int m = (dir % 2 == 0) ? b : h.site;
+      const Float *U = gauge[(dir % 2 == 0) ? oddBit : 1-oddBit] + ((size_t)m*4 + d)*18*W;
+      if (dir % 2 == 1 && h.lanes) for (int i=0; i<18; i++) G[i] = V::load(U + i*W).permute(h.lanes);
+      else for (int i=0; i<18; i++) G[i] = V::load(U + i*W);
+      return;
+    }
+
+    const Float *U = gauge[1-oddBit];
+    Float t[18*W];
+    for (int l=0; l<W; l++) {
+      const int m = lanes[h.lanes + l];
+      const Float *u = (m >= volumeCB) ? U + ((size_t)m*4 + d)*18 : U + ((size_t)(m/W)*4 + d)*18*W + m%W;
+      const int stride = (m >= volumeCB) ? 1 : W;
+      for (int i=0; i<18; i++) t[i*W + l] = u[i*stride];
+    }
+    for (int i=0; i<18; i++) G[i] = V::load(t + i*W);
+  }
+
+  /**
+     The hopping term of the V::width sites of outer site b in the
+     virtual-node layout, out = x + a * D in, or out = D in if x is
+     NULL, with the same generated kernels as wilsonHopSimd.  All
+     loads and stores away from the halo are unit-stride vector loads.
+     volumeCB is the number of sites per parity, hop holds eight hops
+     per outer site, and ghost is the spinor halo in site order.
+   */
+  template <typename V>
+  inline void wilsonHopVN(typename V::Float *out, const typename V::Float *const *gauge,
+			  const typename V::Float *in, const typename V::Float *ghost,
+			  const VirtualNodeHop *hop, const int *lanes, int volumeCB, int b,
+			  int oddBit, int dagger, const typename V::Float *x, double a) {
+    typedef typename V::Float Float;
+    typedef V spinorFloat;
+    const int W = V::width;
+
+    V I[24], G[18], O[24];
+    for (int i=0; i<24; i++) O[i] = V(Float(0.0));
+
+#define CPU_READ_SPINOR(dir) gatherSpinorVN(I, in, ghost, volumeCB, hop[8*b+dir], lanes)
+#define CPU_READ_GAUGE(dir) gatherLinkVN(G, gauge, volumeCB, b, oddBit, dir, hop[8*b+dir], lanes)
+    if (dagger) {
+#include "wilson_dslash_dagger_cpu_core.h"
+    } else {
+#include "wilson_dslash_cpu_core.h"
+    }
+#undef CPU_READ_GAUGE
+#undef CPU_READ_SPINOR
+
+    Float *o = out + (size_t)b*24*W;
+    if (x) {
+      const Float *xs = x + (size_t)b*24*W;
+      const V A = V(Float(a));
+      for (int i=0; i<24; i++) fmadd(A, O[i], V::load(xs + i*W)).store(o + i*W);
+    } else {
+      for (int i=0; i<24; i++) O[i].store(o + i*W);
+    }
+  }
+
+} // namespace quda
+
+#endif // _WILSON_CPU_CORE_H
@@ -0,0 +1,1051 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <dirac_quda.h>
+#include <blas_quda.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+#include <wilson_dslash_reference.h>
+#include <domain_wall_dslash_reference.h>
+#include <staggered_dslash_reference.h>
+
+/*
+ * Host micro-benchmarks
+ *
+ * Times the host kernels on their own, without a device: the host
+ * Wilson operator in every storage format, link compression and site
+ * order, the reference dslashes of the tests, each host BLAS and
+ * reduction kernel, the host field reorders and the halo packing.
+ * The sweep covers a list of local volumes, precisions and thread
+ * counts.  For each thread count the STREAM triad bandwidth of the
+ * node is measured first, and every result is reported with its
+ * Gflop/s, GB/s and percentage of that bandwidth, as CSV or JSON.
+ * The flop and byte counts are those of the algorithm (every
+ * neighbor spinor and link read once per hop, every vector read and
+ * written once per BLAS call), so the percentage of STREAM bounds
+ * how close a kernel is to the memory roofline.  With several
+ * processes every process reports its own local numbers.
+ *
+ * Before it is timed each kernel is checked once: the host operator
+ * against the double-precision reference M of the tests, the BLAS
+ * kernels against naive loops in double precision, the reorders by a
+ * round trip back to the source and the halo packing by the sites
+ * each packed spinor came from.  The error column gives the relative
+ * difference of the check (empty for the reference dslashes, which
+ * are the yardstick), any check over its tolerance is reported as
+ * failed, and the exit status is then non-zero.
+ */
+
+using namespace quda;
+
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int Lsdim;
+extern int niter;
+extern int gridsize_from_cmdline[];
+
+extern void usage(char**);
+
+enum { BENCH_DSLASH = 1, BENCH_BLAS = 2, BENCH_REORDER = 4, BENCH_HALO = 8 };
+
+static std::vector<int> volumes;           // L of the L^4 local volumes (empty: --xdim etc.)
+static std::vector<std::string> precisions;
+static std::vector<int> recons;
+static std::vector<int> threads;
+static int kernels = BENCH_DSLASH | BENCH_BLAS | BENCH_REORDER | BENCH_HALO;
+static double minTime = 0.2;               // minimum time of each measurement (seconds)
+static int streamMB = 128;                 // size of each STREAM array
+static bool json = false;
+static FILE *output = 0;
+
+static double streamGBs = 0.0;             // measured triad bandwidth at the current thread count
+static int nThreads = 1;
+static int nResults = 0;
+static int nFailures = 0;
+
+static void splitList(std::vector<std::string> &list, const char *arg)
+{
+  list.clear();
+  std::string s(arg);
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    if (end > start) list.push_back(s.substr(start, end-start));
+    start = end + 1;
+  }
+}
+
+static void splitList(std::vector<int> &list, const char *arg)
+{
+  std::vector<std::string> s;
+  splitList(s, arg);
+  list.clear();
+  for (size_t i=0; i<s.size(); i++) list.push_back(atoi(s[i].c_str()));
+}
+
+/**
+   Write one result.  seconds is the time of a single application of
+   the kernel, flops and bytes its modeled counts.  error is the
+   relative difference found by the check of the kernel, which fails
+   above tol; a negative error marks an unchecked kernel.
+ */
+static void report(const char *kernel, const char *variant, const int *X, const char *prec,
+		   double seconds, double flops, double bytes, double error=-1.0, double tol=0.0)
+{
+  const bool checked = !(error < 0.0); // a NaN is checked, and fails
+  const bool passed = (error <= tol);
+  if (checked && !passed) {
+    warningQuda("%s %s %dx%dx%dx%d %s: relative difference %e exceeds the tolerance %e",
+		kernel, variant, X[0], X[1], X[2], X[3], prec, error, tol);
+    nFailures++;
+  }
+  if (comm_rank() != 0) return;
+
+  const double gflops = flops / (seconds*1e9);
+  const double gbs = bytes / (seconds*1e9);
+  const double pct = streamGBs > 0.0 ? 100.0*gbs/streamGBs : 0.0;
+
+  char err[32] = "", check[32] = "";
+  if (checked) {
+    sprintf(err, "%.3e", error);
+    sprintf(check, passed ? "passed" : "failed");
+  }
+
+  if (json) {
+    fprintf(output, "%s\n  { \"kernel\": \"%s\", \"variant\": \"%s\", \"volume\": \"%dx%dx%dx%d\", "
+	    "\"precision\": \"%s\", \"threads\": %d, \"seconds\": %.6e, \"gflops\": %.3f, "
+	    "\"gbytes\": %.3f, \"stream_percent\": %.1f, \"error\": %s, \"check\": %s%s%s }",
+	    nResults ? "," : "", kernel, variant, X[0], X[1], X[2], X[3], prec, nThreads, seconds,
+	    gflops, gbs, pct, checked ? err : "null", checked ? "\"" : "", checked ? check : "null",
+	    checked ? "\"" : "");
+  } else {
+    fprintf(output, "%s,%s,%dx%dx%dx%d,%s,%d,%.6e,%.3f,%.3f,%.1f,%s,%s\n", kernel, variant,
+	    X[0], X[1], X[2], X[3], prec, nThreads, seconds, gflops, gbs, pct, err, check);
+  }
+  fflush(output);
+  nResults++;
+}
+
+struct Benchmark {
+  virtual ~Benchmark() { }
+  virtual void apply() = 0;
+};
+
+// time per application, running batches of niter until minTime has passed
+static double timeBenchmark(Benchmark &b)
+{
+  b.apply(); // warm up
+  int n = 0;
+  double t = 0.0;
+  stopwatchStart();
+  do {
+    for (int i=0; i<niter; i++) b.apply();
+    n += niter;
+    t = stopwatchReadSeconds();
+  } while (t < minTime);
+  return t / n;
+}
+
+static void randomize(void *v, size_t length, QudaPrecision precision)
+{
+  for (size_t i=0; i<length; i++) {
+    const double r = rand() / (double)RAND_MAX - 0.5;
+    if (precision == QUDA_DOUBLE_PRECISION) ((double*)v)[i] = r;
+    else ((float*)v)[i] = r;
+  }
+}
+
+static QudaPrecision precisionOf(const std::string &name)
+{
+  return name == "double" ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
+}
+
+// the formats the host BLAS, reorders and references compute in
+static bool nativePrecision(const std::string &name)
+{
+  return name == "double" || name == "single";
+}
+
+static double tolerance(QudaPrecision precision)
+{
+  return precision == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-5;
+}
+
+// relative L2 difference of a from the reference b over all processes
+template <typename FloatA, typename FloatB>
+static double relativeError(const FloatA *a, const FloatB *b, size_t length)
+{
+  double diff2 = 0.0, norm2 = 0.0;
+  for (size_t i=0; i<length; i++) {
+    const double d = (double)a[i] - (double)b[i];
+    diff2 += d*d;
+    norm2 += (double)b[i]*(double)b[i];
+  }
+  comm_allreduce(&diff2);
+  comm_allreduce(&norm2);
+  return sqrt(diff2 / norm2);
+}
+
+static double relativeError(const void *a, const void *b, size_t length, QudaPrecision precision)
+{
+  if (precision == QUDA_DOUBLE_PRECISION) return relativeError((const double*)a, (const double*)b, length);
+  else return relativeError((const float*)a, (const float*)b, length);
+}
+
+static void streamTriad()
+{
+  const size_t n = (size_t)streamMB*1024*1024/sizeof(double);
+  double *a = (double*)malloc(n*sizeof(double));
+  double *b = (double*)malloc(n*sizeof(double));
+  double *c = (double*)malloc(n*sizeof(double));
+  if (!a || !b || !c) errorQuda("Failed to allocate the STREAM arrays");
+
+#pragma omp parallel for
+  for (long i=0; i<(long)n; i++) { a[i] = 0.0; b[i] = 1.0; c[i] = 2.0; }
+
+  // best of ten, as STREAM reports
+  const double s = 3.0;
+  double best = 1e30;
+  for (int k=0; k<10; k++) {
+    stopwatchStart();
+#pragma omp parallel for
+    for (long i=0; i<(long)n; i++) a[i] = b[i] + s*c[i];
+    const double t = stopwatchReadSeconds();
+    if (t < best) best = t;
+  }
+  double error = 0.0; // every element is exactly 7
+  for (size_t i=0; i<n; i++) if (fabs(a[i] - 7.0) > error) error = fabs(a[i] - 7.0);
+
+  streamGBs = 3.0*n*sizeof(double) / (best*1e9);
+  const int X[4] = { 0, 0, 0, 0 };
+  report("stream", "triad", X, "double", best, 2.0*n, 3.0*n*sizeof(double), error/7.0, 0.0);
+
+  free(c);
+  free(b);
+  free(a);
+}
+
+// host Wilson operator: the even-even preconditioned M, two hops and an xpay
+struct WilsonCpuBench : public Benchmark {
+  const DiracWilsonCpu &op;
+  void *out, *in;
+  WilsonCpuBench(const DiracWilsonCpu &op, void *out, void *in) : op(op), out(out), in(in) { }
+  void apply() { op.M(out, in); }
+};
+
+struct WilsonRefBench : public Benchmark {
+  void **gauge, *out, *in;
+  QudaPrecision precision;
+  QudaGaugeParam &param;
+  WilsonRefBench(void **gauge, void *out, void *in, QudaPrecision precision, QudaGaugeParam &param)
+    : gauge(gauge), out(out), in(in), precision(precision), param(param) { }
+  void apply() { wil_dslash(out, gauge, in, 0, 0, precision, param); }
+};
+
+struct StaggeredRefBench : public Benchmark {
+  void **fat, **lng, *out, *in;
+  QudaPrecision precision;
+  StaggeredRefBench(void **fat, void **lng, void *out, void *in, QudaPrecision precision)
+    : fat(fat), lng(lng), out(out), in(in), precision(precision) { }
+  void apply() { staggered_dslash(out, fat, lng, in, 0, 0, precision, precision); }
+};
+
+struct DomainWallRefBench : public Benchmark {
+  void **gauge, *out, *in;
+  QudaPrecision precision;
+  QudaGaugeParam &param;
+  DomainWallRefBench(void **gauge, void *out, void *in, QudaPrecision precision, QudaGaugeParam &param)
+    : gauge(gauge), out(out), in(in), precision(precision), param(param) { }
+  void apply() { dw_dslash(out, gauge, in, 0, 0, precision, param, 0.1); }
+};
+
+static void setGaugeParam(QudaGaugeParam &param, const int *X, QudaPrecision precision)
+{
+  param = newQudaGaugeParam();
+  for (int d=0; d<4; d++) param.X[d] = X[d];
+  param.cpu_prec = precision;
+  param.cuda_prec = precision;
+  param.reconstruct = QUDA_RECONSTRUCT_NO;
+  param.type = QUDA_WILSON_LINKS;
+  param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  param.anisotropy = 1.0;
+  param.tadpole_coeff = 1.0;
+  param.t_boundary = QUDA_ANTI_PERIODIC_T;
+  param.gauge_fix = QUDA_GAUGE_FIXED_NO;
+  param.ga_pad = 0;
+}
+
+/**
+   The host Wilson operator in each link compression and site order.
+   Every variant is first applied to a random source, encoded in the
+   storage format and converted to the layout of the operator, and
+   compared with the reference M of the tests applied in double
+   precision to the same source.
+ */
+static void benchWilsonCpu(const int *X, void **gauge, QudaGaugeParam &gParam, const std::string &prec)
+{
+  QudaStorageType storage;
+  double tol;
+  if (prec == "double") { storage = QUDA_DOUBLE_STORAGE; tol = 1e-10; }
+  else if (prec == "single") { storage = QUDA_SINGLE_STORAGE; tol = 1e-5; }
+  else if (prec == "half") { storage = QUDA_HALF_STORAGE; tol = 1e-3; }
+  else if (prec == "bfloat16") { storage = QUDA_BFLOAT16_STORAGE; tol = 1e-2; }
+  else { warningQuda("Unknown precision %s", prec.c_str()); return; }
+
+  GaugeFieldParam param(gauge, gParam);
+  cpuGaugeField u(param);
+
+  DiracParam diracParam;
+  diracParam.type = QUDA_WILSONPC_DIRAC;
+  diracParam.kappa = 0.12;
+  diracParam.matpcType = QUDA_MATPC_EVEN_EVEN;
+  diracParam.dagger = QUDA_DAG_NO;
+
+  const char *orderName[] = { "lexicographic", "morton", "hilbert", "virtual_node" };
+  const QudaStencilOrder order[] = { QUDA_LEXICOGRAPHIC_STENCIL_ORDER, QUDA_MORTON_STENCIL_ORDER,
+				     QUDA_HILBERT_STENCIL_ORDER, QUDA_LEXICOGRAPHIC_STENCIL_ORDER };
+  const int volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+  bool splittable = true; // the virtual-node layout needs room for up to 16 lanes
+  for (int d=0; d<4; d++) if (X[d] % 4) splittable = false;
+
+  const size_t length = (size_t)volumeCB*spinorSiteSize;
+  double *src = (double*)malloc(length*sizeof(double));
+  double *ref = (double*)malloc(length*sizeof(double));
+  double *result = (double*)malloc(length*sizeof(double));
+  randomize(src, length, QUDA_DOUBLE_PRECISION);
+  wil_matpc(ref, gauge, src, diracParam.kappa, diracParam.matpcType, 0, QUDA_DOUBLE_PRECISION, gParam);
+
+  for (size_t r=0; r<recons.size(); r++) {
+    const QudaReconstructType recon = (QudaReconstructType)recons[r];
+    if (recon != QUDA_RECONSTRUCT_NO && recon != QUDA_RECONSTRUCT_12 && recon != QUDA_RECONSTRUCT_8) {
+      warningQuda("Reconstruct %d not supported by the host operator", recon);
+      continue;
+    }
+    for (int o=0; o<4; o++) {
+      const bool vn = (o == 3);
+      if (vn && (!splittable || recon != QUDA_RECONSTRUCT_NO || !nativePrecision(prec))) continue;
+
+      DiracWilsonCpu op(diracParam, u, storage, recon, vn, order[o]);
+      const size_t siteBytes = op.SiteBytes();
+      const int linkBytes = recon * op.Precision();
+      void *in = malloc(volumeCB*siteBytes);
+      void *out = malloc(volumeCB*siteBytes);
+      void *tmp = malloc(volumeCB*siteBytes);
+
+      encodeSites(tmp, src, volumeCB, storage);
+      op.ToLayout(in, tmp);
+      op.M(out, in);
+      op.FromLayout(tmp, out);
+      decodeSites(result, tmp, volumeCB, storage);
+      const double error = relativeError(result, ref, length);
+
+      WilsonCpuBench b(op, out, in);
+      const double secs = timeBenchmark(b);
+      const double flops = (2*1320.0 + 48.0)*volumeCB;
+      const double bytes = (2.0*(9*siteBytes + 8*linkBytes) + siteBytes)*volumeCB;
+      char variant[64];
+      sprintf(variant, "recon%d_%s", recon, orderName[o]);
+      report("wilson_cpu", variant, X, prec.c_str(), secs, flops, bytes, error, tol);
+
+      free(tmp);
+      free(out);
+      free(in);
+    }
+  }
+
+  free(result);
+  free(ref);
+  free(src);
+}
+
+static void benchDslash(const int *X, const std::string &prec)
+{
+  const QudaPrecision precision = precisionOf(prec);
+  const int volume = X[0]*X[1]*X[2]*X[3];
+  QudaGaugeParam gParam;
+  setGaugeParam(gParam, X, QUDA_DOUBLE_PRECISION);
+
+  // the operator takes double links and converts them
+  void *gauge[4];
+  for (int d=0; d<4; d++) gauge[d] = malloc((size_t)volume*gaugeSiteSize*sizeof(double));
+  construct_gauge_field(gauge, 1, QUDA_DOUBLE_PRECISION, &gParam);
+  benchWilsonCpu(X, gauge, gParam, prec);
+  for (int d=0; d<4; d++) free(gauge[d]);
+
+  if (!nativePrecision(prec)) return;
+
+#ifndef MULTI_GPU
+  // the reference dslashes of the tests, in the precision of the links and spinors
+  setGaugeParam(gParam, X, precision);
+  for (int d=0; d<4; d++) gauge[d] = malloc((size_t)volume*gaugeSiteSize*precision);
+  construct_gauge_field(gauge, 1, precision, &gParam);
+
+  {
+    setSpinorSiteSize(spinorSiteSize);
+    void *in = malloc((size_t)volume*spinorSiteSize*precision);
+    void *out = malloc((size_t)volume*spinorSiteSize*precision);
+    randomize(in, (size_t)volume*spinorSiteSize, precision);
+    WilsonRefBench b(gauge, out, in, precision, gParam);
+    const double secs = timeBenchmark(b);
+    report("wilson_reference", "recon18", X, prec.c_str(), secs, 1320.0*volume/2,
+	   (8.0*(spinorSiteSize + gaugeSiteSize) + spinorSiteSize)*precision*volume/2);
+    free(out);
+    free(in);
+  }
+
+  {
+    dw_setDims(gParam.X, Lsdim);
+    const size_t length = (size_t)volume*Lsdim*spinorSiteSize;
+    void *in = malloc(length*precision);
+    void *out = malloc(length*precision);
+    randomize(in, length, precision);
+    DomainWallRefBench b(gauge, out, in, precision, gParam);
+    const double secs = timeBenchmark(b);
+    char variant[64];
+    sprintf(variant, "Ls%d", Lsdim);
+    report("domain_wall_reference", variant, X, prec.c_str(), secs, (1320.0 + 48.0)*Lsdim*volume/2,
+	   (8.0*(spinorSiteSize + gaugeSiteSize) + 3*spinorSiteSize)*precision*Lsdim*volume/2);
+    free(out);
+    free(in);
+    setDims(gParam.X);
+  }
+
+  for (int d=0; d<4; d++) free(gauge[d]);
+
+  {
+    setSpinorSiteSize(6);
+    void *fat[4], *lng[4];
+    for (int d=0; d<4; d++) {
+      fat[d] = malloc((size_t)volume*gaugeSiteSize*precision);
+      lng[d] = malloc((size_t)volume*gaugeSiteSize*precision);
+    }
+    construct_fat_long_gauge_field(fat, lng, 1, precision, &gParam);
+    void *in = malloc((size_t)volume*6*precision);
+    void *out = malloc((size_t)volume*6*precision);
+    randomize(in, (size_t)volume*6, precision);
+    StaggeredRefBench b(fat, lng, out, in, precision);
+    const double secs = timeBenchmark(b);
+    report("staggered_reference", "recon18", X, prec.c_str(), secs, 1146.0*volume/2,
+	   (16.0*(6 + gaugeSiteSize) + 6)*precision*volume/2);
+    free(out);
+    free(in);
+    for (int d=0; d<4; d++) {
+      free(lng[d]);
+      free(fat[d]);
+    }
+    setSpinorSiteSize(spinorSiteSize);
+  }
+#endif
+}
+
+/**
+   The host BLAS kernels, with their flops per real number and the
+   numbers of vectors read and written.
+ */
+static const struct { const char *name; int flops; int reads; int writes; } blasKernel[] = {
+  { "axpby", 3, 2, 1 },
+  { "xpy", 1, 2, 1 },
+  { "axpy", 2, 2, 1 },
+  { "xpay", 2, 2, 1 },
+  { "mxpy", 1, 2, 1 },
+  { "ax", 1, 1, 1 },
+  { "caxpy", 4, 2, 1 },
+  { "caxpby", 7, 2, 1 },
+  { "cxpaypbz", 8, 3, 1 },
+  { "axpyBzpcx", 5, 3, 2 },
+  { "axpyZpbx", 4, 3, 2 },
+  { "caxpbypzYmbw", 12, 4, 2 },
+  { "cabxpyAx", 5, 2, 2 },
+  { "caxpbypz", 8, 3, 1 },
+  { "caxpbypczpw", 12, 4, 1 },
+  { "caxpyXmaz", 8, 3, 2 },
+  { "norm", 2, 1, 0 },
+  { "reDotProduct", 2, 2, 0 },
+  { "axpyNorm", 4, 2, 1 },
+  { "xmyNorm", 3, 2, 1 },
+  { "caxpyNorm", 6, 2, 1 },
+  { "caxpyXmazNormX", 10, 3, 2 },
+  { "cabxpyAxNorm", 7, 2, 2 },
+  { "cDotProduct", 4, 2, 0 },
+  { "xpaycDotzy", 6, 3, 1 },
+  { "caxpyDotzy", 8, 3, 1 },
+  { "cDotProductNormA", 6, 2, 0 },
+  { "cDotProductNormB", 6, 2, 0 },
+  { "caxpbypzYmbwcDotProductUYNormY", 18, 5, 2 },
+  { "HeavyQuarkResidualNorm", 4, 2, 0 },
+};
+static const int nBlasKernels = sizeof(blasKernel) / sizeof(blasKernel[0]);
+
+// coefficients of modulus below one keep the vectors bounded over the repetitions
+static const double a1 = 0.25, b1 = 0.5, c1 = 0.125;
+static const Complex a2(0.25, 0.125), b2(0.5, -0.25), c2(0.125, 0.25);
+
+struct BlasBench : public Benchmark {
+  int kernel;
+  cpuColorSpinorField &x, &y, &z, &w, &v;
+  double result[3]; // the reductions of the last application
+  BlasBench(int kernel, cpuColorSpinorField **f)
+    : kernel(kernel), x(*f[0]), y(*f[1]), z(*f[2]), w(*f[3]), v(*f[4]) { }
+
+  void set(double r0, double r1=0.0, double r2=0.0) { result[0] = r0; result[1] = r1; result[2] = r2; }
+  void set(const Complex &r) { set(real(r), imag(r)); }
+  void set(const double3 &r) { set(r.x, r.y, r.z); }
+
+  void apply() {
+    switch (kernel) {
+    case 0: axpbyCpu(a1, x, b1, y); break;
+    case 1: xpyCpu(x, y); break;
+    case 2: axpyCpu(a1, x, y); break;
+    case 3: xpayCpu(x, a1, y); break;
+    case 4: mxpyCpu(x, y); break;
+    case 5: axCpu(a1, x); break;
+    case 6: caxpyCpu(a2, x, y); break;
+    case 7: caxpbyCpu(a2, x, b2, y); break;
+    case 8: cxpaypbzCpu(x, a2, y, b2, z); break;
+    case 9: axpyBzpcxCpu(a1, x, y, b1, z, c1); break;
+    case 10: axpyZpbxCpu(a1, x, y, z, b1); break;
+    case 11: caxpbypzYmbwCpu(a2, x, b2, y, z, w); break;
+    case 12: cabxpyAxCpu(a1, b2, x, y); break;
+    case 13: caxpbypzCpu(a2, x, b2, y, z); break;
+    case 14: caxpbypczpwCpu(a2, x, b2, y, c2, z, w); break;
+    case 15: caxpyXmazCpu(a2, x, y, z); break;
+    case 16: set(normCpu(x)); break;
+    case 17: set(reDotProductCpu(x, y)); break;
+    case 18: set(axpyNormCpu(a1, x, y)); break;
+    case 19: set(xmyNormCpu(x, y)); break;
+    case 20: set(caxpyNormCpu(a2, x, y)); break;
+    case 21: set(caxpyXmazNormXCpu(a2, x, y, z)); break;
+    case 22: set(cabxpyAxNormCpu(a1, b2, x, y)); break;
+    case 23: set(cDotProductCpu(x, y)); break;
+    case 24: set(xpaycDotzyCpu(x, a1, y, z)); break;
+    case 25: set(caxpyDotzyCpu(a2, x, y, z)); break;
+    case 26: set(cDotProductNormACpu(x, y)); break;
+    case 27: set(cDotProductNormBCpu(x, y)); break;
+    case 28: set(caxpbypzYmbwcDotProductUYNormYCpu(a2, x, b2, y, z, w, v)); break;
+    case 29: set(HeavyQuarkResidualNormCpu(x, y)); break;
+    default: errorQuda("Undefined blas kernel %d", kernel);
+    }
+  }
+};
+
+/**
+   Naive double-precision loops over copies of the five vectors of a
+   BLAS benchmark, with the expected reductions and their scales (the
+   reduction itself for norms, the product of the norms for dot
+   products).
+ */
+struct BlasReference {
+  std::vector<Complex> v[5];
+  int n;
+  double expect[3], scale[3];
+
+  BlasReference(cpuColorSpinorField **f) : n(0) {
+    for (int i=0; i<5; i++) {
+      v[i].resize(f[i]->Length()/2);
+      for (size_t j=0; j<v[i].size(); j++) {
+	if (f[i]->Precision() == QUDA_DOUBLE_PRECISION)
+	  v[i][j] = Complex(((double*)f[i]->V())[2*j], ((double*)f[i]->V())[2*j+1]);
+	else
+	  v[i][j] = Complex(((float*)f[i]->V())[2*j], ((float*)f[i]->V())[2*j+1]);
+      }
+    }
+  }
+
+  // v[y] = a*v[x] + b*v[y]
+  void caxpby(const Complex &a, int x, const Complex &b, int y) {
+    for (size_t j=0; j<v[y].size(); j++) v[y][j] = a*v[x][j] + b*v[y][j];
+  }
+
+  double norm(int x) const {
+    double n2 = 0.0;
+    for (size_t j=0; j<v[x].size(); j++) n2 += std::norm(v[x][j]);
+    comm_allreduce(&n2);
+    return n2;
+  }
+
+  void expectNorm(int x) {
+    const double n2 = norm(x);
+    expect[n] = n2;
+    scale[n++] = n2;
+  }
+
+  // the dot product (v[x], v[y]), or its real part only
+  void expectDot(int x, int y, bool realOnly=false) {
+    Complex dot = 0.0;
+    for (size_t j=0; j<v[x].size(); j++) dot += conj(v[x][j])*v[y][j];
+    comm_allreduce_array((double*)&dot, 2);
+    const double s = sqrt(norm(x)*norm(y));
+    expect[n] = real(dot);
+    scale[n++] = s;
+    if (realOnly) return;
+    expect[n] = imag(dot);
+    scale[n++] = s;
+  }
+
+  // the heavy-quark residual norm of the host kernel, local to each process
+  void expectHeavyQuark(int x, int r) {
+    const int siteLength = spinorSiteSize/2;
+    const size_t sites = v[x].size() / siteLength;
+    double sum[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i=0; i<sites; i++) {
+      double x2 = 0.0, r2 = 0.0;
+      for (int j=0; j<siteLength; j++) {
+	x2 += std::norm(v[x][i*siteLength+j]);
+	r2 += std::norm(v[r][i*siteLength+j]);
+      }
+      sum[0] += x2;
+      sum[1] += r2;
+      sum[2] += (x2 > 0.0) ? (r2 / x2) : 1.0;
+    }
+    sum[2] /= (double)sites*comm_size();
+    for (int i=0; i<3; i++) {
+      expect[n] = sum[i];
+      scale[n++] = sum[i];
+    }
+  }
+
+  void apply(int kernel) {
+    const int X = 0, Y = 1, Z = 2, W = 3, V = 4;
+    switch (kernel) {
+    case 0: caxpby(a1, X, b1, Y); break;
+    case 1: caxpby(1.0, X, 1.0, Y); break;
+    case 2: caxpby(a1, X, 1.0, Y); break;
+    case 3: caxpby(1.0, X, a1, Y); break;
+    case 4: caxpby(-1.0, X, 1.0, Y); break;
+    case 5: caxpby(0.0, X, a1, X); break;
+    case 6: caxpby(a2, X, 1.0, Y); break;
+    case 7: caxpby(a2, X, b2, Y); break;
+    case 8: caxpby(a2, Y, b2, Z); caxpby(1.0, X, 1.0, Z); break;
+    case 9: caxpby(a1, X, 1.0, Y); caxpby(b1, Z, c1, X); break;
+    case 10: caxpby(a1, X, 1.0, Y); caxpby(1.0, Z, b1, X); break;
+    case 11: caxpby(a2, X, 1.0, Z); caxpby(b2, Y, 1.0, Z); caxpby(-b2, W, 1.0, Y); break;
+    case 12: caxpby(0.0, X, a1, X); caxpby(b2, X, 1.0, Y); break;
+    case 13: caxpby(a2, X, 1.0, Z); caxpby(b2, Y, 1.0, Z); break;
+    case 14: caxpby(a2, X, 1.0, W); caxpby(b2, Y, 1.0, W); caxpby(c2, Z, 1.0, W); break;
+    case 15: caxpby(a2, X, 1.0, Y); caxpby(-a2, Z, 1.0, X); break;
+    case 16: expectNorm(X); break;
+    case 17: expectDot(X, Y, true); break;
+    case 18: caxpby(a1, X, 1.0, Y); expectNorm(Y); break;
+    case 19: caxpby(1.0, X, -1.0, Y); expectNorm(Y); break;
+    case 20: caxpby(a2, X, 1.0, Y); expectNorm(Y); break;
+    case 21: caxpby(a2, X, 1.0, Y); caxpby(-a2, Z, 1.0, X); expectNorm(X); break;
+    case 22: caxpby(0.0, X, a1, X); caxpby(b2, X, 1.0, Y); expectNorm(Y); break;
+    case 23: expectDot(X, Y); break;
+    case 24: caxpby(1.0, X, a1, Y); expectDot(Z, Y); break;
+    case 25: caxpby(a2, X, 1.0, Y); expectDot(Z, Y); break;
+    case 26: expectDot(X, Y); expectNorm(X); break;
+    case 27: expectDot(X, Y); expectNorm(Y); break;
+    case 28:
+      caxpby(a2, X, 1.0, Z); caxpby(b2, Y, 1.0, Z); caxpby(-b2, W, 1.0, Y);
+      expectDot(V, Y); expectNorm(Y);
+      break;
+    case 29: expectHeavyQuark(X, Y); break;
+    default: errorQuda("Undefined blas kernel %d", kernel);
+    }
+  }
+};
+
+/**
+   Apply a BLAS kernel once to copies of the vectors and return the
+   largest relative difference of the vectors and reductions from the
+   naive loops.
+ */
+static double checkBlas(int kernel, cpuColorSpinorField **f)
+{
+  cpuColorSpinorField *g[5];
+  for (int i=0; i<5; i++) g[i] = new cpuColorSpinorField(*f[i]);
+
+  BlasReference ref(g);
+  ref.apply(kernel);
+  BlasBench b(kernel, g);
+  b.apply();
+
+  double diff2 = 0.0, norm2 = 0.0;
+  for (int i=0; i<5; i++) {
+    const double *d = (const double*)g[i]->V();
+    const float *s = (const float*)g[i]->V();
+    const bool isDouble = (g[i]->Precision() == QUDA_DOUBLE_PRECISION);
+    for (size_t j=0; j<ref.v[i].size(); j++) {
+      const Complex r = ref.v[i][j];
+      const Complex u = isDouble ? Complex(d[2*j], d[2*j+1]) : Complex(s[2*j], s[2*j+1]);
+      diff2 += std::norm(u - r);
+      norm2 += std::norm(r);
+    }
+  }
+  comm_allreduce(&diff2);
+  comm_allreduce(&norm2);
+  double error = sqrt(diff2 / norm2);
+
+  for (int i=0; i<ref.n; i++) {
+    const double e = fabs(b.result[i] - ref.expect[i]) / ref.scale[i];
+    if (!(e <= error)) error = e;
+  }
+
+  for (int i=0; i<5; i++) delete g[i];
+  return error;
+}
+
+static void setSpinorParam(ColorSpinorParam &param, const int *X, QudaPrecision precision)
+{
+  param.nColor = 3;
+  param.nSpin = 4;
+  param.nDim = 4;
+  for (int d=0; d<4; d++) param.x[d] = X[d];
+  param.x[0] /= 2;
+  param.precision = precision;
+  param.pad = 0;
+  param.siteSubset = QUDA_PARITY_SITE_SUBSET;
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+}
+
+static void benchBlas(const int *X, const std::string &prec)
+{
+  const QudaPrecision precision = precisionOf(prec);
+  ColorSpinorParam param;
+  setSpinorParam(param, X, precision);
+
+  cpuColorSpinorField *f[5];
+  for (int i=0; i<5; i++) f[i] = new cpuColorSpinorField(param);
+  const double length = f[0]->Length();
+
+  for (int k=0; k<nBlasKernels; k++) {
+    // fresh vectors, since the repetitions of the previous kernel may have driven them towards underflow
+    for (int i=0; i<5; i++) f[i]->Source(QUDA_RANDOM_SOURCE);
+    const double error = checkBlas(k, f);
+    BlasBench b(k, f);
+    const double secs = timeBenchmark(b);
+    report("blas", blasKernel[k].name, X, prec.c_str(), secs, blasKernel[k].flops*length,
+	   (blasKernel[k].reads + blasKernel[k].writes)*length*precision, error, tolerance(precision));
+  }
+
+  for (int i=0; i<5; i++) delete f[i];
+}
+
+struct SpinorReorderBench : public Benchmark {
+  ColorSpinorField &dst;
+  const ColorSpinorField &src;
+  SpinorReorderBench(ColorSpinorField &dst, const ColorSpinorField &src) : dst(dst), src(src) { }
+  void apply() { copyGenericColorSpinor(dst, src, QUDA_CPU_FIELD_LOCATION); }
+};
+
+struct GaugeReorderBench : public Benchmark {
+  GaugeField &dst;
+  const GaugeField &src;
+  GaugeReorderBench(GaugeField &dst, const GaugeField &src) : dst(dst), src(src) { }
+  void apply() { copyGenericGauge(dst, src, QUDA_CPU_FIELD_LOCATION); }
+};
+
+static void benchReorder(const int *X, const std::string &prec)
+{
+  const QudaPrecision precision = precisionOf(prec);
+  const QudaPrecision other = (precision == QUDA_DOUBLE_PRECISION) ? QUDA_SINGLE_PRECISION : QUDA_DOUBLE_PRECISION;
+  const int volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+
+  ColorSpinorParam param;
+  setSpinorParam(param, X, precision);
+  cpuColorSpinorField src(param);
+  src.Source(QUDA_RANDOM_SOURCE);
+
+  struct { const char *name; QudaFieldOrder order; QudaPrecision precision; } target[] = {
+    { "space_color_spin", QUDA_SPACE_COLOR_SPIN_FIELD_ORDER, precision },
+    { "aosoa8", QUDA_AOSOA8_FIELD_ORDER, precision },
+    { "convert_precision", QUDA_SPACE_SPIN_COLOR_FIELD_ORDER, other },
+  };
+  for (int t=0; t<3; t++) {
+    if (aosoaWidth(target[t].order) && volumeCB % aosoaWidth(target[t].order)) continue;
+    ColorSpinorParam dstParam(param);
+    dstParam.fieldOrder = target[t].order;
+    dstParam.precision = target[t].precision;
+    cpuColorSpinorField dst(dstParam);
+    SpinorReorderBench b(dst, src);
+    const double secs = timeBenchmark(b);
+
+    // round trip back to the order and precision of the source
+    cpuColorSpinorField back(param);
+    copyGenericColorSpinor(back, dst, QUDA_CPU_FIELD_LOCATION);
+    mxpyCpu(src, back);
+    const double error = sqrt(normCpu(back) / normCpu(src));
+    report("spinor_reorder", target[t].name, X, prec.c_str(), secs, 0.0,
+	   (double)volumeCB*spinorSiteSize*(precision + target[t].precision), error,
+	   tolerance(std::min(precision, target[t].precision)));
+  }
+
+  // QDP to MILC links
+  const int volume = 2*volumeCB;
+  QudaGaugeParam gParam;
+  setGaugeParam(gParam, X, precision);
+  void *gauge[4], *back[4];
+  for (int d=0; d<4; d++) {
+    gauge[d] = malloc((size_t)volume*gaugeSiteSize*precision);
+    back[d] = malloc((size_t)volume*gaugeSiteSize*precision);
+  }
+  construct_gauge_field(gauge, 1, precision, &gParam);
+  {
+    GaugeFieldParam qdpParam(gauge, gParam);
+    cpuGaugeField qdp(qdpParam);
+    GaugeFieldParam milcParam(X, precision, QUDA_RECONSTRUCT_NO, 0, QUDA_VECTOR_GEOMETRY);
+    milcParam.order = QUDA_MILC_GAUGE_ORDER;
+    milcParam.create = QUDA_NULL_FIELD_CREATE;
+    milcParam.link_type = QUDA_WILSON_LINKS;
+    milcParam.t_boundary = gParam.t_boundary;
+    milcParam.anisotropy = gParam.anisotropy;
+    cpuGaugeField milc(milcParam);
+    GaugeReorderBench b(milc, qdp);
+    const double secs = timeBenchmark(b);
+
+    // round trip back to QDP order
+    GaugeFieldParam backParam(back, gParam);
+    cpuGaugeField qdpBack(backParam);
+    copyGenericGauge(qdpBack, milc, QUDA_CPU_FIELD_LOCATION);
+    double error = 0.0;
+    for (int d=0; d<4; d++) {
+      const double e = relativeError(back[d], gauge[d], (size_t)volume*gaugeSiteSize, precision);
+      if (!(e <= error)) error = e;
+    }
+    report("gauge_reorder", "qdp_to_milc", X, prec.c_str(), secs, 0.0,
+	   2.0*volume*4*gaugeSiteSize*precision, error, tolerance(precision));
+  }
+  for (int d=0; d<4; d++) {
+    free(back[d]);
+    free(gauge[d]);
+  }
+}
+
+struct HaloBench : public Benchmark {
+  cpuColorSpinorField &f;
+  void *buf;
+  int dim;
+  QudaDirection dir;
+  HaloBench(cpuColorSpinorField &f, void *buf, int dim, QudaDirection dir) : f(f), buf(buf), dim(dim), dir(dir) { }
+  void apply() { f.packGhost(buf, dim, dir, QUDA_EVEN_PARITY, 0); }
+};
+
+/**
+   Pack a face of a field whose spinors hold their own checkerboard
+   index and return the fraction of face slots that are not a distinct
+   site of that face.  The face is found independently of packGhost,
+   from the full-lattice coordinates of the even sites.
+ */
+static double checkHalo(const ColorSpinorParam &param, const int *X, int dim, QudaDirection dir)
+{
+  cpuColorSpinorField label(param);
+  const int volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+  for (int i=0; i<volumeCB; i++) {
+    for (int j=0; j<spinorSiteSize; j++) {
+      if (label.Precision() == QUDA_DOUBLE_PRECISION) ((double*)label.V())[i*spinorSiteSize+j] = i;
+      else ((float*)label.V())[i*spinorSiteSize+j] = i;
+    }
+  }
+
+  std::vector<char> onFace(volumeCB, 0), seen(volumeCB, 0);
+  int x[4];
+  for (x[3]=0; x[3]<X[3]; x[3]++)
+    for (x[2]=0; x[2]<X[2]; x[2]++)
+      for (x[1]=0; x[1]<X[1]; x[1]++)
+	for (x[0]=0; x[0]<X[0]; x[0]++) {
+	  if ((x[0] + x[1] + x[2] + x[3]) % 2) continue;
+	  if (x[dim] != (dir == QUDA_BACKWARDS ? 0 : X[dim]-1)) continue;
+	  onFace[(x[0] + X[0]*(x[1] + X[1]*(x[2] + X[2]*x[3]))) / 2] = 1;
+	}
+
+  const int faceCB = volumeCB / X[dim];
+  std::vector<double> buf((size_t)faceCB*spinorSiteSize, -1.0);
+  label.packGhost(&buf[0], dim, dir, QUDA_EVEN_PARITY, 0);
+
+  int wrong = 0;
+  for (int k=0; k<faceCB; k++) {
+    double site[spinorSiteSize];
+    for (int j=0; j<spinorSiteSize; j++) {
+      if (label.Precision() == QUDA_DOUBLE_PRECISION) site[j] = buf[k*spinorSiteSize+j];
+      else site[j] = ((const float*)&buf[0])[k*spinorSiteSize+j];
+    }
+    const int i = (int)site[0];
+    bool ok = (site[0] == i && i >= 0 && i < volumeCB && onFace[i] && !seen[i]);
+    for (int j=1; j<spinorSiteSize; j++) if (site[j] != site[0]) ok = false;
+    if (ok) seen[i] = 1;
+    else wrong++;
+  }
+  double fraction[2] = { (double)wrong, (double)faceCB };
+  comm_allreduce_array(fraction, 2);
+  return fraction[0] / fraction[1];
+}
+
+static void benchHalo(const int *X, const std::string &prec)
+{
+  const QudaPrecision precision = precisionOf(prec);
+  ColorSpinorParam param;
+  setSpinorParam(param, X, precision);
+  cpuColorSpinorField f(param);
+  f.Source(QUDA_RANDOM_SOURCE);
+
+  const int volumeCB = X[0]*X[1]*X[2]*X[3]/2;
+  const char *dimName[] = { "x", "y", "z", "t" };
+  for (int d=0; d<4; d++) {
+    const int faceCB = volumeCB / X[d];
+    void *buf = malloc((size_t)faceCB*spinorSiteSize*precision);
+    for (int e=0; e<2; e++) {
+      const QudaDirection dir = e ? QUDA_FORWARDS : QUDA_BACKWARDS;
+      const double error = checkHalo(param, X, d, dir);
+      HaloBench b(f, buf, d, dir);
+      const double secs = timeBenchmark(b);
+      char variant[64];
+      sprintf(variant, "%s_%s", dimName[d], e ? "forwards" : "backwards");
+      report("halo_pack", variant, X, prec.c_str(), secs, 0.0, 2.0*faceCB*spinorSiteSize*precision,
+	     error, 0.0);
+    }
+    free(buf);
+  }
+}
+
+void usage_extra(char** argv)
+{
+  printf("Extra options:\n");
+  printf("    --volumes <L,...>                         # Local L^4 volumes to sweep (default: --xdim etc.)\n");
+  printf("    --precisions <p,...>                      # double/single/half/bfloat16 (default double,single)\n");
+  printf("    --recons <18,12,8>                        # Link compressions of the host operator (default all)\n");
+  printf("    --threads <n,...>                         # Thread counts to sweep (default: all threads)\n");
+  printf("    --kernels <k,...>                         # dslash/blas/reorder/halo (default all)\n");
+  printf("    --min-time <s>                            # Minimum time of each measurement (default 0.2)\n");
+  printf("    --stream-size <MB>                        # Size of each STREAM array (default 128)\n");
+  printf("    --format <csv/json>                       # Output format (default csv)\n");
+  printf("    --output <file>                           # Output file (default stdout)\n");
+}
+
+int main(int argc, char **argv)
+{
+  const char *outputFile = 0;
+  precisions.push_back("double");
+  precisions.push_back("single");
+  recons.push_back(18);
+  recons.push_back(12);
+  recons.push_back(8);
+
+  for (int i=1; i<argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+
+    if (i+1 >= argc) {
+      fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+      usage(argv);
+    }
+    if (strcmp(argv[i], "--volumes") == 0) {
+      splitList(volumes, argv[++i]);
+    } else if (strcmp(argv[i], "--precisions") == 0) {
+      splitList(precisions, argv[++i]);
+    } else if (strcmp(argv[i], "--recons") == 0) {
+      splitList(recons, argv[++i]);
+    } else if (strcmp(argv[i], "--threads") == 0) {
+      splitList(threads, argv[++i]);
+    } else if (strcmp(argv[i], "--kernels") == 0) {
+      std::vector<std::string> k;
+      splitList(k, argv[++i]);
+      kernels = 0;
+      for (size_t j=0; j<k.size(); j++) {
+	if (k[j] == "dslash") kernels |= BENCH_DSLASH;
+	else if (k[j] == "blas") kernels |= BENCH_BLAS;
+	else if (k[j] == "reorder") kernels |= BENCH_REORDER;
+	else if (k[j] == "halo") kernels |= BENCH_HALO;
+	else { fprintf(stderr, "ERROR: unknown kernel class %s\n", k[j].c_str()); usage(argv); }
+      }
+    } else if (strcmp(argv[i], "--min-time") == 0) {
+      minTime = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--stream-size") == 0) {
+      streamMB = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--format") == 0) {
+      json = (strcmp(argv[++i], "json") == 0);
+    } else if (strcmp(argv[i], "--output") == 0) {
+      outputFile = argv[++i];
+    } else {
+      fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+      usage(argv);
+    }
+  }
+
+  initComms(argc, argv, gridsize_from_cmdline);
+  setVerbosity(QUDA_SILENT);
+  setOutputFile(stderr); // keep the warnings out of the results
+
+  output = stdout;
+  if (outputFile && comm_rank() == 0) {
+    output = fopen(outputFile, "w");
+    if (!output) errorQuda("Unable to open %s", outputFile);
+  }
+  if (comm_rank() == 0) {
+    if (json) fprintf(output, "[");
+    else fprintf(output, "kernel,variant,volume,precision,threads,seconds,gflops,gbytes,stream_percent,error,check\n");
+  }
+
+  if (threads.empty()) {
+#ifdef _OPENMP
+    threads.push_back(omp_get_max_threads());
+#else
+    threads.push_back(1);
+#endif
+  }
+
+  std::vector<int> X;
+  if (volumes.empty()) {
+    X.push_back(xdim); X.push_back(ydim); X.push_back(zdim); X.push_back(tdim);
+  } else {
+    for (size_t v=0; v<volumes.size(); v++) for (int d=0; d<4; d++) X.push_back(volumes[v]);
+  }
+
+  for (size_t t=0; t<threads.size(); t++) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads[t]);
+#else
+    if (threads[t] != 1) warningQuda("Built without OpenMP, running %d threads as 1", threads[t]);
+#endif
+    nThreads = threads[t];
+    streamTriad();
+
+    for (size_t v=0; v<X.size()/4; v++) {
+      int *x = &X[4*v];
+      setDims(x);
+      setSpinorSiteSize(spinorSiteSize);
+      for (size_t p=0; p<precisions.size(); p++) {
+	const std::string &prec = precisions[p];
+	if (prec != "double" && prec != "single" && prec != "half" && prec != "bfloat16") {
+	  warningQuda("Unknown precision %s", prec.c_str());
+	  continue;
+	}
+	if (kernels & BENCH_DSLASH) benchDslash(x, prec);
+	if (!nativePrecision(prec)) continue;
+	if (kernels & BENCH_BLAS) benchBlas(x, prec);
+	if (kernels & BENCH_REORDER) benchReorder(x, prec);
+	if (kernels & BENCH_HALO) benchHalo(x, prec);
+      }
+    }
+  }
+
+  if (comm_rank() == 0) {
+    if (json) fprintf(output, "\n]\n");
+    if (output != stdout) fclose(output);
+  }
+
+  if (nFailures) warningQuda("%d results failed their check", nFailures);
+
+  finalizeComms();
+
+  return nFailures ? 1 : 0;
+}
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include <quda.h>
 #include <quda_internal.h>
@@ -10,6 +11,8 @@
 #include <invert_quda.h>
 #include <util_quda.h>
 #include <blas_quda.h>
+#include <gauge_field.h>
+#include <comm_quda.h>
 
 #include <test_util.h>
 #include <dslash_util.h>
@@ -63,6 +66,9 @@ extern QudaDagType dagger;
 extern int niter;
 extern char latfile[];
 
+static bool check_stencil_orders = false; // --stencil-orders
+static bool check_host_reference = false; // --host-reference
+
 void init(int argc, char **argv) {
 
   cuda_prec = prec;
@@ -536,6 +542,176 @@ void dslashRef() {
 }
 
 
+/**
+   Set the parameters of the host Wilson operator for the test type.
+   For the Wilson operator the asymmetric and symmetric even-odd
+   preconditionings are the same, and the host operator only accepts
+   the latter.  MdagM is always M^dag M, as in the reference.
+ */
+void setHostDiracParam(DiracParam &diracParam)
+{
+  bool pc = (test_type != 2 && test_type != 4);
+  setDiracParam(diracParam, &inv_param, pc);
+  if (diracParam.matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) diracParam.matpcType = QUDA_MATPC_EVEN_EVEN;
+  if (diracParam.matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) diracParam.matpcType = QUDA_MATPC_ODD_ODD;
+  if (test_type == 3 || test_type == 4) diracParam.dagger = QUDA_DAG_NO;
+}
+
+/**
+   Apply the host Wilson operator DiracWilsonCpu with each
+   cpu_stencil_order.  Only the order in which the sites are visited
+   changes, so the results must be identical to the lexicographic
+   order.  Returns the number of orders that differ.
+ */
+int checkStencilOrders()
+{
+  if (dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("Stencil order check only supports the Wilson dslash\n");
+    return 0;
+  }
+
+  const QudaStencilOrder order[] = { QUDA_LEXICOGRAPHIC_STENCIL_ORDER, QUDA_MORTON_STENCIL_ORDER,
+				     QUDA_HILBERT_STENCIL_ORDER };
+  const char *name[] = { "lexicographic", "Morton", "Hilbert" };
+  const int n = sizeof(order) / sizeof(order[0]);
+
+  DiracParam diracParam;
+  setHostDiracParam(diracParam);
+  QudaStorageType storage = (inv_param.cpu_prec == QUDA_DOUBLE_PRECISION) ? QUDA_DOUBLE_STORAGE : QUDA_SINGLE_STORAGE;
+
+  cpuColorSpinorField *out[n];
+  for (int i=0; i<n; i++) {
+    DiracWilsonCpu host(diracParam, storage, QUDA_RECONSTRUCT_NO, false, order[i]);
+    out[i] = new cpuColorSpinorField(*spinorOut);
+    switch (test_type) {
+    case 0: host.Dslash(*out[i], *spinor, parity); break;
+    case 1:
+    case 2: host.M(*out[i], *spinor); break;
+    case 3:
+    case 4: host.MdagM(*out[i], *spinor); break;
+    }
+  }
+
+  int failures = 0;
+  for (int i=1; i<n; i++) {
+    bool same = (memcmp(out[i]->V(), out[0]->V(), out[0]->Bytes()) == 0);
+    double diff = xmyNormCpu(*out[0], *out[i]);
+    printfQuda("Host operator, %s order: %s the %s order (|difference|^2 = %e)\n",
+	       name[i], same ? "identical to" : "differs from", name[0], diff);
+    if (!same) failures++;
+  }
+  for (int i=0; i<n; i++) delete out[i];
+
+  return failures;
+}
+
+/**
+   Compare the host Wilson operator DiracWilsonCpu, built from the
+   host links, with the reference implementation for each storage
+   format, link reconstruction, site layout and stencil order.  The
+   native storages are applied to cpuColorSpinorFields, the half and
+   bfloat16 storages to raw vectors (M and MdagM only, since there is
+   no raw Dslash).  The virtual-node layout is only checked when every
+   local dimension is a multiple of 4, so that it can be split for any
+   vector width.  Returns the number of combinations whose relative
+   difference exceeds the tolerance of the storage precision.
+ */
+int checkHostReference()
+{
+  if (dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("Host reference check only supports the Wilson dslash\n");
+    return 0;
+  }
+  if (inv_param.cpu_prec != QUDA_DOUBLE_PRECISION) {
+    printfQuda("Host reference check requires double precision host fields\n");
+    return 0;
+  }
+
+  const QudaStorageType storage[] = { QUDA_DOUBLE_STORAGE, QUDA_SINGLE_STORAGE,
+				      QUDA_HALF_STORAGE, QUDA_BFLOAT16_STORAGE };
+  const char *storage_str[] = { "double", "single", "half", "bfloat16" };
+  const double tol[] = { 1e-10, 1e-5, 1e-3, 1e-2 };
+  const QudaReconstructType recon[] = { QUDA_RECONSTRUCT_NO, QUDA_RECONSTRUCT_12, QUDA_RECONSTRUCT_8 };
+  const QudaStencilOrder order[] = { QUDA_LEXICOGRAPHIC_STENCIL_ORDER, QUDA_MORTON_STENCIL_ORDER,
+				     QUDA_HILBERT_STENCIL_ORDER };
+  const char *order_str[] = { "lexicographic", "Morton", "Hilbert" };
+
+  bool vn_ok = true;
+  for (int d=0; d<4; d++) if (gauge_param.X[d] % 4 != 0) vn_ok = false;
+
+  GaugeFieldParam gParam(hostGauge, gauge_param);
+  cpuGaugeField gauge(gParam);
+
+  DiracParam diracParam;
+  setHostDiracParam(diracParam);
+
+  const int sites = spinor->Volume();
+  const int length = 24*sites;
+  const double *ref = (const double*)spinorRef->V();
+  double ref2 = 0.0;
+  for (int i=0; i<length; i++) ref2 += ref[i]*ref[i];
+
+  double *result = new double[length];
+  char *in = new char[length*sizeof(double)];
+  char *out = new char[length*sizeof(double)];
+
+  int failures = 0;
+  for (int s=0; s<4; s++) {
+    bool native = (storage[s] == QUDA_DOUBLE_STORAGE || storage[s] == QUDA_SINGLE_STORAGE);
+    if (!native && test_type == 0) continue;
+
+    for (int r=0; r<3; r++) {
+      for (int vn=0; vn<2; vn++) {
+	if (vn && (!native || recon[r] != QUDA_RECONSTRUCT_NO || !vn_ok)) continue;
+
+	for (int o=0; o<3; o++) {
+	  DiracWilsonCpu host(diracParam, gauge, storage[s], recon[r], vn, order[o]);
+
+	  if (native) {
+	    ColorSpinorParam param(*spinor);
+	    param.precision = host.Precision();
+	    param.create = QUDA_ZERO_FIELD_CREATE;
+	    cpuColorSpinorField x(param), y(param);
+	    encodeSites(x.V(), (const double*)spinor->V(), sites, storage[s]);
+	    switch (test_type) {
+	    case 0: host.Dslash(y, x, parity); break;
+	    case 1:
+	    case 2: host.M(y, x); break;
+	    case 3:
+	    case 4: host.MdagM(y, x); break;
+	    }
+	    decodeSites(result, y.V(), sites, storage[s]);
+	  } else {
+	    encodeSites(in, (const double*)spinor->V(), sites, storage[s]);
+	    if (test_type == 1 || test_type == 2) host.M(out, in);
+	    else host.MdagM(out, in);
+	    decodeSites(result, out, sites, storage[s]);
+	  }
+
+	  double diff2 = 0.0;
+	  for (int i=0; i<length; i++) diff2 += (result[i]-ref[i])*(result[i]-ref[i]);
+	  comm_allreduce(&diff2);
+	  double norm2 = ref2;
+	  comm_allreduce(&norm2);
+	  double rel = sqrt(diff2 / norm2);
+
+	  bool pass = (rel <= tol[s]);
+	  printfQuda("Host operator, %s storage, %s, %s, %s order: relative difference %e (tolerance %e) %s\n",
+		     storage_str[s], get_recon_str(recon[r]), vn ? "virtual node" : "site order",
+		     order_str[o], rel, tol[s], pass ? "PASSED" : "FAILED");
+	  if (!pass) failures++;
+	}
+      }
+    }
+  }
+
+  delete []out;
+  delete []in;
+  delete []result;
+
+  return failures;
+}
+
 void display_test_info()
 {
   printfQuda("running the following test:\n");
@@ -558,6 +734,15 @@ void display_test_info()
 
 extern void usage(char**);
 
+void usage_extra(char** argv )
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --stencil-orders                         # Check that the host Wilson operator gives identical results\n");
+  printfQuda("                                               with each cpu_stencil_order\n");
+  printfQuda("    --host-reference                         # Compare the host Wilson operator with the reference\n");
+  printfQuda("                                               for each storage, reconstruct, layout and order\n");
+}
+
 
 int main(int argc, char **argv)
 {
@@ -566,6 +751,16 @@ int main(int argc, char **argv)
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     }  
+
+    if (strcmp(argv[i], "--stencil-orders") == 0) {
+      check_stencil_orders = true;
+      continue;
+    }
+
+    if (strcmp(argv[i], "--host-reference") == 0) {
+      check_host_reference = true;
+      continue;
+    }
     
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
@@ -626,7 +821,14 @@ int main(int argc, char **argv)
     
     cpuColorSpinorField::Compare(*spinorRef, *spinorOut);
   }    
+
+  int failures = 0;
+  if (check_stencil_orders) failures += checkStencilOrders();
+  if (check_host_reference) failures += checkHostReference();
+
   end();
 
   finalizeComms();
+
+  return failures ? 1 : 0;
 }
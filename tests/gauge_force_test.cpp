@@ -21,6 +21,7 @@ extern int device;
 static QudaGaugeParam qudaGaugeParam;
 QudaGaugeFieldOrder gauge_order =  QUDA_QDP_GAUGE_ORDER;
 static int verify_results = 0;
+static int host_force = 0; // compute the force on the host threads
 extern int tdim;
 extern QudaPrecision prec;
 extern int xdim;
@@ -372,6 +373,7 @@ gauge_force_test(void)
   qudaGaugeParam.type = QUDA_WILSON_LINKS; // in this context, just means these are site links   
   
   qudaGaugeParam.gauge_order = gauge_order;
+  qudaGaugeParam.force_location = host_force ? QUDA_CPU_FIELD_LOCATION : QUDA_CUDA_FIELD_LOCATION;
   
   int gSize = qudaGaugeParam.cpu_prec;
     
@@ -673,6 +675,7 @@ usage_extra(char** argv )
   printf("    --gauge-order  <qdp/milc>                 # Gauge storing order in CPU\n");
   printf("    --attempts  <n>                           # Number of tests\n");
   printf("    --verify                                  # Verify the GPU results using CPU results\n");
+  printf("    --host                                    # Compute the force on the host threads\n");
   return ;
 }
 
@@ -719,6 +722,11 @@ main(int argc, char **argv)
 	verify_results=1;
 	continue;	    
       }	
+
+      if( strcmp(argv[i], "--host") == 0){
+	host_force=1;
+	continue;
+      }
       
       fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
       usage(argv);
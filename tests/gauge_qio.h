@@ -1,12 +1,18 @@
 #ifndef _GAUGE_QIO_H
 #define _GAUGE_QIO_H
 
+#include <quda.h>
+
 #ifdef HAVE_QIO
 void read_gauge_field(char *filename, void *gauge[], QudaPrecision prec, int *X, int argc, char *argv[]);
 #else
+// without QIO, use the native NERSC / MILC / ILDG reader of the library
 void read_gauge_field(char *filename, void *gauge[], QudaPrecision prec, int *X, int argc, char *argv[]) {
-  printf("QIO support has not been enabled\n");
-  exit(-1);
+  QudaGaugeParam param = newQudaGaugeParam();
+  param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  param.cpu_prec = prec;
+  for (int d=0; d<4; d++) param.X[d] = X[d];
+  readGaugeFileQuda(gauge, filename, &param);
 }
 #endif
 
@@ -44,6 +44,7 @@ cpuGaugeField *cpuLongLinkOprod = NULL;
 cudaGaugeField *cudaLongLinkOprod = NULL;
 
 int verify_results = 1;
+static int host_force = 0;
 int ODD_BIT = 1;
 extern int xdim, ydim, zdim, tdim;
 extern int gridsize_from_cmdline[];
@@ -526,6 +527,77 @@ hisq_force_end()
   return;
 }
 
+// run the host force pipeline on the same fields and check it against the reference
+static int
+hisq_force_host(const double *act_path_coeff)
+{
+  GaugeFieldParam hParam = gParam;
+  hParam.link_type = QUDA_GENERAL_LINKS;
+  hParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  hParam.order = gauge_order;
+  hParam.pad = 0;
+  hParam.create = QUDA_ZERO_FIELD_CREATE;
+
+  int res = 1;
+#ifndef MULTI_GPU
+  // the outer products from the first colour vector of each half-Wilson vector
+  void *quark = malloc(cpuGauge->Volume()*6*hw_prec);
+  for(int i=0; i<cpuGauge->Volume(); i++){
+    memcpy((char*)quark + i*6*hw_prec, (char*)hw + i*hwSiteSize*hw_prec, 6*hw_prec);
+  }
+  const double one = 1.0;
+  cpuGaugeField hostOprod(hParam);
+  cpuGaugeField hostLongOprod(hParam);
+  fermion_force::hisqOuterProductCpu(&quark, &one, 1, qudaGaugeParam, hostOprod, &hostLongOprod);
+  const int nField = (gauge_order == QUDA_QDP_GAUGE_ORDER) ? 4 : 1;
+  for(int dir=0; dir<nField; dir++){
+    const int len = (4/nField)*cpuGauge->Volume()*gaugeSiteSize;
+    if(gauge_order == QUDA_QDP_GAUGE_ORDER){
+      res &= compare_floats(((void**)hostOprod.Gauge_p())[dir], ((void**)cpuOprod->Gauge_p())[dir], len, 1e-10, hw_prec);
+      res &= compare_floats(((void**)hostLongOprod.Gauge_p())[dir], ((void**)cpuLongLinkOprod->Gauge_p())[dir], len, 1e-10, hw_prec);
+    }else{
+      res &= compare_floats(hostOprod.Gauge_p(), cpuOprod->Gauge_p(), len, 1e-10, hw_prec);
+      res &= compare_floats(hostLongOprod.Gauge_p(), cpuLongLinkOprod->Gauge_p(), len, 1e-10, hw_prec);
+    }
+  }
+  printfQuda("Host outer product %s\n", res ? "PASSED" : "FAILED");
+  free(quark);
+#endif
+
+#ifdef MULTI_GPU
+  GaugeFieldParam fParam = gParam_ex;
+  fParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  fParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField *oprod = cpuOprod_ex, *longOprod = cpuLongLinkOprod_ex, *link = cpuGauge_ex;
+#else
+  GaugeFieldParam fParam = hParam;
+  cpuGaugeField *oprod = cpuOprod, *longOprod = cpuLongLinkOprod, *link = cpuGauge;
+#endif
+  cpuGaugeField hostForce(fParam);
+
+  GaugeFieldParam mParam = gParam;
+  mParam.reconstruct = QUDA_RECONSTRUCT_10;
+  mParam.link_type = QUDA_ASQTAD_MOM_LINKS;
+  mParam.order = QUDA_MILC_GAUGE_ORDER;
+  mParam.pad = 0;
+  mParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuGaugeField hostMom(mParam);
+
+  struct timeval t0, t1;
+  gettimeofday(&t0, NULL);
+  fermion_force::hisqStaplesForceCpu(act_path_coeff, qudaGaugeParam, *oprod, *link, &hostForce);
+  fermion_force::hisqLongLinkForceCpu(act_path_coeff[1], qudaGaugeParam, *longOprod, *link, &hostForce);
+  fermion_force::hisqCompleteForceCpu(qudaGaugeParam, hostForce, *link, &hostMom);
+  gettimeofday(&t1, NULL);
+
+  int mom_res = compare_floats(hostMom.Gauge_p(), refMom->Gauge_p(), 4*hostMom.Volume()*momSiteSize, 1e-10,
+			       qudaGaugeParam.cpu_prec);
+  printfQuda("Host force %s\n", mom_res ? "PASSED" : "FAILED");
+  printfQuda("Host force time : %g ms\n", TDIFF(t0, t1)*1000);
+
+  return res & mom_res;
+}
+
 static int 
 hisq_force_test(void)
 {
@@ -689,6 +761,8 @@ hisq_force_test(void)
   printfQuda("Staples time : %g ms\t LongLink time : %g ms\t Completion time : %g ms\n", TDIFF(t0,t1)*1000, TDIFF(t1,t2)*1000, TDIFF(t2,t3)*1000);
   printfQuda("Host time (half-wilson fermion force) : %g ms\n", TDIFF(ht0, ht1)*1000);
 
+  if (host_force && verify_results && !hisq_force_host(d_act_path_coeff)) accuracy_level = 0;
+
   hisq_force_end();
 
   return accuracy_level;
@@ -715,6 +789,7 @@ usage_extra(char** argv )
 {
   printfQuda("Extra options: \n");
   printfQuda("    --no_verify                                  # Do not verify the GPU results using CPU results\n");
+  printfQuda("    --host                                       # Also compute the force on the host and verify it\n");
   return ;
 }
 int 
@@ -748,6 +823,11 @@ main(int argc, char **argv)
       verify_results=0;
       continue;	    
     }	
+
+    if( strcmp(argv[i], "--host") == 0){
+      host_force=1;
+      continue;
+    }
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -3,6 +3,10 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <glob.h>
 
 #include <util_quda.h>
 #include <test_util.h>
@@ -13,6 +17,7 @@
 #include "misc.h"
 
 #include "face_quda.h"
+#include <comm_quda.h>
 
 #if defined(QMP_COMMS)
 #include <qmp.h>
@@ -26,6 +31,7 @@
 
 // In a typical application, quda.h is the only QUDA header required.
 #include <quda.h>
+#include <quda_new_interace.h> // the field handles, for --field-api
 
 // Wilson, clover-improved Wilson, twisted mass, and domain wall are supported.
 extern QudaDslashType dslash_type;
@@ -46,6 +52,670 @@ extern char latfile[];
 
 extern void usage(char** );
 
+static const char *prop_file = 0; // --write-prop: propagator file for the round-trip check
+static int multi_shift = 0; // whether to test multi-shift or standard solver
+static QudaInverterType inv_type = QUDA_INVALID_INVERTER; // --inv-type: overrides the default solver
+static int checkpoint_interval = 0; // --checkpoint: interval of the checkpoint/resume check
+static bool field_api = false; // --field-api: check the field handles against the pointer calls
+static bool async = false; // --async: check the queued solves against the synchronous one
+static bool host_solver = false; // --host-solver: check the host CG and multi-shift CG
+static bool host_schwarz = false; // --host-schwarz: check GCR with the host Schwarz preconditioner
+static bool chrono = false; // --chrono: check the solves with a chronological history
+static bool adaptive = false; // --adaptive: check the adaptive reliable updates of CG
+static const char checkpoint_prefix[] = "invert_test_checkpoint";
+
+// the zlib crc32, as used by the SciDAC checksum
+static unsigned int crc32(const unsigned char *buf, size_t len)
+{
+  static unsigned int table[256];
+  static bool init = false;
+  if (!init) {
+    for (unsigned int n=0; n<256; n++) {
+      unsigned int c = n;
+      for (int k=0; k<8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[n] = c;
+    }
+    init = true;
+  }
+  unsigned int c = 0xffffffffu;
+  for (size_t i=0; i<len; i++) c = table[(c ^ buf[i]) & 0xff] ^ (c >> 8);
+  return c ^ 0xffffffffu;
+}
+
+static unsigned long long readBE(const unsigned char *p, int bytes)
+{
+  unsigned long long v = 0;
+  for (int i=0; i<bytes; i++) v = (v << 8) | p[i];
+  return v;
+}
+
+static unsigned int rotl(unsigned int w, int n) { return n ? (w << n) | (w >> (32-n)) : w; }
+
+// number of checkpoint files of this rank
+static int countCheckpoints()
+{
+  char pattern[256];
+  sprintf(pattern, "%s.*.%d", checkpoint_prefix, comm_rank());
+  glob_t g;
+  int n = 0;
+  if (glob(pattern, 0, 0, &g) == 0) n = g.gl_pathc;
+  globfree(&g);
+  return n;
+}
+
+/**
+   Cut the solve off at half of its iterations with checkpoints
+   enabled, rerun it, and check that the cut-off solve left a
+   checkpoint, that the completed solve removed it, and that the
+   resumed solutions agree with the reference solutions of the
+   uninterrupted solve.  Returns the number of failures.
+ */
+static int checkResume(const QudaInvertParam &inv_param, void *spinorIn, void **reference,
+		       int n, int len)
+{
+  QudaInvertParam param = inv_param;
+  param.checkpoint_interval = checkpoint_interval;
+  param.maxiter = inv_param.iter / 2;
+  if (param.maxiter <= checkpoint_interval) {
+    printfQuda("Checkpoint interval %d too large for a solve of %d iterations\n", checkpoint_interval, inv_param.iter);
+    return 1;
+  }
+  setCheckpointQuda(checkpoint_prefix);
+
+  size_t bytes = len*(inv_param.cpu_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  void **x = (void**)malloc(n*sizeof(void*));
+  for (int i=0; i<n; i++) x[i] = calloc(bytes, 1);
+
+  int failures = 0;
+  for (int pass=0; pass<2; pass++) {
+    for (int i=0; i<n; i++) memset(x[i], 0, bytes); // the same initial guess, so the solve is recognized
+    if (multi_shift) invertMultiShiftQuda(x, spinorIn, &param);
+    else invertQuda(x[0], spinorIn, &param);
+
+    int files = countCheckpoints();
+#ifdef MULTI_GPU
+    comm_allreduce_int(&files);
+#endif
+    if (pass == 0 && files == 0) {
+      printfQuda("The solve cut off at %d iterations left no checkpoint\n", param.maxiter);
+      failures++;
+    } else if (pass == 1 && files != 0) {
+      printfQuda("The resumed solve did not remove its checkpoint\n");
+      failures++;
+    }
+    param.maxiter = inv_param.maxiter;
+  }
+
+  for (int i=0; i<n; i++) {
+    mxpy(reference[i], x[i], len, inv_param.cpu_prec);
+    double diff = sqrt(norm_2(x[i], len, inv_param.cpu_prec) / norm_2(reference[i], len, inv_param.cpu_prec));
+    printfQuda("Resumed solution %d: %d iterations, |x - x_ref| / |x_ref| = %e\n", i, param.iter, diff);
+    if (diff > sqrt(inv_param.tol)) failures++;
+    free(x[i]);
+  }
+  free(x);
+
+  return failures;
+}
+
+// tolerance on the agreement of operator results computed at the device precision
+static double fieldTol(QudaPrecision prec)
+{
+  return prec == QUDA_DOUBLE_PRECISION ? 1e-10 : (prec == QUDA_SINGLE_PRECISION ? 1e-5 : 1e-2);
+}
+
+// |x - scale*ref| / |scale*ref|
+static double relDiff(void *x, void *ref, double scale, int len, QudaPrecision prec)
+{
+  size_t bytes = len*(prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  void *tmp = malloc(bytes);
+  memcpy(tmp, ref, bytes);
+  ax(scale, tmp, len, prec);
+  double nref = norm_2(tmp, len, prec);
+  mxpy(x, tmp, len, prec);
+  double diff = sqrt(norm_2(tmp, len, prec) / nref);
+  free(tmp);
+  return diff;
+}
+
+/**
+   Apply M and MdagM, for each mass normalization, and solve through
+   three paths: the pointer calls (MatQuda, MatDagMatQuda and the
+   reference solution x_ref of invertQuda), wrapped host fields, and
+   fields owned by the library on the device in the internal layout,
+   which the operators and the solver use in place.  A device input
+   with a host output and the converse are applied too.  The results
+   must agree, and the operators must scale with the normalization as
+   the even/odd preconditioned or full operator should.  Returns the
+   number of failures.
+ */
+static int checkFieldApi(const QudaInvertParam &inv_param, void *spinorIn, void *x_ref, const int *X)
+{
+  const bool pc = (inv_param.solution_type == QUDA_MATPC_SOLUTION ||
+		   inv_param.solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  const int len = (pc ? Vh : V)*spinorSiteSize*inv_param.Ls;
+  const QudaPrecision prec = inv_param.cpu_prec;
+  const size_t bytes = len*(prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+
+  QUDA_DiracFieldParam hostParam = QUDA_newDiracFieldParam();
+  for (int d=0; d<4; d++) hostParam.X[d] = X[d];
+  hostParam.Ls = inv_param.Ls;
+  hostParam.twist_flavor = inv_param.twist_flavor;
+  hostParam.precision = prec;
+  hostParam.location = QUDA_CPU_FIELD_LOCATION;
+  hostParam.site_subset = pc ? QUDA_PARITY_SITE_SUBSET : QUDA_FULL_SITE_SUBSET;
+  hostParam.dirac_order = inv_param.dirac_order;
+  hostParam.gamma_basis = inv_param.gamma_basis;
+
+  QUDA_DiracFieldParam devParam = hostParam;
+  devParam.pad = inv_param.sp_pad;
+  devParam.precision = inv_param.cuda_prec;
+  devParam.location = QUDA_CUDA_FIELD_LOCATION;
+  devParam.dirac_order = QUDA_INTERNAL_DIRAC_ORDER;
+  devParam.gamma_basis = QUDA_UKQCD_GAMMA_BASIS;
+
+  void *ref = malloc(bytes), *kappa_ref = malloc(bytes), *out = malloc(bytes);
+  QUDA_DiracField *hIn = QUDA_wrapDiracField(x_ref, &hostParam); // the solution is nonzero on every site
+  QUDA_DiracField *hOut = QUDA_wrapDiracField(out, &hostParam);
+  QUDA_DiracField *dIn = QUDA_createDiracField(&devParam);
+  QUDA_DiracField *dOut = QUDA_createDiracField(&devParam);
+  QUDA_copyDiracField(dIn, hIn);
+
+  const double tol = fieldTol(inv_param.cuda_prec);
+  const double kappa = inv_param.kappa;
+  const QudaMassNormalization norms[] =
+    { QUDA_KAPPA_NORMALIZATION, QUDA_MASS_NORMALIZATION, QUDA_ASYMMETRIC_MASS_NORMALIZATION };
+  const char *paths[] = { "wrapped host", "device", "device in, host out", "host in, device out" };
+
+  int failures = 0;
+  for (int normal=0; normal<2; normal++) {
+    for (int n=0; n<3; n++) {
+      QudaInvertParam param = inv_param;
+      param.mass_normalization = norms[n];
+
+      // the operators relative to the kappa normalization
+      double scale = 1.0;
+      if (norms[n] == QUDA_MASS_NORMALIZATION && pc) scale = normal ? 1.0/pow(2.0*kappa,4) : 0.25/(kappa*kappa);
+      else if (norms[n] != QUDA_KAPPA_NORMALIZATION) scale = normal ? 0.25/(kappa*kappa) : 0.5/kappa;
+
+      if (normal) MatDagMatQuda(ref, x_ref, &param);
+      else MatQuda(ref, x_ref, &param);
+      if (n == 0) memcpy(kappa_ref, ref, bytes);
+
+      double diff = relDiff(ref, kappa_ref, scale, len, prec);
+      printfQuda("%s, mass normalization %d: pointers, |out - s*out_kappa| / |s*out_kappa| = %e\n",
+		 normal ? "MdagM" : "M", norms[n], diff);
+      if (diff > tol) failures++;
+
+      for (int path=0; path<4; path++) {
+	memset(out, 0, bytes);
+	QUDA_DiracField *o = (path == 1 || path == 3) ? dOut : hOut;
+	QUDA_DiracField *i = (path == 1 || path == 2) ? dIn : hIn;
+	if (normal) QUDA_MatDagMatDiracField(o, i, &param);
+	else QUDA_MatDiracField(o, i, &param);
+	if (o == dOut) QUDA_copyDiracField(hOut, dOut);
+
+	diff = relDiff(out, ref, 1.0, len, prec);
+	printfQuda("%s, mass normalization %d: %s, |out - out_ptr| / |out_ptr| = %e\n",
+		   normal ? "MdagM" : "M", norms[n], paths[path], diff);
+	if (diff > tol) failures++;
+      }
+    }
+  }
+
+  // the solves, from the original source
+  QUDA_DiracField *hB = QUDA_wrapDiracField(spinorIn, &hostParam);
+  for (int path=0; path<2; path++) {
+    QudaInvertParam param = inv_param;
+    memset(out, 0, bytes);
+    if (path == 0) {
+      QUDA_invertDiracField(hOut, hB, &param);
+    } else {
+      QUDA_copyDiracField(dIn, hB);
+      QUDA_invertDiracField(dOut, dIn, &param);
+      QUDA_copyDiracField(hOut, dOut);
+    }
+    double diff = relDiff(out, x_ref, 1.0, len, prec);
+    printfQuda("Solve: %s, %d iterations, |x - x_ptr| / |x_ptr| = %e\n", paths[path], param.iter, diff);
+    if (diff > sqrt(inv_param.tol)) failures++;
+  }
+
+  QUDA_destroyDiracField(hB);
+  QUDA_destroyDiracField(dOut);
+  QUDA_destroyDiracField(dIn);
+  QUDA_destroyDiracField(hOut);
+  QUDA_destroyDiracField(hIn);
+  free(out);
+  free(kappa_ref);
+  free(ref);
+
+  return failures;
+}
+
+/**
+   Queue two solves of the source with invertQudaAsync, each into its
+   own solution with its own copy of the parameters, poll them with
+   invertQudaTest until both have completed, and check that they
+   completed in order and that their solutions and residuals match
+   those of the synchronous solve (x_ref and the outputs of
+   inv_param).  Returns the number of failures.
+ */
+static int checkAsync(const QudaInvertParam &inv_param, void *spinorIn, void *x_ref, int len)
+{
+  const QudaPrecision prec = inv_param.cpu_prec;
+  const size_t bytes = len*(prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+
+  QudaInvertParam param[2];
+  void *x[2];
+  QudaInvertHandle handle[2];
+  for (int i=0; i<2; i++) {
+    param[i] = inv_param;
+    x[i] = calloc(bytes, 1);
+    handle[i] = invertQudaAsync(x[i], spinorIn, &param[i]);
+  }
+
+  int failures = 0;
+  int done[2] = {0, 0};
+  long polls = 0;
+  while (!done[0] || !done[1]) {
+    usleep(1000); // the application would work here
+    done[1] = invertQudaTest(handle[1]);
+    done[0] = invertQudaTest(handle[0]);
+    if (done[1] && !done[0]) {
+      printfQuda("The second queued solve completed before the first\n");
+      failures++;
+      break;
+    }
+    polls++;
+  }
+  for (int i=0; i<2; i++) invertQudaWait(handle[i]);
+  printfQuda("Queued solves completed after %ld polls\n", polls);
+
+  for (int i=0; i<2; i++) {
+    double diff = relDiff(x[i], x_ref, 1.0, len, prec);
+    printfQuda("Queued solve %d: %d iterations, true residual %e (synchronous %e), |x - x_sync| / |x_sync| = %e\n",
+	       i, param[i].iter, param[i].true_res, inv_param.true_res, diff);
+    if (diff > sqrt(inv_param.tol)) failures++;
+    if (fabs(param[i].true_res - inv_param.true_res) > 0.1*inv_param.true_res) failures++;
+    free(x[i]);
+  }
+
+  return failures;
+}
+
+/**
+   The true residual |(M^dag M + offset) x - b| / |b| of a solution of
+   the preconditioned normal equations, or |M x - b| / |b| of the
+   preconditioned system (normal = false), recomputed with the
+   reference Wilson operator.
+ */
+static double trueResidual(void *x, void *b, bool normal, double offset, void **gauge,
+			   QudaGaugeParam &gauge_param, const QudaInvertParam &param)
+{
+  const int len = Vh*spinorSiteSize;
+  const size_t bytes = len*(param.cpu_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  void *tmp = malloc(bytes);
+  void *r = malloc(bytes);
+
+  if (normal) {
+    wil_matpc(tmp, gauge, x, param.kappa, param.matpc_type, 0, param.cpu_prec, gauge_param);
+    wil_matpc(r, gauge, tmp, param.kappa, param.matpc_type, 1, param.cpu_prec, gauge_param);
+    axpy(offset, x, r, len, param.cpu_prec);
+  } else {
+    wil_matpc(r, gauge, x, param.kappa, param.matpc_type, 0, param.cpu_prec, gauge_param);
+  }
+  mxpy(b, r, len, param.cpu_prec);
+  double l2r = sqrt(norm_2(r, len, param.cpu_prec) / norm_2(b, len, param.cpu_prec));
+
+  free(r);
+  free(tmp);
+  return l2r;
+}
+
+/**
+   Solve the preconditioned normal equations with the host solver
+   (solver_location = QUDA_CPU_FIELD_LOCATION, Wilson only) and check
+   that the true residual, recomputed with the reference operator,
+   meets the tolerance.  The mixed-precision CG is run for each
+   storage format of the sloppy vectors and each link compression of
+   the sloppy operator; the multi-shift CG checks every shift.
+   Returns the number of failures.
+ */
+static int checkHostSolver(const QudaInvertParam &inv_param, void *spinorIn, void **gauge,
+			   QudaGaugeParam &gauge_param)
+{
+  if (inv_param.dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("Host solver only supports the Wilson dslash\n");
+    return 0;
+  }
+
+  QudaInvertParam param = inv_param;
+  param.solver_location = QUDA_CPU_FIELD_LOCATION;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  param.solution_type = QUDA_MATPCDAG_MATPC_SOLUTION;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+
+  const int len = Vh*spinorSiteSize;
+  const size_t bytes = len*(param.cpu_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  // the residual is recomputed in the precision of the solver, so only rounding separates it from the tolerance
+  const double slack = 1.01;
+
+  int failures = 0;
+
+  if (multi_shift) {
+    void *x[QUDA_MAX_MULTI_SHIFT];
+    for (int i=0; i<param.num_offset; i++) x[i] = calloc(bytes, 1);
+    invertMultiShiftQuda(x, spinorIn, &param);
+    for (int i=0; i<param.num_offset; i++) {
+      double l2r = trueResidual(x[i], spinorIn, true, param.offset[i], gauge, gauge_param, param);
+      bool pass = (l2r <= slack*param.tol_offset[i]);
+      printfQuda("Host multi-shift CG, shift %d: %d iterations, true residual %e, host %e (tolerance %e) %s\n",
+		 i, param.iter, param.true_res_offset[i], l2r, param.tol_offset[i], pass ? "PASSED" : "FAILED");
+      if (!pass) failures++;
+      free(x[i]);
+    }
+    return failures;
+  }
+
+  const QudaStorageType storage[] = { QUDA_DOUBLE_STORAGE, QUDA_SINGLE_STORAGE,
+				      QUDA_HALF_STORAGE, QUDA_BFLOAT16_STORAGE };
+  const char *storage_str[] = { "double", "single", "half", "bfloat16" };
+  const QudaReconstructType recon[] = { QUDA_RECONSTRUCT_NO, QUDA_RECONSTRUCT_12, QUDA_RECONSTRUCT_8 };
+
+  void *x = malloc(bytes);
+  for (int s=0; s<4; s++) {
+    for (int r=0; r<3; r++) {
+      param.cpu_storage_sloppy = storage[s];
+      param.cpu_reconstruct_sloppy = recon[r];
+      memset(x, 0, bytes);
+      invertQuda(x, spinorIn, &param);
+      double l2r = trueResidual(x, spinorIn, true, 0.0, gauge, gauge_param, param);
+      bool pass = (l2r <= slack*param.tol);
+      printfQuda("Host CG, %s sloppy storage, sloppy %s: %d iterations, true residual %e, host %e (tolerance %e) %s\n",
+		 storage_str[s], get_recon_str(recon[r]), param.iter, param.true_res, l2r, param.tol,
+		 pass ? "PASSED" : "FAILED");
+      if (!pass) failures++;
+    }
+  }
+  free(x);
+
+  return failures;
+}
+
+// the residual a device solve can be held to: the tolerance, unless the outer precision cannot resolve it
+static double deviceTol(const QudaInvertParam &param)
+{
+  return MAX(param.tol, fieldTol(param.cuda_prec));
+}
+
+/**
+   Solve with GCR preconditioned by the Schwarz MR block solver run on
+   the host threads (schwarz_location = QUDA_CPU_FIELD_LOCATION), with
+   additive and multiplicative Schwarz, and check that the true
+   residual meets the tolerance.  Returns the number of failures.
+ */
+static int checkHostSchwarz(const QudaInvertParam &inv_param, void *spinorIn, void **gauge,
+			    QudaGaugeParam &gauge_param)
+{
+  if (inv_param.dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("Host Schwarz preconditioner only supports the Wilson dslash\n");
+    return 0;
+  }
+
+  QudaInvertParam param = inv_param;
+  param.inv_type = QUDA_GCR_INVERTER;
+  param.solve_type = QUDA_DIRECT_PC_SOLVE;
+  param.solution_type = QUDA_MATPC_SOLUTION;
+  param.inv_type_precondition = QUDA_MR_INVERTER;
+  param.schwarz_location = QUDA_CPU_FIELD_LOCATION;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.tol = deviceTol(inv_param);
+
+  const QudaSchwarzType schwarz[] = { QUDA_ADDITIVE_SCHWARZ, QUDA_MULTIPLICATIVE_SCHWARZ };
+  const char *schwarz_str[] = { "additive", "multiplicative" };
+
+  const size_t bytes = Vh*spinorSiteSize*(param.cpu_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  void *x = malloc(bytes);
+
+  int failures = 0;
+  for (int i=0; i<2; i++) {
+    param.schwarz_type = schwarz[i];
+    memset(x, 0, bytes);
+    invertQuda(x, spinorIn, &param);
+    double l2r = trueResidual(x, spinorIn, false, 0.0, gauge, gauge_param, param);
+    bool pass = (l2r <= 1.1*param.tol);
+    printfQuda("GCR with host %s Schwarz: %d iterations, true residual %e, host %e (tolerance %e) %s\n",
+	       schwarz_str[i], param.iter, param.true_res, l2r, param.tol, pass ? "PASSED" : "FAILED");
+    if (!pass) failures++;
+  }
+  free(x);
+
+  return failures;
+}
+
+/**
+   Run a sequence of CG solves sharing a chronological history of
+   chrono_max_dim = 3 solutions, on perturbations of the source and
+   then on the first source again, and one more so that the oldest
+   solution is dropped.  Checks that every solve meets the tolerance,
+   and that the repeated source, whose solution is in the history,
+   takes fewer iterations than its first solve.  Returns the number of
+   failures.
+ */
+static int checkChrono(const QudaInvertParam &inv_param, void *spinorIn, void **gauge,
+		       QudaGaugeParam &gauge_param)
+{
+  if (inv_param.dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("Chronological forecasting check only supports the Wilson dslash\n");
+    return 0;
+  }
+
+  QudaInvertParam param = inv_param;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  param.solution_type = QUDA_MATPCDAG_MATPC_SOLUTION;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+  param.tol = deviceTol(inv_param);
+  param.chrono_max_dim = 3;
+  param.chrono_index = 1; // a channel of its own
+
+  const int len = Vh*spinorSiteSize;
+  const size_t bytes = len*(param.cpu_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+
+  // the sources: the test source, three perturbations of it, and the test source again
+  const int n = 5;
+  const int source[n] = { 0, 1, 2, 0, 3 };
+  void *b[4];
+  for (int i=0; i<4; i++) {
+    b[i] = malloc(bytes);
+    memcpy(b[i], spinorIn, bytes);
+    if (i == 0) continue;
+    for (int j=0; j<len; j++) {
+      double r = 0.1 * (rand() / (double)RAND_MAX - 0.5);
+      if (param.cpu_prec == QUDA_DOUBLE_PRECISION) ((double*)b[i])[j] += r;
+      else ((float*)b[i])[j] += r;
+    }
+  }
+
+  void *x = malloc(bytes);
+  int iter[n];
+  int failures = 0;
+  for (int k=0; k<n; k++) {
+    memset(x, 0, bytes);
+    invertQuda(x, b[source[k]], &param);
+    iter[k] = param.iter;
+    double l2r = trueResidual(x, b[source[k]], true, 0.0, gauge, gauge_param, param);
+    bool pass = (l2r <= 1.1*param.tol);
+    printfQuda("Chronological solve %d (source %d): %d iterations, true residual %e, host %e (tolerance %e) %s\n",
+	       k, source[k], iter[k], param.true_res, l2r, param.tol, pass ? "PASSED" : "FAILED");
+    if (!pass) failures++;
+  }
+  if (iter[3] >= iter[0]) {
+    printfQuda("The forecast of a source in the history did not reduce the iterations (%d, first solve %d)\n",
+	       iter[3], iter[0]);
+    failures++;
+  }
+  flushChronoQuda(param.chrono_index);
+
+  free(x);
+  for (int i=0; i<4; i++) free(b[i]);
+
+  return failures;
+}
+
+/**
+   Solve with the adaptive reliable updates of CG (reliable_drift > 0)
+   for a loose, a tight and a vanishing drift tolerance, the last two
+   forcing more frequent reliable updates and the promotion of the
+   sloppy precision, and check that each solve meets the tolerance.
+   Returns the number of failures.
+ */
+static int checkAdaptive(const QudaInvertParam &inv_param, void *spinorIn, void **gauge,
+			 QudaGaugeParam &gauge_param)
+{
+  if (inv_param.dslash_type != QUDA_WILSON_DSLASH) {
+    printfQuda("Adaptive reliable update check only supports the Wilson dslash\n");
+    return 0;
+  }
+  if (inv_param.cuda_prec_sloppy == inv_param.cuda_prec)
+    printfQuda("The sloppy precision equals the precision, the reliable updates will not adapt\n");
+
+  QudaInvertParam param = inv_param;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  param.solution_type = QUDA_MATPCDAG_MATPC_SOLUTION;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.tol = deviceTol(inv_param);
+
+  const double drift[] = { 1e-2, 1e-6, 1e-14 };
+  const size_t bytes = Vh*spinorSiteSize*(param.cpu_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  void *x = malloc(bytes);
+
+  int failures = 0;
+  for (int i=0; i<3; i++) {
+    param.reliable_drift = drift[i];
+    memset(x, 0, bytes);
+    invertQuda(x, spinorIn, &param);
+    double l2r = trueResidual(x, spinorIn, true, 0.0, gauge, gauge_param, param);
+    bool pass = (l2r <= 1.1*param.tol);
+    printfQuda("Adaptive CG, drift %e: %d iterations, true residual %e, host %e (tolerance %e) %s\n",
+	       drift[i], param.iter, param.true_res, l2r, param.tol, pass ? "PASSED" : "FAILED");
+    if (!pass) failures++;
+  }
+  free(x);
+
+  return failures;
+}
+
+/**
+   Read back the first record of a SciDAC propagator file written by
+   writeSpinorQuda, and check the local sites against the host field
+   v (QUDA_DIRAC_ORDER) and the whole record against its checksum.
+   Returns the number of failures over all the ranks.
+ */
+static int checkSpinorFile(const char *filename, const void *v, QudaPrecision prec, const int *X)
+{
+  int failures = 0;
+  unsigned char *file = 0;
+  long size = 0;
+
+  FILE *f = fopen(filename, "rb");
+  if (f) {
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    file = (unsigned char*)malloc(size);
+    if (fread(file, 1, size, f) != (size_t)size) size = 0;
+    fclose(f);
+  }
+
+  // walk the LIME records to the binary data and its checksum
+  const unsigned char *data = 0;
+  unsigned long long data_bytes = 0;
+  unsigned int suma = 0, sumb = 0;
+  bool have_sum = false;
+  for (long o=0; o+144 <= size && !have_sum; ) {
+    const unsigned char *h = file + o;
+    if (readBE(h, 4) != 0x456789ab) break;
+    const unsigned long long length = readBE(h + 8, 8);
+    const char *type = (const char*)h + 16;
+    if (!strcmp(type, "scidac-binary-data")) {
+      data = h + 144;
+      data_bytes = length;
+    } else if (!strcmp(type, "scidac-checksum") && data) {
+      std::string xml((const char*)h + 144, length);
+      const size_t a = xml.find("<suma>"), b = xml.find("<sumb>");
+      if (a != std::string::npos && b != std::string::npos) {
+	suma = strtoul(xml.c_str() + a + 6, 0, 16);
+	sumb = strtoul(xml.c_str() + b + 6, 0, 16);
+	have_sum = true;
+      }
+    }
+    o += 144 + (length + 7) / 8 * 8;
+  }
+
+  int dims[4], offset[4];
+  size_t global = 1;
+  for (int d=0; d<4; d++) {
+    dims[d] = X[d]*comm_dim(d);
+    offset[d] = X[d]*comm_coord(d);
+    global *= dims[d];
+  }
+  const size_t site_bytes = 24*prec;
+
+  if (!have_sum || data_bytes != global*site_bytes) {
+    printfQuda("%s: missing or malformed propagator record\n", filename);
+    failures = 1;
+  } else {
+    unsigned int sum[2] = { 0, 0 };
+    for (size_t r=0; r<global; r++) {
+      const unsigned int crc = crc32(data + r*site_bytes, site_bytes);
+      sum[0] ^= rotl(crc, r % 29);
+      sum[1] ^= rotl(crc, r % 31);
+    }
+    if (sum[0] != suma || sum[1] != sumb) {
+      printfQuda("%s: checksum %08x %08x does not match the record %08x %08x\n",
+		 filename, sum[0], sum[1], suma, sumb);
+      failures++;
+    }
+
+    // the file is in global lexicographic site order, [spin][color][complex], big-endian
+    for (int s=0; s<V; s++) {
+      int x[4], c = s;
+      for (int d=0; d<4; d++) { x[d] = c % X[d]; c /= X[d]; }
+      size_t r = 0;
+      for (int d=3; d>=0; d--) r = r*dims[d] + x[d] + offset[d];
+      const int idx = ((x[0] + x[1] + x[2] + x[3]) & 1)*Vh + s/2;
+
+      for (int i=0; i<24; i++) {
+	const unsigned char *p = data + r*site_bytes + i*prec;
+	bool same;
+	if (prec == QUDA_DOUBLE_PRECISION) {
+	  unsigned long long u = readBE(p, 8);
+	  double w;
+	  memcpy(&w, &u, sizeof(w));
+	  same = (w == ((const double*)v)[idx*24 + i]);
+	} else {
+	  unsigned int u = readBE(p, 4);
+	  float w;
+	  memcpy(&w, &u, sizeof(w));
+	  same = (w == ((const float*)v)[idx*24 + i]);
+	}
+	if (!same) { failures++; break; }
+      }
+    }
+  }
+
+  free(file);
+#ifdef MULTI_GPU
+  comm_allreduce_int(&failures);
+#endif
+  return failures;
+}
+
 void
 display_test_info()
 {
@@ -68,6 +738,31 @@ display_test_info()
   
 }
 
+void
+usage_extra(char** argv )
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --write-prop <file>                      # Write a random propagator to file, read it back and check it\n");
+  printfQuda("    --inv-type <cg/bicgstab/gcr>             # Solver (default BiCGstab for Wilson and clover, CG otherwise)\n");
+  printfQuda("    --multi-shift                            # Test the multi-shift CG solver\n");
+  printfQuda("    --checkpoint <n>                         # Cut the solve off, resume it from checkpoints every n iterations\n");
+  printfQuda("                                               and check it against the uninterrupted solve\n");
+  printfQuda("    --field-api                              # Apply the operators and solve through the field handles,\n");
+  printfQuda("                                               host and device, and check them against the pointer calls\n");
+  printfQuda("    --async                                  # Queue two solves, poll them and check them against the\n");
+  printfQuda("                                               synchronous solve\n");
+  printfQuda("    --host-solver                            # Solve on the host threads, for each sloppy storage and\n");
+  printfQuda("                                               reconstruct, and check the true residuals (Wilson only)\n");
+  printfQuda("    --host-schwarz                           # Solve with GCR and the host Schwarz MR preconditioner,\n");
+  printfQuda("                                               additive and multiplicative (Wilson only)\n");
+  printfQuda("    --chrono                                 # Solve a sequence of sources with chrono_max_dim = 3 and\n");
+  printfQuda("                                               check the residuals and the forecast (Wilson only)\n");
+  printfQuda("    --adaptive                               # Solve with CG and adaptive reliable updates for several\n");
+  printfQuda("                                               reliable_drift values (Wilson only)\n");
+
+  return ;
+}
+
 int main(int argc, char **argv)
 {
 
@@ -75,6 +770,51 @@ int main(int argc, char **argv)
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     } 
+    if (strcmp(argv[i], "--write-prop") == 0 && i+1 < argc) {
+      prop_file = argv[++i];
+      continue;
+    }
+    if (strcmp(argv[i], "--inv-type") == 0 && i+1 < argc) {
+      i++;
+      if (strcmp(argv[i], "cg") == 0) inv_type = QUDA_CG_INVERTER;
+      else if (strcmp(argv[i], "bicgstab") == 0) inv_type = QUDA_BICGSTAB_INVERTER;
+      else if (strcmp(argv[i], "gcr") == 0) inv_type = QUDA_GCR_INVERTER;
+      else usage(argv);
+      continue;
+    }
+    if (strcmp(argv[i], "--multi-shift") == 0) {
+      multi_shift = 1;
+      continue;
+    }
+    if (strcmp(argv[i], "--checkpoint") == 0 && i+1 < argc) {
+      checkpoint_interval = atoi(argv[++i]);
+      if (checkpoint_interval <= 0) usage(argv);
+      continue;
+    }
+    if (strcmp(argv[i], "--field-api") == 0) {
+      field_api = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--async") == 0) {
+      async = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--host-solver") == 0) {
+      host_solver = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--host-schwarz") == 0) {
+      host_schwarz = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--chrono") == 0) {
+      chrono = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--adaptive") == 0) {
+      adaptive = true;
+      continue;
+    }
     printfQuda("ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -89,9 +829,14 @@ int main(int argc, char **argv)
   // initialize QMP or MPI
 #if defined(QMP_COMMS)
   QMP_thread_level_t tl;
-  QMP_init_msg_passing(&argc, &argv, QMP_THREAD_SINGLE, &tl);
+  QMP_init_msg_passing(&argc, &argv, async ? QMP_THREAD_SERIALIZED : QMP_THREAD_SINGLE, &tl);
 #elif defined(MPI_COMMS)
-  MPI_Init(&argc, &argv);
+  if (async) { // the queued solves communicate from the solver thread
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+  } else {
+    MPI_Init(&argc, &argv);
+  }
 #endif
 
   // call srand() with a rank-dependent seed
@@ -101,8 +846,6 @@ int main(int argc, char **argv)
 
   // *** QUDA parameters begin here.
 
-  int multi_shift = 0; // whether to test multi-shift or standard solver
-
   if (dslash_type != QUDA_WILSON_DSLASH &&
       dslash_type != QUDA_CLOVER_WILSON_DSLASH &&
       dslash_type != QUDA_TWISTED_MASS_DSLASH &&
@@ -183,6 +926,11 @@ int main(int argc, char **argv)
     inv_param.inv_type = QUDA_BICGSTAB_INVERTER;
   }
 
+  if (inv_type != QUDA_INVALID_INVERTER && !multi_shift) {
+    inv_param.inv_type = inv_type;
+    inv_param.solve_type = (inv_type == QUDA_CG_INVERTER) ? QUDA_NORMOP_PC_SOLVE : QUDA_DIRECT_PC_SOLVE;
+  }
+
   inv_param.gcrNkrylov = 10;
   inv_param.tol = 1e-7;
 #if __COMPUTE_CAPABILITY__ >= 200
@@ -481,6 +1229,83 @@ int main(int argc, char **argv)
 
   }
 
+  int test_failures = 0;
+
+  if (checkpoint_interval > 0) {
+    int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
+    int failures = multi_shift ?
+      checkResume(inv_param, spinorIn, spinorOutMulti, inv_param.num_offset, vol*spinorSiteSize*inv_param.Ls) :
+      checkResume(inv_param, spinorIn, &spinorOut, 1, vol*spinorSiteSize*inv_param.Ls);
+    printfQuda("Checkpoint resume: %s\n", failures ? "FAILED" : "PASSED");
+    test_failures += failures;
+  }
+
+  if (field_api) {
+    if (multi_shift) {
+      printfQuda("Field handle check not supported for the multi-shift solver\n");
+    } else {
+      int failures = checkFieldApi(inv_param, spinorIn, spinorOut, gauge_param.X);
+      printfQuda("Field handles: %s\n", failures ? "FAILED" : "PASSED");
+      test_failures += failures;
+    }
+  }
+
+  if (async) {
+    if (multi_shift) {
+      printfQuda("Queued solves not supported for the multi-shift solver\n");
+    } else {
+      int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
+      int failures = checkAsync(inv_param, spinorIn, spinorOut, vol*spinorSiteSize*inv_param.Ls);
+      printfQuda("Queued solves: %s\n", failures ? "FAILED" : "PASSED");
+      test_failures += failures;
+    }
+  }
+
+  if (host_solver) {
+    int failures = checkHostSolver(inv_param, spinorIn, gauge, gauge_param);
+    printfQuda("Host solver: %s\n", failures ? "FAILED" : "PASSED");
+    test_failures += failures;
+  }
+
+  if (host_schwarz) {
+    int failures = checkHostSchwarz(inv_param, spinorIn, gauge, gauge_param);
+    printfQuda("Host Schwarz preconditioner: %s\n", failures ? "FAILED" : "PASSED");
+    test_failures += failures;
+  }
+
+  if (chrono) {
+    int failures = checkChrono(inv_param, spinorIn, gauge, gauge_param);
+    printfQuda("Chronological forecasting: %s\n", failures ? "FAILED" : "PASSED");
+    test_failures += failures;
+  }
+
+  if (adaptive) {
+    int failures = checkAdaptive(inv_param, spinorIn, gauge, gauge_param);
+    printfQuda("Adaptive reliable updates: %s\n", failures ? "FAILED" : "PASSED");
+    test_failures += failures;
+  }
+
+  if (prop_file) {
+    if (inv_param.Ls != 1) {
+      printfQuda("Propagator round trip not supported for Ls = %d\n", inv_param.Ls);
+    } else {
+      // write a random full-lattice field, read it back and check it
+      QudaInvertParam prop_param = inv_param;
+      prop_param.solution_type = QUDA_MAT_SOLUTION;
+      void *prop = malloc(V*spinorSiteSize*sSize);
+      for (int i=0; i<V*spinorSiteSize; i++) {
+	if (inv_param.cpu_prec == QUDA_DOUBLE_PRECISION) ((double*)prop)[i] = rand() / (double)RAND_MAX;
+	else ((float*)prop)[i] = rand() / (float)RAND_MAX;
+      }
+      writeSpinorQuda(prop_file, prop, &prop_param);
+      flushSpinorWriterQuda();
+      int failures = checkSpinorFile(prop_file, prop, inv_param.cpu_prec, gauge_param.X);
+      printfQuda("Propagator round trip through %s: %s\n", prop_file, failures ? "FAILED" : "PASSED");
+      test_failures += failures;
+      free(prop);
+    }
+  }
+
   freeGaugeQuda();
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) freeCloverQuda();
 
@@ -494,5 +1319,5 @@ int main(int argc, char **argv)
   MPI_Finalize();
 #endif
 
-  return 0;
+  return test_failures ? 1 : 0;
 }
@@ -20,6 +20,7 @@
 
 extern void usage(char** argv);
 static int verify_results = 1;
+static int host_fat = 0; // fatten on the host threads
 
 extern int device;
 extern int xdim, ydim, zdim, tdim;
@@ -186,6 +187,7 @@ llfat_test(int test)
 
   void** sitelink_ptr; 
   QudaComputeFatMethod method = (test) ? QUDA_COMPUTE_FAT_EXTENDED_VOLUME : QUDA_COMPUTE_FAT_STANDARD;
+  if (host_fat) method = QUDA_COMPUTE_FAT_HOST;
   if(gauge_order == QUDA_QDP_GAUGE_ORDER){
     sitelink_ptr = (test) ? (void**)sitelink_ex : (void**)sitelink;
   }else{
@@ -446,6 +448,7 @@ usage_extra(char** argv )
   printfQuda("                                                0: standard method\n");
   printfQuda("                                                1: extended volume method\n");
   printfQuda("    --verify                                 # Verify the GPU results using CPU results\n");
+  printfQuda("    --host                                   # Fatten on the host threads (extended volume)\n");
   printfQuda("    --gauge-order <qdp/milc>		   # ordering of the input gauge-field\n");
   return ;
 }
@@ -494,6 +497,12 @@ main(int argc, char **argv)
       continue;
     }
 
+    if( strcmp(argv[i], "--host") == 0){
+      host_fat = 1;
+      test = 1; // the host method takes the extended site links
+      continue;
+    }
+
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <iostream>
 
 #include <quda_internal.h>
@@ -10,6 +11,7 @@
 #include <dslash_util.h>
 
 #include <color_spinor_field.h>
+#include <clover_field.h>
 #include <blas_quda.h>
 
 using namespace quda;
@@ -190,6 +192,136 @@ void packTest() {
 
 }
 
+static int failures = 0;
+
+// max |a - b| over n reals of precision prec_b against the double reals of a
+static double maxDiff(const void *a, const void *b, size_t n, QudaPrecision prec_b)
+{
+  double diff = 0.0;
+  for (size_t i=0; i<n; i++) {
+    double y = (prec_b == QUDA_DOUBLE_PRECISION) ? ((const double*)b)[i] : ((const float*)b)[i];
+    diff = fmax(diff, fabs(((const double*)a)[i] - y));
+  }
+  return diff;
+}
+
+static void report(const char *field, QudaPrecision prec, int width, double diff)
+{
+  // the double round trip is a permutation, the single one rounds each real once
+  const double tol = (prec == QUDA_DOUBLE_PRECISION) ? 0.0 : 1e-6;
+  printf("%s round trip through the AoSoA%d order in %s precision: max difference %e %s\n",
+	 field, width, prec == QUDA_DOUBLE_PRECISION ? "double" : "single", diff, diff > tol ? "FAILED" : "PASSED");
+  if (diff > tol) failures++;
+}
+
+static cpuCloverField* newCloverField(void *&buffer, QudaCloverFieldOrder order, QudaPrecision precision)
+{
+  CloverFieldParam cParam;
+  cParam.nDim = 4;
+  for (int d=0; d<4; d++) cParam.x[d] = param.X[d];
+  cParam.pad = 0;
+  cParam.precision = precision;
+  cParam.direct = true;
+  cParam.inverse = false;
+  cParam.norm = 0;
+  cParam.cloverInv = 0;
+  cParam.invNorm = 0;
+  cParam.order = order;
+  cParam.create = QUDA_REFERENCE_FIELD_CREATE;
+  buffer = malloc(ALIGNMENT_ADJUST(V*cloverSiteSize*precision));
+  cParam.clover = buffer;
+  return new cpuCloverField(cParam);
+}
+
+/**
+   Copy host spinor, gauge and clover fields to each AoSoA order, in
+   double and single precision, and back with the copyGeneric*
+   routines, and check that the fields come back unchanged (up to the
+   rounding to single precision).
+ */
+void aosoaTest() {
+
+  const QudaFieldOrder spinorOrder[] = { QUDA_AOSOA4_FIELD_ORDER, QUDA_AOSOA8_FIELD_ORDER, QUDA_AOSOA16_FIELD_ORDER };
+  const QudaGaugeFieldOrder gaugeOrder[] = { QUDA_AOSOA4_GAUGE_ORDER, QUDA_AOSOA8_GAUGE_ORDER, QUDA_AOSOA16_GAUGE_ORDER };
+  const QudaCloverFieldOrder cloverOrder[] = { QUDA_AOSOA4_CLOVER_ORDER, QUDA_AOSOA8_CLOVER_ORDER,
+					       QUDA_AOSOA16_CLOVER_ORDER };
+  const QudaPrecision precision[] = { QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION };
+
+  param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  construct_gauge_field(qdpCpuGauge_p, 1, param.cpu_prec, &param);
+  GaugeFieldParam qdpParam(qdpCpuGauge_p, param);
+  cpuGaugeField qdpGauge(qdpParam);
+
+  void *cloverBuf;
+  cpuCloverField *clover = newCloverField(cloverBuf, QUDA_PACKED_CLOVER_ORDER, QUDA_DOUBLE_PRECISION);
+  for (int i=0; i<V*cloverSiteSize; i++) ((double*)cloverBuf)[i] = rand() / (double)RAND_MAX - 0.5;
+
+  for (int w=0; w<3; w++) {
+    const int width = aosoaWidth(spinorOrder[w]);
+    if (Vh % width) {
+      printf("Checkerboard volume %d not a multiple of %d, skipping the AoSoA%d orders\n", Vh, width, width);
+      continue;
+    }
+
+    for (int p=0; p<2; p++) {
+      { // spinor
+	ColorSpinorParam aParam(*spinor);
+	aParam.fieldOrder = spinorOrder[w];
+	aParam.precision = precision[p];
+	aParam.create = QUDA_NULL_FIELD_CREATE;
+	cpuColorSpinorField aosoa(aParam);
+	aosoa = *spinor;
+
+	ColorSpinorParam bParam(*spinor);
+	bParam.create = QUDA_NULL_FIELD_CREATE;
+	cpuColorSpinorField back(bParam);
+	back = aosoa;
+	report("Spinor", precision[p], width, maxDiff(spinor->V(), back.V(), (size_t)spinor->Volume()*spinorSiteSize,
+						      QUDA_DOUBLE_PRECISION));
+      }
+
+      { // gauge
+	GaugeFieldParam aParam(qdpParam);
+	aParam.order = gaugeOrder[w];
+	aParam.precision = precision[p];
+	aParam.create = QUDA_NULL_FIELD_CREATE;
+	cpuGaugeField aosoa(aParam);
+	copyGenericGauge(aosoa, qdpGauge, QUDA_CPU_FIELD_LOCATION);
+
+	GaugeFieldParam bParam(qdpParam);
+	bParam.create = QUDA_NULL_FIELD_CREATE;
+	cpuGaugeField back(bParam);
+	copyGenericGauge(back, aosoa, QUDA_CPU_FIELD_LOCATION);
+	double diff = 0.0;
+	for (int d=0; d<4; d++)
+	  diff = fmax(diff, maxDiff(qdpCpuGauge_p[d], ((void**)back.Gauge_p())[d], (size_t)V*gaugeSiteSize,
+				    QUDA_DOUBLE_PRECISION));
+	report("Gauge", precision[p], width, diff);
+      }
+
+      { // clover
+	void *aosoaBuf, *backBuf;
+	cpuCloverField *aosoa = newCloverField(aosoaBuf, cloverOrder[w], precision[p]);
+	cpuCloverField *back = newCloverField(backBuf, QUDA_PACKED_CLOVER_ORDER, QUDA_DOUBLE_PRECISION);
+	copyGenericClover(*aosoa, *clover, false, QUDA_CPU_FIELD_LOCATION);
+	copyGenericClover(*back, *aosoa, false, QUDA_CPU_FIELD_LOCATION);
+	double diff = 0.0;
+	for (int parity=0; parity<2; parity++)
+	  diff = fmax(diff, maxDiff((char*)cloverBuf + parity*clover->Bytes()/2, (char*)backBuf + parity*back->Bytes()/2,
+				    (size_t)Vh*cloverSiteSize, QUDA_DOUBLE_PRECISION));
+	report("Clover", precision[p], width, diff);
+	delete back;
+	delete aosoa;
+	free(backBuf);
+	free(aosoaBuf);
+      }
+    }
+  }
+
+  delete clover;
+  free(cloverBuf);
+}
+
 extern void usage(char**);
 
 int main(int argc, char **argv) {
@@ -206,8 +338,11 @@ int main(int argc, char **argv) {
 
   init();
   packTest();
+  aosoaTest();
   end();
 
   finalizeComms();
+
+  return failures ? 1 : 0;
 }
 
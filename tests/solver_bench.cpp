@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include <quda.h>
+#include <quda_internal.h>
+#include <dirac_quda.h>
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <comm_quda.h>
+
+#include <test_util.h>
+
+/*
+ * Host solver benchmark
+ *
+ * Runs complete solves of the even-even preconditioned Wilson normal
+ * equations with the host solvers on reproducible synthetic gauge
+ * fields, and reports the time to solution, the iterations and the
+ * time spent in each TimeProfile category of the solver.  The sweep
+ * covers the solver (mixed-precision CG or multi-shift CG), the
+ * precision of the outer and of the sloppy operator, the reliable
+ * update delta and the process grid.  The global lattice is kept
+ * fixed while the process grid changes: it is the local volume
+ * (--xdim etc.) times the grid given by --xgridsize etc., and each
+ * layout of --layouts must use the same number of processes.  The
+ * gauge field is drawn from the global site, so every layout solves
+ * the same system from a point source at the origin.
+ */
+
+using namespace quda;
+
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+extern int gridsize_from_cmdline[];
+extern QudaReconstructType link_recon_sloppy;
+
+extern void usage(char**);
+
+static std::vector<std::string> solvers;
+static std::vector<std::string> precisions;   // outer precision
+static std::vector<std::string> sloppies;     // storage of the sloppy operator
+static std::vector<double> deltas;
+static std::vector<std::vector<int> > layouts;
+static std::vector<double> offsets;
+static double kappa = 0.12;
+static double tol = 1e-8;
+static int maxiter = 10000;
+static int nsrc = 1;
+static double disorder = 0.5;
+static int smearSteps = 4;
+static unsigned int seed = 1234;
+static QudaStencilOrder stencilOrder = QUDA_LEXICOGRAPHIC_STENCIL_ORDER;
+static bool json = false;
+static FILE *output = 0;
+static int nResults = 0;
+
+static void splitList(std::vector<std::string> &list, const char *arg)
+{
+  list.clear();
+  std::string s(arg);
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    if (end > start) list.push_back(s.substr(start, end-start));
+    start = end + 1;
+  }
+}
+
+static void splitList(std::vector<double> &list, const char *arg)
+{
+  std::vector<std::string> s;
+  splitList(s, arg);
+  list.clear();
+  for (size_t i=0; i<s.size(); i++) list.push_back(atof(s[i].c_str()));
+}
+
+static QudaStorageType storageOf(const std::string &name)
+{
+  if (name == "double") return QUDA_DOUBLE_STORAGE;
+  if (name == "single") return QUDA_SINGLE_STORAGE;
+  if (name == "half") return QUDA_HALF_STORAGE;
+  if (name == "bfloat16") return QUDA_BFLOAT16_STORAGE;
+  errorQuda("Unknown precision %s", name.c_str());
+  return QUDA_INVALID_STORAGE;
+}
+
+// lexicographic process map with t varying fastest, as initCommsGridQuda
+static int lexRank(const int *coords, void *fdata)
+{
+  const int *dims = static_cast<const int*>(fdata);
+  int rank = coords[0];
+  for (int i=1; i<4; i++) rank = dims[i]*rank + coords[i];
+  return rank;
+}
+
+static void setLayout(const int *grid)
+{
+  int nodes = 1;
+  for (int d=0; d<4; d++) nodes *= grid[d];
+  if (nodes != comm_size())
+    errorQuda("Layout %dx%dx%dx%d does not match the %d processes", grid[0], grid[1], grid[2], grid[3], comm_size());
+
+  int dims[4] = { grid[0], grid[1], grid[2], grid[3] };
+  Topology *topo = comm_default_topology();
+  comm_set_default_topology(comm_create_topology(4, dims, lexRank, dims));
+  comm_destroy_topology(topo);
+}
+
+struct Result {
+  const char *solver;
+  const int *grid;
+  const int *X;
+  std::string precision;
+  std::string sloppy;
+  double delta;
+  int iter;
+  double trueRes;
+  double gflops;
+};
+
+// one row per configuration, with the mean times per solve
+static void report(const Result &r, const TimeProfile &profile)
+{
+  if (comm_rank() != 0) return;
+
+  const double total = profile.profile[QUDA_PROFILE_TOTAL].time / nsrc;
+  const double iter = (double)r.iter / nsrc;
+
+  if (json) {
+    fprintf(output, "%s\n  { \"solver\": \"%s\", \"layout\": \"%dx%dx%dx%d\", \"volume\": \"%dx%dx%dx%d\", "
+	    "\"precision\": \"%s\", \"sloppy\": \"%s\", \"delta\": %g, \"iterations\": %.1f, "
+	    "\"true_res\": %.3e, \"seconds\": %.6e, \"seconds_per_iteration\": %.6e, \"gflops\": %.3f, "
+	    "\"profile\": {", nResults ? "," : "", r.solver,
+	    r.grid[0], r.grid[1], r.grid[2], r.grid[3], r.X[0], r.X[1], r.X[2], r.X[3],
+	    r.precision.c_str(), r.sloppy.c_str(), r.delta, iter, r.trueRes, total,
+	    iter > 0 ? total/iter : 0.0, r.gflops);
+    for (int i=QUDA_PROFILE_INIT; i<=QUDA_PROFILE_FREE; i++)
+      fprintf(output, "%s \"%s\": %.6e", i > QUDA_PROFILE_INIT ? "," : "", TimeProfile::pname[i].c_str(),
+	      profile.profile[i].time / nsrc);
+    fprintf(output, " } }");
+  } else {
+    fprintf(output, "%s,%dx%dx%dx%d,%dx%dx%dx%d,%s,%s,%g,%.1f,%.3e,%.6e,%.6e,%.3f", r.solver,
+	    r.grid[0], r.grid[1], r.grid[2], r.grid[3], r.X[0], r.X[1], r.X[2], r.X[3],
+	    r.precision.c_str(), r.sloppy.c_str(), r.delta, iter, r.trueRes, total,
+	    iter > 0 ? total/iter : 0.0, r.gflops);
+    for (int i=QUDA_PROFILE_INIT; i<=QUDA_PROFILE_FREE; i++)
+      fprintf(output, ",%.6e", profile.profile[i].time / nsrc);
+    fprintf(output, "\n");
+  }
+  fflush(output);
+  nResults++;
+}
+
+static void setSolverParam(QudaInvertParam &param, double delta)
+{
+  param = newQudaInvertParam();
+  param.dslash_type = QUDA_WILSON_DSLASH;
+  param.inv_type = QUDA_CG_INVERTER;
+  param.kappa = kappa;
+  param.tol = tol;
+  param.maxiter = maxiter;
+  param.reliable_delta = delta;
+  param.residual_type = QUDA_L2_RELATIVE_RESIDUAL;
+  param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+  param.num_offset = offsets.size();
+  for (int i=0; i<param.num_offset; i++) {
+    param.offset[i] = offsets[i];
+    param.tol_offset[i] = tol;
+    param.tol_hq_offset[i] = 0.0;
+  }
+}
+
+static void runLayout(const int *grid, const int *G)
+{
+  int X[4];
+  for (int d=0; d<4; d++) {
+    X[d] = G[d] / grid[d];
+    if (G[d] % grid[d] || X[d] % 2) {
+      warningQuda("Skipping layout %dx%dx%dx%d: global dimension %d = %d does not split into even local extents",
+		  grid[0], grid[1], grid[2], grid[3], d, G[d]);
+      return;
+    }
+  }
+  setLayout(grid);
+  setDims(X);
+
+  // the synthetic field, then its boundary conditions
+  QudaGaugeParam gParam = newQudaGaugeParam();
+  for (int d=0; d<4; d++) gParam.X[d] = X[d];
+  gParam.cpu_prec = QUDA_DOUBLE_PRECISION;
+  gParam.cuda_prec = QUDA_DOUBLE_PRECISION;
+  gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+  gParam.type = QUDA_WILSON_LINKS;
+  gParam.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gParam.anisotropy = 1.0;
+  gParam.t_boundary = QUDA_ANTI_PERIODIC_T;
+  gParam.gauge_fix = QUDA_GAUGE_FIXED_NO;
+
+  const int volume = X[0]*X[1]*X[2]*X[3];
+  void *gauge[4];
+  for (int d=0; d<4; d++) gauge[d] = malloc((size_t)volume*gaugeSiteSize*sizeof(double));
+  construct_ensemble_gauge_field(gauge, disorder, smearSteps, seed, QUDA_DOUBLE_PRECISION, &gParam);
+
+  QudaGaugeObservables obs;
+  gaugeObservablesQuda(&obs, gauge, &gParam);
+  printfQuda("Layout %dx%dx%dx%d: local volume %dx%dx%dx%d, plaquette %.8f\n", grid[0], grid[1], grid[2], grid[3],
+	     X[0], X[1], X[2], X[3], obs.plaquette[0]);
+
+  construct_gauge_field(gauge, 2, QUDA_DOUBLE_PRECISION, &gParam);
+  GaugeFieldParam uParam(gauge, gParam);
+  cpuGaugeField u(uParam);
+
+  DiracParam diracParam;
+  diracParam.type = QUDA_WILSONPC_DIRAC;
+  diracParam.kappa = kappa;
+  diracParam.matpcType = QUDA_MATPC_EVEN_EVEN;
+  diracParam.dagger = QUDA_DAG_NO;
+
+  for (size_t p=0; p<precisions.size(); p++) {
+    const QudaStorageType storage = storageOf(precisions[p]);
+    if (storage != QUDA_DOUBLE_STORAGE && storage != QUDA_SINGLE_STORAGE) {
+      warningQuda("The outer precision must be double or single, skipping %s", precisions[p].c_str());
+      continue;
+    }
+    DiracWilsonCpu mat(diracParam, u, storage, QUDA_RECONSTRUCT_NO, false, stencilOrder);
+
+    // point source at the global origin, on the even sites
+    ColorSpinorParam csParam;
+    csParam.nColor = 3;
+    csParam.nSpin = 4;
+    csParam.nDim = 4;
+    for (int d=0; d<4; d++) csParam.x[d] = X[d];
+    csParam.x[0] /= 2;
+    csParam.precision = mat.Precision();
+    csParam.pad = 0;
+    csParam.siteSubset = QUDA_PARITY_SITE_SUBSET;
+    csParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    csParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    cpuColorSpinorField b(csParam);
+    bool origin = true;
+    for (int d=0; d<4; d++) if (comm_coord(d) != 0) origin = false;
+    if (origin) {
+      if (mat.Precision() == QUDA_DOUBLE_PRECISION) ((double*)b.V())[0] = 1.0;
+      else ((float*)b.V())[0] = 1.0;
+    }
+
+    for (size_t s=0; s<solvers.size(); s++) {
+      if (solvers[s] == "cg") {
+	for (size_t q=0; q<sloppies.size(); q++) {
+	  DiracWilsonCpu matSloppy(diracParam, u, storageOf(sloppies[q]), link_recon_sloppy, false, stencilOrder);
+	  for (size_t k=0; k<deltas.size(); k++) {
+	    QudaInvertParam invParam;
+	    setSolverParam(invParam, deltas[k]);
+	    TimeProfile profile("solver_bench");
+	    Result r = { "cg", grid, X, precisions[p], sloppies[q], deltas[k], 0, 0.0, 0.0 };
+	    double flops = 0.0;
+	    for (int n=0; n<nsrc; n++) {
+	      cpuColorSpinorField x(csParam);
+	      SolverParam solverParam(invParam);
+	      CGCpu cg(mat, matSloppy, solverParam, profile);
+	      cg(x, b);
+	      r.iter += solverParam.iter;
+	      r.trueRes = solverParam.true_res;
+	      flops += solverParam.gflops;
+	    }
+	    const double compute = profile.profile[QUDA_PROFILE_COMPUTE].time;
+	    r.gflops = compute > 0.0 ? flops / compute : 0.0;
+	    report(r, profile);
+	  }
+	}
+      } else if (solvers[s] == "multishift") {
+	if (offsets.empty()) {
+	  warningQuda("No offsets given, skipping the multi-shift solver");
+	  continue;
+	}
+	QudaInvertParam invParam;
+	setSolverParam(invParam, 0.0);
+	TimeProfile profile("solver_bench");
+	Result r = { "multishift", grid, X, precisions[p], precisions[p], 0.0, 0, 0.0, 0.0 };
+	double flops = 0.0;
+	for (int n=0; n<nsrc; n++) {
+	  cpuColorSpinorField *x[QUDA_MAX_MULTI_SHIFT];
+	  for (size_t i=0; i<offsets.size(); i++) x[i] = new cpuColorSpinorField(csParam);
+	  SolverParam solverParam(invParam);
+	  MultiShiftCGCpu cg(mat, solverParam, profile);
+	  cg(x, b);
+	  r.iter += solverParam.iter;
+	  r.trueRes = 0.0;
+	  for (size_t i=0; i<offsets.size(); i++) {
+	    if (solverParam.true_res_offset[i] > r.trueRes) r.trueRes = solverParam.true_res_offset[i];
+	    delete x[i];
+	  }
+	  flops += solverParam.gflops;
+	}
+	const double compute = profile.profile[QUDA_PROFILE_COMPUTE].time;
+	r.gflops = compute > 0.0 ? flops / compute : 0.0;
+	report(r, profile);
+      } else {
+	warningQuda("Unknown solver %s", solvers[s].c_str());
+      }
+    }
+  }
+
+  for (int d=0; d<4; d++) free(gauge[d]);
+}
+
+void usage_extra(char** argv)
+{
+  printf("Extra options:\n");
+  printf("    --solvers <s,...>                         # cg/multishift (default cg)\n");
+  printf("    --precisions <p,...>                      # Outer precisions, double/single (default double)\n");
+  printf("    --sloppy <p,...>                          # Sloppy precisions, double/single/half/bfloat16 (default single)\n");
+  printf("    --deltas <d,...>                          # Reliable update deltas (default 0.1)\n");
+  printf("    --layouts <XxYxZxT,...>                   # Process grids of the sweep (default: --xgridsize etc.)\n");
+  printf("    --offsets <o,...>                         # Shifts of the multi-shift solver (default 0.01,0.02,0.04,0.08)\n");
+  printf("    --kappa <k>                               # Hopping parameter (default 0.12)\n");
+  printf("    --tol <t>                                 # Relative residual of the solves (default 1e-8)\n");
+  printf("    --maxiter <n>                             # Maximum iterations (default 10000)\n");
+  printf("    --nsrc <n>                                # Solves per configuration (default 1)\n");
+  printf("    --disorder <d>                            # Disorder of the synthetic field (default 0.5)\n");
+  printf("    --smear-steps <n>                         # Stout steps of the synthetic field (default 4)\n");
+  printf("    --seed <n>                                # Seed of the synthetic field (default 1234)\n");
+  printf("    --stencil-order <lex/morton/hilbert>      # Site order of the host operators (default lex)\n");
+  printf("    --format <csv/json>                       # Output format (default csv)\n");
+  printf("    --output <file>                           # Output file (default stdout)\n");
+}
+
+int main(int argc, char **argv)
+{
+  const char *outputFile = 0;
+  solvers.push_back("cg");
+  precisions.push_back("double");
+  sloppies.push_back("single");
+  deltas.push_back(0.1);
+  offsets.push_back(0.01);
+  offsets.push_back(0.02);
+  offsets.push_back(0.04);
+  offsets.push_back(0.08);
+
+  for (int i=1; i<argc; i++) {
+    if (process_command_line_option(argc, argv, &i) == 0) continue;
+
+    if (i+1 >= argc) {
+      fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+      usage(argv);
+    }
+    if (strcmp(argv[i], "--solvers") == 0) {
+      splitList(solvers, argv[++i]);
+    } else if (strcmp(argv[i], "--precisions") == 0) {
+      splitList(precisions, argv[++i]);
+    } else if (strcmp(argv[i], "--sloppy") == 0) {
+      splitList(sloppies, argv[++i]);
+    } else if (strcmp(argv[i], "--deltas") == 0) {
+      splitList(deltas, argv[++i]);
+    } else if (strcmp(argv[i], "--layouts") == 0) {
+      std::vector<std::string> l;
+      splitList(l, argv[++i]);
+      layouts.clear();
+      for (size_t j=0; j<l.size(); j++) {
+	std::vector<int> grid(4);
+	if (sscanf(l[j].c_str(), "%dx%dx%dx%d", &grid[0], &grid[1], &grid[2], &grid[3]) != 4) {
+	  fprintf(stderr, "ERROR: invalid layout %s\n", l[j].c_str());
+	  usage(argv);
+	}
+	layouts.push_back(grid);
+      }
+    } else if (strcmp(argv[i], "--offsets") == 0) {
+      splitList(offsets, argv[++i]);
+      if (offsets.size() > QUDA_MAX_MULTI_SHIFT) {
+	fprintf(stderr, "ERROR: at most %d offsets\n", QUDA_MAX_MULTI_SHIFT);
+	usage(argv);
+      }
+    } else if (strcmp(argv[i], "--kappa") == 0) {
+      kappa = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--tol") == 0) {
+      tol = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--maxiter") == 0) {
+      maxiter = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--nsrc") == 0) {
+      nsrc = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--disorder") == 0) {
+      disorder = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--smear-steps") == 0) {
+      smearSteps = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--seed") == 0) {
+      seed = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--stencil-order") == 0) {
+      i++;
+      if (strcmp(argv[i], "lex") == 0) stencilOrder = QUDA_LEXICOGRAPHIC_STENCIL_ORDER;
+      else if (strcmp(argv[i], "morton") == 0) stencilOrder = QUDA_MORTON_STENCIL_ORDER;
+      else if (strcmp(argv[i], "hilbert") == 0) stencilOrder = QUDA_HILBERT_STENCIL_ORDER;
+      else { fprintf(stderr, "ERROR: invalid stencil order %s\n", argv[i]); usage(argv); }
+    } else if (strcmp(argv[i], "--format") == 0) {
+      json = (strcmp(argv[++i], "json") == 0);
+    } else if (strcmp(argv[i], "--output") == 0) {
+      outputFile = argv[++i];
+    } else {
+      fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
+      usage(argv);
+    }
+  }
+  if (link_recon_sloppy == QUDA_RECONSTRUCT_INVALID) link_recon_sloppy = QUDA_RECONSTRUCT_NO;
+
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  if (layouts.empty()) layouts.push_back(std::vector<int>(gridsize_from_cmdline, gridsize_from_cmdline+4));
+  const int G[4] = { xdim*gridsize_from_cmdline[0], ydim*gridsize_from_cmdline[1],
+		     zdim*gridsize_from_cmdline[2], tdim*gridsize_from_cmdline[3] };
+
+  output = stdout;
+  if (outputFile && comm_rank() == 0) {
+    output = fopen(outputFile, "w");
+    if (!output) errorQuda("Unable to open %s", outputFile);
+  }
+  if (comm_rank() == 0) {
+    if (json) {
+      fprintf(output, "[");
+    } else {
+      fprintf(output, "solver,layout,volume,precision,sloppy,delta,iterations,true_res,seconds,"
+	      "seconds_per_iteration,gflops");
+      for (int i=QUDA_PROFILE_INIT; i<=QUDA_PROFILE_FREE; i++) fprintf(output, ",%s", TimeProfile::pname[i].c_str());
+      fprintf(output, "\n");
+    }
+  }
+
+  for (size_t l=0; l<layouts.size(); l++) runLayout(&layouts[l][0], G);
+
+  if (comm_rank() == 0) {
+    if (json) fprintf(output, "\n]\n");
+    if (output != stdout) fclose(output);
+  }
+
+  finalizeComms();
+
+  return 0;
+}
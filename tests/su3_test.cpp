@@ -1,11 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <util_quda.h>
 #include <test_util.h>
 #include <dslash_util.h>
 
 #include <gauge_qio.h>
+#include <comm_quda.h>
 
 #ifdef QMP_COMMS
 #include <qmp.h>
@@ -83,12 +90,379 @@ void end() {
 
 extern void usage(char**);
 
+static const char *io_file = 0; // --io: gauge file for the write-and-read round trip
+static bool observables = false; // --observables: check the plaquette and the other observables
+static bool smear = false; // --smear: check the APE, stout and HYP smeared links
+static int failures = 0;
+
+static bool bigEndianHost()
+{
+  const unsigned int one = 1;
+  return *(const unsigned char*)&one == 0;
+}
+
+/**
+   Write the host field (QDP order) as a NERSC file of the global
+   lattice, with rows = 2 or 3 rows stored per link, in big-endian
+   double or little-endian single precision.  The header carries the
+   link trace and the checksum, the sum of the 32-bit words of the
+   stored numbers.
+ */
+template <typename Float>
+static void writeNersc(const char *filename, void **gauge, int rows, bool bigEndian)
+{
+  const int reals = 6*rows;
+  const bool swap = (bigEndian != bigEndianHost());
+  Float *data = (Float*)malloc((size_t)V*4*reals*sizeof(Float));
+  unsigned int sum = 0;
+  double trace = 0.0;
+
+  for (int r=0; r<V; r++) {
+    int x[4], c = r;
+    for (int d=0; d<4; d++) { x[d] = c % Z[d]; c /= Z[d]; }
+    const int idx = r/2 + ((x[0]+x[1]+x[2]+x[3]) & 1)*Vh;
+    for (int d=0; d<4; d++) {
+      const double *u = (const double*)gauge[d] + idx*gaugeSiteSize;
+      Float *w = data + ((size_t)r*4 + d)*reals;
+      for (int i=0; i<reals; i++) w[i] = u[i];
+      trace += u[0] + u[8] + u[16];
+      const unsigned int *word = (const unsigned int*)w;
+      for (int k=0; k<(int)(reals*sizeof(Float)/4); k++) sum += word[k];
+    }
+  }
+
+  if (swap) {
+    char *b = (char*)data;
+    for (size_t i=0; i<(size_t)V*4*reals; i++, b += sizeof(Float))
+      for (size_t k=0; k<sizeof(Float)/2; k++) { char t = b[k]; b[k] = b[sizeof(Float)-1-k]; b[sizeof(Float)-1-k] = t; }
+  }
+
+  FILE *f = fopen(filename, "wb");
+  if (!f) errorQuda("Cannot open %s", filename);
+  fprintf(f, "BEGIN_HEADER\nHDR_VERSION = 1.0\nDATATYPE = %s\n", rows == 2 ? "4D_SU3_GAUGE" : "4D_SU3_GAUGE_3x3");
+  for (int d=0; d<4; d++) fprintf(f, "DIMENSION_%d = %d\n", d+1, Z[d]);
+  fprintf(f, "LINK_TRACE = %.15e\nCHECKSUM = %x\n", trace/(3.0*4.0*V), sum);
+  fprintf(f, "FLOATING_POINT = %s\nEND_HEADER\n",
+	  sizeof(Float) == 8 ? (bigEndian ? "IEEE64BIG" : "IEEE64LITTLE") : (bigEndian ? "IEEE32BIG" : "IEEE32LITTLE"));
+  if (fwrite(data, sizeof(Float)*reals, (size_t)V*4, f) != (size_t)V*4) errorQuda("Failed to write %s", filename);
+  fclose(f);
+  free(data);
+}
+
+/**
+   Write the field in the NERSC formats, read each file back with
+   readGaugeFileQuda and compare it with the field.  The reader is run
+   with several OpenMP threads, so that the checksums are formed
+   from the partial sums of the threads.
+ */
+static void ioTest()
+{
+  if (comm_size() > 1) {
+    printfQuda("Gauge file round trip not supported with %d processes\n", comm_size());
+    return;
+  }
+  if (param.cpu_prec != QUDA_DOUBLE_PRECISION) errorQuda("Host precision %d not supported", param.cpu_prec);
+
+#ifdef _OPENMP
+  const int threads = omp_get_max_threads();
+  if (threads < 4) omp_set_num_threads(4);
+  printfQuda("Reading with %d threads\n", omp_get_max_threads());
+#endif
+
+  const char *names[] = { "3x2, IEEE64BIG", "3x3, IEEE64BIG", "3x2, IEEE32LITTLE", "3x3, IEEE32LITTLE" };
+  for (int t=0; t<4; t++) {
+    const int rows = (t % 2) ? 3 : 2;
+    const bool single = (t >= 2);
+    if (single) writeNersc<float>(io_file, gauge, rows, false);
+    else writeNersc<double>(io_file, gauge, rows, true);
+
+    for (int d=0; d<4; d++) memset(new_gauge[d], 0, V*gaugeSiteSize*sizeof(double));
+    readGaugeFileQuda(new_gauge, io_file, &param); // a checksum or trace mismatch is fatal
+
+    double diff = 0.0;
+    for (int d=0; d<4; d++)
+      for (int i=0; i<V*gaugeSiteSize; i++)
+	diff = fmax(diff, fabs(((double*)gauge[d])[i] - ((double*)new_gauge[d])[i]));
+    const double tol = single ? 1e-6 : 1e-12;
+    printfQuda("NERSC %s round trip: max |U - U_read| = %e, %s\n", names[t], diff, diff > tol ? "FAILED" : "PASSED");
+    if (diff > tol) failures++;
+  }
+  remove(io_file);
+
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+}
+
+// c = a b and c = a b^dag for 3x3 complex matrices stored as [row][col][re/im]
+static void su3MulNN(const double *a, const double *b, double *c)
+{
+  for (int i=0; i<3; i++) {
+    for (int j=0; j<3; j++) {
+      double re = 0.0, im = 0.0;
+      for (int k=0; k<3; k++) {
+	re += a[6*i+2*k]*b[6*k+2*j] - a[6*i+2*k+1]*b[6*k+2*j+1];
+	im += a[6*i+2*k]*b[6*k+2*j+1] + a[6*i+2*k+1]*b[6*k+2*j];
+      }
+      c[6*i+2*j] = re;
+      c[6*i+2*j+1] = im;
+    }
+  }
+}
+
+static void su3MulND(const double *a, const double *b, double *c)
+{
+  for (int i=0; i<3; i++) {
+    for (int j=0; j<3; j++) {
+      double re = 0.0, im = 0.0;
+      for (int k=0; k<3; k++) {
+	re += a[6*i+2*k]*b[6*j+2*k] + a[6*i+2*k+1]*b[6*j+2*k+1];
+	im += a[6*i+2*k+1]*b[6*j+2*k] - a[6*i+2*k]*b[6*j+2*k+1];
+      }
+      c[6*i+2*j] = re;
+      c[6*i+2*j+1] = im;
+    }
+  }
+}
+
+// the link U_d(x + shift) of the host field (QDP order), periodic in every dimension
+static const double* hostLink(void **u, int d, const int *x, const int *shift)
+{
+  int y[4], r = 0;
+  for (int i=3; i>=0; i--) {
+    y[i] = (x[i] + shift[i] + Z[i]) % Z[i];
+    r = r*Z[i] + y[i];
+  }
+  const int idx = r/2 + ((y[0]+y[1]+y[2]+y[3]) & 1)*Vh;
+  return (const double*)u[d] + idx*gaugeSiteSize;
+}
+
+/**
+   Reference plaquette, rectangle, Polyakov loop and link trace of the
+   host field of a single process, averaged as in
+   QudaGaugeObservables.
+ */
+static void referenceObservables(QudaGaugeObservables &obs, void **u)
+{
+  double ps = 0.0, pt = 0.0, rs = 0.0, rt = 0.0, tr = 0.0, poly[2] = {0.0, 0.0};
+  for (int r=0; r<V; r++) {
+    int x[4], c = r;
+    for (int d=0; d<4; d++) { x[d] = c % Z[d]; c /= Z[d]; }
+
+    for (int mu=0; mu<4; mu++) {
+      int e[4] = {0, 0, 0, 0};
+      const double *U = hostLink(u, mu, x, e);
+      tr += U[0] + U[8] + U[16];
+
+      for (int nu=0; nu<4; nu++) {
+	if (nu == mu) continue;
+	int fmu[4] = {0, 0, 0, 0}, fnu[4] = {0, 0, 0, 0}, f2mu[4] = {0, 0, 0, 0}, fmunu[4] = {0, 0, 0, 0};
+	fmu[mu] = 1; fnu[nu] = 1; f2mu[mu] = 2; fmunu[mu] = 1; fmunu[nu] = 1;
+	double a[18], b[18], w[18];
+
+	if (mu < nu) { // U_mu(x) U_nu(x+mu) U_mu(x+nu)^dag U_nu(x)^dag
+	  su3MulNN(U, hostLink(u, nu, x, fmu), a);
+	  su3MulND(a, hostLink(u, mu, x, fnu), b);
+	  su3MulND(b, hostLink(u, nu, x, e), w);
+	  if (nu == 3) pt += w[0] + w[8] + w[16];
+	  else ps += w[0] + w[8] + w[16];
+	}
+
+	// the 2x1 rectangle, long in mu
+	su3MulNN(U, hostLink(u, mu, x, fmu), a);
+	su3MulNN(a, hostLink(u, nu, x, f2mu), b);
+	su3MulND(b, hostLink(u, mu, x, fmunu), a);
+	su3MulND(a, hostLink(u, mu, x, fnu), b);
+	su3MulND(b, hostLink(u, nu, x, e), w);
+	if (mu == 3 || nu == 3) rt += w[0] + w[8] + w[16];
+	else rs += w[0] + w[8] + w[16];
+      }
+    }
+
+    if (x[3] == 0) { // the Polyakov loop through this spatial site
+      double p[18], q[18];
+      int e[4] = {0, 0, 0, 0};
+      memcpy(p, hostLink(u, 3, x, e), sizeof(p));
+      for (int t=1; t<Z[3]; t++) {
+	e[3] = t;
+	su3MulNN(p, hostLink(u, 3, x, e), q);
+	memcpy(p, q, sizeof(p));
+      }
+      poly[0] += p[0] + p[8] + p[16];
+      poly[1] += p[1] + p[9] + p[17];
+    }
+  }
+
+  obs.plaquette[1] = ps / (3.0*3*V);
+  obs.plaquette[2] = pt / (3.0*3*V);
+  obs.plaquette[0] = 0.5*(obs.plaquette[1] + obs.plaquette[2]);
+  obs.rectangle[1] = rs / (3.0*6*V);
+  obs.rectangle[2] = rt / (3.0*6*V);
+  obs.rectangle[0] = 0.5*(obs.rectangle[1] + obs.rectangle[2]);
+  obs.link_trace = tr / (3.0*4*V);
+  obs.polyakov[0] = poly[0] / (3.0*Z[0]*Z[1]*Z[2]);
+  obs.polyakov[1] = poly[1] / (3.0*Z[0]*Z[1]*Z[2]);
+}
+
+static int compareObservables(const char *name, const QudaGaugeObservables &obs, const QudaGaugeObservables &ref,
+			      double tol)
+{
+  const double value[] = { obs.plaquette[0], obs.plaquette[1], obs.plaquette[2], obs.rectangle[0],
+			   obs.rectangle[1], obs.rectangle[2], obs.polyakov[0], obs.polyakov[1], obs.link_trace };
+  const double expect[] = { ref.plaquette[0], ref.plaquette[1], ref.plaquette[2], ref.rectangle[0],
+			    ref.rectangle[1], ref.rectangle[2], ref.polyakov[0], ref.polyakov[1], ref.link_trace };
+  const char *label[] = { "plaquette", "spatial plaquette", "temporal plaquette", "rectangle",
+			  "spatial rectangle", "temporal rectangle", "Re Polyakov loop", "Im Polyakov loop",
+			  "link trace" };
+  int fail = 0;
+  for (int i=0; i<9; i++) {
+    bool pass = fabs(value[i] - expect[i]) <= tol;
+    printfQuda("%s %s: %.15f, expected %.15f %s\n", name, label[i], value[i], expect[i], pass ? "PASSED" : "FAILED");
+    if (!pass) fail++;
+  }
+  return fail;
+}
+
+/**
+   Check gaugeObservablesQuda on the unit field, whose loops and link
+   trace are all 1, and on the test field against the reference
+   loops and the NERSC checksum, the sum of the 32-bit words of the
+   links.
+ */
+static void observablesTest()
+{
+  if (param.cpu_prec != QUDA_DOUBLE_PRECISION) errorQuda("Host precision %d not supported", param.cpu_prec);
+
+  QudaGaugeObservables obs, ref;
+
+  construct_gauge_field(new_gauge, 0, param.cpu_prec, &param);
+  gaugeObservablesQuda(&obs, new_gauge, &param);
+  ref.plaquette[0] = ref.plaquette[1] = ref.plaquette[2] = 1.0;
+  ref.rectangle[0] = ref.rectangle[1] = ref.rectangle[2] = 1.0;
+  ref.polyakov[0] = 1.0;
+  ref.polyakov[1] = 0.0;
+  ref.link_trace = 1.0;
+  failures += compareObservables("Unit field", obs, ref, 1e-14);
+
+  if (comm_size() > 1) {
+    printfQuda("Reference observables not supported with %d processes\n", comm_size());
+    return;
+  }
+
+  gaugeObservablesQuda(&obs, gauge, &param);
+  referenceObservables(ref, gauge);
+  failures += compareObservables("Test field", obs, ref, 1e-12);
+
+  unsigned int sum = 0;
+  for (int d=0; d<4; d++) {
+    const unsigned int *word = (const unsigned int*)gauge[d];
+    for (size_t k=0; k<V*gaugeSiteSize*sizeof(double)/4; k++) sum += word[k];
+  }
+  bool pass = (obs.nersc_checksum == sum);
+  printfQuda("Test field NERSC checksum: %x, expected %x %s\n", obs.nersc_checksum, sum, pass ? "PASSED" : "FAILED");
+  if (!pass) failures++;
+}
+
+// max over the links of |U U^dag - 1| and |det U - 1|, elementwise
+static double unitarityDeviation(void **u)
+{
+  double dev = 0.0;
+  for (int d=0; d<4; d++) {
+    for (int i=0; i<V; i++) {
+      const double *U = (const double*)u[d] + i*gaugeSiteSize;
+      double w[18];
+      su3MulND(U, U, w);
+      for (int k=0; k<18; k++) dev = fmax(dev, fabs(w[k] - ((k % 8 == 0) ? 1.0 : 0.0)));
+
+      double det[2] = {0.0, 0.0};
+      for (int k=0; k<3; k++) { // expand along the first row
+	const int a = (k+1)%3, b = (k+2)%3;
+	const double mre = U[6+2*a]*U[12+2*b] - U[6+2*a+1]*U[12+2*b+1] - U[6+2*b]*U[12+2*a] + U[6+2*b+1]*U[12+2*a+1];
+	const double mim = U[6+2*a]*U[12+2*b+1] + U[6+2*a+1]*U[12+2*b] - U[6+2*b]*U[12+2*a+1] - U[6+2*b+1]*U[12+2*a];
+	det[0] += U[2*k]*mre - U[2*k+1]*mim;
+	det[1] += U[2*k]*mim + U[2*k+1]*mre;
+      }
+      dev = fmax(dev, fmax(fabs(det[0] - 1.0), fabs(det[1])));
+    }
+  }
+  comm_allreduce_max(&dev);
+  return dev;
+}
+
+/**
+   Smear a copy of the field with APE, stout and HYP smearing, and
+   with spatial APE smearing, and check that the smeared links are in
+   SU(3) and that the smoothing has raised the plaquette (the spatial
+   plaquette for spatial smearing, which must leave the temporal
+   links untouched).
+ */
+static void smearTest()
+{
+  if (param.cpu_prec != QUDA_DOUBLE_PRECISION) errorQuda("Host precision %d not supported", param.cpu_prec);
+
+  const QudaGaugeSmearType type[] = { QUDA_GAUGE_SMEAR_APE, QUDA_GAUGE_SMEAR_STOUT, QUDA_GAUGE_SMEAR_HYP,
+				      QUDA_GAUGE_SMEAR_APE };
+  const double coeff[][3] = { { 0.6, 0.0, 0.0 }, { 0.1, 0.0, 0.0 }, { 0.75, 0.6, 0.3 }, { 0.6, 0.0, 0.0 } };
+  const int spatial[] = { 0, 0, 0, 1 };
+  const char *name[] = { "APE", "stout", "HYP", "spatial APE" };
+  const int n_steps = 2;
+  const size_t bytes = V*gaugeSiteSize*sizeof(double);
+
+  QudaGaugeObservables before, after;
+  gaugeObservablesQuda(&before, gauge, &param);
+
+  for (int t=0; t<4; t++) {
+    for (int d=0; d<4; d++) memcpy(new_gauge[d], gauge[d], bytes);
+    smearGaugeQuda(new_gauge, &param, type[t], coeff[t], n_steps, spatial[t]);
+    gaugeObservablesQuda(&after, new_gauge, &param);
+
+    const double dev = unitarityDeviation(new_gauge);
+    const int plane = spatial[t] ? 1 : 0;
+    bool pass = (dev < 1e-10 && after.plaquette[plane] > before.plaquette[plane]);
+    if (spatial[t]) {
+      int same = (memcmp(new_gauge[3], gauge[3], bytes) == 0);
+      comm_allreduce_int(&same);
+      if (same != comm_size()) {
+	printfQuda("%s smearing changed the temporal links\n", name[t]);
+	pass = false;
+      }
+    }
+    printfQuda("%s smearing, %d steps: %splaquette %.12f -> %.12f, max SU(3) deviation %e %s\n",
+	       name[t], n_steps, spatial[t] ? "spatial " : "", before.plaquette[plane], after.plaquette[plane],
+	       dev, pass ? "PASSED" : "FAILED");
+    if (!pass) failures++;
+  }
+}
+
+void usage_extra(char** argv)
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --io <file>                              # Write the field as NERSC files, read them back with several\n");
+  printfQuda("                                               threads and compare\n");
+  printfQuda("    --observables                            # Check the observables of the unit field, and of the field\n");
+  printfQuda("                                               against a reference computation\n");
+  printfQuda("    --smear                                  # Smear the field with APE, stout and HYP, and check that the\n");
+  printfQuda("                                               links stay in SU(3) and the plaquette increases\n");
+}
+
 void SU3Test(int argc, char **argv) {
 
   for (int i =1;i < argc; i++){    
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     }  
+    if (strcmp(argv[i], "--io") == 0 && i+1 < argc) {
+      io_file = argv[++i];
+      continue;
+    }
+    if (strcmp(argv[i], "--observables") == 0) {
+      observables = true;
+      continue;
+    }
+    if (strcmp(argv[i], "--smear") == 0) {
+      smear = true;
+      continue;
+    }
     
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
@@ -110,6 +484,10 @@ void SU3Test(int argc, char **argv) {
 
   check_gauge(gauge, new_gauge, 1e-3, param.cpu_prec);
 
+  if (io_file) ioTest();
+  if (observables) observablesTest();
+  if (smear) smearTest();
+
   end();
 }
 
@@ -121,5 +499,5 @@ int main(int argc, char **argv) {
 
   finalizeComms();
 
-  return 0;
+  return failures ? 1 : 0;
 }
@@ -395,6 +395,75 @@ int compare_floats(void *a, void *b, int len, double epsilon, QudaPrecision prec
   else return compareFloats((float*)a, (float*)b, len, epsilon);
 }
 
+// encode sites of 24 doubles in the storage format of the host operator (see cpu_spinor_storage.h)
+void encodeSites(void *out, const double *in, int sites, QudaStorageType storage)
+{
+  for (int x=0; x<sites; x++) {
+    const double *v = in + 24*x;
+    switch (storage) {
+    case QUDA_DOUBLE_STORAGE:
+      memcpy((double*)out + 24*x, v, 24*sizeof(double));
+      break;
+    case QUDA_SINGLE_STORAGE:
+      for (int i=0; i<24; i++) ((float*)out)[24*x+i] = (float)v[i];
+      break;
+    case QUDA_HALF_STORAGE: {
+      char *site = (char*)out + x*(sizeof(float) + 24*sizeof(short));
+      float max = 0.0f;
+      for (int i=0; i<24; i++) if (fabsf((float)v[i]) > max) max = fabsf((float)v[i]);
+      const float scale = (max > 0.0f) ? 32767.0f / max : 0.0f;
+      short *s = (short*)(site + sizeof(float));
+      *(float*)site = max;
+      for (int i=0; i<24; i++) s[i] = (short)lrintf((float)v[i]*scale);
+      break;
+    }
+    case QUDA_BFLOAT16_STORAGE:
+      for (int i=0; i<24; i++) {
+	float f = (float)v[i];
+	unsigned int u;
+	memcpy(&u, &f, sizeof(u));
+	u += 0x7fff + ((u >> 16) & 1);
+	((unsigned short*)out)[24*x+i] = (unsigned short)(u >> 16);
+      }
+      break;
+    default:
+      errorQuda("Unsupported storage %d", storage);
+    }
+  }
+}
+
+void decodeSites(double *out, const void *in, int sites, QudaStorageType storage)
+{
+  for (int x=0; x<sites; x++) {
+    double *v = out + 24*x;
+    switch (storage) {
+    case QUDA_DOUBLE_STORAGE:
+      memcpy(v, (const double*)in + 24*x, 24*sizeof(double));
+      break;
+    case QUDA_SINGLE_STORAGE:
+      for (int i=0; i<24; i++) v[i] = ((const float*)in)[24*x+i];
+      break;
+    case QUDA_HALF_STORAGE: {
+      const char *site = (const char*)in + x*(sizeof(float) + 24*sizeof(short));
+      const float scale = *(const float*)site * (1.0f/32767.0f);
+      const short *s = (const short*)(site + sizeof(float));
+      for (int i=0; i<24; i++) v[i] = s[i] * scale;
+      break;
+    }
+    case QUDA_BFLOAT16_STORAGE:
+      for (int i=0; i<24; i++) {
+	unsigned int u = (unsigned int)((const unsigned short*)in)[24*x+i] << 16;
+	float f;
+	memcpy(&f, &u, sizeof(f));
+	v[i] = f;
+      }
+      break;
+    default:
+      errorQuda("Unsupported storage %d", storage);
+    }
+  }
+}
+
 int fullLatticeIndex(int dim[4], int index, int oddBit){
 
   int za = index/(dim[0]>>1);
@@ -1035,6 +1104,83 @@ construct_fat_long_gauge_field(void **fatlink, void** longlink,
 }
 
 
+// counter-based generator: uniform in (0,1) from the key (seed, site, n)
+static double hashUniform(unsigned int seed, long long site, int n) {
+  unsigned long long z = ((unsigned long long)seed << 40) ^ ((unsigned long long)site << 8) ^ (unsigned long long)n;
+  z += 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+  return ((z >> 11) + 0.5) / 9007199254740992.0;
+}
+
+template <typename Float>
+static void constructEnsembleGaugeField(Float **res, double disorder, unsigned int seed) {
+  int X[4];
+  for (int d=0; d<4; d++) X[d] = Z[d]*commDim(d);
+
+  for (int dir = 0; dir < 4; dir++) {
+    for (int i = 0; i < V; i++) {
+      // global lexicographic index of the site, so the field does not depend on the process grid
+      const int parity = i / Vh;
+      const int Y = fullLatticeIndex(i % Vh, parity);
+      int x[4] = { Y % Z[0], (Y/Z[0]) % Z[1], (Y/(Z[0]*Z[1])) % Z[2], Y/(Z[0]*Z[1]*Z[2]) };
+      for (int d=0; d<4; d++) x[d] += commCoords(d)*Z[d];
+      const long long site = (((long long)x[3]*X[2] + x[2])*X[1] + x[1])*X[0] + x[0];
+
+      // last two rows of 1 + disorder * (gaussian complex matrix)
+      Float *u = res[dir] + (parity*Vh + i%Vh)*gaugeSiteSize;
+      for (int m = 1; m < 3; m++) {
+	for (int n = 0; n < 3; n++) {
+	  const int k = (dir*3 + m)*3 + n;
+	  const double r = sqrt(-2.0*log(hashUniform(seed, site, 2*k)));
+	  const double phi = 2.0*M_PI*hashUniform(seed, site, 2*k+1);
+	  u[m*(3*2) + n*(2) + 0] = (m==n ? 1.0 : 0.0) + disorder*r*cos(phi);
+	  u[m*(3*2) + n*(2) + 1] = disorder*r*sin(phi);
+	}
+      }
+      normalize((complex<Float>*)(u + 1*3*2), 3);
+      orthogonalize((complex<Float>*)(u + 1*3*2), (complex<Float>*)(u + 2*3*2), 3);
+      normalize((complex<Float>*)(u + 2*3*2), 3);
+
+      Float *w = u, *a = u + 1*3*2, *b = u + 2*3*2;
+      for (int n = 0; n < 6; n++) w[n] = 0.0;
+      accumulateConjugateProduct(w+0*(2), a+1*(2), b+2*(2), +1);
+      accumulateConjugateProduct(w+0*(2), a+2*(2), b+1*(2), -1);
+      accumulateConjugateProduct(w+1*(2), a+2*(2), b+0*(2), +1);
+      accumulateConjugateProduct(w+1*(2), a+0*(2), b+2*(2), -1);
+      accumulateConjugateProduct(w+2*(2), a+0*(2), b+1*(2), +1);
+      accumulateConjugateProduct(w+2*(2), a+1*(2), b+0*(2), -1);
+    }
+  }
+}
+
+/*
+  Reproducible gauge field with the short-distance structure of a
+  thermalized configuration: each link is the SU(3) projection of
+  1 + disorder * G with G a gaussian complex matrix (disorder = 0
+  gives the unit field, large disorder a hot start), followed by
+  smear_steps stout steps (rho = 0.1) that correlate neighboring
+  links.  The links are drawn from a hash of the seed and of the
+  global site, so the same seed gives the same global field on any
+  process grid.  The anisotropy and boundary conditions are not
+  applied (use construct_gauge_field with type 2).
+*/
+void construct_ensemble_gauge_field(void **gauge, double disorder, int smear_steps, unsigned int seed,
+				    QudaPrecision precision, QudaGaugeParam *param) {
+  if (param->gauge_order != QUDA_QDP_GAUGE_ORDER) {
+    printf("ERROR: ensemble gauge fields must be in QDP order\n");
+    exit(1);
+  }
+  if (precision == QUDA_DOUBLE_PRECISION) constructEnsembleGaugeField((double**)gauge, disorder, seed);
+  else constructEnsembleGaugeField((float**)gauge, disorder, seed);
+
+  if (smear_steps > 0) {
+    const double rho = 0.1;
+    smearGaugeQuda(gauge, param, QUDA_GAUGE_SMEAR_STOUT, &rho, smear_steps, 0);
+  }
+}
+
 template <typename Float>
 static void constructCloverField(Float *res, double norm, double diag) {
 
@@ -1746,11 +1892,13 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
   
+#ifndef QUDA_HOST_ONLY // the host-only library has no device kernels
   if( strcmp(argv[i], "--kernel_pack_t") == 0){
     quda::setKernelPackT(true);
     ret= 0;
     goto out;
   }
+#endif
 
 
   if( strcmp(argv[i], "--tune") == 0){
@@ -56,6 +56,8 @@
 
   void construct_gauge_field(void **gauge, int type, QudaPrecision precision, QudaGaugeParam *param);
     void construct_fat_long_gauge_field(void **fatlink, void** longlink, int type, QudaPrecision precision, QudaGaugeParam*);
+  void construct_ensemble_gauge_field(void **gauge, double disorder, int smear_steps, unsigned int seed,
+				      QudaPrecision precision, QudaGaugeParam *param);
     void construct_clover_field(void *clover, double norm, double diag, QudaPrecision precision);
   void construct_spinor_field(void *spinor, int type, int i0, int s0, int c0, QudaPrecision precision);
   void createSiteLinkCPU(void** link,  QudaPrecision precision, int phase) ;
@@ -69,6 +71,10 @@
   void strong_check(void *spinor, void *spinorGPU, int len, QudaPrecision precision);
   int compare_floats(void *a, void *b, int len, double epsilon, QudaPrecision precision);
 
+  // convert sites of 24 doubles to and from the spinor storage formats of the host Wilson operator
+  void encodeSites(void *out, const double *in, int sites, QudaStorageType storage);
+  void decodeSites(double *out, const void *in, int sites, QudaStorageType storage);
+
   void check_gauge(void **, void **, double epsilon, QudaPrecision precision);
 
   int strong_check_link(void ** linkA, const char* msgA,  void **linkB, const char* msgB, int len, QudaPrecision prec);
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <sys/time.h>
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -37,6 +38,7 @@ static bool reunit_svd_only  = false;
 static double svd_rel_error  = 1e-4;
 static double svd_abs_error  = 1e-5;
 static double max_allowed_error = 1e-11;
+static bool host_unitarize = false;
 
 extern int xdim, ydim, zdim, tdim;
 extern int gridsize_from_cmdline[];
@@ -48,6 +50,48 @@ static QudaGaugeFieldOrder gauge_order = QUDA_QDP_GAUGE_ORDER;
 
 static size_t gSize;
 
+// largest difference between the elements of two QDP-ordered fields
+template<typename Float>
+static double maxLinkDifference(void **a, void **b)
+{
+  double max_diff = 0.0;
+  for(int dir=0; dir<4; ++dir){
+    const Float *u = (const Float*)a[dir], *v = (const Float*)b[dir];
+    for(int i=0; i<V*gaugeSiteSize; ++i){
+      double diff = fabs((double)u[i] - (double)v[i]);
+      if(diff > max_diff) max_diff = diff;
+    }
+  }
+  return max_diff;
+}
+
+// largest element of U^dagger U - 1 over the links of a QDP-ordered field
+template<typename Float>
+static double maxUnitarityError(void **field)
+{
+  double max_error = 0.0;
+  for(int dir=0; dir<4; ++dir){
+    for(int site=0; site<V; ++site){
+      const Float *u = (const Float*)field[dir] + site*gaugeSiteSize;
+      for(int i=0; i<3; ++i){
+	for(int j=0; j<3; ++j){
+	  // sum_k conj(u_ki) u_kj
+	  double re = 0.0, im = 0.0;
+	  for(int k=0; k<3; ++k){
+	    const Float *ki = u + 2*(3*k+i), *kj = u + 2*(3*k+j);
+	    re += ki[0]*kj[0] + ki[1]*kj[1];
+	    im += ki[0]*kj[1] - ki[1]*kj[0];
+	  }
+	  if(i == j) re -= 1.0;
+	  double err = sqrt(re*re + im*im);
+	  if(err > max_error) max_error = err;
+	}
+      }
+    }
+  }
+  return max_error;
+}
+
 
 static int
 unitarize_link_test()
@@ -198,6 +242,52 @@ unitarize_link_test()
   int num_failures=0;
   cudaMemcpy(&num_failures, num_failures_dev, sizeof(int), cudaMemcpyDeviceToHost);
 
+  if(host_unitarize){
+    gParam.create = QUDA_REFERENCE_FIELD_CREATE;
+    gParam.gauge  = fatlink_2d;
+    cpuGaugeField cpuFatLink(gParam);
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    cpuGaugeField cpuULink(gParam);
+
+    UnitarizeLinksStats stats;
+    struct timeval ht0, ht1;
+    gettimeofday(&ht0,NULL);
+    num_failures += unitarizeLinksCPU(qudaGaugeParam, cpuFatLink, &cpuULink, NULL, &stats);
+    gettimeofday(&ht1,NULL);
+
+    printfQuda("Host unitarization: %lld analytic, %lld SVD, %lld failures, max error %e\n",
+	       stats.analytic, stats.svd, stats.failures, stats.max_error);
+    printfQuda("Host unitarization time: %g ms\n", TDIFF(ht0,ht1)*1000);
+
+    // compare with the device result, and check the host result independently
+    cpuGaugeField cpuDevULink(gParam);
+    cudaULink->saveCPUField(cpuDevULink, QUDA_CPU_FIELD_LOCATION);
+
+    void **host_link = (void**)cpuULink.Gauge_p();
+    void **dev_link = (void**)cpuDevULink.Gauge_p();
+    double max_diff, max_unitarity;
+    if(cpu_prec == QUDA_DOUBLE_PRECISION){
+      max_diff = maxLinkDifference<double>(host_link, dev_link);
+      max_unitarity = maxUnitarityError<double>(host_link);
+    }else{
+      max_diff = maxLinkDifference<float>(host_link, dev_link);
+      max_unitarity = maxUnitarityError<float>(host_link);
+    }
+
+    // single precision cannot resolve the default tolerance
+    const double tol = (prec == QUDA_SINGLE_PRECISION && max_allowed_error < 1e-5) ? 1e-5 : max_allowed_error;
+    printfQuda("Host vs device max difference = %e, host max unitarity error = %e (tolerance %e)\n",
+	       max_diff, max_unitarity, tol);
+    if(max_diff > tol){
+      printfQuda("Host and device unitarized links differ\n");
+      num_failures++;
+    }
+    if(max_unitarity > tol){
+      printfQuda("Host unitarized links are not unitary\n");
+      num_failures++;
+    }
+  }
+
  delete cpuOutLink;
  delete cudaFatLink;
  delete cudaULink;
@@ -252,6 +342,11 @@ main(int argc, char **argv)
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     }
+
+    if(strcmp(argv[i], "--host") == 0){
+      host_unitarize = true;
+      continue;
+    }
     
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);